@@ -1,20 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////
+// Material table
+struct MaterialData
+{
+    vec3 vAlbedoTint;
+    float fOpacity;
+    vec3 vEmissiveColor;
+    float fMetallic;
+    vec4 vSpecularMapSpecularMask;
+    vec4 vSpecularMapRoughnessMask;
+    vec4 vSpecularMapMetallicMask;
+    float fRoughness;
+    float fSpecular;
+    float fNormalMapStrength;
+    float fDisplacement;
+    uint uiFlags;
+};
+
+layout (std430, binding = UNIFORM_BUFFER_MATERIALS) readonly buffer MaterialTable
+{
+    MaterialData sMaterials[];
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Material uniforms
-layout (location = 0) uniform vec4 bFlagsA;  // albedo, normal, specular, alpha
-layout (location = 1) uniform vec4 bFlagsB;  // alpha, displacement, 0, 0
-layout (location = 2) uniform vec3 vAlbedoTint;
-layout (location = 3) uniform vec3 vEmissiveColor;
-layout (location = 4) uniform float fOpacity;
-layout (location = 5) uniform float fMetallic;
-layout (location = 6) uniform float fRoughness;
-layout (location = 7) uniform float fSpecular;
-layout (location = 8) uniform float fNormalMapStrength;
-layout (location = 9) uniform float fDisplacement;
+layout (location = 0) uniform uint uiMaterialId;
 layout (location = 10) uniform uint uiNormalMappingAlgorithm;
 layout (location = 11) uniform uint uiDisplacementMappingAlgorithm;
-layout (location = 12) uniform vec4 vSpecularMapSpecularMask;
-layout (location = 13) uniform vec4 vSpecularMapRoughnessMask;
-layout (location = 14) uniform vec4 vSpecularMapMetallicMask;
+
+// The material of the current draw
+#define sMaterial sMaterials[uiMaterialId]
 
 ////////////////////////////////////////////////////////////////////////////////
 // Various texture maps
@@ -25,12 +39,12 @@ layout (binding = TEXTURE_ALPHA_MAP) uniform sampler2D sAlphaMap;
 layout (binding = TEXTURE_DISPLACEMENT_MAP) uniform sampler2D sDisplacementMap;
 
 ////////////////////////////////////////////////////////////////////////////////
-bool isTwoSided()         { return bFlagsA.x == 1.0; }
-bool hasAlbedoMap()       { return bFlagsA.y == 1.0; }
-bool hasNormalMap()       { return bFlagsA.z == 1.0; }
-bool hasSpecularMap()     { return bFlagsA.w == 1.0; }
-bool hasAlphaMap()        { return bFlagsB.x == 1.0; }
-bool hasDisplacementMap() { return bFlagsB.y == 1.0; }
+bool isTwoSided()         { return (sMaterial.uiFlags & MaterialFlag_TwoSided) != 0; }
+bool hasAlbedoMap()       { return (sMaterial.uiFlags & MaterialFlag_AlbedoMap) != 0; }
+bool hasNormalMap()       { return (sMaterial.uiFlags & MaterialFlag_NormalMap) != 0; }
+bool hasSpecularMap()     { return (sMaterial.uiFlags & MaterialFlag_SpecularMap) != 0; }
+bool hasAlphaMap()        { return (sMaterial.uiFlags & MaterialFlag_AlphaMap) != 0; }
+bool hasDisplacementMap() { return (sMaterial.uiFlags & MaterialFlag_DisplacementMap) != 0; }
 bool hasMapByMask(const vec4 mask) { return any(greaterThan(mask, vec4(0.0))); }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -42,14 +56,14 @@ vec2 parallaxMap(const vec2 uv, const vec3 viewDirection)
 
     // Basic parallax mapping ends here
     if (uiDisplacementMappingAlgorithm == DisplacementMappingMethod_BasicParallaxMapping)
-        return uv - viewDirection.xy * (currentDepthMapValue * fDisplacement);
+        return uv - viewDirection.xy * (currentDepthMapValue * sMaterial.fDisplacement);
 
     // Initial values: steep parallax mapping
     vec2  currentTexCoords  = uv;
     float currentLayerDepth = 0.0;
 
     // The amount to shift the texture coordinates per layer (from vector P)
-    const vec2 P = (viewDirection.xy / viewDirection.z) * fDisplacement; 
+    const vec2 P = (viewDirection.xy / viewDirection.z) * sMaterial.fDisplacement; 
 
     // Depth layer parameters
     const float minLayers = 8;
@@ -105,7 +119,7 @@ vec2 applyDisplacementMap(const vec2 uv, const vec3 viewDirection)
 vec3 applyNormalMap(const vec2 uv, const vec3 normal, const mat3 tbn)
 {
     const vec3 normalMap = 2.0 * texture2D(sNormalMap, uv).rgb - 1.0;
-    return lerp(normal, normalize(tbn * normalMap), fNormalMapStrength);
+    return lerp(normal, normalize(tbn * normalMap), sMaterial.fNormalMapStrength);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,8 +149,8 @@ MaterialInfo evaluateMaterialFn(const vec2 uv, const vec3 normal, const mat3 tbn
     ////////////////////////////////////////////////////////////////////////////////
     // Albedo & opacity
     ////////////////////////////////////////////////////////////////////////////////
-    material.albedo = vAlbedoTint.rgb;
-    material.opacity = fOpacity;
+    material.albedo = sMaterial.vAlbedoTint.rgb;
+    material.opacity = sMaterial.fOpacity;
 
     // Sample the albedo map
     if (hasAlbedoMap()) 
@@ -152,7 +166,7 @@ MaterialInfo evaluateMaterialFn(const vec2 uv, const vec3 normal, const mat3 tbn
     ////////////////////////////////////////////////////////////////////////////////
     // Emissive
     ////////////////////////////////////////////////////////////////////////////////
-    material.emission = vEmissiveColor;
+    material.emission = sMaterial.vEmissiveColor;
     
     ////////////////////////////////////////////////////////////////////////////////
     // Normal
@@ -164,18 +178,18 @@ MaterialInfo evaluateMaterialFn(const vec2 uv, const vec3 normal, const mat3 tbn
     ////////////////////////////////////////////////////////////////////////////////
     // Metallic, roughness, specular, ao
     ////////////////////////////////////////////////////////////////////////////////
-    material.metallic = fMetallic;
-    material.roughness = fRoughness;
-    material.specular = fSpecular;
+    material.metallic = sMaterial.fMetallic;
+    material.roughness = sMaterial.fRoughness;
+    material.specular = sMaterial.fSpecular;
 
     // Sample the specular map
     if (hasSpecularMap())
     {
         const vec4 specularMap = texture2D(sSpecularMap, material.uv);
 
-        if (hasMapByMask(vSpecularMapMetallicMask))  material.metallic = dot(specularMap, vSpecularMapMetallicMask);
-        if (hasMapByMask(vSpecularMapRoughnessMask)) material.roughness = dot(specularMap, vSpecularMapRoughnessMask);
-        if (hasMapByMask(vSpecularMapSpecularMask))  material.specular = dot(specularMap, vSpecularMapSpecularMask);
+        if (hasMapByMask(sMaterial.vSpecularMapMetallicMask))  material.metallic = dot(specularMap, sMaterial.vSpecularMapMetallicMask);
+        if (hasMapByMask(sMaterial.vSpecularMapRoughnessMask)) material.roughness = dot(specularMap, sMaterial.vSpecularMapRoughnessMask);
+        if (hasMapByMask(sMaterial.vSpecularMapSpecularMask))  material.specular = dot(specularMap, sMaterial.vSpecularMapSpecularMask);
     }
 
     return material;
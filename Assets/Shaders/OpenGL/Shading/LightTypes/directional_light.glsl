@@ -18,7 +18,9 @@ layout (std140, binding = UNIFORM_BUFFER_GENERIC_1) uniform LightData
     float fShadowLightBleedBias;
     float fShadowMomentsBias;
     vec2 vShadowExponentialConstants;
-    mat4 mLightTransform;
+    int iNumCascades;
+    mat4 mLightTransforms[MAX_SHADOW_CASCADES];
+    vec4 vShadowMapOffsetScales[MAX_SHADOW_CASCADES];
 } sLightData;
 
 // Other base-pass related uniforms
@@ -33,13 +35,22 @@ layout (binding = TEXTURE_SHADOW_MAP) uniform sampler2D sShadowMap;
 vec4 computeDirectionalLight(const SurfaceInfo surface, const MaterialInfo material, const float posOffset,
                              const float diffuseScale, const float specularScale, const float ambientScale)
 {
-    // Light-space position of the pixel
-    const vec4 posLS = sLightData.mLightTransform * vec4(surface.position, 1.0);
-    const vec3 positionLS = ndcToScreen(posLS.xyz / posLS.w);
+    // Light-space position of the pixel, in the first cascade that contains it
+    vec3 positionLS = vec3(0.0);
+    int cascadeId = 0;
+    for (; cascadeId < sLightData.iNumCascades; ++cascadeId)
+    {
+        const vec4 posLS = sLightData.mLightTransforms[cascadeId] * vec4(surface.position, 1.0);
+        positionLS = ndcToScreen(posLS.xyz / posLS.w);
+        if (all(greaterThanEqual(positionLS, vec3(0.0))) && all(lessThanEqual(positionLS, vec3(1.0))))
+            break;
+    }
+    cascadeId = min(cascadeId, sLightData.iNumCascades - 1);
+    const vec4 offsetScale = sLightData.vShadowMapOffsetScales[cascadeId];
 
     // Shadow map parameters
     ShadowParameters shadowParameters;
-    shadowParameters.uv = positionLS.xy;
+    shadowParameters.uv = offsetScale.xy + clamp(positionLS.xy, vec2(0.0), vec2(1.0)) * offsetScale.zw;
     shadowParameters.depth = positionLS.z;
     shadowParameters.castsShadow = sLightData.fCastsShadow != 0.0;
     shadowParameters.algorithm = sLightData.uiShadowMapAlgorithm;
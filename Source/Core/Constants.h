@@ -17,6 +17,12 @@ namespace Constants
 	// Absolute maximum profiled threads
 	static constexpr size_t s_maxProfilerThreads = 1;
 
+	// Number of events in the per-thread profiler event buffers (must be a power of two)
+	static constexpr size_t s_profilerEventBufferSize = 16384;
+
+	// Number of log records the asynchronous log queue can hold (must be a power of two)
+	static constexpr size_t s_logQueueSize = 8192;
+
 	// Absolute maximum render layers
 	static constexpr size_t s_maxLayers = 8;
 
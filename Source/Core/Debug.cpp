@@ -355,14 +355,17 @@ namespace Debug
 			}
 			return log_null;
 		}
-		LogOutputRef make_log_from_output(LogOutput& output, const char* file, int line, const char* function)
+		void init_on_demand()
 		{
-			// Perform on-demand init
 			if (!s_initDone)
 			{
 				s_initDone = true;
 				initLogDevices();
 			}
+		}
+		LogOutputRef make_log_from_output(LogOutput& output, const char* file, int line, const char* function)
+		{
+			init_on_demand();
 			return LogOutputRef(output, LogMessageSource{ file, line, function });
 		}
 		LogOutputRef make_log_from_level(DebugOutputLevel level, const char* file, int line, const char* function)
@@ -393,6 +396,11 @@ namespace Debug
 		{
 			return make_log_from_output(log_error, file, line, function);
 		}
+		bool is_log_active(LogOutput& output)
+		{
+			init_on_demand();
+			return isEnabled(output);
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -409,6 +417,7 @@ namespace Debug
 		m_nameUpper(name),
         m_colorCode(m_colorCode),
         m_devices(devices.begin(), devices.end()),
+        m_numDevices(devices.size()),
         m_newLine(true)
     {
 		std::transform(m_nameUpper.begin(), m_nameUpper.end(), m_nameUpper.begin(), [](unsigned char ch) { return std::toupper(ch); });
@@ -417,9 +426,11 @@ namespace Debug
 	////////////////////////////////////////////////////////////////////////////////
 	LogOutputRef::LogOutputRef(LogOutput& output, LogMessageSource const& source) :
 		m_ref(output),
-		m_lock(output.m_mutex),
+		m_lock(output.m_mutex, std::defer_lock),
 		m_source(source)
 	{
+		// The asynchronous backend stages the messages per-thread, so no locking is needed there
+		if (!asyncLogging()) m_lock.lock();
 		output << source;
 	}
 
@@ -435,61 +446,130 @@ namespace Debug
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	void putLinePrefixConsole(Device& device, LogOutput& log, bool newLine)
+	void putLinePrefixConsole(Device& device, LogOutput& log, time_t date, size_t threadId, std::string const& region)
 	{
 		std::ostream& stream = device.m_stream.get();
 		stream << "\033[" << log.m_colorCode << "m";
-		stream << "[" << DateTime::getDateStringUtf8(DateTime::timeFormatDisplay()) << "]";
-		//stream << "[" << Threading::currentThreadId() << "]";
+		stream << "[" << DateTime::getDateStringUtf8(date, DateTime::timeFormatDisplay()) << "]";
+		//stream << "[" << threadId << "]";
 		//stream << "[" << log.m_nameUpper << "]";
-		stream << s_region[Threading::currentThreadId()];
+		stream << region;
 		stream << ": ";
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	void putLinePrefixFile(Device& device, LogOutput& log, bool newLine)
+	void putLinePrefixFile(Device& device, LogOutput& log, time_t date, size_t threadId, std::string const& region)
 	{
 		std::ostream& stream = device.m_stream.get();
-		stream << "[" << DateTime::getDateStringUtf8(DateTime::timeFormatDisplay()) << "]";
-		stream << "[" << Threading::currentThreadId() << "]";
+		stream << "[" << DateTime::getDateStringUtf8(date, DateTime::timeFormatDisplay()) << "]";
+		stream << "[" << threadId << "]";
 		stream << "[" << log.m_nameUpper << "]";
-		stream << s_region[Threading::currentThreadId()];
+		stream << region;
 		stream << ": ";
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	void putLinePrefixInMemory(Device& device, LogOutput& log, bool newLine)
+	void putLinePrefixInMemory(Device& device, LogOutput& log, time_t date, size_t threadId, std::string const& region)
 	{
 		InMemoryLogBuffer* buffer = (InMemoryLogBuffer*)(device.m_stream.get().rdbuf());
 		InMemoryLogEntry* entry = &buffer->m_messages[buffer->m_outMessageId];
 
-		entry->m_dateEpoch = time(nullptr);
-		entry->m_date = DateTime::getDateStringUtf8(DateTime::dateFormatDisplay());
+		entry->m_dateEpoch = date;
+		entry->m_date = DateTime::getDateStringUtf8(date, DateTime::dateFormatDisplay());
 		entry->m_sourceLog = log.m_name;
-		entry->m_threadId = std::to_string(Threading::currentThreadId());
-		entry->m_region = s_region[Threading::currentThreadId()];
+		entry->m_threadId = std::to_string(threadId);
+		entry->m_region = region;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	void putLinePrefix(Device& device, LogOutput& log, bool newLine)
+	void putLinePrefix(Device& device, LogOutput& log, time_t date, size_t threadId, std::string const& region)
 	{
 		switch (device.m_deviceType)
 		{
-		case Device::Console:  putLinePrefixConsole(device, log, newLine); break;
-		case Device::File:     putLinePrefixFile(device, log, newLine); break;
-		case Device::InMemory: putLinePrefixInMemory(device, log, newLine); break;
+		case Device::Console:  putLinePrefixConsole(device, log, date, threadId, region); break;
+		case Device::File:     putLinePrefixFile(device, log, date, threadId, region); break;
+		case Device::InMemory: putLinePrefixInMemory(device, log, date, threadId, region); break;
 		}
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Per-thread staging buffer of the asynchronous backend. */
+	struct LogStagingBuffer
+	{
+		// The record being built
+		LogRecord m_record;
+
+		// Stream for the message contents
+		std::ostringstream m_stream;
+
+		// Whether a record is currently being built
+		bool m_active = false;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	thread_local LogStagingBuffer s_stagingBuffer;
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::ostream& stagingStream()
+	{
+		return s_stagingBuffer.m_stream;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Starts staging a new line for the parameter log, if there isn't one already. */
+	void beginStagedRecord(LogOutput& log, bool hasPrefix)
+	{
+		if (s_stagingBuffer.m_active) return;
+
+		const size_t threadId = Threading::currentThreadId();
+		LogRecord& record = s_stagingBuffer.m_record;
+		record.m_log = &log;
+		record.m_date = time(nullptr);
+		record.m_threadId = threadId;
+		record.m_region = s_region[threadId];
+		record.m_hasPrefix = hasPrefix;
+		s_stagingBuffer.m_active = true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void submitLogRecord(LogRecord& record);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Finishes the currently staged line and hands it over to the sink thread. */
+	void submitStagedRecord(LogOutput& log, bool newLine)
+	{
+		beginStagedRecord(log, false);
+
+		LogRecord& record = s_stagingBuffer.m_record;
+		record.m_message = s_stagingBuffer.m_stream.str();
+		record.m_newLine = newLine;
+		s_stagingBuffer.m_stream.str("");
+		s_stagingBuffer.m_active = false;
+
+		submitLogRecord(record);
+
+		// Errors are usually followed by termination, so make sure they reach the devices
+		if (&log == &logger_impl::log_error)
+			flushLogs();
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/**  Writes out a log line prefix */
 	LogOutput& putLinePrefix(LogOutput& log, bool newLine)
 	{
+		if (asyncLogging())
+		{
+			if (isEnabled(log)) beginStagedRecord(log, true);
+			return log;
+		}
+
 		// Write out the logger name and the color code prefix
 		if (log.m_newLine)
 		{
+			const size_t threadId = Threading::currentThreadId();
+			const time_t date = time(nullptr);
 			for (auto const& device : log.m_devices)
-				putLinePrefix(device, log, newLine);
+				putLinePrefix(device, log, date, threadId, s_region[threadId]);
 			log.m_newLine = false;
 		}
 
@@ -533,6 +613,12 @@ namespace Debug
 	/**  Writes out a log line suffix */
 	LogOutput& putLineSuffix(LogOutput& log, bool newLine)
 	{
+		if (asyncLogging())
+		{
+			if (isEnabled(log)) submitStagedRecord(log, newLine);
+			return log;
+		}
+
 		for (auto device : log.m_devices)
 			putLineSuffix(device, log, newLine);
 		log.m_newLine = true;
@@ -575,6 +661,12 @@ namespace Debug
 	/**  Writes out a log line source */
 	LogOutput& putLineSource(LogOutput& log, LogMessageSource const& source)
 	{
+		if (asyncLogging())
+		{
+			s_stagingBuffer.m_record.m_source = source;
+			return log;
+		}
+
 		for (auto device : log.m_devices)
 			putLineSource(device, source);
 
@@ -610,6 +702,337 @@ namespace Debug
 		return log << formattedMessage.m_data;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	LogRecordQueue::LogRecordQueue(size_t capacity) :
+		m_cells(std::make_unique<Cell[]>(capacity)),
+		m_mask(capacity - 1),
+		m_enqueuePos(0),
+		m_dequeuePos(0)
+	{
+		for (size_t i = 0; i < capacity; ++i)
+			m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool LogRecordQueue::tryPush(LogRecord& record)
+	{
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = m_cells[pos & m_mask];
+			const size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+			const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+
+			// The slot is free; try to claim it
+			if (diff == 0)
+			{
+				if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.m_record = std::move(record);
+					cell.m_sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+
+			// The slot still holds an unread record; the queue is full
+			else if (diff < 0)
+			{
+				return false;
+			}
+
+			// Another producer claimed the slot; reload the position
+			else
+			{
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool LogRecordQueue::tryPop(LogRecord& record)
+	{
+		Cell& cell = m_cells[m_dequeuePos & m_mask];
+		const size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+		if (std::ptrdiff_t(sequence) - std::ptrdiff_t(m_dequeuePos + 1) < 0)
+			return false;
+
+		record = std::move(cell.m_record);
+		cell.m_sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+		++m_dequeuePos;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Writes out a single log record to the devices of its log. */
+	void writeLogRecord(LogRecord const& record)
+	{
+		LogOutput& log = *record.m_log;
+		std::lock_guard<std::mutex> lock(log.m_mutex);
+		for (auto const& device : log.m_devices)
+		{
+			putLineSource(device, record.m_source);
+			if (record.m_hasPrefix)
+				putLinePrefix(device, log, record.m_date, record.m_threadId, record.m_region);
+			device.get().m_stream.get() << record.m_message;
+			putLineSuffix(device, log, record.m_newLine);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** The asynchronous log sink; owns the record queue and the writer thread. */
+	struct AsyncLogSink
+	{
+		AsyncLogSink();
+		~AsyncLogSink();
+
+		// The pending records
+		LogRecordQueue m_queue{ Constants::s_logQueueSize };
+
+		// Number of records submitted and written so far
+		std::atomic<size_t> m_numSubmitted = 0;
+		std::atomic<size_t> m_numWritten = 0;
+
+		// Whether the sink thread should keep running
+		std::atomic_bool m_running = true;
+
+		// The sink thread
+		std::thread m_thread;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Whether the async backend is enabled, and whether the sink is still alive
+	static std::atomic_bool s_asyncLogging = false;
+	static std::atomic_bool s_asyncSinkDestroyed = false;
+
+	////////////////////////////////////////////////////////////////////////////////
+	void asyncSinkThreadCallback(AsyncLogSink& sink)
+	{
+		LogRecord record;
+		int numIdleRounds = 0;
+		while (true)
+		{
+			// Write out the next record
+			if (sink.m_queue.tryPop(record))
+			{
+				writeLogRecord(record);
+				++sink.m_numWritten;
+				numIdleRounds = 0;
+				continue;
+			}
+
+			// Only stop once the queue is drained
+			if (!sink.m_running)
+				break;
+
+			// Back off while there is nothing to do
+			if (++numIdleRounds < 64) std::this_thread::yield();
+			else                      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	AsyncLogSink::AsyncLogSink() :
+		m_thread(asyncSinkThreadCallback, std::ref(*this))
+	{}
+
+	////////////////////////////////////////////////////////////////////////////////
+	AsyncLogSink::~AsyncLogSink()
+	{
+		m_running = false;
+		m_thread.join();
+		s_asyncSinkDestroyed = true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	AsyncLogSink& asyncLogSink()
+	{
+		// Constructed on first use, so it is destroyed (and drained) before the devices are
+		static AsyncLogSink s_sink;
+		return s_sink;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void submitLogRecord(LogRecord& record)
+	{
+		AsyncLogSink& sink = asyncLogSink();
+		++sink.m_numSubmitted;
+		while (!sink.m_queue.tryPush(record))
+			std::this_thread::yield();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool asyncLogging()
+	{
+		return s_asyncLogging.load(std::memory_order_relaxed) && !s_asyncSinkDestroyed.load(std::memory_order_relaxed);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool defaultAsyncLogging()
+	{
+		return Config::AttribValue("log_async").get<int>() != 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void setAsyncLogging(bool enabled)
+	{
+		if (enabled == s_asyncLogging) return;
+
+		// Drain the pending records before switching back to synchronous output
+		if (!enabled) flushLogs();
+		s_asyncLogging = enabled;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void flushLogs()
+	{
+		if (s_asyncSinkDestroyed) return;
+
+		AsyncLogSink& sink = asyncLogSink();
+		const size_t numSubmitted = sink.m_numSubmitted;
+		while (sink.m_numWritten < numSubmitted)
+			std::this_thread::yield();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkLogging(size_t numThreads, size_t numLinesPerThread)
+	{
+		// Private in-memory target, so the benchmark does not flood the real logs
+		std::ostringstream stream;
+		Device device(std::ref<std::ostream>(stream), Device::File);
+		LogOutput output("Benchmark", "0", { device });
+
+		const bool asyncEnabled = s_asyncLogging;
+		for (bool async : { false, true })
+		{
+			setAsyncLogging(async);
+			stream.str("");
+
+			// Per-call latencies, in nanoseconds
+			std::vector<std::vector<double>> latencies(numThreads, std::vector<double>(numLinesPerThread));
+
+			// Release all the threads at once, so they actually contend
+			std::atomic<size_t> numReady = 0;
+			std::atomic_bool go = false;
+			std::vector<std::thread> threads;
+			for (size_t threadId = 0; threadId < numThreads; ++threadId)
+			{
+				threads.emplace_back([&, threadId]()
+				{
+					++numReady;
+					while (!go) std::this_thread::yield();
+
+					for (size_t lineId = 0; lineId < numLinesPerThread; ++lineId)
+					{
+						const auto begin = std::chrono::steady_clock::now();
+						logger_impl::make_log_from_output(output, __FILE__, __LINE__, __FUNCTION__) << "Benchmark line " << lineId << " from thread " << threadId << Debug::end;
+						latencies[threadId][lineId] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+					}
+				});
+			}
+			while (numReady < numThreads) std::this_thread::yield();
+
+			DateTime::Timer submitTimer(true);
+			go = true;
+			for (auto& thread : threads)
+				thread.join();
+			submitTimer.stop();
+
+			// The lines only reach the device once the sink drained the queue
+			DateTime::Timer drainTimer(true);
+			flushLogs();
+			drainTimer.stop();
+
+			std::vector<double> allLatencies;
+			allLatencies.reserve(numThreads * numLinesPerThread);
+			for (auto const& threadLatencies : latencies)
+				allLatencies.insert(allLatencies.end(), threadLatencies.begin(), threadLatencies.end());
+			auto percentile = [&](double p)
+			{
+				if (allLatencies.empty()) return 0.0;
+				auto it = allLatencies.begin() + size_t(p * (allLatencies.size() - 1));
+				std::nth_element(allLatencies.begin(), it, allLatencies.end());
+				return *it;
+			};
+
+			const double numLines = double(numThreads * numLinesPerThread);
+			const double totalTime = submitTimer.getElapsedTime() + drainTimer.getElapsedTime();
+			log_info() << "Logging benchmark (" << (async ? "asynchronous" : "synchronous") << ", " << numThreads << " threads, " << numLinesPerThread << " lines each):" << Debug::end;
+			log_info() << "  - throughput: " << numLines / glm::max(submitTimer.getElapsedTime(), 1e-9) << " lines/s submitted, "
+				<< numLines / glm::max(totalTime, 1e-9) << " lines/s written" << Debug::end;
+			log_info() << "  - latency per call: " << percentile(0.5) << " ns median, " << percentile(0.99) << " ns p99, " << percentile(1.0) << " ns max" << Debug::end;
+			log_info() << "  - bytes written: " << stream.str().size() << Debug::end;
+		}
+		setAsyncLogging(asyncEnabled);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkDisabledLogging(size_t numIterations)
+	{
+		// Private log without any devices; stands in for a channel that is turned off at runtime
+		LogOutput output("Benchmark", "0", {});
+
+		volatile size_t sink = 0;
+		size_t numArgumentEvaluations = 0, numLevelEvaluations = 0;
+		auto argument = [&](size_t i) { ++numArgumentEvaluations; return std::to_string(double(i) * 0.5); };
+		auto level = [&]() { ++numLevelEvaluations; return DebugOutputLevel::Null; };
+
+		// Bare loop, subtracted from the other measurements
+		DateTime::Timer baselineTimer(true);
+		for (size_t i = 0; i < numIterations; ++i)
+			sink = sink + i;
+		baselineTimer.stop();
+
+		// Level stripped at compile time
+		DateTime::Timer compiledOutTimer(true);
+		for (size_t i = 0; i < numIterations; ++i)
+		{
+			sink = sink + i;
+			log_null() << "Iteration " << i << ": " << argument(i) << Debug::end;
+		}
+		compiledOutTimer.stop();
+
+		// Runtime level
+		DateTime::Timer runtimeLevelTimer(true);
+		for (size_t i = 0; i < numIterations; ++i)
+		{
+			sink = sink + i;
+			log_output(level()) << "Iteration " << i << ": " << argument(i) << Debug::end;
+		}
+		runtimeLevelTimer.stop();
+
+		// Channel turned off at runtime
+		DateTime::Timer disabledTimer(true);
+		for (size_t i = 0; i < numIterations; ++i)
+		{
+			sink = sink + i;
+			LOG_STATEMENT_IMPL(logger_impl::is_log_skipped<DebugOutputLevel::Error>(output), make_log_from_output(output, __FILE__, __LINE__, __FUNCTION__)) << "Iteration " << i << ": " << argument(i) << Debug::end;
+		}
+		disabledTimer.stop();
+		const size_t numSkippedArgumentEvaluations = numArgumentEvaluations;
+
+		// The same statement without the skip, evaluating its arguments
+		DateTime::Timer eagerTimer(true);
+		for (size_t i = 0; i < numIterations; ++i)
+		{
+			sink = sink + i;
+			logger_impl::make_log_from_output(output, __FILE__, __LINE__, __FUNCTION__) << "Iteration " << i << ": " << argument(i) << Debug::end;
+		}
+		eagerTimer.stop();
+
+		const double baseline = baselineTimer.getElapsedTime();
+		auto perStatement = [&](DateTime::Timer const& timer) { return glm::max(timer.getElapsedTime() - baseline, 0.0) * 1e9 / double(glm::max(numIterations, size_t(1))); };
+		log_info() << "Disabled logging benchmark (" << numIterations << " statements):" << Debug::end;
+		log_info() << "  - compiled out: " << perStatement(compiledOutTimer) << " ns per statement" << Debug::end;
+		log_info() << "  - runtime level: " << perStatement(runtimeLevelTimer) << " ns per statement" << Debug::end;
+		log_info() << "  - disabled channel: " << perStatement(disabledTimer) << " ns per statement" << Debug::end;
+		log_info() << "  - disabled channel, arguments evaluated: " << perStatement(eagerTimer) << " ns per statement" << Debug::end;
+
+		// The skipped statements must not touch their arguments, and the runtime level must be evaluated once per statement
+		if (numSkippedArgumentEvaluations != 0 || numLevelEvaluations != numIterations)
+			log_error() << "Disabled log statements evaluated " << numSkippedArgumentEvaluations << " arguments and "
+				<< numLevelEvaluations << " levels for " << numIterations << " statements" << Debug::end;
+	}
+
 	///////////////////////////////////////////////////////
 	// Helper for finding the iterator to a device
 	auto findDevice(LogOutput const& log, std::reference_wrapper<Device> const& paramDevice)
@@ -624,6 +1047,9 @@ namespace Debug
 	////////////////////////////////////////////////////////////////////////////////
 	void enableLogDevice(bool enabled, LogOutput& outputRef, std::reference_wrapper<Device> const& paramDevice)
 	{
+		// The sink thread may be writing to the devices
+		std::lock_guard<std::mutex> lock(outputRef.m_mutex);
+
 		auto deviceRef = findDevice(outputRef, paramDevice);
 
 		if (enabled && deviceRef == outputRef.m_devices.end())
@@ -634,6 +1060,7 @@ namespace Debug
 		{
 			outputRef.m_devices.erase(deviceRef);
 		}
+		outputRef.m_numDevices = outputRef.m_devices.size();
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -731,34 +1158,34 @@ namespace Debug
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Is the param logger enabled for memory output. */
-	bool memoryLogEnabled(LogOutputRef const& output)
+	bool memoryLogEnabled(LogOutput const& output)
 	{
-		return Config::AttribValue("log_memory").contains(output.m_ref.get().m_name);
+		return Config::AttribValue("log_memory").contains(output.m_name);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Is the param logger enabled for console output. */
-	bool consoleLogEnabled(LogOutputRef const& output)
+	bool consoleLogEnabled(LogOutput const& output)
 	{
-		return Config::AttribValue("log_console").contains(output.m_ref.get().m_name);
+		return Config::AttribValue("log_console").contains(output.m_name);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Is the param logger enabled for file output. */
-	bool fileLogEnabled(LogOutputRef const& output)
+	bool fileLogEnabled(LogOutput const& output)
 	{
-		return Config::AttribValue("log_file").contains(output.m_ref.get().m_name);
+		return Config::AttribValue("log_file").contains(output.m_name);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	LogChannels defaultLogChannelsMemory()
 	{
 		LogChannels memoryChannels;
-		memoryChannels.m_debug = memoryLogEnabled(log_debug());
-		memoryChannels.m_trace = memoryLogEnabled(log_trace());
-		memoryChannels.m_info = memoryLogEnabled(log_info());
-		memoryChannels.m_warning = memoryLogEnabled(log_warning());
-		memoryChannels.m_error = memoryLogEnabled(log_error());
+		memoryChannels.m_debug = memoryLogEnabled(logger_impl::log_debug);
+		memoryChannels.m_trace = memoryLogEnabled(logger_impl::log_trace);
+		memoryChannels.m_info = memoryLogEnabled(logger_impl::log_info);
+		memoryChannels.m_warning = memoryLogEnabled(logger_impl::log_warning);
+		memoryChannels.m_error = memoryLogEnabled(logger_impl::log_error);
 		return memoryChannels;
 	}
 
@@ -766,11 +1193,11 @@ namespace Debug
 	LogChannels defaultLogChannelsConsole()
 	{
 		LogChannels stdoutChannels;
-		stdoutChannels.m_debug = consoleLogEnabled(log_debug());
-		stdoutChannels.m_trace = consoleLogEnabled(log_trace());
-		stdoutChannels.m_info = consoleLogEnabled(log_info());
-		stdoutChannels.m_warning = consoleLogEnabled(log_warning());
-		stdoutChannels.m_error = consoleLogEnabled(log_error());
+		stdoutChannels.m_debug = consoleLogEnabled(logger_impl::log_debug);
+		stdoutChannels.m_trace = consoleLogEnabled(logger_impl::log_trace);
+		stdoutChannels.m_info = consoleLogEnabled(logger_impl::log_info);
+		stdoutChannels.m_warning = consoleLogEnabled(logger_impl::log_warning);
+		stdoutChannels.m_error = consoleLogEnabled(logger_impl::log_error);
 		return stdoutChannels;
 	}
 
@@ -778,11 +1205,11 @@ namespace Debug
 	LogChannels defaultLogChannelsFile()
 	{
 		LogChannels fileChannels;
-		fileChannels.m_debug = fileLogEnabled(log_debug());
-		fileChannels.m_trace = fileLogEnabled(log_trace());
-		fileChannels.m_info = fileLogEnabled(log_info());
-		fileChannels.m_warning = fileLogEnabled(log_warning());
-		fileChannels.m_error = fileLogEnabled(log_error());
+		fileChannels.m_debug = fileLogEnabled(logger_impl::log_debug);
+		fileChannels.m_trace = fileLogEnabled(logger_impl::log_trace);
+		fileChannels.m_info = fileLogEnabled(logger_impl::log_info);
+		fileChannels.m_warning = fileLogEnabled(logger_impl::log_warning);
+		fileChannels.m_error = fileLogEnabled(logger_impl::log_error);
 		return fileChannels;
 	}
 
@@ -916,6 +1343,14 @@ namespace Debug
 			Config::attribRegexString()
 		});
 
+		// @CONSOLE_VAR(Log, Async, -log_async, 1, 0)
+		Config::registerConfigAttribute(Config::AttributeDescriptor{
+			"log_async", "Logging",
+			"Should the log lines be written out by a dedicated sink thread?",
+			"0|1", { "1" }, {},
+			Config::attribRegexBool()
+		});
+
 		// @CONSOLE_VAR(Log, File, -log_file, Debug, Trace, Info, Warning, Error)
 		Config::registerConfigAttribute(Config::AttributeDescriptor{
 			"log_file", "Logging",
@@ -17,6 +17,23 @@ namespace Debug
 	////////////////////////////////////////////////////////////////////////////////
 	meta_enum(DebugOutputLevel, int, Null, Debug, Trace, Info, Warning, Error);
 
+	////////////////////////////////////////////////////////////////////////////////
+	// Lowest log level compiled into the binary; messages below it are stripped out
+	#ifndef LOG_MIN_LEVEL
+		#if defined(CONFIG_RELEASE_FINAL)
+			#define LOG_MIN_LEVEL Info
+		#else
+			#define LOG_MIN_LEVEL Debug
+		#endif
+	#endif
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether messages of the parameter level are compiled in at all. */
+	constexpr bool isLevelCompiledIn(DebugOutputLevel level)
+	{
+		return level >= DebugOutputLevel::LOG_MIN_LEVEL;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** Forward declaration of the log output object. */
 	struct LogOutput;
@@ -130,6 +147,9 @@ namespace Debug
 
 		// Output devices
 		std::vector<std::reference_wrapper<Device>> m_devices;
+
+		// Number of output devices; checked before paying any formatting cost
+		std::atomic<size_t> m_numDevices;
 	
 		// Internals
 		bool m_newLine;
@@ -151,6 +171,96 @@ namespace Debug
 		LogMessageSource m_source;
 	};
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** A fully staged log line, handed over to the asynchronous log sink. */
+	struct LogRecord
+	{
+		// The log output that produced the line
+		LogOutput* m_log = nullptr;
+
+		// Source of the message
+		LogMessageSource m_source{ "", 0, "" };
+
+		// Raw line prefix data; formatted by the sink thread
+		time_t m_date = 0;
+		size_t m_threadId = 0;
+		std::string m_region;
+		bool m_hasPrefix = true;
+
+		// The message itself
+		std::string m_message;
+
+		// Whether the line ends in a new line or a carriage return
+		bool m_newLine = true;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Bounded, lock-free multi-producer single-consumer queue of log records. */
+	struct LogRecordQueue
+	{
+		LogRecordQueue(size_t capacity);
+
+		// Tries to enqueue a record; fails if the queue is full
+		bool tryPush(LogRecord& record);
+
+		// Tries to dequeue a record; must only be called from the consumer thread
+		bool tryPop(LogRecord& record);
+
+		// A single slot, with its sequence number
+		struct Cell
+		{
+			std::atomic<size_t> m_sequence;
+			LogRecord m_record;
+		};
+
+		// The record slots
+		std::unique_ptr<Cell[]> m_cells;
+
+		// Mask for the slot indices
+		size_t m_mask;
+
+		// Producer and consumer positions
+		alignas(64) std::atomic<size_t> m_enqueuePos;
+		alignas(64) size_t m_dequeuePos;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether the asynchronous logging backend is in use. */
+	bool asyncLogging();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether the asynchronous logging backend should be used by default. */
+	bool defaultAsyncLogging();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Switches between synchronous and asynchronous logging. */
+	void setAsyncLogging(bool enabled);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Waits until every log line submitted so far is written out. */
+	void flushLogs();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Logs from many threads at once into a private log with both backends, and reports
+	    the throughput and the per-call latency percentiles. */
+	void benchmarkLogging(size_t numThreads = 32, size_t numLinesPerThread = 4096);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Measures the per-statement cost of disabled log statements in a tight loop, and checks
+	    that their arguments and runtime levels are evaluated as expected. */
+	void benchmarkDisabledLogging(size_t numIterations = 1 << 22);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** The calling thread's message staging stream, used by the asynchronous backend. */
+	std::ostream& stagingStream();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether the parameter log has any output devices attached. */
+	inline bool isEnabled(LogOutput const& log)
+	{
+		return log.m_numDevices.load(std::memory_order_relaxed) > 0;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/**  Writes out a log line prefix */
 	LogOutput& putLinePrefix(LogOutput& log, bool newLine = true);
@@ -168,6 +278,12 @@ namespace Debug
 	template<typename T>
 	LogOutput& putMessage(LogOutput& log, T const& val)
 	{
+		if (asyncLogging())
+		{
+			if (isEnabled(log)) stagingStream() << val;
+			return log;
+		}
+
 		for (auto device : log.m_devices) 
 			device.get().m_stream.get() << val;
 		return log;
@@ -178,6 +294,8 @@ namespace Debug
 	template<typename T, typename std::enable_if<std::is_string<T>::value, int>::type = 0>
 	LogOutput& operator<< (LogOutput& log, T const& val)
 	{
+		if (!isEnabled(log)) return log;
+
 		std::string line = std::string(val);
 		std::stringstream ss(line);
 		for (int lineNo = 0; std::getline(ss, line); ++lineNo)
@@ -210,6 +328,8 @@ namespace Debug
 	template<typename T, typename std::enable_if<!std::is_string<T>::value && !std::is_iomanip<T>::value && !std::is_same<T, LogMessageSource>::value, int>::type = 0>
 	LogOutput& operator<< (LogOutput& log, T const& val)
 	{
+		if (!isEnabled(log)) return log;
+
 		return log << std::to_string(val);
 	}
 
@@ -373,17 +493,73 @@ namespace Debug
 		LogOutputRef make_log_info(const char* file, int line, const char* function);
 		LogOutputRef make_log_warning(const char* file, int line, const char* function);
 		LogOutputRef make_log_error(const char* file, int line, const char* function);
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Whether the parameter log has any devices attached; performs the on-demand init. */
+		bool is_log_active(LogOutput& output);
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Whether a message for the parameter log can be skipped, without evaluating any of its arguments. */
+		template<DebugOutputLevel Level>
+		bool is_log_skipped(LogOutput& output)
+		{
+			constexpr bool compiledIn = isLevelCompiledIn(Level);
+			return !compiledIn || !is_log_active(output);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Whether a message for the parameter (runtime) log level can be skipped. */
+		inline bool is_log_skipped(DebugOutputLevel level)
+		{
+			return !isLevelCompiledIn(level) || !is_log_active(make_log_output_from_level(level));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Level of the runtime-level log statement currently being evaluated on this thread. */
+		inline thread_local DebugOutputLevel s_statementLevel = DebugOutputLevel::Null;
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Stores the level of a runtime-level log statement and returns whether it can be skipped,
+		    so the level expression is only evaluated once per statement. */
+		inline bool bind_log_level(DebugOutputLevel level)
+		{
+			s_statementLevel = level;
+			return is_log_skipped(level);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Creates the log reference for the level stored by bind_log_level. */
+		inline LogOutputRef make_log_from_bound_level(const char* file, int line, const char* function)
+		{
+			return make_log_from_level(s_statementLevel, file, line, function);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Turns a full log statement into a void expression, so it can sit in the branch of a conditional. */
+		struct LogStatement
+		{
+			void operator&(LogOutput&) const {}
+			void operator&(LogOutputRef const&) const {}
+		};
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	// Log output constructors
-	#define log_output(OUTPUT) logger_impl::make_log_from_level(OUTPUT, __FILE__, __LINE__, __FUNCTION__)
-	#define log_null() logger_impl::make_log_null(__FILE__, __LINE__, __FUNCTION__)
-	#define log_debug() logger_impl::make_log_debug(__FILE__, __LINE__, __FUNCTION__)
-	#define log_trace() logger_impl::make_log_trace(__FILE__, __LINE__, __FUNCTION__)
-	#define log_info() logger_impl::make_log_info(__FILE__, __LINE__, __FUNCTION__)
-	#define log_warning() logger_impl::make_log_warning(__FILE__, __LINE__, __FUNCTION__)
-	#define log_error() logger_impl::make_log_error(__FILE__, __LINE__, __FUNCTION__)
+	//
+	// Each of these expands to 'skipped ? (void)0 : LogStatement() & make_log(...) << ...'; since the 
+	// conditional operator binds looser than '<<', a disabled level or channel skips the entire statement, 
+	// including the evaluation of the streamed arguments, and levels below LOG_MIN_LEVEL fold away entirely.
+	// Consequently, these can only be used as full statements.
+	#define LOG_STATEMENT_IMPL(SKIPPED, MAKE_LOG) SKIPPED ? (void)0 : ::Debug::logger_impl::LogStatement() & ::Debug::logger_impl::MAKE_LOG
+	#define LOG_STATEMENT(LEVEL, OUTPUT, MAKE_LOG) LOG_STATEMENT_IMPL(logger_impl::is_log_skipped<::Debug::DebugOutputLevel::LEVEL>(::Debug::logger_impl::OUTPUT), MAKE_LOG(__FILE__, __LINE__, __FUNCTION__))
+
+	#define log_output(OUTPUT) LOG_STATEMENT_IMPL(logger_impl::bind_log_level((OUTPUT)), make_log_from_bound_level(__FILE__, __LINE__, __FUNCTION__))
+	#define log_null() LOG_STATEMENT(Null, log_null, make_log_null)
+	#define log_debug() LOG_STATEMENT(Debug, log_debug, make_log_debug)
+	#define log_trace() LOG_STATEMENT(Trace, log_trace, make_log_trace)
+	#define log_info() LOG_STATEMENT(Info, log_info, make_log_info)
+	#define log_warning() LOG_STATEMENT(Warning, log_warning, make_log_warning)
+	#define log_error() LOG_STATEMENT(Error, log_error, make_log_error)
 
 	////////////////////////////////////////////////////////////////////////////////
 	// Which channels to log into for a specific log target
@@ -3,6 +3,11 @@
 #include "Config.h"
 #include "Debug.h"
 #include "StaticInitializer.h"
+#include "DateTime.h"
+#include "Units.h"
+
+#include <immintrin.h>
+#include <random>
 
 namespace GPU
 {
@@ -880,14 +885,14 @@ namespace GPU
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	Debug::LogOutputRef makeGLLogOutput(GLenum severity)
+	Debug::DebugOutputLevel glLogOutputLevel(GLenum severity)
 	{
-		if      (severity == GL_DEBUG_SEVERITY_HIGH         && glDebugConfig() > 0)   return Debug::log_error();
-		else if (severity == GL_DEBUG_SEVERITY_MEDIUM       && glDebugConfig() > 1)   return Debug::log_warning();
-		else if (severity == GL_DEBUG_SEVERITY_LOW          && glDebugConfig() > 2)   return Debug::log_info();
-		else if (severity == GL_DEBUG_SEVERITY_NOTIFICATION && glDebugConfig() > 3)   return Debug::log_debug();
+		if      (severity == GL_DEBUG_SEVERITY_HIGH         && glDebugConfig() > 0)   return Debug::Error;
+		else if (severity == GL_DEBUG_SEVERITY_MEDIUM       && glDebugConfig() > 1)   return Debug::Warning;
+		else if (severity == GL_DEBUG_SEVERITY_LOW          && glDebugConfig() > 2)   return Debug::Info;
+		else if (severity == GL_DEBUG_SEVERITY_NOTIFICATION && glDebugConfig() > 3)   return Debug::Debug;
 
-		return Debug::log_null();
+		return Debug::Null;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -896,7 +901,7 @@ namespace GPU
 		if (shouldLogGLMessage(severity))
 		{
 			Debug::DebugRegion region({ "OpenGL", logMessageSource(source), logTypeName(type), logIdName(id) });
-			makeGLLogOutput(severity) << message << Debug::end;
+			Debug::log_output(glLogOutputLevel(severity)) << message << Debug::end;
 		}
 	}
 
@@ -1375,4 +1380,285 @@ namespace GPU
 		// Process the capability attributes
 		queryGpuCapabilites();
 	}
-}
\ No newline at end of file
+
+	////////////////////////////////////////////////////////////////////////////////
+	void packColumns(void* destination, size_t stride, size_t offset, std::array<float const*, 4> const& columns, size_t count)
+	{
+		uint8_t* out = static_cast<uint8_t*>(destination) + offset;
+
+		// Missing columns are filled with zeros
+		const __m256 zero = _mm256_setzero_ps();
+		auto loadColumn = [&](float const* column, size_t i) { return column ? _mm256_loadu_ps(column + i) : zero; };
+
+		// Eight records at a time
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 x = loadColumn(columns[0], i);
+			const __m256 y = loadColumn(columns[1], i);
+			const __m256 z = loadColumn(columns[2], i);
+			const __m256 w = loadColumn(columns[3], i);
+
+			// Transpose the 4x8 block; each 128-bit lane of the results holds one record
+			const __m256 xy01 = _mm256_unpacklo_ps(x, y); // x0 y0 x1 y1 | x4 y4 x5 y5
+			const __m256 xy23 = _mm256_unpackhi_ps(x, y); // x2 y2 x3 y3 | x6 y6 x7 y7
+			const __m256 zw01 = _mm256_unpacklo_ps(z, w);
+			const __m256 zw23 = _mm256_unpackhi_ps(z, w);
+			const __m256 r04 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 r15 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 r26 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 r37 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+
+			uint8_t* block = out + i * stride;
+
+			// Tightly packed vec4 arrays are written with full-width stores
+			if (stride == sizeof(glm::vec4))
+			{
+				float* records = reinterpret_cast<float*>(block);
+				_mm256_storeu_ps(records + 0, _mm256_permute2f128_ps(r04, r15, 0x20));
+				_mm256_storeu_ps(records + 8, _mm256_permute2f128_ps(r26, r37, 0x20));
+				_mm256_storeu_ps(records + 16, _mm256_permute2f128_ps(r04, r15, 0x31));
+				_mm256_storeu_ps(records + 24, _mm256_permute2f128_ps(r26, r37, 0x31));
+			}
+
+			// Otherwise write one record at a time
+			else
+			{
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 0 * stride), _mm256_castps256_ps128(r04));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 1 * stride), _mm256_castps256_ps128(r15));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 2 * stride), _mm256_castps256_ps128(r26));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 3 * stride), _mm256_castps256_ps128(r37));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 4 * stride), _mm256_extractf128_ps(r04, 1));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 5 * stride), _mm256_extractf128_ps(r15, 1));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 6 * stride), _mm256_extractf128_ps(r26, 1));
+				_mm_storeu_ps(reinterpret_cast<float*>(block + 7 * stride), _mm256_extractf128_ps(r37, 1));
+			}
+		}
+
+		// Remaining records
+		for (; i < count; ++i)
+		{
+			float* record = reinterpret_cast<float*>(out + i * stride);
+			for (size_t c = 0; c < 4; ++c)
+				record[c] = columns[c] ? columns[c][i] : 0.0f;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Layout rule tests; offsets and sizes follow the examples of the GL specification
+	////////////////////////////////////////////////////////////////////////////////
+
+	make_gpu_struct(LayoutTestStd140, std140,
+		(float, m_a)(glm::vec3, m_b)(float, m_c)(glm::vec2, m_d)(float[3], m_e)(glm::mat4, m_f)(float, m_g)
+	);
+	make_gpu_struct(LayoutTestStd430, std430,
+		(float, m_a)(glm::vec3, m_b)(float, m_c)(glm::vec2, m_d)(float[3], m_e)(glm::mat4, m_f)(float, m_g)
+	);
+
+	// The expected offsets are computed by hand, so they do not depend on the layout helpers
+	static_assert(offsetof(LayoutTestStd140, m_b) == 16 && offsetof(LayoutTestStd430, m_b) == 16, "vec3 must be aligned to a vec4.");
+	static_assert(offsetof(LayoutTestStd140, m_c) == 28 && offsetof(LayoutTestStd430, m_c) == 28, "Scalars must pack into the tail of a vec3.");
+	static_assert(offsetof(LayoutTestStd140, m_d) == 32 && offsetof(LayoutTestStd430, m_d) == 32, "vec2 must be aligned to 8 bytes.");
+	static_assert(offsetof(LayoutTestStd140, m_e) == 48 && offsetof(LayoutTestStd430, m_e) == 40, "Unexpected scalar array alignment.");
+	static_assert(offsetof(LayoutTestStd140, m_f) == 96 && offsetof(LayoutTestStd430, m_f) == 64, "Unexpected scalar array stride.");
+	static_assert(offsetof(LayoutTestStd140, m_g) == 160 && offsetof(LayoutTestStd430, m_g) == 128, "Unexpected matrix size.");
+	static_assert(sizeof(LayoutTestStd140) == 176 && sizeof(LayoutTestStd430) == 144, "Struct sizes must be padded to the struct alignment.");
+
+	make_gpu_struct(LayoutTestVectorArraysStd140, std140,
+		(float, m_a)(glm::vec2[2], m_b)(glm::vec3[2], m_c)(float, m_d)
+	);
+	make_gpu_struct(LayoutTestVectorArraysStd430, std430,
+		(float, m_a)(glm::vec2[2], m_b)(glm::vec3[2], m_c)(float, m_d)
+	);
+
+	// Vector arrays are strided by a vec4 in std140, and by their own alignment in std430
+	static_assert(offsetof(LayoutTestVectorArraysStd140, m_b) == 16 && offsetof(LayoutTestVectorArraysStd430, m_b) == 8, "Unexpected vec2 array alignment.");
+	static_assert(offsetof(LayoutTestVectorArraysStd140, m_c) == 48 && offsetof(LayoutTestVectorArraysStd430, m_c) == 32, "Unexpected vec2 array stride.");
+	static_assert(offsetof(LayoutTestVectorArraysStd140, m_d) == 80 && offsetof(LayoutTestVectorArraysStd430, m_d) == 64, "Unexpected vec3 array stride.");
+	static_assert(sizeof(LayoutTestVectorArraysStd140) == 96 && sizeof(LayoutTestVectorArraysStd430) == 80, "Unexpected vector array struct size.");
+
+	make_gpu_struct(LayoutTestInnerStd140, std140, (float, m_x));
+	make_gpu_struct(LayoutTestOuterStd140, std140, (float, m_a)(LayoutTestInnerStd140, m_b)(float, m_c));
+	make_gpu_struct(LayoutTestInnerStd430, std430, (float, m_x));
+	make_gpu_struct(LayoutTestOuterStd430, std430, (float, m_a)(LayoutTestInnerStd430, m_b)(float, m_c));
+
+	// Nested structs are aligned to a vec4 in std140 only
+	static_assert(sizeof(LayoutTestInnerStd140) == 16 && sizeof(LayoutTestInnerStd430) == 4, "Unexpected nested struct size.");
+	static_assert(offsetof(LayoutTestOuterStd140, m_b) == 16 && offsetof(LayoutTestOuterStd140, m_c) == 32, "Unexpected std140 nested struct layout.");
+	static_assert(offsetof(LayoutTestOuterStd430, m_b) == 4 && offsetof(LayoutTestOuterStd430, m_c) == 8, "Unexpected std430 nested struct layout.");
+
+	// Record of the packing tests, similar to the light records
+	make_gpu_struct(LayoutTestLight, std430,
+		(glm::vec3, m_position)(float, m_radius)(glm::vec3, m_color)(GLuint, m_flags)
+	);
+	static_assert(sizeof(LayoutTestLight) == 32 && arrayStride<LayoutTestLight>() == 32, "Unexpected light record layout.");
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** CPU-side light, in the order the packing tests read it. */
+	struct LayoutTestSource
+	{
+		glm::vec3 m_position;
+		glm::vec3 m_color;
+		float m_radius;
+		GLuint m_flags;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::vector<LayoutTestSource> generateLayoutTestSources(size_t count, uint32_t seed)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+		std::vector<LayoutTestSource> result(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			result[i].m_position = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+			result[i].m_color = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+			result[i].m_radius = distribution(generator);
+			result[i].m_flags = GLuint(i);
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void packLayoutTestLight(LayoutTestLight& record, LayoutTestSource const& source)
+	{
+		record.m_position = source.m_position;
+		record.m_radius = source.m_radius;
+		record.m_color = source.m_color;
+		record.m_flags = source.m_flags;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validateLayouts()
+	{
+		bool passed = true;
+		auto check = [&](bool condition, std::string const& name)
+		{
+			if (!condition) Debug::log_error() << "Layout check failed: " << name << Debug::end;
+			passed = passed && condition;
+		};
+
+		// Struct packer, against records written member by member at the offsets of the metadata
+		const std::vector<LayoutTestSource> sources = generateLayoutTestSources(37, 0);
+		std::vector<uint8_t> packed(sources.size() * arrayStride<LayoutTestLight>(), 0xCD);
+		std::vector<uint8_t> reference(packed.size(), 0);
+		const size_t bytesWritten = packArray<LayoutTestLight>(packed.data(), sources.data(), sources.size(), packLayoutTestLight);
+		for (size_t i = 0; i < sources.size(); ++i)
+		{
+			uint8_t* record = reference.data() + i * arrayStride<LayoutTestLight>();
+			std::memcpy(record + LayoutTestLight_meta.members[0].offset, &sources[i].m_position, sizeof(glm::vec3));
+			std::memcpy(record + LayoutTestLight_meta.members[1].offset, &sources[i].m_radius, sizeof(float));
+			std::memcpy(record + LayoutTestLight_meta.members[2].offset, &sources[i].m_color, sizeof(glm::vec3));
+			std::memcpy(record + LayoutTestLight_meta.members[3].offset, &sources[i].m_flags, sizeof(GLuint));
+		}
+		check(bytesWritten == packed.size(), "packArray size");
+		check(packed == reference, "packArray contents");
+
+		// Copying packed records
+		std::vector<uint8_t> copied(packed.size(), 0xCD);
+		packArray(copied.data(), reinterpret_cast<LayoutTestLight const*>(packed.data()), sources.size());
+		check(copied == packed, "packArray copy");
+
+		// Column interleaving, against a scalar reference; the bytes outside the slots must be left untouched
+		std::mt19937 generator(1);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		for (size_t count : { 0, 1, 7, 8, 9, 31, 100 })
+		for (size_t stride : { 16, 32, 48 })
+		for (size_t offset : { 0, 16 })
+		{
+			if (offset + sizeof(glm::vec4) > stride) continue;
+
+			std::vector<std::vector<float>> columns(4, std::vector<float>(count));
+			for (auto& column : columns)
+				for (auto& value : column)
+					value = distribution(generator);
+
+			// Leave out the last column, to test the zero fill
+			const std::array<float const*, 4> columnPtrs = { columns[0].data(), columns[1].data(), columns[2].data(), nullptr };
+
+			std::vector<uint8_t> result(count * stride + 16, 0xCD);
+			std::vector<uint8_t> expected(result);
+			packColumns(result.data(), stride, offset, columnPtrs, count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float values[4] = { columns[0][i], columns[1][i], columns[2][i], 0.0f };
+				std::memcpy(expected.data() + i * stride + offset, values, sizeof(values));
+			}
+			check(result == expected, "packColumns (count: " + std::to_string(count) + ", stride: " + std::to_string(stride) + ", offset: " + std::to_string(offset) + ")");
+		}
+
+		Debug::log_info() << "GPU layout validation " << (passed ? "passed" : "FAILED") << Debug::end;
+		return passed;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkPacking(size_t numElements, size_t numIterations)
+	{
+		const std::vector<LayoutTestSource> sources = generateLayoutTestSources(numElements, 0);
+		const size_t numBytes = numElements * arrayStride<LayoutTestLight>();
+
+		// Stand-in for a mapped buffer region
+		std::vector<uint8_t> destination(numBytes);
+
+		// Building an intermediate vector, then copying it
+		std::vector<LayoutTestLight> intermediate;
+		DateTime::Timer vectorTimer(true);
+		for (size_t iteration = 0; iteration < numIterations; ++iteration)
+		{
+			intermediate.resize(numElements);
+			for (size_t i = 0; i < numElements; ++i)
+				packLayoutTestLight(intermediate[i], sources[i]);
+			packArray(destination.data(), intermediate.data(), numElements);
+			intermediate.clear();
+			intermediate.shrink_to_fit();
+		}
+		vectorTimer.stop();
+
+		// Packing straight into the destination
+		DateTime::Timer directTimer(true);
+		for (size_t iteration = 0; iteration < numIterations; ++iteration)
+			packArray<LayoutTestLight>(destination.data(), sources.data(), numElements, packLayoutTestLight);
+		directTimer.stop();
+
+		// Interleaving columns
+		std::vector<float> positionX(numElements), positionY(numElements), positionZ(numElements), radius(numElements);
+		for (size_t i = 0; i < numElements; ++i)
+		{
+			positionX[i] = sources[i].m_position.x;
+			positionY[i] = sources[i].m_position.y;
+			positionZ[i] = sources[i].m_position.z;
+			radius[i] = sources[i].m_radius;
+		}
+		const std::array<float const*, 4> columns = { positionX.data(), positionY.data(), positionZ.data(), radius.data() };
+
+		DateTime::Timer scalarTimer(true);
+		for (size_t iteration = 0; iteration < numIterations; ++iteration)
+		{
+			for (size_t i = 0; i < numElements; ++i)
+			{
+				LayoutTestLight& record = reinterpret_cast<LayoutTestLight*>(destination.data())[i];
+				record.m_position = glm::vec3(positionX[i], positionY[i], positionZ[i]);
+				record.m_radius = radius[i];
+			}
+		}
+		scalarTimer.stop();
+
+		DateTime::Timer columnTimer(true);
+		for (size_t iteration = 0; iteration < numIterations; ++iteration)
+			packColumns(destination.data(), arrayStride<LayoutTestLight>(), 0, columns, numElements);
+		columnTimer.stop();
+
+		auto report = [&](std::string const& name, DateTime::Timer& timer, size_t bytesPerIteration)
+		{
+			const double seconds = timer.getElapsedTime() / double(numIterations);
+			Debug::log_info() << "  - " << name << ": " << seconds * 1000.0 << " ms per upload, "
+				<< double(bytesPerIteration) / seconds / (1024.0 * 1024.0 * 1024.0) << " GiB/s" << Debug::end;
+		};
+
+		Debug::log_info() << "GPU packing benchmark (" << numElements << " records, " << Units::bytesToString(numBytes) << "):" << Debug::end;
+		report("intermediate vector", vectorTimer, numBytes);
+		report("direct packing", directTimer, numBytes);
+		report("scalar column interleave", scalarTimer, numElements * sizeof(glm::vec4));
+		report("AVX column interleave", columnTimer, numElements * sizeof(glm::vec4));
+	}
+}
@@ -35,7 +35,8 @@ namespace GPU
 		UNIFORM_BUFFER_GENERIC_13 = 14,
 		UNIFORM_BUFFER_GENERIC_14 = 15,
 		UNIFORM_BUFFER_GENERIC_15 = 16,
-		UNIFORM_BUFFER_GENERIC_16 = 17
+		UNIFORM_BUFFER_GENERIC_16 = 17,
+		UNIFORM_BUFFER_MATERIALS = 18
 	);
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -162,10 +163,11 @@ namespace GPU
 		size_t index = {};
 		size_t alignment = {};
 		size_t size = {};
+		size_t offset = {};
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
-	template<typename StructTypeIn, size_t size>
+	template<typename StructTypeIn, size_t NumMembers>
 	struct GpuStruct
 	{
 		using StructType = StructTypeIn;
@@ -173,7 +175,8 @@ namespace GPU
 		std::string_view name;
 		GpuStructLayout layout = GpuStructLayout::std140;
 		size_t alignment = {};
-		std::array<GpuStructMember<StructType>, size> members = {};
+		size_t size = {};
+		std::array<GpuStructMember<StructType>, NumMembers> members = {};
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -207,6 +210,11 @@ namespace GPU
 			return std::min(((s + sv4 - 1) / sv4) * sv4, sv4);
 		}
 
+		constexpr size_t roundUp(size_t s, size_t alignment)
+		{
+			return ((s + alignment - 1) / alignment) * alignment;
+		}
+
 		template<typename T, size_t Alignment>
 		struct alignas(Alignment) AlignedArrElement
 		{
@@ -257,13 +265,23 @@ namespace GPU
 		LAYOUT_INFO_std140_VECTOR(std140, glm::tvec3, glm::tvec4);
 		LAYOUT_INFO_std140_VECTOR(std140, glm::tvec4, glm::tvec4);
 
-		// Arrays
+		// Aligned vector array element types; the stride is rounded up to a vec4, like for the scalar arrays
+		#define STRUCT_TYPE_std140_VECTOR_ARRAY(L, T) \
+			template<typename V, size_t s> struct StructType<L, T<V>[s], void> : \
+				public StructTypeBase<std::array<AlignedArrElement<T<V>, roundUp(LayoutInfo<L, T<V>>::alignment, sizeof(glm::vec4))>, s>> {}
+
+		STRUCT_TYPE_std140_VECTOR_ARRAY(std140, glm::tvec1);
+		STRUCT_TYPE_std140_VECTOR_ARRAY(std140, glm::tvec2);
+		STRUCT_TYPE_std140_VECTOR_ARRAY(std140, glm::tvec3);
+		STRUCT_TYPE_std140_VECTOR_ARRAY(std140, glm::tvec4);
+
+		// Arrays; the stride of every array is rounded up to a vec4
 		template<typename T, size_t s> struct LayoutInfo<std140, T[s], void> :
-			public LayoutInfoBase<roundToVec4(LayoutInfo<std140, T>::alignment), roundToVec4(sizeof(T))* s> {};
+			public LayoutInfoBase<roundUp(LayoutInfo<std140, T>::alignment, sizeof(glm::vec4)), roundUp(sizeof(T), sizeof(glm::vec4)) * s> {};
 
-		// Matrices
+		// Matrices, stored as arrays of column vectors
 		#define LAYOUT_INFO_std140_MATRIX(L, T, A, C, R) \
-			template<typename V> struct LayoutInfo<L, T<V>, void> : public LayoutInfo<L, BOOST_PP_CAT(glm::tvec, C)<V>[R]> {}
+			template<typename V> struct LayoutInfo<L, T<V>, void> : public LayoutInfo<L, BOOST_PP_CAT(glm::tvec, R)<V>[C]> {}
 
 		LAYOUT_INFO_std140_MATRIX(std140, glm::tmat2x2, glm::tmat2x2, 2, 2);
 		LAYOUT_INFO_std140_MATRIX(std140, glm::tmat2x3, glm::tmat2x3, 2, 3);
@@ -275,6 +293,79 @@ namespace GPU
 		LAYOUT_INFO_std140_MATRIX(std140, glm::tmat4x3, glm::tmat4x3, 4, 3);
 		LAYOUT_INFO_std140_MATRIX(std140, glm::tmat4x4, glm::tmat4x4, 4, 4);
 
+		////////////////////////////////////////////////////////////////////////////////
+		// Layout info for std430
+		////////////////////////////////////////////////////////////////////////////////
+
+		// Aligned array element type; only vec3 elements need padding
+		template<typename T, size_t s> struct StructType<std430, T[s], typename std::enable_if<!std::is_base_of<GpuStructTag, T>::value, void>::type> :
+			public StructTypeBase<std::array<AlignedArrElement<T, LayoutInfo<std430, T>::alignment>, s>> {};
+
+		template<typename T, size_t s> struct StructType<std430, T[s], typename std::enable_if<std::is_base_of<GpuStructTag, T>::value, void>::type> :
+			public StructTypeBase<std::array<T, s>> {};
+
+		// Structs
+		template<typename T> struct LayoutInfo<std430, T, typename std::enable_if<std::is_base_of<GpuStructTag, T>::value, void>::type> :
+			public LayoutInfoBase<T::_Alignment, sizeof(T)> {};
+
+		// Scalars
+		template<typename T>
+		struct LayoutInfo<std430, T, typename std::enable_if<std::is_fundamental<T>::value, void>::type> : public LayoutInfoBase<sizeof(T), sizeof(T)> {};
+
+		// Vectors; same as std140
+		LAYOUT_INFO_std140_VECTOR(std430, glm::tvec1, glm::tvec1);
+		LAYOUT_INFO_std140_VECTOR(std430, glm::tvec2, glm::tvec2);
+		LAYOUT_INFO_std140_VECTOR(std430, glm::tvec3, glm::tvec4);
+		LAYOUT_INFO_std140_VECTOR(std430, glm::tvec4, glm::tvec4);
+
+		// Arrays; the stride is the element size, rounded up to the element alignment
+		template<typename T, size_t s> struct LayoutInfo<std430, T[s], void> :
+			public LayoutInfoBase<LayoutInfo<std430, T>::alignment, roundUp(sizeof(T), LayoutInfo<std430, T>::alignment) * s> {};
+
+		// Matrices, stored as arrays of column vectors
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat2x2, glm::tmat2x2, 2, 2);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat2x3, glm::tmat2x3, 2, 3);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat2x4, glm::tmat2x4, 2, 4);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat3x2, glm::tmat3x2, 3, 2);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat3x3, glm::tmat3x3, 3, 3);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat3x4, glm::tmat3x4, 3, 4);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat4x2, glm::tmat4x2, 4, 2);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat4x3, glm::tmat4x3, 4, 3);
+		LAYOUT_INFO_std140_MATRIX(std430, glm::tmat4x4, glm::tmat4x4, 4, 4);
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Layout computation
+		////////////////////////////////////////////////////////////////////////////////
+
+		// Base alignment of a struct; std140 rounds it up to a vec4
+		constexpr size_t structAlignment(GpuStructLayout layout, size_t memberAlignment)
+		{
+			return layout == std140 ? roundUp(memberAlignment, sizeof(glm::vec4)) : memberAlignment;
+		}
+
+		// Offsets of the members, each one placed at the next multiple of its alignment
+		template<size_t N>
+		constexpr std::array<size_t, N> computeOffsets(std::array<size_t, N> const& alignments, std::array<size_t, N> const& sizes)
+		{
+			std::array<size_t, N> result = {};
+			size_t offset = 0;
+			for (size_t i = 0; i < N; ++i)
+			{
+				offset = roundUp(offset, alignments[i]);
+				result[i] = offset;
+				offset += sizes[i];
+			}
+			return result;
+		}
+
+		// Total size of the struct, padded to its alignment
+		template<size_t N>
+		constexpr size_t computeSize(std::array<size_t, N> const& alignments, std::array<size_t, N> const& sizes, size_t alignment)
+		{
+			const std::array<size_t, N> offsets = computeOffsets(alignments, sizes);
+			return roundUp(offsets[N - 1] + sizes[N - 1], alignment);
+		}
+
 		////////////////////////////////////////////////////////////////////////////////
 		// Metadata generation
 		////////////////////////////////////////////////////////////////////////////////
@@ -337,6 +428,9 @@ namespace GPU
 			result.name = name;
 			result.layout = layout;
 			result.alignment = StructType::_Alignment;
+			result.size = computeSize(alignments, sizes, result.alignment);
+
+			const std::array<size_t, size> offsets = computeOffsets(alignments, sizes);
 
 			std::array<std::string_view, size> memberStrings;
 			size_t amountFilled = 0;
@@ -362,6 +456,7 @@ namespace GPU
 				result.members[i].arr_size = arraySizes[i];
 				result.members[i].alignment = alignments[i];
 				result.members[i].size = sizes[i];
+				result.members[i].offset = offsets[i];
 
 				std::string_view memberString = memberStrings[i];
 
@@ -420,15 +515,20 @@ namespace GPU
 	#define __EXTRACT_SIZES(layout, members) { BOOST_PP_SEQ_FOR_EACH_I(__EXTRACT_SIZE, layout, members) }
 	#define __EXTRACT_ARRAY_SIZE(r, layout, i, member) BOOST_PP_COMMA_IF(i) __ARRAY_SIZE(__TYPE(member), __NAME(member))
 	#define __EXTRACT_ARRAY_SIZES(layout, members) { BOOST_PP_SEQ_FOR_EACH_I(__EXTRACT_ARRAY_SIZE, layout, members) }
+	#define __ASSERT_OFFSET(r, NAME, i, member) static_assert(offsetof(NAME, __NAME(member)) == BOOST_PP_CAT(NAME, _meta).members[i].offset, \
+		"Offset of " BOOST_PP_STRINGIZE(NAME) "::" BOOST_PP_STRINGIZE(__NAME(member)) " does not follow the layout rules.");
+	#define __ASSERT_OFFSETS(NAME, members) BOOST_PP_SEQ_FOR_EACH_I(__ASSERT_OFFSET, NAME, members)
 
 	////////////////////////////////////////////////////////////////////////////////
 	#define _make_struct_layout(layout) BOOST_PP_CAT(GPU::, layout)
-	#define _make_struct_alignment(layout, members) GPU::impl::parseAlignment(__EXTRACT_ALIGNMENTS(layout, members))
+	#define _make_struct_alignment(layout, members) GPU::impl::structAlignment(layout, GPU::impl::parseAlignment(__EXTRACT_ALIGNMENTS(layout, members)))
 	#define _make_struct_element_impl(type, name, layout) alignas(__LAYOUT_INFO(layout, type, name)::alignment) GPU::impl::StructType<layout, type>::member_type name;
 	#define _make_struct_element_cb(r, layout, member) _make_struct_element_impl(__TYPE(member), __NAME(member), layout)
 	#define _make_struct_elements(layout, members) BOOST_PP_SEQ_FOR_EACH(_make_struct_element_cb, layout, members)
 
 	////////////////////////////////////////////////////////////////////////////////
+	// Declares a struct following the parameter layout rules, along with its metadata;
+	// the offset of every member and the struct size are verified at compile time
 	#define make_gpu_struct(NAME, LAYOUT, ...) \
 		struct NAME : public GPU::impl::GpuStructBase<_make_struct_alignment(_make_struct_layout(LAYOUT), __INPUT_SEQ(__VA_ARGS__))> \
 		{ \
@@ -438,7 +538,61 @@ namespace GPU
         #NAME, #__VA_ARGS__, _make_struct_layout(LAYOUT), \
         __EXTRACT_ARRAY_SIZES(_make_struct_layout(LAYOUT), __INPUT_SEQ(__VA_ARGS__)), \
         __EXTRACT_ALIGNMENTS(_make_struct_layout(LAYOUT), __INPUT_SEQ(__VA_ARGS__)), \
-        __EXTRACT_SIZES(_make_struct_layout(LAYOUT), __INPUT_SEQ(__VA_ARGS__))) \
+        __EXTRACT_SIZES(_make_struct_layout(LAYOUT), __INPUT_SEQ(__VA_ARGS__))); \
+    __ASSERT_OFFSETS(NAME, __INPUT_SEQ(__VA_ARGS__)) \
+    static_assert(sizeof(NAME) == NAME##_meta.size, "Size of " #NAME " does not follow the layout rules.") \
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Array stride of the parameter GPU struct, which is its size padded to its alignment. */
+	template<typename T>
+	constexpr size_t arrayStride()
+	{
+		static_assert(std::is_base_of<impl::GpuStructTag, T>::value, "Only GPU structs have a known array stride.");
+		static_assert(sizeof(T) % T::_Alignment == 0, "GPU struct size must be a multiple of its alignment.");
+		return sizeof(T);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Copies already packed records to the destination, typically a mapped buffer region. Returns the number of bytes written. */
+	template<typename T>
+	size_t packArray(void* destination, T const* source, size_t count)
+	{
+		std::memcpy(destination, source, count * arrayStride<T>());
+		return count * arrayStride<T>();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Packs the source elements straight into the destination, without an intermediate array. Each record is filled in by
+		packer(record, element) on the stack, with zeroed padding, then written out with a single copy, so write-combined
+		mapped memory only sees sequential full-record writes. Returns the number of bytes written. */
+	template<typename T, typename S, typename Packer>
+	size_t packArray(void* destination, S const* source, size_t count, Packer&& packer)
+	{
+		uint8_t* out = static_cast<uint8_t*>(destination);
+		for (size_t i = 0; i < count; ++i, out += arrayStride<T>())
+		{
+			T record;
+			std::memset(static_cast<void*>(&record), 0, sizeof(T));
+			packer(record, source[i]);
+			std::memcpy(out, &record, sizeof(T));
+		}
+		return count * arrayStride<T>();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Interleaves up to four float columns into vec4 slots of an std430 array, as in a 'vec3 position; float radius;' pair.
+		Slot i starts at byte offset + i * stride of the destination; null columns are written as zeros. Transposes eight
+		records at a time with AVX. The stride and the offset must be multiples of sizeof(float). */
+	void packColumns(void* destination, size_t stride, size_t offset, std::array<float const*, 4> const& columns, size_t count);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the struct packers and the column interleaving against scalar references, and logs the results;
+		the layout rules themselves are verified at compile time. Returns whether all the checks passed. */
+	bool validateLayouts();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Measures the throughput of the struct packers and the column interleaving, and logs the results. */
+	void benchmarkPacking(size_t numElements = 1 << 20, size_t numIterations = 20);
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Represents a capability attribute. */
@@ -535,6 +689,9 @@ namespace GPU
 		/** Name of the submesh. */
 		std::string m_name;
 
+		/** Name of the submesh in the profiler, built once at load time. */
+		std::string m_profilerName;
+
 		// AABB of the submesh
 		BVH::AABB m_aabb;
 
@@ -19,6 +19,7 @@
 #include "Context.h"
 #include "BVH.h"
 #include "GPU.h"
+#include "UploadRing.h"
 
 #include "LibraryExtensions/StdEx.h"
 #include "LibraryExtensions/MatlabEx.h"
@@ -42,7 +42,7 @@ namespace Threading
 	template<typename Callback>
 	void invoke_for_threads(int threadId, int maxThreads, Callback const& callback)
 	{
-		for (int i = (threadId == numThreads() ? 0 : maxThreads); i < (threadId == numThreads() ? maxThreads : threadId + 1); ++i)
+		for (int i = (threadId == numThreads() ? 0 : threadId); i < (threadId == numThreads() ? maxThreads : std::min(threadId + 1, maxThreads)); ++i)
 			callback(i);
 	}
 
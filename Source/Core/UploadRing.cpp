@@ -0,0 +1,565 @@
+#include "PCH.h"
+#include "UploadRing.h"
+
+#include <random>
+
+namespace UploadRing
+{
+	////////////////////////////////////////////////////////////////////////////////
+	size_t alignUp(size_t offset, size_t alignment)
+	{
+		return ((offset + alignment - 1) / alignment) * alignment;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool initialize(Ring& ring, Backend const& backend, size_t capacity, size_t maxCapacity, size_t maxFramesInFlight)
+	{
+		void* memory = nullptr;
+		const StorageHandle storage = backend.m_createStorage(capacity, &memory);
+		if (storage == 0 || memory == nullptr)
+		{
+			Debug::log_error() << "Unable to create the upload ring backing store of size " << capacity << Debug::end;
+			return false;
+		}
+
+		ring = Ring{};
+		ring.m_backend = backend;
+		ring.m_storage = storage;
+		ring.m_memory = static_cast<uint8_t*>(memory);
+		ring.m_capacity = capacity;
+		ring.m_maxCapacity = std::max(capacity, maxCapacity);
+		ring.m_maxFramesInFlight = std::max(maxFramesInFlight, size_t(1));
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void release(Ring& ring)
+	{
+		if (ring.m_memory == nullptr) return;
+
+		// Fence the current frame too, its commands may still reference the ring
+		endFrame(ring);
+		while (!ring.m_frames.empty())
+			retireFrames(ring, true);
+
+		ring.m_backend.m_releaseStorage(ring.m_storage);
+		ring = Ring{};
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	size_t retireFrames(Ring& ring, bool waitForOldest)
+	{
+		size_t numRetired = 0;
+		while (!ring.m_frames.empty())
+		{
+			FrameRecord const& frame = ring.m_frames.front();
+			if (!ring.m_backend.m_queryFence(frame.m_fence, waitForOldest && numRetired == 0))
+				break;
+
+			ring.m_backend.m_deleteFence(frame.m_fence);
+			ring.m_usedBytes -= frame.m_numBytes;
+			ring.m_numCompletedFrames = frame.m_frameId + 1;
+			ring.m_frames.pop_front();
+			++numRetired;
+		}
+
+		// Release the replaced backing stores whose last frame completed
+		for (size_t i = 0; i < ring.m_retiredStorages.size();)
+		{
+			if (ring.m_numCompletedFrames > ring.m_retiredStorages[i].m_lastFrameId)
+			{
+				ring.m_backend.m_releaseStorage(ring.m_retiredStorages[i].m_storage);
+				ring.m_retiredStorages.erase(ring.m_retiredStorages.begin() + i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+
+		// Restart from the beginning once the ring is empty, to avoid needless wrap-arounds
+		if (ring.m_usedBytes == 0)
+			ring.m_head = 0;
+
+		return numRetired;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void beginFrame(Ring& ring)
+	{
+		if (ring.m_memory == nullptr) return;
+
+		// Don't let the CPU run too far ahead of the GPU
+		while (ring.m_frames.size() >= ring.m_maxFramesInFlight)
+		{
+			if (!ring.m_backend.m_queryFence(ring.m_frames.front().m_fence, false))
+				++ring.m_statistics.m_numPacingWaits;
+			retireFrames(ring, true);
+		}
+
+		retireFrames(ring, false);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void endFrame(Ring& ring)
+	{
+		if (ring.m_memory == nullptr) return;
+
+		FrameRecord frame;
+		frame.m_fence = ring.m_backend.m_insertFence();
+		frame.m_frameId = ring.m_frameId;
+		frame.m_numBytes = ring.m_frameBytes;
+		ring.m_frames.push_back(frame);
+
+		ring.m_frameBytes = 0;
+		++ring.m_frameId;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool grow(Ring& ring, size_t minCapacity)
+	{
+		const size_t newCapacity = std::min(std::max(ring.m_capacity * 2, minCapacity), ring.m_maxCapacity);
+		if (newCapacity <= ring.m_capacity)
+			return false;
+
+		void* memory = nullptr;
+		const StorageHandle storage = ring.m_backend.m_createStorage(newCapacity, &memory);
+		if (storage == 0 || memory == nullptr)
+			return false;
+
+		Debug::log_debug() << "Growing the upload ring from " << ring.m_capacity << " to " << newCapacity << " bytes" << Debug::end;
+
+		// The old store is still referenced by the frames in flight and the current frame
+		RetiredStorage retired;
+		retired.m_storage = ring.m_storage;
+		retired.m_lastFrameId = ring.m_frameId;
+		ring.m_retiredStorages.push_back(retired);
+
+		// The bytes of the frames in flight belong to the old store from now on
+		for (auto& frame : ring.m_frames)
+			frame.m_numBytes = 0;
+
+		ring.m_storage = storage;
+		ring.m_memory = static_cast<uint8_t*>(memory);
+		ring.m_capacity = newCapacity;
+		ring.m_head = 0;
+		ring.m_usedBytes = 0;
+		ring.m_frameBytes = 0;
+		++ring.m_statistics.m_numGrowths;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Allocation allocate(Ring& ring, size_t size, size_t alignment)
+	{
+		if (ring.m_memory == nullptr || size == 0) return Allocation{};
+		alignment = std::max(alignment, size_t(1));
+
+		// Requests that can never fit are left to the caller right away, without growing or waiting for the GPU
+		if (size > ring.m_maxCapacity)
+		{
+			++ring.m_statistics.m_numOversizedRequests;
+			return Allocation{};
+		}
+
+		while (true)
+		{
+			// Place the allocation after the head, or wrap around to the start of the store
+			const size_t alignedHead = alignUp(ring.m_head, alignment);
+			const bool wrap = alignedHead + size > ring.m_capacity;
+			const size_t offset = wrap ? 0 : alignedHead;
+			const size_t padding = wrap ? ring.m_capacity - ring.m_head : alignedHead - ring.m_head;
+
+			// The free space is contiguous from the head, since frames are reclaimed in order
+			if (padding + size <= ring.m_capacity - ring.m_usedBytes)
+			{
+				Allocation allocation;
+				allocation.m_storage = ring.m_storage;
+				allocation.m_data = ring.m_memory + offset;
+				allocation.m_offset = offset;
+				allocation.m_size = size;
+
+				ring.m_head = offset + size;
+				ring.m_usedBytes += padding + size;
+				ring.m_frameBytes += padding + size;
+
+				++ring.m_statistics.m_numAllocations;
+				ring.m_statistics.m_numAllocatedBytes += size;
+				ring.m_statistics.m_numPaddingBytes += padding;
+				if (wrap) ++ring.m_statistics.m_numWraps;
+				ring.m_statistics.m_peakUsage = std::max(ring.m_statistics.m_peakUsage, ring.m_usedBytes);
+				return allocation;
+			}
+
+			// Reclaim the frames that completed in the meantime
+			if (retireFrames(ring, false) > 0)
+				continue;
+
+			// Grow the backing store, so the CPU does not have to wait
+			if (grow(ring, size))
+				continue;
+
+			// Wait for the oldest frame as a last resort
+			if (!ring.m_frames.empty())
+			{
+				++ring.m_statistics.m_numStalls;
+				retireFrames(ring, true);
+				continue;
+			}
+
+			// The current frame alone needs more than the largest allowed store
+			++ring.m_statistics.m_numFailedAllocations;
+			Debug::log_error() << "Unable to allocate " << size << " bytes from the upload ring (capacity: " << ring.m_capacity
+				<< ", used by the current frame: " << ring.m_frameBytes << ")" << Debug::end;
+			return Allocation{};
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Allocation upload(Ring& ring, const void* data, size_t size, size_t alignment)
+	{
+		Allocation allocation = allocate(ring, size, alignment);
+		if (allocation.m_data != nullptr)
+			std::memcpy(allocation.m_data, data, size);
+		return allocation;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Mock GPU for the tests. Backing stores live in host memory, and the GPU only progresses when told to. */
+	struct MockGpu
+	{
+		// The backing stores that are alive
+		std::unordered_map<StorageHandle, std::vector<uint8_t>> m_storages;
+		StorageHandle m_nextStorage = 1;
+
+		// Every fence up to m_completedFence is signaled
+		FenceHandle m_nextFence = 1;
+		FenceHandle m_completedFence = 0;
+		std::set<FenceHandle> m_liveFences;
+
+		// Test hooks
+		std::function<void(FenceHandle fence)> m_onFenceCompleted;
+		std::function<void(StorageHandle storage)> m_onStorageReleased;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	void completeFences(MockGpu& gpu, FenceHandle fence)
+	{
+		while (gpu.m_completedFence < fence && gpu.m_completedFence + 1 < gpu.m_nextFence)
+		{
+			++gpu.m_completedFence;
+			if (gpu.m_onFenceCompleted) gpu.m_onFenceCompleted(gpu.m_completedFence);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Backend mockBackend(MockGpu& gpu)
+	{
+		Backend backend;
+		backend.m_createStorage = [&gpu](size_t size, void** mappedMemory)
+		{
+			const StorageHandle storage = gpu.m_nextStorage++;
+			gpu.m_storages[storage].resize(size);
+			*mappedMemory = gpu.m_storages[storage].data();
+			return storage;
+		};
+		backend.m_releaseStorage = [&gpu](StorageHandle storage)
+		{
+			if (gpu.m_onStorageReleased) gpu.m_onStorageReleased(storage);
+			gpu.m_storages.erase(storage);
+		};
+		backend.m_insertFence = [&gpu]()
+		{
+			const FenceHandle fence = gpu.m_nextFence++;
+			gpu.m_liveFences.insert(fence);
+			return fence;
+		};
+		backend.m_queryFence = [&gpu](FenceHandle fence, bool wait)
+		{
+			if (wait) completeFences(gpu, fence);
+			return fence <= gpu.m_completedFence;
+		};
+		backend.m_deleteFence = [&gpu](FenceHandle fence)
+		{
+			gpu.m_liveFences.erase(fence);
+		};
+		return backend;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validate()
+	{
+		bool passed = true;
+		auto check = [&](bool condition, std::string const& name)
+		{
+			if (!condition) Debug::log_error() << "Upload ring check failed: " << name << Debug::end;
+			passed = passed && condition;
+		};
+
+		// Alignment, wrap-around, pacing and stalls on a fixed-size ring
+		{
+			MockGpu gpu;
+			Ring ring;
+			check(initialize(ring, mockBackend(gpu), 1024, 1024, 2), "initialize");
+
+			beginFrame(ring);
+			check(allocate(ring, 100, 16).m_offset == 0, "first allocation");
+			check(allocate(ring, 10, 256).m_offset == 256, "aligned allocation");
+			check(ring.m_usedBytes == 266, "alignment padding");
+			endFrame(ring);
+
+			beginFrame(ring);
+			check(allocate(ring, 600, 4).m_offset == 268, "second frame");
+			endFrame(ring);
+
+			// Reclaim the first frame, then wrap around
+			completeFences(gpu, ring.m_frames.front().m_fence);
+			beginFrame(ring);
+			check(ring.m_usedBytes == 602, "reclaimed frame");
+			const Allocation wrapped = allocate(ring, 200, 16);
+			check(wrapped.m_offset == 0 && ring.m_statistics.m_numWraps == 1, "wrap-around");
+			check(ring.m_usedBytes == 602 + (1024 - 868) + 200, "wrap-around padding");
+			endFrame(ring);
+
+			// Two frames are in flight, so the next frame must wait for the oldest one
+			beginFrame(ring);
+			check(ring.m_statistics.m_numPacingWaits == 1 && ring.m_frames.size() == 1, "frame pacing");
+
+			// Nothing completes on its own, so the ring must stall instead of growing
+			check(allocate(ring, 900, 16).m_data != nullptr && ring.m_statistics.m_numStalls == 1, "stall");
+			check(ring.m_statistics.m_numGrowths == 0 && ring.m_frames.empty(), "no growth at max capacity");
+			endFrame(ring);
+
+			// Allocations larger than the maximum capacity are rejected without stalling
+			completeFences(gpu, ring.m_frames.back().m_fence);
+			beginFrame(ring);
+			check(allocate(ring, 2048, 16).m_data == nullptr && ring.m_statistics.m_numOversizedRequests == 1, "oversized allocation");
+			check(ring.m_statistics.m_numFailedAllocations == 0 && ring.m_statistics.m_numStalls == 1 && ring.m_usedBytes == 0, "oversized allocation rejected up front");
+
+			// The current frame alone exhausting the ring fails
+			check(allocate(ring, 600, 16).m_data != nullptr, "allocation before exhaustion");
+			check(allocate(ring, 600, 16).m_data == nullptr && ring.m_statistics.m_numFailedAllocations == 1, "exhausted ring");
+			endFrame(ring);
+
+			release(ring);
+			check(gpu.m_storages.empty() && gpu.m_liveFences.empty(), "fixed ring release");
+		}
+
+		// Fallback growth on a growable ring
+		{
+			MockGpu gpu;
+			Ring ring;
+			check(initialize(ring, mockBackend(gpu), 256, 4096), "initialize growable");
+			const StorageHandle firstStorage = ring.m_storage;
+
+			beginFrame(ring);
+			check(allocate(ring, 200, 16).m_storage == firstStorage, "allocation before growth");
+
+			// Oversized requests must not grow the ring
+			check(allocate(ring, 8192, 16).m_data == nullptr && ring.m_statistics.m_numOversizedRequests == 1, "oversized allocation on a growable ring");
+			check(ring.m_capacity == 256 && ring.m_statistics.m_numGrowths == 0 && ring.m_statistics.m_numFailedAllocations == 0, "no growth for oversized allocations");
+			endFrame(ring);
+
+			// The first frame is still in flight, so the ring grows instead of waiting
+			beginFrame(ring);
+			const Allocation grown = allocate(ring, 200, 16);
+			check(grown.m_storage != firstStorage && grown.m_offset == 0, "allocation after growth");
+			check(ring.m_capacity == 512 && ring.m_statistics.m_numGrowths == 1 && ring.m_statistics.m_numStalls == 0, "growth");
+			endFrame(ring);
+
+			// The old store was used by the second frame too, so it lives until that completes
+			completeFences(gpu, ring.m_frames.front().m_fence);
+			beginFrame(ring);
+			check(gpu.m_storages.count(firstStorage) == 1, "retired store kept alive");
+			endFrame(ring);
+
+			completeFences(gpu, ring.m_frames.front().m_fence);
+			beginFrame(ring);
+			check(gpu.m_storages.count(firstStorage) == 0, "retired store released");
+			endFrame(ring);
+
+			release(ring);
+			check(gpu.m_storages.empty() && gpu.m_liveFences.empty(), "growable ring release");
+		}
+
+		Debug::log_info() << "Upload ring validation " << (passed ? "passed" : "FAILED") << Debug::end;
+		return passed;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** An allocation handed out by the ring, along with the seed of its contents. */
+	struct StressAllocation
+	{
+		StorageHandle m_storage = 0;
+		size_t m_offset = 0;
+		size_t m_size = 0;
+		uint32_t m_seed = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint8_t stressPattern(uint32_t seed, size_t i)
+	{
+		return uint8_t((seed * 2654435761u) >> 24) ^ uint8_t(i * 7);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool stressTest(Ring& ring, MockGpu& gpu, std::string const& name, size_t numFrames, uint32_t seed)
+	{
+		size_t numErrors = 0;
+		auto error = [&](std::string const& message)
+		{
+			if (numErrors++ < 10) Debug::log_error() << "Upload ring stress test (" << name << "): " << message << Debug::end;
+		};
+
+		std::vector<StressAllocation> currentFrame;
+		std::map<FenceHandle, std::vector<StressAllocation>> inFlight;
+
+		// The GPU reads the allocations of a frame when its fence completes; they must still hold what the CPU wrote
+		gpu.m_onFenceCompleted = [&](FenceHandle fence)
+		{
+			auto it = inFlight.find(fence);
+			if (it == inFlight.end()) return;
+			for (auto const& allocation : it->second)
+			{
+				auto storageIt = gpu.m_storages.find(allocation.m_storage);
+				if (storageIt == gpu.m_storages.end())
+				{
+					error("backing store released before the GPU read it");
+					continue;
+				}
+				for (size_t i = 0; i < allocation.m_size; ++i)
+				{
+					if (storageIt->second[allocation.m_offset + i] != stressPattern(allocation.m_seed, i))
+					{
+						error("allocation overwritten before the GPU read it");
+						break;
+					}
+				}
+			}
+			inFlight.erase(it);
+		};
+
+		// Backing stores must not be referenced by any pending allocation when released
+		gpu.m_onStorageReleased = [&](StorageHandle storage)
+		{
+			for (auto const& allocation : currentFrame)
+				if (allocation.m_storage == storage) error("backing store released while used by the current frame");
+			for (auto const& frame : inFlight)
+				for (auto const& allocation : frame.second)
+					if (allocation.m_storage == storage) error("backing store released while used by a frame in flight");
+		};
+
+		auto overlaps = [](StressAllocation const& a, StressAllocation const& b)
+		{
+			return a.m_storage == b.m_storage && a.m_offset < b.m_offset + b.m_size && b.m_offset < a.m_offset + a.m_size;
+		};
+
+		std::mt19937 generator(seed);
+		std::uniform_int_distribution<size_t> numAllocationsDistribution(0, 32);
+		std::uniform_int_distribution<size_t> sizeClassDistribution(0, 99);
+		std::uniform_int_distribution<size_t> alignmentDistribution(0, 5);
+		std::uniform_int_distribution<size_t> latencyDistribution(0, 4);
+		const size_t alignments[] = { 1, 4, 16, 64, 256, 1024 };
+		uint32_t nextSeed = 1;
+
+		for (size_t frameId = 0; frameId < numFrames; ++frameId)
+		{
+			beginFrame(ring);
+
+			// Keep each frame within half of the smallest store, so every allocation can succeed
+			const size_t frameBudget = ring.m_capacity / 2;
+			size_t frameBytes = 0;
+
+			const size_t numAllocations = numAllocationsDistribution(generator);
+			for (size_t allocationId = 0; allocationId < numAllocations; ++allocationId)
+			{
+				const size_t sizeClass = sizeClassDistribution(generator);
+				const size_t maxSize = sizeClass < 70 ? 256 : (sizeClass < 95 ? 4096 : 16384);
+				const size_t size = std::uniform_int_distribution<size_t>(1, maxSize)(generator);
+				const size_t alignment = alignments[alignmentDistribution(generator)];
+				if (frameBytes + size + alignment > frameBudget) break;
+				frameBytes += size + alignment;
+
+				const Allocation allocation = allocate(ring, size, alignment);
+				if (allocation.m_data == nullptr)
+				{
+					error("allocation failed");
+					continue;
+				}
+
+				StressAllocation record;
+				record.m_storage = allocation.m_storage;
+				record.m_offset = allocation.m_offset;
+				record.m_size = allocation.m_size;
+				record.m_seed = nextSeed++;
+
+				// Check the placement of the allocation
+				auto storageIt = gpu.m_storages.find(allocation.m_storage);
+				if (storageIt == gpu.m_storages.end() || allocation.m_offset + allocation.m_size > storageIt->second.size() ||
+					allocation.m_data != storageIt->second.data() + allocation.m_offset)
+					error("allocation outside of its backing store");
+				if (allocation.m_offset % alignment != 0)
+					error("misaligned allocation");
+				for (auto const& other : currentFrame)
+					if (overlaps(record, other)) error("allocation overlaps one of the current frame");
+				for (auto const& frame : inFlight)
+					for (auto const& other : frame.second)
+						if (overlaps(record, other)) error("allocation overlaps one still in use by the GPU");
+
+				// Fill in the contents
+				uint8_t* data = static_cast<uint8_t*>(allocation.m_data);
+				for (size_t i = 0; i < size; ++i)
+					data[i] = stressPattern(record.m_seed, i);
+				currentFrame.push_back(record);
+			}
+
+			endFrame(ring);
+			inFlight[ring.m_frames.back().m_fence] = std::move(currentFrame);
+			currentFrame.clear();
+
+			// The GPU lags behind by a random number of frames
+			const size_t latency = latencyDistribution(generator);
+			if (gpu.m_nextFence > latency + 1)
+				completeFences(gpu, gpu.m_nextFence - 1 - latency);
+		}
+
+		const Statistics statistics = ring.m_statistics;
+		release(ring);
+		if (!inFlight.empty()) error("frames left unread by the GPU");
+		if (!gpu.m_storages.empty()) error("backing stores leaked");
+		if (!gpu.m_liveFences.empty()) error("fences leaked");
+
+		Debug::log_info() << "Upload ring stress test (" << name << "): " << (numErrors == 0 ? "passed" : "FAILED")
+			<< "; allocations: " << statistics.m_numAllocations
+			<< ", wraps: " << statistics.m_numWraps
+			<< ", growths: " << statistics.m_numGrowths
+			<< ", stalls: " << statistics.m_numStalls
+			<< ", pacing waits: " << statistics.m_numPacingWaits
+			<< ", peak usage: " << statistics.m_peakUsage << " bytes" << Debug::end;
+		return numErrors == 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool stressTest(size_t numFrames, uint32_t seed)
+	{
+		bool passed = true;
+
+		// Growable ring, starting out too small for the frames in flight
+		{
+			MockGpu gpu;
+			Ring ring;
+			initialize(ring, mockBackend(gpu), 64 * 1024, 4 * 1024 * 1024);
+			passed &= stressTest(ring, gpu, "growable", numFrames, seed);
+		}
+
+		// Fixed-size ring, which has to wrap around and stall
+		{
+			MockGpu gpu;
+			Ring ring;
+			initialize(ring, mockBackend(gpu), 64 * 1024, 64 * 1024);
+			passed &= stressTest(ring, gpu, "fixed", numFrames, seed + 1);
+		}
+
+		return passed;
+	}
+}
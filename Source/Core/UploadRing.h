@@ -0,0 +1,183 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+//  Headers
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PCH.h"
+#include "Constants.h"
+#include "Debug.h"
+#include "DateTime.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// UPLOAD RING
+////////////////////////////////////////////////////////////////////////////////
+namespace UploadRing
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/** Opaque handles of the backing stores and fences; 0 is never a valid handle. */
+	using StorageHandle = uint64_t;
+	using FenceHandle = uint64_t;
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** The GPU side of the ring. The ring logic only talks to the GPU through these callbacks, so it can be
+		driven by a mock backend without a GL context. */
+	struct Backend
+	{
+		// Creates a mapped backing store of the parameter size, and returns its handle and mapped pointer
+		std::function<StorageHandle(size_t size, void** mappedMemory)> m_createStorage;
+
+		// Releases a backing store; only called once the GPU is done with it
+		std::function<void(StorageHandle storage)> m_releaseStorage;
+
+		// Places a fence after the commands issued so far
+		std::function<FenceHandle()> m_insertFence;
+
+		// Whether the fence is signaled; blocks until it is if wait is set
+		std::function<bool(FenceHandle fence, bool wait)> m_queryFence;
+
+		// Deletes a fence
+		std::function<void(FenceHandle fence)> m_deleteFence;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A sub-allocation of the ring, valid until the end of the frame it was made in. */
+	struct Allocation
+	{
+		// Backing store holding the allocation
+		StorageHandle m_storage = 0;
+
+		// Mapped pointer to the start of the allocation; nullptr if the allocation failed
+		void* m_data = nullptr;
+
+		// Range of the allocation in the backing store
+		size_t m_offset = 0;
+		size_t m_size = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A frame submitted to the GPU, whose allocations are still in use. */
+	struct FrameRecord
+	{
+		// Fence placed at the end of the frame
+		FenceHandle m_fence = 0;
+
+		// Id of the frame
+		size_t m_frameId = 0;
+
+		// Bytes consumed by the frame in the current backing store, including alignment and wrap-around padding
+		size_t m_numBytes = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A backing store replaced by a larger one, kept alive until its last frame completes. */
+	struct RetiredStorage
+	{
+		StorageHandle m_storage = 0;
+		size_t m_lastFrameId = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Counters of the ring events, accumulated since initialization. */
+	struct Statistics
+	{
+		size_t m_numAllocations = 0;
+		size_t m_numAllocatedBytes = 0;
+		size_t m_numPaddingBytes = 0;
+		size_t m_numFailedAllocations = 0;
+		size_t m_numOversizedRequests = 0;
+		size_t m_numWraps = 0;
+		size_t m_numGrowths = 0;
+		size_t m_numStalls = 0;
+		size_t m_numPacingWaits = 0;
+		size_t m_peakUsage = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Ring allocator over a single persistently mapped backing store. Allocations are made linearly from the head,
+		and reclaimed a whole frame at a time once the fence of the frame is signaled. */
+	struct Ring
+	{
+		// The GPU side of the ring
+		Backend m_backend;
+
+		// The current backing store
+		StorageHandle m_storage = 0;
+		uint8_t* m_memory = nullptr;
+		size_t m_capacity = 0;
+
+		// Upper limit for growing the backing store; when reached, allocations wait for the GPU instead
+		size_t m_maxCapacity = 0;
+
+		// Number of frames the CPU may run ahead of the GPU
+		size_t m_maxFramesInFlight = 3;
+
+		// Offset of the next free byte
+		size_t m_head = 0;
+
+		// Bytes in use by the in-flight frames and the current frame
+		size_t m_usedBytes = 0;
+
+		// Bytes consumed by the current frame
+		size_t m_frameBytes = 0;
+
+		// Id of the current frame, and the number of frames the GPU completed
+		size_t m_frameId = 0;
+		size_t m_numCompletedFrames = 0;
+
+		// Frames still in flight, oldest first
+		std::deque<FrameRecord> m_frames;
+
+		// Backing stores waiting for their last frame to complete
+		std::vector<RetiredStorage> m_retiredStorages;
+
+		// Event counters
+		Statistics m_statistics;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Rounds the parameter offset up to a multiple of the alignment. */
+	size_t alignUp(size_t offset, size_t alignment);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Creates the initial backing store of the ring. Returns whether it succeeded. */
+	bool initialize(Ring& ring, Backend const& backend, size_t capacity, size_t maxCapacity, size_t maxFramesInFlight = 3);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Waits for every frame in flight, and releases the fences and backing stores. */
+	void release(Ring& ring);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Reclaims the frames whose fences are signaled, and releases the retired backing stores that are no longer used.
+		When waitForOldest is set, blocks until the oldest frame completes. Returns the number of reclaimed frames. */
+	size_t retireFrames(Ring& ring, bool waitForOldest = false);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Starts a new frame; waits for the oldest frame if too many are in flight. */
+	void beginFrame(Ring& ring);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Ends the current frame by fencing its allocations. */
+	void endFrame(Ring& ring);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Allocates the parameter number of bytes at the given alignment. Reclaims finished frames when the ring is full,
+		then grows the backing store up to its maximum capacity, and only waits for the GPU as a last resort. Requests larger
+		than the maximum capacity return an empty allocation right away, so the caller can upload the data directly. */
+	Allocation allocate(Ring& ring, size_t size, size_t alignment);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Allocates room for the parameter data and copies it into the ring. */
+	Allocation upload(Ring& ring, const void* data, size_t size, size_t alignment);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the alignment, wrap-around, pacing, growth and stall behavior against a mock backend, and logs the results.
+		Returns whether all the checks passed. */
+	bool validate();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Runs the ring for many frames with randomized allocation sizes, alignments and GPU latencies on a mock backend.
+		Checks that no allocation overlaps one still in use by the GPU, that the GPU reads back what was written, and that
+		backing stores are only released after their last frame. Returns whether all the checks passed. */
+	bool stressTest(size_t numFrames = 2000, uint32_t seed = 0);
+}
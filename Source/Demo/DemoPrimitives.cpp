@@ -47,6 +47,7 @@ namespace DemoPrimitives
 				material.m_roughness = 0.0f;
 				material.m_metallic = 0.0f;
 				scene.m_materials["Snellen_E"] = material;
+				MaterialTable::markMaterialChanged(scene, "Snellen_E");
 				object.component<Mesh::MeshComponent>().m_materials.back() = "Snellen_E";
 			});
 		}));
@@ -78,6 +79,7 @@ namespace DemoPrimitives
 				material.m_roughness = 0.35f;
 				material.m_metallic = 0.0f;
 				scene.m_materials["PrimitiveSphere"] = material;
+				MaterialTable::markMaterialChanged(scene, "PrimitiveSphere");
 				object.component<Mesh::MeshComponent>().m_materials.back() = "PrimitiveSphere";
 			});
 		}));
@@ -110,6 +112,7 @@ namespace DemoPrimitives
 					material.m_roughness = 1.0f;
 					material.m_metallic = 0.75f;
 					scene.m_materials["PrimitiveCube"] = material;
+					MaterialTable::markMaterialChanged(scene, "PrimitiveCube");
 					object.component<Mesh::MeshComponent>().m_materials.back() = "PrimitiveCube";
 				});
 		}));
@@ -85,6 +85,9 @@ namespace DemoSibenik
 				scene.m_materials[prefix + "material_73"].m_metallic = 1.0f; // fences-circles
 				scene.m_materials[prefix + "material_73"].m_roughness = 0.8f;
 				scene.m_materials[prefix + "material_73"].m_specular = 1.0f;
+
+				// Repack the edited materials
+				MaterialTable::markAllMaterialsChanged(scene);
 			});
 		}));
 
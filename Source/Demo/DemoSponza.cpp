@@ -91,6 +91,9 @@ namespace DemoSponza
 
 				// Fix backfacing materials
 				scene.m_materials["sponza-pbr_material6"].m_twoSided = true;
+
+				// Repack the edited materials
+				MaterialTable::markAllMaterialsChanged(scene);
 			});
 		}));
 
@@ -30,12 +30,16 @@
 #include <map>
 #include <stack>
 #include <list>
+#include <deque>
 #include <forward_list>
 #include <unordered_set>
 #include <unordered_map>
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <future>
 #include <mutex>
+#include <condition_variable>
 #include <shared_mutex>
 #include <variant>
 #include <any>
@@ -148,6 +152,7 @@
 #endif
 
 #include "Eigen/Core"
+#include "Eigen/SVD"
 #include "unsupported/Eigen/MatrixFunctions"
 #include "unsupported/Eigen/Polynomials"
 
@@ -1378,6 +1378,7 @@ namespace Asset
 
 			// Store the material in the scane
 			scene.m_materials[material.m_name] = material;
+			MaterialTable::markMaterialChanged(scene, material.m_name);
 		}
 
 		// Compute the total number of vertices and indices
@@ -1413,6 +1414,7 @@ namespace Asset
 
 			// Extract the relevant info.
 			subMesh.m_name = pSubMesh->mName.C_Str();
+			subMesh.m_profilerName = "Submesh #" + std::to_string(subMeshId) + " (" + subMesh.m_name + ")";
 			subMesh.m_materialId = pSubMesh->mMaterialIndex;
 			subMesh.m_vertexCount = pSubMesh->mNumVertices;
 			subMesh.m_indexCount = pSubMesh->mNumFaces * 3;
@@ -604,7 +604,8 @@ namespace ComplexBlur
 				Aberration::PsfStackElements::PsfEntry const& targetPsf)
 			{
 				// Normalize the PSF
-				Aberration::Psf psf = targetPsf.m_psf / targetPsf.m_psf.maxCoeff();
+				Aberration::Psf psf = Aberration::getPsf(scene, Psfs::getAberration(scene, object), targetPsf);
+				psf /= psf.maxCoeff();
 
 				// Save the target PSF
 				if (alignSettings.m_exportPsf)
@@ -744,7 +745,7 @@ namespace ComplexBlur
 				const size_t radiusHorizontal, const size_t radiusVertical)
 			{
 				// Project the PSF
-				Aberration::Psf psf = targetPsf.m_psf;
+				Aberration::Psf psf = Aberration::getPsf(scene, Psfs::getAberration(scene, object), targetPsf);
 				if (fitSettings.m_projectPsf)
 				{
 					Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
@@ -1066,7 +1067,7 @@ namespace ComplexBlur
 			auto const& targetPsf = getPsfEntry(scene, Psfs::getAberration(scene, object), targetPsfIndex);
 
 			// Construct the target PSF
-			Aberration::Psf psf = targetPsf.m_psf;
+			Aberration::Psf psf = Aberration::getPsf(scene, Psfs::getAberration(scene, object), targetPsf);
 				Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
 			Scene::Object* camera = RenderSettings::getMainCamera(scene, renderSettings);
 
@@ -1109,7 +1110,7 @@ namespace ComplexBlur
 		void uploadPsfTexture(Scene::Scene& scene, Scene::Object* object, std::string const& textureName, Aberration::PsfIndex const& psfIndex, const bool normalize = true)
 		{
 			uploadPreviewTexture(scene, object, textureName, 
-				Aberration::getPsfEntry(scene, Psfs::getAberration(scene, object), psfIndex).m_psf);
+				Aberration::getPsf(scene, Psfs::getAberration(scene, object), Aberration::getPsfEntry(scene, Psfs::getAberration(scene, object), psfIndex)));
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -1124,7 +1125,7 @@ namespace ComplexBlur
 			Aberration::Psf psf = KernelAlign::constructTargetPsf(scene, object, alignSettings, targetPsf);
 
 			// Upload the results
-			uploadPreviewTexture(scene, object, "AlignPsfBase", targetPsf.m_psf);
+			uploadPreviewTexture(scene, object, "AlignPsfBase", Aberration::getPsf(scene, Psfs::getAberration(scene, object), targetPsf));
 			uploadPreviewTexture(scene, object, "AlignPsfTransformed", psf);
 		}
 
@@ -1140,7 +1141,7 @@ namespace ComplexBlur
 			Aberration::Psf psf = KernelFit::constructTargetPsf(scene, object, fitSettings, targetPsf);
 
 			// Upload the results
-			uploadPreviewTexture(scene, object, "FitPsfBase", targetPsf.m_psf);
+			uploadPreviewTexture(scene, object, "FitPsfBase", Aberration::getPsf(scene, Psfs::getAberration(scene, object), targetPsf));
 			uploadPreviewTexture(scene, object, "FitPsfTransformed", psf);
 		}
 
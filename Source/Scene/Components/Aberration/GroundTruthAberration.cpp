@@ -811,22 +811,33 @@ namespace GroundTruthAberration
 			Aberration::PsfStackComputation_Psfs;
 		Aberration::computePSFStack(scene, commonData.m_aberration, computationFlags);
 
+		// Extract the resulting PSFs and compute their radii
+		std::vector<Aberration::Psf> psfsOriginal(commonData.m_numChannels);
+		std::vector<float> psfRadii(commonData.m_numChannels);
+		for (int channelId = 0; channelId < psfsOriginal.size(); ++channelId)
+		{
+			auto const& psfEntry = commonData.m_aberration.m_psfStack.m_psfs[0][0][0][channelId][0][0];
+			psfsOriginal[channelId] = Aberration::getPsf(scene, commonData.m_aberration, psfEntry);
+			psfRadii[channelId] = Aberration::blurRadiusPixels(psfEntry, commonData.m_renderResolution, commonData.m_fovy);
+		}
+
+		// Downscale every channel in one batch
+		std::vector<Aberration::Psf> psfsResized;
+		Aberration::resizePsfBatch(scene, commonData.m_aberration, psfsOriginal, psfRadii, psfsResized);
+
 		// Store the downscaled PSF
 		psfs.resize(commonData.m_numChannels);
 		for (int channelId = 0; channelId < psfs.size(); ++channelId)
 		{
-			// Extract the resulting PSF
 			auto const& psfParams = commonData.m_aberration.m_psfStack.m_psfEntryParameters[0][0][0][channelId][0][0];
-			auto const& psfEntry = commonData.m_aberration.m_psfStack.m_psfs[0][0][0][channelId][0][0];
-
-			// Compute its radius
-			const float psfRadius = Aberration::blurRadiusPixels(psfEntry, commonData.m_renderResolution, commonData.m_fovy);
+			Aberration::Psf const& psfOriginal = psfsOriginal[channelId];
+			const float psfRadius = psfRadii[channelId];
 
 			if (outputFilterLevel(scene, object, ConvolutionSettings::Detailed, log))
 			{
 				Debug::log_debug() << "    < "
 					<< "Channel[" << channelId << "]: "
-					<< "PSF Radius: " << psfRadius << " (" << psfEntry.m_psf.cols() << "), "
+					<< "PSF Radius: " << psfRadius << " (" << psfOriginal.cols() << "), "
 					<< "Defocus: " << psfParams.m_focus.m_defocusParam 
 					<< Debug::end;
 			}
@@ -834,7 +845,7 @@ namespace GroundTruthAberration
 			// Actual PSF to convolve with
 			psfs[channelId].m_defocus = psfParams.m_focus.m_defocusParam;
 			psfs[channelId].m_radius = psfRadius;
-			psfs[channelId].m_psf = Aberration::resizePsfNormalized(scene, commonData.m_aberration, psfEntry.m_psf, psfRadius);
+			psfs[channelId].m_psf = psfsResized[channelId] / psfsResized[channelId].sum();
 
 			if (object->component<GroundTruthAberrationComponent>().m_convolutionSettings.m_exportPsfs)
 			{
@@ -848,7 +859,7 @@ namespace GroundTruthAberration
 
 				// Export the original PSF image
 				{
-					Aberration::Psf psf = psfEntry.m_psf / psfEntry.m_psf.maxCoeff();
+					Aberration::Psf psf = psfOriginal / psfOriginal.maxCoeff();
 					std::string filePath = (commonData.m_psfFolderOriginal / ("psf_original" + psfName + ".png")).string();
 					Asset::saveImage(scene, filePath, psf);
 				}
@@ -919,6 +930,8 @@ namespace GroundTruthAberration
 				Threading::ThreadedExecuteParams(1, "Computing PSF bins", "PSF", outputLogLevel(scene, object, ConvolutionSettings::Progress)),
 				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t binId)
 				{
+					Profiler::ScopedCpuEvent psfEvent(scene, "Compute PSF Bin", true);
+
 					computePsf(scene, object, environment, commonData, perThreadData[Threading::currentThreadId()], binId);
 				},
 				commonData.m_psfBinParams.size());
@@ -1341,16 +1354,20 @@ namespace GroundTruthAberration
 	{
 		// Perform the actual convolution
 		Threading::threadedExecuteIndices(
-			Threading::ThreadedExecuteParams(Threading::numThreads(), "Convolving pixels", "pixel", outputLogLevel(scene, object, ConvolutionSettings::Progress)),
-			[&](Threading::ThreadedExecuteEnvironment const& environment, int img_row, int img_col)
+			Threading::ThreadedExecuteParams(Threading::numThreads(), "Convolving pixels", "row", outputLogLevel(scene, object, ConvolutionSettings::Progress)),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, int img_row)
 			{
 				// Extract the thread data corresponding to this thread
 				PerThreadData& threadData = perThreadData[Threading::currentThreadId()];
 
+				// One scope per row; per-pixel scopes would overflow the event buffers
+				Profiler::ScopedCpuEvent gatherEvent(scene, "Gather Row", true);
+
 				// Convolve with the PSF by gathering
-				gatherPixel(scene, object, environment, commonData, perThreadData[Threading::currentThreadId()], img_row, img_col);
+				for (int img_col = 0; img_col < commonData.m_renderResolution[0]; ++img_col)
+					gatherPixel(scene, object, environment, commonData, threadData, img_row, img_col);
 			},
-			commonData.m_renderResolution[1], commonData.m_renderResolution[0]);
+			commonData.m_renderResolution[1]);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -1,6 +1,8 @@
 #include "PCH.h"
 #include "TiledSplatBlur.h"
 
+#include <random>
+
 namespace TiledSplatBlur
 {
 	////////////////////////////////////////////////////////////////////////////////
@@ -110,16 +112,38 @@ namespace TiledSplatBlur
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		float tileBufferLayerMultiplier(int layers)
+		/** Integer floor(log2(v)), for v >= 1. */
+		constexpr int log2Floor(int v)
+		{
+			int result = 0;
+			while (v > 1) { v >>= 1; ++result; }
+			return result;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Next power of two, not smaller than v. */
+		constexpr int nextPow2(int v)
+		{
+			--v;
+			v |= v >> 1;
+			v |= v >> 2;
+			v |= v >> 4;
+			v |= v >> 8;
+			v |= v >> 16;
+			return ++v;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		constexpr int tileBufferLayerMultiplier(int layers)
 		{
-			return float(layers);
+			return layers;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxCenterFragmentsPerEntry(int layers, int tileSize)
+		constexpr int tileBufferMaxCenterFragmentsPerEntry(int layers, int tileSize)
 		{
 			// Number of entries in the center zone
-			return int(tileBufferLayerMultiplier(layers) * tileSize * tileSize);
+			return tileBufferLayerMultiplier(layers) * tileSize * tileSize;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -131,32 +155,23 @@ namespace TiledSplatBlur
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxFragmentsPerEntry(int layers, int tileSize, int maxCoc)
+		constexpr int tileBufferMaxFragmentsPerEntry(int layers, int tileSize, int maxCoc)
 		{
 			// Number of entries in the center zone
-			int center = tileSize * tileSize;
+			const int center = tileSize * tileSize;
 
 			// Number of entries in the neighbor zones (top, bottom, left, right)
-			int side = 4.0f * tileSize * maxCoc;
+			const int side = 4 * tileSize * maxCoc;
 
-			// Number of entries in the neighbor zones (top, bottom, left, right)
-			int corner = 4.0f * maxCoc * maxCoc;
+			// Number of entries in the corner zones
+			const int corner = 4 * maxCoc * maxCoc;
 
 			// Multiply by the number of layers and return
-			return int(tileBufferLayerMultiplier(layers) * (center + side + corner));
-		}
-
-		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxFragmentsPerEntry(Scene::Scene& scene, Scene::Object* object, int layers)
-		{
-			return tileBufferMaxFragmentsPerEntry(
-				layers,
-				object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_tileSize,
-				object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_maxCoC);
+			return tileBufferLayerMultiplier(layers) * (center + side + corner);
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferNumNeighborTilesSplat(int tileSize, int maxCoc)
+		constexpr int tileBufferNumNeighborTilesSplat(int tileSize, int maxCoc)
 		{
 			return (maxCoc + tileSize - 1) / tileSize;
 		}
@@ -170,79 +185,165 @@ namespace TiledSplatBlur
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxSortElements(int maxFragmentsPerEntry)
+		constexpr int tileBufferMaxSortElements(int maxFragmentsPerEntry)
 		{
-			return std::next_pow2(maxFragmentsPerEntry);
+			return nextPow2(maxFragmentsPerEntry);
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int sortGroupId(int groupSize, int maxSharedIndices)
+		constexpr int sortGroupId(int groupSize, int maxSharedIndices)
 		{
-			return int(glm::log2((float)groupSize)) - int(glm::log2((float)maxSharedIndices));
+			return log2Floor(groupSize) - log2Floor(maxSharedIndices);
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int dispatchElementIndex(int groupSize, int maxSharedIndices)
+		constexpr int dispatchElementIndex(int groupSize, int maxSharedIndices)
 		{
 			return (sortGroupId(groupSize, maxSharedIndices) * (sortGroupId(groupSize, maxSharedIndices) + 1)) / 2;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxSortSharedElements(int maxSortElements, int maxFragmentsPerEntry)
-		{
-			return glm::min(tileBufferMaxSortElements(maxFragmentsPerEntry), maxSortElements);
-		}
-
-		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxSortSharedElements(Scene::Scene& scene, Scene::Object* object, int layers)
+		constexpr int tileBufferMaxSortSharedElements(int maxSortElements, int maxFragmentsPerEntry)
 		{
-			return tileBufferMaxSortSharedElements(
-				object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_maxSortElements,
-				tileBufferMaxFragmentsPerEntry(scene, object, layers));
+			return std::min(tileBufferMaxSortElements(maxFragmentsPerEntry), maxSortElements);
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxSortIterations(int maxFragmentsPerEntry, int tileBufferMaxSharedSortIndices)
+		constexpr int tileBufferMaxSortIterations(int maxFragmentsPerEntry, int tileBufferMaxSharedSortIndices)
 		{
 			// Maximum number of fragments in a tile buffer entry
-			int maxSortElements = tileBufferMaxSortElements(maxFragmentsPerEntry);
+			const int maxSortElements = tileBufferMaxSortElements(maxFragmentsPerEntry);
 
 			// Maximum number of total iterations needed
-			int maxTotalIterations = (int)glm::log2((float)glm::max(maxSortElements, tileBufferMaxSharedSortIndices));
+			const int maxTotalIterations = log2Floor(std::max(maxSortElements, tileBufferMaxSharedSortIndices));
 
 			// From which this many iterations are inner ones
-			int numInnerIterations = (int)glm::log2((float)tileBufferMaxSharedSortIndices);
+			const int numInnerIterations = log2Floor(tileBufferMaxSharedSortIndices);
 
 			// Maximum number of iterations necessary to sort a tile buffer entry
 			return maxTotalIterations - numInnerIterations + 1;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int tileBufferMaxSortIterations(Scene::Scene& scene, Scene::Object* object, int layers)
+		constexpr int dispatchBufferMaxDispatchPerEntry(int maxSortIterations)
 		{
-			return tileBufferMaxSortIterations(
-				tileBufferMaxFragmentsPerEntry(scene, object, layers),
-				tileBufferMaxSortSharedElements(scene, object, layers));
+			return (maxSortIterations * (maxSortIterations + 1)) / 2;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int dispatchBufferMaxDispatchPerEntry(int maxSortIterations)
+		constexpr int dispatchBufferMaxDispatchPerEntry(int maxFragmentsPerEntry, int tileBufferMaxSharedSortIndices)
 		{
-			return (maxSortIterations * (maxSortIterations + 1)) / 2;
+			return dispatchBufferMaxDispatchPerEntry(tileBufferMaxSortIterations(maxFragmentsPerEntry, tileBufferMaxSharedSortIndices));
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		int dispatchBufferMaxDispatchPerEntry(int maxFragmentsPerEntry, int tileBufferMaxSharedSortIndices)
+		// Lock down the sizing formulas that the shaders rely on
+		static_assert(tileBufferMaxFragmentsPerEntry(1, 16, 32) == 6400);
+		static_assert(tileBufferMaxFragmentsPerEntry(4, 16, 32) == 25600);
+		static_assert(tileBufferMaxFragmentsPerEntry(2, 8, 0) == 128);
+		static_assert(tileBufferMaxCenterFragmentsPerEntry(4, 16) == 1024);
+		static_assert(tileBufferNumNeighborTilesSplat(16, 33) == 3);
+		static_assert(tileBufferMaxSortElements(6400) == 8192);
+		static_assert(tileBufferMaxSortElements(8192) == 8192);
+		static_assert(tileBufferMaxSortSharedElements(1024, 6400) == 1024);
+		static_assert(tileBufferMaxSortSharedElements(1024, 100) == 128);
+		static_assert(tileBufferMaxSortIterations(6400, 1024) == 4);
+		static_assert(tileBufferMaxSortIterations(100, 128) == 1);
+		static_assert(dispatchBufferMaxDispatchPerEntry(6400, 1024) == 10);
+		static_assert(dispatchElementIndex(8192, 1024) == 6);
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Returns the tile buffer sizes for the current settings, recomputing them only when the settings change. */
+		TiledSplatBlurComponent::TileBufferSizes const& tileBufferSizes(Scene::Scene& scene, Scene::Object* object, int layers)
 		{
-			return dispatchBufferMaxDispatchPerEntry(tileBufferMaxSortIterations(maxFragmentsPerEntry, tileBufferMaxSharedSortIndices));
+			TiledSplatBlurComponent& component = object->component<TiledSplatBlur::TiledSplatBlurComponent>();
+			TiledSplatBlurComponent::TileBufferSizes& sizes = component.m_tileBufferSizes;
+
+			if (sizes.m_layers != layers || sizes.m_tileSize != component.m_tileSize || sizes.m_maxCoc != component.m_maxCoC || sizes.m_maxSortElements != component.m_maxSortElements)
+			{
+				sizes.m_layers = layers;
+				sizes.m_tileSize = component.m_tileSize;
+				sizes.m_maxCoc = component.m_maxCoC;
+				sizes.m_maxSortElements = component.m_maxSortElements;
+				sizes.m_maxFragmentsPerEntry = tileBufferMaxFragmentsPerEntry(layers, component.m_tileSize, component.m_maxCoC);
+				sizes.m_maxSortSharedElements = tileBufferMaxSortSharedElements(component.m_maxSortElements, sizes.m_maxFragmentsPerEntry);
+				sizes.m_maxSortIterations = tileBufferMaxSortIterations(sizes.m_maxFragmentsPerEntry, sizes.m_maxSortSharedElements);
+				sizes.m_maxDispatchPerEntry = dispatchBufferMaxDispatchPerEntry(sizes.m_maxSortIterations);
+			}
+
+			return sizes;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		int tileBufferMaxFragmentsPerEntry(Scene::Scene& scene, Scene::Object* object, int layers)
+		{
+			return tileBufferSizes(scene, object, layers).m_maxFragmentsPerEntry;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		int tileBufferMaxSortSharedElements(Scene::Scene& scene, Scene::Object* object, int layers)
+		{
+			return tileBufferSizes(scene, object, layers).m_maxSortSharedElements;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		int tileBufferMaxSortIterations(Scene::Scene& scene, Scene::Object* object, int layers)
+		{
+			return tileBufferSizes(scene, object, layers).m_maxSortIterations;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
 		int dispatchBufferMaxDispatchPerEntry(Scene::Scene& scene, Scene::Object* object, int layers)
 		{
-			return dispatchBufferMaxDispatchPerEntry(
-				tileBufferMaxFragmentsPerEntry(scene, object, layers),
-				tileBufferMaxSortSharedElements(scene, object, layers));
+			return tileBufferSizes(scene, object, layers).m_maxDispatchPerEntry;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** The original floating-point sizing formulas, kept for validating and benchmarking the integer ones. */
+		namespace FloatReference
+		{
+			////////////////////////////////////////////////////////////////////////////////
+			int tileBufferMaxFragmentsPerEntry(int layers, int tileSize, int maxCoc)
+			{
+				int center = tileSize * tileSize;
+				int side = 4.0f * tileSize * maxCoc;
+				int corner = 4.0f * maxCoc * maxCoc;
+				return int(float(layers) * (center + side + corner));
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			int tileBufferMaxSortElements(int maxFragmentsPerEntry)
+			{
+				return int(std::next_pow2(maxFragmentsPerEntry));
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			int sortGroupId(int groupSize, int maxSharedIndices)
+			{
+				return int(glm::log2((float)groupSize)) - int(glm::log2((float)maxSharedIndices));
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			int tileBufferMaxSortSharedElements(int maxSortElements, int maxFragmentsPerEntry)
+			{
+				return glm::min(tileBufferMaxSortElements(maxFragmentsPerEntry), maxSortElements);
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			int tileBufferMaxSortIterations(int maxFragmentsPerEntry, int tileBufferMaxSharedSortIndices)
+			{
+				int maxSortElements = tileBufferMaxSortElements(maxFragmentsPerEntry);
+				int maxTotalIterations = (int)glm::log2((float)glm::max(maxSortElements, tileBufferMaxSharedSortIndices));
+				int numInnerIterations = (int)glm::log2((float)tileBufferMaxSharedSortIndices);
+				return maxTotalIterations - numInnerIterations + 1;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			int dispatchBufferMaxDispatchPerEntry(int maxFragmentsPerEntry, int tileBufferMaxSharedSortIndices)
+			{
+				int maxSortIterations = tileBufferMaxSortIterations(maxFragmentsPerEntry, tileBufferMaxSharedSortIndices);
+				return (maxSortIterations * (maxSortIterations + 1)) / 2;
+			}
 		}
 	}
 
@@ -347,6 +448,99 @@ namespace TiledSplatBlur
 			return arePsfsSameOrNeighbors(a, b, object->component<TiledSplatBlurComponent>().m_psfAxisMethod == TiledSplatBlurComponent::OffAxis);
 		}
 
+		////////////////////////////////////////////////////////////////////////////////
+		/** Builds the neighbor stencil of a PSF stack with the parameter shape, strides and axis method. */
+		void buildNeighborStencil(Aberration::PsfIndex const& shape, Aberration::PsfIndex const& strides, const int psfAxisMethod,
+			TiledSplatBlurComponent::PsfNeighborStencil& stencil)
+		{
+			stencil.m_shape = shape;
+			stencil.m_strides = strides;
+			stencil.m_psfAxisMethod = psfAxisMethod;
+			stencil.m_offsets.clear();
+			stencil.m_flatOffsets.clear();
+
+			// Axes along which neighbors may differ (see arePsfsNeighbors); single-entry axes have no neighbors at all
+			const bool offAxis = psfAxisMethod == TiledSplatBlurComponent::OffAxis;
+			const std::array<bool, 6> axes = { true, offAxis, offAxis, false, true, true };
+
+			// Enumerate the 3^6 offset combinations, keeping those along the enabled axes
+			for (size_t code = 0; code < 729; ++code)
+			{
+				std::array<int, 6> offset;
+				bool valid = true, self = true;
+				for (size_t d = 0, rest = code; d < 6; ++d, rest /= 3)
+				{
+					offset[d] = int(rest % 3) - 1;
+					valid &= offset[d] == 0 || (axes[d] && shape[d] > 1);
+					self &= offset[d] == 0;
+				}
+				if (!valid || self) continue;
+
+				ptrdiff_t flatOffset = 0;
+				for (size_t d = 0; d < 6; ++d)
+					flatOffset += ptrdiff_t(offset[d]) * ptrdiff_t(strides[d]);
+				stencil.m_offsets.push_back(offset);
+				stencil.m_flatOffsets.push_back(flatOffset);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Returns the neighbor stencil of the current PSF stack, rebuilding it only when the stack shape or axis method change. */
+		TiledSplatBlurComponent::PsfNeighborStencil const& neighborStencil(Scene::Scene& scene, Scene::Object* object)
+		{
+			TiledSplatBlurComponent& component = object->component<TiledSplatBlur::TiledSplatBlurComponent>();
+			TiledSplatBlurComponent::PsfNeighborStencil& stencil = component.m_psfNeighborStencil;
+
+			auto const& psfs = getPsfStack(scene, object).m_psfs;
+			Aberration::PsfIndex shape, strides;
+			for (size_t d = 0; d < 6; ++d)
+			{
+				shape[d] = psfs.shape()[d];
+				strides[d] = psfs.strides()[d];
+			}
+
+			if (stencil.m_shape != shape || stencil.m_strides != strides || stencil.m_psfAxisMethod != component.m_psfAxisMethod)
+				buildNeighborStencil(shape, strides, component.m_psfAxisMethod, stencil);
+
+			return stencil;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		size_t flatPsfIndex(TiledSplatBlurComponent::PsfNeighborStencil const& stencil, Aberration::PsfIndex const& psfIndex)
+		{
+			size_t result = 0;
+			for (size_t d = 0; d < 6; ++d)
+				result += psfIndex[d] * stencil.m_strides[d];
+			return result;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Calls the parameter function with the index and flat index of each neighbor of the parameter PSF. */
+		template<typename Fn>
+		void forEachPsfNeighbor(TiledSplatBlurComponent::PsfNeighborStencil const& stencil, Aberration::PsfIndex const& psfIndex, Fn const& fn)
+		{
+			const ptrdiff_t psfId = ptrdiff_t(flatPsfIndex(stencil, psfIndex));
+			for (size_t i = 0; i < stencil.m_offsets.size(); ++i)
+			{
+				Aberration::PsfIndex neighborIndex;
+				bool valid = true;
+				for (size_t d = 0; d < 6 && valid; ++d)
+				{
+					const ptrdiff_t coord = ptrdiff_t(psfIndex[d]) + stencil.m_offsets[i][d];
+					valid = coord >= 0 && coord < ptrdiff_t(stencil.m_shape[d]);
+					neighborIndex[d] = size_t(coord);
+				}
+				if (valid) fn(neighborIndex, size_t(psfId + stencil.m_flatOffsets[i]));
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		template<typename Fn>
+		void forEachPsfNeighbor(Scene::Scene& scene, Scene::Object* object, Aberration::PsfIndex const& psfIndex, Fn const& fn)
+		{
+			forEachPsfNeighbor(neighborStencil(scene, object), psfIndex, fn);
+		}
+
 		////////////////////////////////////////////////////////////////////////////////
 		// Returns the blur radius (in pixels) for the parameter PSF index at the input resolution and fovy setting
 		float blurRadius(Scene::Scene& scene, Scene::Object* object, glm::ivec2 resolution, float fovy,
@@ -491,13 +685,27 @@ namespace TiledSplatBlur
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		glm::ivec2 blurRadiusLimitsEntry(Scene::Scene& scene, Scene::Object* object,
+		/** Blur radius limits of a single PSF, across every supported resolution and fovy. */
+		glm::ivec2 blurRadiusLimitsSingle(Scene::Scene& scene, Scene::Object* object,
 			Aberration::PsfIndex const& psfIndex)
 		{
-			return blurRadiusLimits(scene, object,
+			return minMaxPred(scene, object,
 				Tiling::computeMaxRenderResolution(scene, object),
 				Tiling::computeFovyLimits(scene, object),
-				[&](auto const& neighborIndex) { return arePsfsSameOrNeighbors(scene, object, psfIndex, neighborIndex); });
+				glm::ivec2(INT_MAX, -INT_MAX), [](auto const&) { return true; }, psfIndex);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Blur radius limits of a PSF and its neighbors, from the per-PSF limits (indexed by flat PSF index). */
+		glm::ivec2 blurRadiusLimitsEntry(TiledSplatBlurComponent::PsfNeighborStencil const& stencil,
+			std::vector<glm::ivec2> const& psfLimits, Aberration::PsfIndex const& psfIndex)
+		{
+			glm::ivec2 result = psfLimits[flatPsfIndex(stencil, psfIndex)];
+			forEachPsfNeighbor(stencil, psfIndex, [&](Aberration::PsfIndex const& neighborIndex, const size_t neighborId)
+			{
+				result = glm::ivec2(glm::min(result[0], psfLimits[neighborId][0]), glm::max(result[1], psfLimits[neighborId][1]));
+			});
+			return result;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -556,13 +764,6 @@ namespace TiledSplatBlur
 			Aberration::freeCacheResources(scene, getAberration(scene, object));
 		}
 
-		////////////////////////////////////////////////////////////////////////////////
-		using PsfGpu = Eigen::Matrix<GLfloat, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
-		PsfGpu computeGpuPsf(Scene::Scene& scene, Scene::Object* object,
-			Aberration::PsfStackElements::PsfEntry const& psfEntry, const size_t radius)
-		{
-			return Aberration::resizePsfNormalized(scene, getAberration(scene, object), psfEntry.m_psf, radius).cast<GLfloat>();
-		}
 
 		////////////////////////////////////////////////////////////////////////////////
 		void updateDerivedParameters(Scene::Scene& scene, Scene::Object* object)
@@ -575,13 +776,25 @@ namespace TiledSplatBlur
 			// Resize the derived parameters vector
 			object->component<TiledSplatBlurComponent>().m_derivedPsfParameters.resize(numTotalPsfs);
 
+			// Build the neighbor stencil up front, so the worker threads only read it
+			TiledSplatBlurComponent::PsfNeighborStencil const& stencil = neighborStencil(scene, object);
+
+			// Blur radius limits of the individual PSFs
+			std::vector<glm::ivec2> psfLimits(numTotalPsfs);
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+				{
+					psfLimits[psfId] = Psfs::blurRadiusLimitsSingle(scene, object, Psfs::getPsfIndex(scene, object, psfId));
+				},
+				numTotalPsfs);
+
 			Threading::threadedExecuteIndices(Threading::numThreads(),
 				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
 				{
 					// Extract the psf and calculate the needed properties
 					const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
 					Aberration::PsfStackElements::PsfEntry const& psfEntry = Psfs::selectEntry(scene, object, psfIndex);
-					const glm::ivec2 blurRadii = Psfs::blurRadiusLimitsEntry(scene, object, psfIndex);
+					const glm::ivec2 blurRadii = Psfs::blurRadiusLimitsEntry(stencil, psfLimits, psfIndex);
 
 					// Remember the total number of weights for this PSF entry
 					const size_t numPsfWeights = Psfs::weightsPerEntry(blurRadii[0], blurRadii[1], 1);
@@ -1539,148 +1752,362 @@ namespace TiledSplatBlur
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		void uploadPsfData(Scene::Scene& scene, Scene::Object* object, const bool uploadParams, const bool uploadWeights,
-			Aberration::PsfIndex const& startIndex, Aberration::PsfIndex const& numIndices)
-		{
-			// Various numbers needed later
-			auto& psfStack = Psfs::getPsfStack(scene, object);
-			const size_t numDefocuses = psfStack.m_psfs.size();
-			const size_t numHorizontal = psfStack.m_psfs[0].size();
-			const size_t numVertical = psfStack.m_psfs[0][0].size();
-			const size_t numChannels = psfStack.m_psfs[0][0][0].size();
-			const size_t numApertures = psfStack.m_psfs[0][0][0][0].size();
-			const size_t numFocuses = psfStack.m_psfs[0][0][0][0][0].size();
+		// Number of weights generated and uploaded together
+		static constexpr size_t s_psfWeightChunkSize = 4 * 1024 * 1024;
 
-			// Extract the total number of PSFs and weights
-			const size_t numTotalPsfs = Psfs::numTotalPsfs(scene, object);
-			size_t numTotalWeights = 0;
+		////////////////////////////////////////////////////////////////////////////////
+		/** Receives a contiguous range of the PSF weight buffer; ranges arrive in arbitrary order. */
+		using PsfWeightSink = std::function<void(const size_t weightOffset, const GLfloat* weights, const size_t numWeights)>;
 
-			// Go through each PSF and upload the PSF parameters
-			std::vector<UniformDataPsfParam> psfParamBuffer(numTotalPsfs); // Parameters of the individual PSFs
+		////////////////////////////////////////////////////////////////////////////////
+		/** Sink that uploads the weights straight into the GPU weight buffer. */
+		PsfWeightSink gpuPsfWeightSink(Scene::Scene& scene)
+		{
+			return [&scene](const size_t weightOffset, const GLfloat* weights, const size_t numWeights)
 			{
-				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numTotalPsfs, DateTime::Seconds, "PSF Params");
+				Scene::uploadBufferSubData(scene, "TiledSplatBlur_PsfWeights", weightOffset * sizeof(GLfloat), numWeights * sizeof(GLfloat), weights);
+			};
+		}
 
-				for (size_t psfId = 0; psfId < numTotalPsfs; ++psfId)
-				{
-					// Extract the psf and calculate the needed properties
-					const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
+		////////////////////////////////////////////////////////////////////////////////
+		/** Sink that copies the weights into a host-side buffer, matching the layout of the GPU buffer. */
+		PsfWeightSink hostPsfWeightSink(std::vector<GLfloat>& buffer)
+		{
+			return [&buffer](const size_t weightOffset, const GLfloat* weights, const size_t numWeights)
+			{
+				std::memcpy(buffer.data() + weightOffset, weights, numWeights * sizeof(GLfloat));
+			};
+		}
 
-					// Extract the correponding derived PSF parameters
-					TiledSplatBlurComponent::DerivedPsfParameters& derivedPsfParameters =
-						object->component<TiledSplatBlurComponent>().m_derivedPsfParameters[psfId];
+		////////////////////////////////////////////////////////////////////////////////
+		/** A run of consecutive PSFs whose weights are generated and uploaded together. */
+		struct PsfWeightChunk
+		{
+			// Location of the chunk in the weight buffer
+			size_t m_weightOffset = 0;
+			size_t m_numWeights = 0;
 
-					// Store the relevant props in the output structure
-					UniformDataPsfParam& psfParameters = psfParamBuffer[psfId];
-					psfParameters.m_minBlurRadius = derivedPsfParameters.m_minBlurRadius;
-					psfParameters.m_maxBlurRadius = derivedPsfParameters.m_maxBlurRadius;
-					psfParameters.m_weightStartId = numTotalWeights;
-					psfParameters.m_blurRadiusDeg = derivedPsfParameters.m_blurRadiusDeg;
-
-					// Increment the weight start pointer
-					if (shouldUpdatePsf(psfIndex, startIndex, numIndices))
-						numTotalWeights += derivedPsfParameters.m_numPsfWeights;
-				}
-			}
+			// The PSFs in the chunk
+			std::vector<size_t> m_psfIds;
+		};
 
-			// Upload the generated data
-			if (uploadParams)
-				Scene::uploadBufferData(scene, "TiledSplatBlur_PsfParams", psfParamBuffer);
+		////////////////////////////////////////////////////////////////////////////////
+		/** Bounded pool of chunk buffers, passed between the generating threads and the uploading thread. */
+		struct PsfWeightChunkPool
+		{
+			// The reusable chunk buffers
+			std::vector<std::vector<GLfloat>> m_buffers;
 
-			// Skip the weight upload if not requested
-			if (!uploadWeights)
-				return;
+			// Buffers available for generation
+			std::vector<size_t> m_freeBuffers;
 
-			// Now actually upload the weights
-			std::vector<GLfloat> psfWeightBuffer(numTotalWeights);
-			{
-				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numTotalPsfs, DateTime::Seconds, "PSF Weights");
+			// Generated chunks waiting for upload (chunk id, buffer id)
+			std::deque<std::pair<size_t, size_t>> m_readyChunks;
+
+			// Synchronization
+			std::mutex m_lock;
+			std::condition_variable m_bufferFreed;
+			std::condition_variable m_chunkReady;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Generates the weights of the parameter chunks on the worker threads and hands them to the sink on the calling thread. */
+		void streamPsfWeights(Scene::Scene& scene, Scene::Object* object, Aberration::PsfResampler& resampler,
+			std::vector<UniformDataPsfParam> const& psfParamBuffer, std::vector<PsfWeightChunk> const& chunks, PsfWeightSink const& sink)
+		{
+			if (chunks.empty()) return;
 
+			// At most one buffer per worker plus the one being uploaded, which caps the host memory in use
+			PsfWeightChunkPool pool;
+			const size_t numBuffers = std::min(chunks.size(), size_t(Threading::numThreads()) + 1);
+			pool.m_buffers.resize(numBuffers);
+			for (size_t bufferId = 0; bufferId < numBuffers; ++bufferId)
+				pool.m_freeBuffers.push_back(bufferId);
+
+			// Generate the chunks in the background
+			std::thread producer([&]()
+			{
 				Threading::threadedExecuteIndices(Threading::numThreads(),
-					[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+					[&](Threading::ThreadedExecuteEnvironment const& environment, size_t chunkId)
 				{
-					// Extract the psf and calculate the needed properties
-					const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
-					Aberration::PsfStackElements::PsfEntry const& psfEntry = Psfs::selectEntry(scene, object, psfIndex);
+					PsfWeightChunk const& chunk = chunks[chunkId];
 
-					// Ignore PSFs that we shouldn't upload
-					if (!shouldUpdatePsf(psfIndex, startIndex, numIndices)) return;
+					// Wait for a free buffer
+					size_t bufferId = 0;
+					{
+						std::unique_lock<std::mutex> lock(pool.m_lock);
+						pool.m_bufferFreed.wait(lock, [&]() { return !pool.m_freeBuffers.empty(); });
+						bufferId = pool.m_freeBuffers.back();
+						pool.m_freeBuffers.pop_back();
+					}
+
+					// Store the downscaled PSFs in all the relevant radii
+					std::vector<GLfloat>& buffer = pool.m_buffers[bufferId];
+					buffer.resize(chunk.m_numWeights);
+					Aberration::Psf psfScratch;
+					for (size_t psfId : chunk.m_psfIds)
+					{
+						const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
+						Aberration::PsfStackElements::PsfEntry const& psfEntry = Psfs::selectEntry(scene, object, psfIndex);
+						Aberration::Psf const& psf = Aberration::getPsf(scene, Psfs::getAberration(scene, object), psfEntry, psfScratch);
+						UniformDataPsfParam const& psfParameters = psfParamBuffer[psfId];
 
-					// Extract the PSF properties
-					UniformDataPsfParam const& psfParameters = psfParamBuffer[psfId];
+						GLfloat* writePtr = buffer.data() + (psfParameters.m_weightStartId - chunk.m_weightOffset);
+						for (size_t radius = psfParameters.m_minBlurRadius; radius <= psfParameters.m_maxBlurRadius; ++radius)
+						{
+							const size_t diameter = radius * 2 + 1;
+							Aberration::resamplePsfNormalized(resampler, psf, radius, writePtr);
+							writePtr += diameter * diameter;
+						}
+					}
 
-					// Store the downscaled PSF in all the relevant radii
-					GLfloat* writePtr = &psfWeightBuffer[psfParameters.m_weightStartId];
-					for (size_t radius = psfParameters.m_minBlurRadius; radius <= psfParameters.m_maxBlurRadius; ++radius)
+					// Hand it over for uploading
 					{
-						const size_t diameter = radius * 2 + 1;
-						const size_t numWeights = diameter * diameter;
-						Psfs::PsfGpu::Map(writePtr, diameter, diameter) = Psfs::computeGpuPsf(scene, object, psfEntry, radius);
-						writePtr += numWeights;
+						std::lock_guard<std::mutex> lock(pool.m_lock);
+						pool.m_readyChunks.emplace_back(chunkId, bufferId);
 					}
+					pool.m_chunkReady.notify_one();
 				},
-				numTotalPsfs);
+				chunks.size());
+			});
+
+			// Upload the finished chunks; this must happen on the thread owning the GL context
+			for (size_t numUploaded = 0; numUploaded < chunks.size(); ++numUploaded)
+			{
+				std::pair<size_t, size_t> readyChunk;
+				{
+					std::unique_lock<std::mutex> lock(pool.m_lock);
+					pool.m_chunkReady.wait(lock, [&]() { return !pool.m_readyChunks.empty(); });
+					readyChunk = pool.m_readyChunks.front();
+					pool.m_readyChunks.pop_front();
+				}
+
+				auto const& [chunkId, bufferId] = readyChunk;
+				sink(chunks[chunkId].m_weightOffset, pool.m_buffers[bufferId].data(), chunks[chunkId].m_numWeights);
+
+				{
+					std::lock_guard<std::mutex> lock(pool.m_lock);
+					pool.m_freeBuffers.push_back(bufferId);
+				}
+				pool.m_bufferFreed.notify_one();
 			}
 
-			// Upload the generated data
-			Scene::resizeGPUBuffer(scene, "TiledSplatBlur_PsfWeights", numTotalWeights * sizeof(GLfloat), true);
-			Scene::uploadBufferData(scene, "TiledSplatBlur_PsfWeights", psfWeightBuffer);
+			producer.join();
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		void uploadPsfData(Scene::Scene& scene, Scene::Object* object)
+		/** Fills the parameters of every PSF in the stack, and returns the number of weights needed by the selected ones. */
+		size_t buildPsfParams(Scene::Scene& scene, Scene::Object* object, Aberration::PsfIndex const& startIndex, Aberration::PsfIndex const& numIndices,
+			std::vector<UniformDataPsfParam>& psfParamBuffer)
 		{
-			// Various numbers needed later
-			auto& aberration = Psfs::getAberration(scene, object);
-			auto& psfStack = Psfs::getPsfStack(scene, object);
-			const size_t numDefocuses = psfStack.m_psfs.size();
-			const size_t numHorizontal = psfStack.m_psfs[0].size();
-			const size_t numVertical = psfStack.m_psfs[0][0].size();
-			const size_t numChannels = psfStack.m_psfs[0][0][0].size();
-			const size_t numApertures = psfStack.m_psfs[0][0][0][0].size();
-			const size_t numFocuses = psfStack.m_psfs[0][0][0][0][0].size();
-			auto const& psfParameters = aberration.m_psfParameters.m_evaluatedParameters;
+			// Extract the total number of PSFs and weights
+			const size_t numTotalPsfs = Psfs::numTotalPsfs(scene, object);
+			size_t numTotalWeights = 0;
 
-			// Generate on-axis PSF data
-			if (object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfAxisMethod == TiledSplatBlur::TiledSplatBlurComponent::OnAxis)
-			{
-				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, 1, DateTime::Seconds, "PSF Data Upload");
+			DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numTotalPsfs, DateTime::Seconds, "PSF Params");
 
-				// Upload all the weights in one go
-				uploadPsfData(scene, object, true, true,
-					Aberration::PsfIndex{ 0, 0, 0, 0, 0, 0 },
-					Aberration::PsfIndex{ numDefocuses, numHorizontal, numVertical, numChannels, numApertures, numFocuses });
+			// Go through each PSF and store the PSF parameters
+			psfParamBuffer.resize(numTotalPsfs);
+			for (size_t psfId = 0; psfId < numTotalPsfs; ++psfId)
+			{
+				// Extract the psf and calculate the needed properties
+				const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
+
+				// Extract the correponding derived PSF parameters
+				TiledSplatBlurComponent::DerivedPsfParameters& derivedPsfParameters =
+					object->component<TiledSplatBlurComponent>().m_derivedPsfParameters[psfId];
+
+				// Store the relevant props in the output structure
+				UniformDataPsfParam& psfParameters = psfParamBuffer[psfId];
+				psfParameters.m_minBlurRadius = derivedPsfParameters.m_minBlurRadius;
+				psfParameters.m_maxBlurRadius = derivedPsfParameters.m_maxBlurRadius;
+				psfParameters.m_weightStartId = numTotalWeights;
+				psfParameters.m_blurRadiusDeg = derivedPsfParameters.m_blurRadiusDeg;
+
+				// Increment the weight start pointer
+				if (shouldUpdatePsf(psfIndex, startIndex, numIndices))
+					numTotalWeights += derivedPsfParameters.m_numPsfWeights;
 			}
 
-			// Generate texture parameters with off-axis angles
-			if (object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfAxisMethod == TiledSplatBlur::TiledSplatBlurComponent::OffAxis)
-			{
-				// Generate the shader parameters
-				const Shaders::ShaderParameters shaderParameters = Shaders::ShaderParameters(scene, object);
+			return numTotalWeights;
+		}
 
-				// Some necessary objects
-				Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
-				Scene::Object* camera = RenderSettings::getMainCamera(scene, renderSettings);
-				const glm::ivec2 minMaxRadiusGlobal = Psfs::blurRadiusLimitsGlobal(scene, object);
+		////////////////////////////////////////////////////////////////////////////////
+		/** Splits the selected PSFs into chunks of at most the given number of weights, and builds the shared resampling filters. */
+		void preparePsfWeights(Scene::Scene& scene, Scene::Object* object, Aberration::PsfIndex const& startIndex, Aberration::PsfIndex const& numIndices,
+			std::vector<UniformDataPsfParam> const& psfParamBuffer, const size_t maxChunkWeights, std::vector<PsfWeightChunk>& chunks, Aberration::PsfResampler& resampler)
+		{
+			const size_t numTotalPsfs = Psfs::numTotalPsfs(scene, object);
 
-				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numApertures * numFocuses, DateTime::Seconds, "PSF Data Upload");
+			// Collect the distinct PSF sizes and the radius range of the PSFs to upload, and split them into chunks
+			std::vector<std::pair<size_t, size_t>> psfSizes;
+			size_t minRadius = std::numeric_limits<size_t>::max(), maxRadius = 0;
+			chunks.clear();
+			for (size_t psfId = 0; psfId < numTotalPsfs; ++psfId)
+			{
+				const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
+				if (!shouldUpdatePsf(psfIndex, startIndex, numIndices)) continue;
 
-				// Generate each slice
-				for (size_t a = 0; a < numApertures; ++a)
-				for (size_t f = 0; f < numFocuses; ++f)
+				const size_t numPsfWeights = object->component<TiledSplatBlurComponent>().m_derivedPsfParameters[psfId].m_numPsfWeights;
+				if (chunks.empty() || (chunks.back().m_numWeights > 0 && chunks.back().m_numWeights + numPsfWeights > maxChunkWeights))
 				{
-					// Upload the relevant PSF weights
-					uploadPsfData(scene, object, true, true,
-						Aberration::PsfIndex{ 0, 0, 0, 0, a, f },
-						Aberration::PsfIndex{ numDefocuses, numHorizontal, numVertical, numChannels, 1, 1 });
+					chunks.emplace_back();
+					chunks.back().m_weightOffset = psfParamBuffer[psfId].m_weightStartId;
+				}
+				chunks.back().m_psfIds.push_back(psfId);
+				chunks.back().m_numWeights += numPsfWeights;
 
-					// Upload the necessary uniforms	
-					TiledSplatBlur::UniformDataCommon blurDataCommon;
-					blurDataCommon.m_renderResolution = Tiling::computeRenderResolution(scene, object);
-					blurDataCommon.m_paddedResolution = Tiling::computePaddedResolution(scene, object);
-					blurDataCommon.m_cameraFov = glm::degrees(Camera::getFieldOfView(renderSettings, camera));
-					blurDataCommon.m_psfLayersS = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersS, 0.0f);
-					blurDataCommon.m_psfLayersP = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersP, 0.0f);
-					blurDataCommon.m_minBlurRadiusGlobal = minMaxRadiusGlobal[0];
+				const std::pair<size_t, size_t> psfSize = Aberration::getPsfSize(Psfs::selectEntry(scene, object, psfIndex));
+				if (std::find(psfSizes.begin(), psfSizes.end(), psfSize) == psfSizes.end())
+					psfSizes.push_back(psfSize);
+
+				minRadius = std::min(minRadius, size_t(psfParamBuffer[psfId].m_minBlurRadius));
+				maxRadius = std::max(maxRadius, size_t(psfParamBuffer[psfId].m_maxBlurRadius));
+			}
+
+			// Precompute the resampling filters, shared by every PSF
+			if (!psfSizes.empty())
+			{
+				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, psfSizes.size(), DateTime::Seconds, "PSF Resampling Filters");
+				Aberration::initPsfResampler(scene, Psfs::getAberration(scene, object), resampler, psfSizes, minRadius, maxRadius);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Generates the weights of the selected PSFs and hands them to the parameter sink. */
+		void generatePsfWeights(Scene::Scene& scene, Scene::Object* object, Aberration::PsfIndex const& startIndex, Aberration::PsfIndex const& numIndices,
+			std::vector<UniformDataPsfParam> const& psfParamBuffer, PsfWeightSink const& sink, const size_t maxChunkWeights = s_psfWeightChunkSize)
+		{
+			std::vector<PsfWeightChunk> chunks;
+			Aberration::PsfResampler resampler;
+			preparePsfWeights(scene, object, startIndex, numIndices, psfParamBuffer, maxChunkWeights, chunks, resampler);
+
+			// Now actually generate the weights, chunk by chunk
+			{
+				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, Psfs::numTotalPsfs(scene, object), DateTime::Seconds, "PSF Weights");
+
+				streamPsfWeights(scene, object, resampler, psfParamBuffer, chunks, sink);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Generates the weights of the selected PSFs into a single host buffer, the way they were produced before chunked streaming. */
+		std::vector<GLfloat> generatePsfWeightsMonolithic(Scene::Scene& scene, Scene::Object* object, Aberration::PsfIndex const& startIndex, Aberration::PsfIndex const& numIndices,
+			std::vector<UniformDataPsfParam> const& psfParamBuffer, const size_t numTotalWeights)
+		{
+			const size_t numTotalPsfs = Psfs::numTotalPsfs(scene, object);
+
+			std::vector<PsfWeightChunk> chunks;
+			Aberration::PsfResampler resampler;
+			preparePsfWeights(scene, object, startIndex, numIndices, psfParamBuffer, s_psfWeightChunkSize, chunks, resampler);
+
+			std::vector<GLfloat> psfWeightBuffer(numTotalWeights);
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+			{
+				// Extract the psf and calculate the needed properties
+				const Aberration::PsfIndex psfIndex = Psfs::getPsfIndex(scene, object, psfId);
+
+				// Ignore PSFs that we shouldn't upload
+				if (!shouldUpdatePsf(psfIndex, startIndex, numIndices)) return;
+
+				Aberration::PsfStackElements::PsfEntry const& psfEntry = Psfs::selectEntry(scene, object, psfIndex);
+				Aberration::Psf psfScratch;
+				Aberration::Psf const& psf = Aberration::getPsf(scene, Psfs::getAberration(scene, object), psfEntry, psfScratch);
+				UniformDataPsfParam const& psfParameters = psfParamBuffer[psfId];
+
+				// Store the downscaled PSF in all the relevant radii
+				GLfloat* writePtr = psfWeightBuffer.data() + psfParameters.m_weightStartId;
+				for (size_t radius = psfParameters.m_minBlurRadius; radius <= psfParameters.m_maxBlurRadius; ++radius)
+				{
+					const size_t diameter = radius * 2 + 1;
+					Aberration::resamplePsfNormalized(resampler, psf, radius, writePtr);
+					writePtr += diameter * diameter;
+				}
+			},
+			numTotalPsfs);
+
+			return psfWeightBuffer;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void uploadPsfData(Scene::Scene& scene, Scene::Object* object, const bool uploadParams, const bool uploadWeights,
+			Aberration::PsfIndex const& startIndex, Aberration::PsfIndex const& numIndices)
+		{
+			// Compute the parameters of the individual PSFs
+			std::vector<UniformDataPsfParam> psfParamBuffer;
+			const size_t numTotalWeights = buildPsfParams(scene, object, startIndex, numIndices, psfParamBuffer);
+
+			// Upload the generated data
+			if (uploadParams)
+				Scene::uploadBufferDataStaged(scene, "TiledSplatBlur_PsfParams", psfParamBuffer);
+
+			// Skip the weight upload if not requested
+			if (!uploadWeights)
+				return;
+
+			// Make room for the weights
+			Scene::resizeGPUBuffer(scene, "TiledSplatBlur_PsfWeights", numTotalWeights * sizeof(GLfloat), true);
+
+			// Generate and upload the weights
+			generatePsfWeights(scene, object, startIndex, numIndices, psfParamBuffer, gpuPsfWeightSink(scene));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void uploadPsfData(Scene::Scene& scene, Scene::Object* object)
+		{
+			// Various numbers needed later
+			auto& aberration = Psfs::getAberration(scene, object);
+			auto& psfStack = Psfs::getPsfStack(scene, object);
+			const size_t numDefocuses = psfStack.m_psfs.size();
+			const size_t numHorizontal = psfStack.m_psfs[0].size();
+			const size_t numVertical = psfStack.m_psfs[0][0].size();
+			const size_t numChannels = psfStack.m_psfs[0][0][0].size();
+			const size_t numApertures = psfStack.m_psfs[0][0][0][0].size();
+			const size_t numFocuses = psfStack.m_psfs[0][0][0][0][0].size();
+			auto const& psfParameters = aberration.m_psfParameters.m_evaluatedParameters;
+
+			// Generate on-axis PSF data
+			if (object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfAxisMethod == TiledSplatBlur::TiledSplatBlurComponent::OnAxis)
+			{
+				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, 1, DateTime::Seconds, "PSF Data Upload");
+
+				// Upload all the weights in one go
+				uploadPsfData(scene, object, true, true,
+					Aberration::PsfIndex{ 0, 0, 0, 0, 0, 0 },
+					Aberration::PsfIndex{ numDefocuses, numHorizontal, numVertical, numChannels, numApertures, numFocuses });
+			}
+
+			// Generate texture parameters with off-axis angles
+			if (object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfAxisMethod == TiledSplatBlur::TiledSplatBlurComponent::OffAxis)
+			{
+				// Generate the shader parameters
+				const Shaders::ShaderParameters shaderParameters = Shaders::ShaderParameters(scene, object);
+
+				// Some necessary objects
+				Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+				Scene::Object* camera = RenderSettings::getMainCamera(scene, renderSettings);
+				const glm::ivec2 minMaxRadiusGlobal = Psfs::blurRadiusLimitsGlobal(scene, object);
+
+				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numApertures * numFocuses, DateTime::Seconds, "PSF Data Upload");
+
+				// Generate each slice
+				for (size_t a = 0; a < numApertures; ++a)
+				for (size_t f = 0; f < numFocuses; ++f)
+				{
+					// Upload the relevant PSF weights
+					uploadPsfData(scene, object, true, true,
+						Aberration::PsfIndex{ 0, 0, 0, 0, a, f },
+						Aberration::PsfIndex{ numDefocuses, numHorizontal, numVertical, numChannels, 1, 1 });
+
+					// Upload the necessary uniforms	
+					TiledSplatBlur::UniformDataCommon blurDataCommon;
+					blurDataCommon.m_renderResolution = Tiling::computeRenderResolution(scene, object);
+					blurDataCommon.m_paddedResolution = Tiling::computePaddedResolution(scene, object);
+					blurDataCommon.m_cameraFov = glm::degrees(Camera::getFieldOfView(renderSettings, camera));
+					blurDataCommon.m_psfLayersS = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersS, 0.0f);
+					blurDataCommon.m_psfLayersP = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersP, 0.0f);
+					blurDataCommon.m_minBlurRadiusGlobal = minMaxRadiusGlobal[0];
 					blurDataCommon.m_maxBlurRadiusGlobal = minMaxRadiusGlobal[1];
 					blurDataCommon.m_numDefocuses = numDefocuses;
 					blurDataCommon.m_numHorizontalAngles = numHorizontal;
@@ -1703,7 +2130,7 @@ namespace TiledSplatBlur
 					blurDataCommon.m_incidentAnglesVertMin = psfParameters.m_incidentAnglesVertical.front();
 					blurDataCommon.m_incidentAnglesVertMax = psfParameters.m_incidentAnglesVertical.back();
 					blurDataCommon.m_incidentAnglesVertStep = psfParameters.m_incidentAnglesVerticalRange.m_step;
-					uploadBufferData(scene, "TiledSplatBlurCommon", blurDataCommon);
+					uploadTransientBufferData(scene, "TiledSplatBlurCommon", blurDataCommon);
 
 					// Bind all the necessary buffers
 					for (auto const& bufferName : Buffers::bufferNames(scene, object))
@@ -1735,140 +2162,1790 @@ namespace TiledSplatBlur
 					glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
 				}
 
-				// Generate PSF parameters
-				bindShader(scene, object, "psf_cache_params", shaderParameters);
-				glDispatchCompute(1, 1, 1);
-				glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);				
+				// Generate PSF parameters
+				bindShader(scene, object, "psf_cache_params", shaderParameters);
+				glDispatchCompute(1, 1, 1);
+				glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);				
+
+				// Get rid of the temporary PSF weights buffer by resizing it
+				Scene::resizeGPUBuffer(scene, "TiledSplatBlur_PsfWeights", sizeof(GLfloat), false);
+
+				// Log the total raw PSF memory
+				const size_t totalRawMemory = Psfs::numTotalWeights(scene, object) * sizeof(GLfloat);
+				Debug::log_debug() << "Number of raw PSF data: " << Units::bytesToString(totalRawMemory) << Debug::end;
+
+				// Also do a PSF texture size comparison
+				PsfTexture::textureDimensionsComparisonOffAxis(scene, object);
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace Uniforms
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** Fills the common uniform block for rendering at the parameter resolution. */
+		UniformDataCommon commonData(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera, Scene::Object* object, glm::ivec2 renderResolution)
+		{
+			// Aberration and PSF stack
+			auto& aberration = Psfs::getAberration(scene, object);
+			auto& psfStack = Psfs::getPsfStack(scene, object);
+			const size_t numDefocuses = psfStack.m_psfs.size();
+			const size_t numHorizontal = psfStack.m_psfs[0].size();
+			const size_t numVertical = psfStack.m_psfs[0][0].size();
+			const size_t numChannels = psfStack.m_psfs[0][0][0].size();
+			const size_t numApertures = psfStack.m_psfs[0][0][0][0].size();
+			const size_t numFocuses = psfStack.m_psfs[0][0][0][0][0].size();
+			auto const& psfParameters = aberration.m_psfParameters.m_evaluatedParameters;
+
+			// Tiling properties
+			const glm::ivec2 numTiles = Tiling::computeNumTiles(scene, object, renderResolution);
+			const glm::ivec2 paddedResolution = Tiling::computePaddedResolution(scene, object, renderResolution);
+			const size_t mergedFragmentSize = Tiling::fragmentBlockSize(scene, object);
+
+			// Find the minimum and maximum blur radius
+			// TODO: consider the current aperture and focus settings to determine this
+			const glm::ivec2 minMaxRadiusCurrent = Psfs::blurRadiusLimitsCurrent(scene, object);
+			const glm::ivec2 minMaxRadiusGlobal = Psfs::blurRadiusLimitsGlobal(scene, object);
+
+			// Maximum buffer sizes with the current configuration
+			const size_t tileSize = object->component<TiledSplatBlurComponent>().m_tileSize;
+			const size_t numLayers = renderSettings->component<RenderSettings::RenderSettingsComponent>().m_layers.m_numLayers;
+			const size_t fragmentBufferMaxSubentries = Tiling::fragmentBufferMaxFragmentsPerEntry(scene, object, numLayers);
+			const size_t tileBufferMaxCenterSubentries = Tiling::tileBufferMaxCenterFragmentsPerEntry(numLayers, tileSize);
+			const size_t tileBufferMaxSubentries = Tiling::tileBufferMaxFragmentsPerEntry(numLayers, tileSize, minMaxRadiusCurrent[1]);
+			const size_t maxSharedIndices = Tiling::tileBufferMaxSortSharedElements(scene, object, tileBufferMaxSubentries);
+			const size_t numSortIterations = Tiling::tileBufferMaxSortIterations(tileBufferMaxSubentries, maxSharedIndices);
+
+			TiledSplatBlur::UniformDataCommon blurDataCommon;
+			blurDataCommon.m_numTiles = numTiles;
+			blurDataCommon.m_renderResolution = renderResolution;
+			blurDataCommon.m_paddedResolution = paddedResolution;
+			blurDataCommon.m_cameraFov = glm::degrees(Camera::getFieldOfView(renderSettings, camera));
+			blurDataCommon.m_fragmentBufferSubentries = fragmentBufferMaxSubentries;
+			blurDataCommon.m_tileBufferCenterSubentries = tileBufferMaxCenterSubentries;
+			blurDataCommon.m_tileBufferTotalSubentries = tileBufferMaxSubentries;
+			blurDataCommon.m_numSortIterations = numSortIterations;
+
+			blurDataCommon.m_psfAxisMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfAxisMethod;
+			blurDataCommon.m_psfTextureFormat = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfTextureFormat;
+			blurDataCommon.m_psfTextureDepthLayout = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfTextureDepthLayout;
+			blurDataCommon.m_psfTextureAngleLayout = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfTextureAngleLayout;
+			blurDataCommon.m_weightScaleMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_weightScaleMethod;
+			blurDataCommon.m_weightRescaleMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_weightRescaleMethod;
+			blurDataCommon.m_outputMode = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_outputMode;
+			blurDataCommon.m_overlayMode = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_overlayMode;
+			blurDataCommon.m_accumulationMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_accumulationMethod;
+
+			blurDataCommon.m_psfLayersS = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersS, 0.0f);
+			blurDataCommon.m_psfLayersP = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersP, 0.0f);
+
+			blurDataCommon.m_numMergeSteps = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_fragmentMergeSteps;
+			blurDataCommon.m_mergedFragmentSize = mergedFragmentSize;
+
+			blurDataCommon.m_sortOffsetConstant = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_sortDepthOffset;
+			blurDataCommon.m_sortOffsetScale = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_sortDepthScale;
+
+			blurDataCommon.m_renderChannels = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_numWavelengths;
+			blurDataCommon.m_renderLayers = renderSettings->component<RenderSettings::RenderSettingsComponent>().m_layers.m_numLayers;
+			blurDataCommon.m_depthOffset = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_depthOffset;
+			blurDataCommon.m_alphaThreshold = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_alphaThreshold;
+			blurDataCommon.m_normalizeResult = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_normalizeResult ? 1.0f : 0.0f;
+
+			blurDataCommon.m_minBlurRadiusCurrent = minMaxRadiusCurrent[0];
+			blurDataCommon.m_maxBlurRadiusCurrent = minMaxRadiusCurrent[1];
+			blurDataCommon.m_minBlurRadiusGlobal = minMaxRadiusGlobal[0];
+			blurDataCommon.m_maxBlurRadiusGlobal = minMaxRadiusGlobal[1];
+			blurDataCommon.m_numDefocuses = numDefocuses;
+			blurDataCommon.m_numHorizontalAngles = numHorizontal;
+			blurDataCommon.m_numVerticalAngles = numVertical;
+			blurDataCommon.m_numChannels = numChannels;
+			blurDataCommon.m_numApertures = numApertures;
+			blurDataCommon.m_numFocuses = numFocuses;
+			blurDataCommon.m_objectDistancesMin = psfParameters.m_objectDioptres.front();
+			blurDataCommon.m_objectDistancesMax = psfParameters.m_objectDioptres.back();
+			blurDataCommon.m_objectDistancesStep = psfParameters.m_objectDistancesRange.m_step;
+			blurDataCommon.m_apertureMin = psfParameters.m_apertureDiameters.front();
+			blurDataCommon.m_apertureMax = psfParameters.m_apertureDiameters.back();
+			blurDataCommon.m_apertureStep = psfParameters.m_apertureDiametersRange.m_step;
+			blurDataCommon.m_focusDistanceMin = psfParameters.m_focusDioptres.front();
+			blurDataCommon.m_focusDistanceMax = psfParameters.m_focusDioptres.back();
+			blurDataCommon.m_focusDistanceStep = psfParameters.m_focusDistancesRange.m_step;
+			blurDataCommon.m_incidentAnglesHorMin = psfParameters.m_incidentAnglesHorizontal.front();
+			blurDataCommon.m_incidentAnglesHorMax = psfParameters.m_incidentAnglesHorizontal.back();
+			blurDataCommon.m_incidentAnglesHorStep = psfParameters.m_incidentAnglesHorizontalRange.m_step;
+			blurDataCommon.m_incidentAnglesVertMin = psfParameters.m_incidentAnglesVertical.front();
+			blurDataCommon.m_incidentAnglesVertMax = psfParameters.m_incidentAnglesVertical.back();
+			blurDataCommon.m_incidentAnglesVertStep = psfParameters.m_incidentAnglesVerticalRange.m_step;
+
+			return blurDataCommon;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace CpuReference
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** Unpacked fragment, mirroring FragmentData in the shaders. */
+		struct FragmentData
+		{
+			glm::vec3 m_color{ 0.0f };
+			glm::vec2 m_screenPosition{ 0.0f };
+			glm::vec3 m_psfIndex{ 0.0f };
+			GLuint m_fragmentSize = 0;
+			GLuint m_blurRadius = 0;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Mirrors SplatIndex in the shaders. */
+		struct SplatIndex
+		{
+			glm::ivec2 m_tileId;
+			GLuint m_fragmentIndex;
+			GLfloat m_fragmentDepth;
+			GLfloat m_blurRadius;
+			glm::vec2 m_screenPosition;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Mirrors SortIndex in the shaders. */
+		struct SortIndex
+		{
+			GLuint m_index;
+			GLfloat m_depth;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Mirrors an entry of the tile parameter buffer. */
+		struct TileParameters
+		{
+			GLuint m_numFragmentsTile = 0;
+			GLuint m_numFragmentsTotal = 0;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Host-side copies of the GPU buffers, along with the settings shared by the stages. */
+		struct Context
+		{
+			// Common uniforms, exactly as uploaded for the GPU path
+			UniformDataCommon m_common;
+
+			// Tile sizes, in pixels and in merged fragments
+			int m_tileSize = 0;
+			int m_mergedTileSize = 0;
+
+			// Number of channels to evaluate
+			GLuint m_renderChannels = 0;
+
+			// Aperture and focus indices of the camera
+			glm::vec3 m_apertureIds{ 0.0f };
+			glm::vec3 m_focusIds{ 0.0f };
+
+			// PSF parameter and weight buffers
+			std::vector<UniformDataPsfParam> m_psfParams;
+			std::vector<GLfloat> m_psfWeights;
+
+			// Interpolated PSF blur radii (in pixels), per object distance and channel
+			std::vector<GLfloat> m_interpolatedBlurRadii;
+
+			// Fragment and tile buffers
+			std::vector<FragmentData> m_fragments;
+			std::vector<TileParameters> m_tileParameters;
+			std::vector<SplatIndex> m_tileSplats;
+			std::vector<SortIndex> m_tileSorts;
+
+			// Start of each tile's entries in the splat buffer; replaces the atomic counter of the GPU path
+			std::vector<GLuint> m_tileSplatOffsets;
+
+			// Per-thread scratch arrays for sorting and convolution
+			std::array<std::vector<SortIndex>, Constants::s_maxThreads> m_sortScratch;
+			std::array<std::vector<FragmentData>, Constants::s_maxThreads> m_tileFragmentScratch;
+
+			// Number of splats that did not fit in their tile's buffer
+			std::atomic<size_t> m_numDroppedSplats{ 0 };
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		int roundedDiv(const int a, const int b)
+		{
+			return (a + b - 1) / b;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		int numTiles(Context const& context)
+		{
+			return int(context.m_common.m_numTiles.x * context.m_common.m_numTiles.y);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		glm::ivec2 tileIdFromIndex(Context const& context, const size_t tileIndex)
+		{
+			return glm::ivec2(tileIndex % context.m_common.m_numTiles.x, tileIndex / context.m_common.m_numTiles.x);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// PSF index functions
+		////////////////////////////////////////////////////////////////////////////////
+
+		////////////////////////////////////////////////////////////////////////////////
+		glm::vec3 makeIndices(const float index)
+		{
+			return glm::vec3(glm::floor(index), glm::ceil(index), index);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		glm::vec3 clampPsfIndices(const float index, const GLuint numPsfs)
+		{
+			return glm::clamp(makeIndices(index), glm::vec3(0.0f), glm::vec3(float(numPsfs - 1)));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Index along a PSF axis; single-entry axes (with a zero step) always map to 0. */
+		glm::vec3 axisIndices(const float value, const float min, const float step, const GLuint numPsfs)
+		{
+			return clampPsfIndices(numPsfs <= 1 ? 0.0f : (value - min) / step, numPsfs);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		glm::vec3 objectDistanceIndices(Context const& context, const float distance)
+		{
+			return axisIndices(1.0f / distance, context.m_common.m_objectDistancesMin, context.m_common.m_objectDistancesStep, context.m_common.m_numDefocuses);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Index of a PSF in the parameter buffer; matches the storage order of the PSF stack. */
+		size_t psfArrayIndex(Context const& context, const size_t d, const size_t h, const size_t v, const size_t c, const size_t a, const size_t f)
+		{
+			UniformDataCommon const& common = context.m_common;
+			return ((((d * common.m_numHorizontalAngles + h) * common.m_numVerticalAngles + v) * common.m_numChannels + c) * common.m_numApertures + a) * common.m_numFocuses + f;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Index of the on-axis PSF with the parameter object distance, channel, aperture and focus. */
+		size_t psfArrayIndex(Context const& context, const size_t d, const size_t c, const size_t a, const size_t f)
+		{
+			return psfArrayIndex(context, d, context.m_common.m_numHorizontalAngles / 2, context.m_common.m_numVerticalAngles / 2, c, a, f);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Bilinearly interpolates a PSF property across the aperture and focus axes. */
+		template<typename Fn>
+		float lerpApertureFocus(Context const& context, Fn const& property)
+		{
+			const glm::ivec2 a = glm::ivec2(context.m_apertureIds[0], context.m_apertureIds[1]);
+			const glm::ivec2 f = glm::ivec2(context.m_focusIds[0], context.m_focusIds[1]);
+			const glm::vec2 alpha = glm::vec2(glm::fract(context.m_apertureIds[2]), glm::fract(context.m_focusIds[2]));
+
+			// Skip the neighbors that do not contribute
+			const float f0 = alpha.x == 0.0f ? property(a[0], f[0]) : glm::mix(property(a[0], f[0]), property(a[1], f[0]), alpha.x);
+			if (alpha.y == 0.0f) return f0;
+			const float f1 = alpha.x == 0.0f ? property(a[0], f[1]) : glm::mix(property(a[0], f[1]), property(a[1], f[1]), alpha.x);
+			return glm::mix(f0, f1, alpha.y);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Blur radius functions
+		////////////////////////////////////////////////////////////////////////////////
+
+		////////////////////////////////////////////////////////////////////////////////
+		float projectBlurRadius(Context const& context, const float blurRadiusDeg)
+		{
+			return glm::clamp((blurRadiusDeg / context.m_common.m_cameraFov[1]) * context.m_common.m_renderResolution[1],
+				0.0f, float(context.m_common.m_maxBlurRadiusGlobal));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Interpolates the blur radii for the current camera state (interpolatePsfParams in the shaders). */
+		void interpolatePsfParams(Context& context)
+		{
+			context.m_interpolatedBlurRadii.resize(context.m_common.m_numDefocuses * context.m_common.m_numChannels);
+			for (size_t d = 0; d < context.m_common.m_numDefocuses; ++d)
+			for (size_t c = 0; c < context.m_common.m_numChannels; ++c)
+			{
+				const float blurRadiusDeg = lerpApertureFocus(context, [&](const size_t a, const size_t f)
+				{
+					return context.m_psfParams[psfArrayIndex(context, d, c, a, f)].m_blurRadiusDeg;
+				});
+				context.m_interpolatedBlurRadii[d * context.m_common.m_numChannels + c] = projectBlurRadius(context, blurRadiusDeg);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float blurRadius(Context const& context, glm::vec3 const& sphericalCoords, const GLuint channelId)
+		{
+			const glm::vec3 psfIds = objectDistanceIndices(context, sphericalCoords.z);
+			return glm::mix(
+				context.m_interpolatedBlurRadii[size_t(psfIds[0]) * context.m_common.m_numChannels + channelId],
+				context.m_interpolatedBlurRadii[size_t(psfIds[1]) * context.m_common.m_numChannels + channelId],
+				glm::fract(psfIds[2]));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float minBlurRadius(Context const& context, glm::vec3 const& sphericalCoords)
+		{
+			float result = std::numeric_limits<float>::max();
+			for (GLuint channelId = 0; channelId < context.m_renderChannels; ++channelId)
+				result = glm::min(result, blurRadius(context, sphericalCoords, channelId));
+			return result;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float maxBlurRadius(Context const& context, glm::vec3 const& sphericalCoords)
+		{
+			float result = 0.0f;
+			for (GLuint channelId = 0; channelId < context.m_renderChannels; ++channelId)
+				result = glm::max(result, blurRadius(context, sphericalCoords, channelId));
+			return result;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float calcFragmentSizeOffset(const GLuint fragmentSize)
+		{
+			return glm::sqrt(2.0f) * (float(fragmentSize - 1) * 0.5f);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// PSF sampling functions
+		////////////////////////////////////////////////////////////////////////////////
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Number of weights for all the radii in [minRadius, maxRadius]. */
+		size_t psfWeightsPerEntry(const int64_t minRadius, const int64_t maxRadius)
+		{
+			return size_t((minRadius - 4 * minRadius * minRadius * minRadius + (1 + maxRadius) * (1 + 2 * maxRadius) * (3 + 2 * maxRadius)) / 3);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** A single PSF weight; texels outside the PSF's footprint read as zero. */
+		float psfWeight(Context const& context, const size_t psfId, const int radius, glm::ivec2 const& texel)
+		{
+			UniformDataPsfParam const& psfParams = context.m_psfParams[psfId];
+			const int minRadius = int(psfParams.m_minBlurRadius);
+			if (radius < minRadius || radius > int(psfParams.m_maxBlurRadius)) return 0.0f;
+			if (glm::any(glm::lessThan(texel, glm::ivec2(0))) || glm::any(glm::greaterThan(texel, glm::ivec2(radius * 2)))) return 0.0f;
+
+			const size_t radiusStartId = radius == minRadius ? 0 : psfWeightsPerEntry(minRadius, radius - 1);
+			return context.m_psfWeights[psfParams.m_weightStartId + radiusStartId + texel.y * (radius * 2 + 1) + texel.x];
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** One texel of the radius-based PSF texture. */
+		float psfTexel(Context const& context, const size_t d, const GLuint channelId, const int radius, glm::ivec2 const& texel)
+		{
+			// Clamp to the edge of the texture, like the PSF texture sampler does
+			const int maxDiameter = int(context.m_common.m_maxBlurRadiusCurrent) * 2 + 1;
+			const glm::ivec2 clamped = glm::clamp(texel, glm::ivec2(0), glm::ivec2(maxDiameter - 1));
+
+			return lerpApertureFocus(context, [&](const size_t a, const size_t f)
+			{
+				return psfWeight(context, psfArrayIndex(context, d, channelId, a, f), radius, clamped);
+			});
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Trilinear sample of the radius-based PSF texture at the parameter radius. */
+		float samplePsfRadius(Context const& context, glm::vec3 const& psfIds, const GLuint channelId, const int radius, glm::vec2 const& sampleCoords)
+		{
+			const glm::vec2 texCoords = sampleCoords + float(radius);
+			const glm::vec2 texCoordsFloor = glm::floor(texCoords);
+			const glm::vec2 alpha = texCoords - texCoordsFloor;
+			const glm::ivec2 t = glm::ivec2(texCoordsFloor);
+
+			auto bilinear = [&](const size_t d)
+			{
+				return glm::mix(
+					glm::mix(psfTexel(context, d, channelId, radius, t + glm::ivec2(0, 0)), psfTexel(context, d, channelId, radius, t + glm::ivec2(1, 0)), alpha.x),
+					glm::mix(psfTexel(context, d, channelId, radius, t + glm::ivec2(0, 1)), psfTexel(context, d, channelId, radius, t + glm::ivec2(1, 1)), alpha.x),
+					alpha.y);
+			};
+
+			// Neighboring layers hold the neighboring object distances
+			const float depthAlpha = glm::fract(psfIds[2]);
+			const float result = bilinear(size_t(psfIds[0]));
+			return depthAlpha == 0.0f ? result : glm::mix(result, bilinear(size_t(psfIds[1])), depthAlpha);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float scaleFactorFragmentSize(Context const& context, const GLuint fragmentSize)
+		{
+			switch (context.m_common.m_weightScaleMethod)
+			{
+			case TiledSplatBlurComponent::One: return 1.0f;
+			case TiledSplatBlurComponent::Linear: return float(fragmentSize);
+			case TiledSplatBlurComponent::AreaCircle: return glm::pi<float>() * (float(fragmentSize) * 0.5f) * (float(fragmentSize) * 0.5f);
+			case TiledSplatBlurComponent::AreaSquare: return float(fragmentSize * fragmentSize);
+			}
+			return 1.0f;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		glm::vec3 scaleWeight(Context const& context, glm::vec3 const& weight, const GLuint fragmentSize)
+		{
+			const float scaleFactor = scaleFactorFragmentSize(context, fragmentSize);
+			if (context.m_common.m_weightRescaleMethod == TiledSplatBlurComponent::AlphaBlend)
+				return 1.0f - glm::pow(1.0f - weight, glm::vec3(scaleFactor));
+			return scaleFactor * weight;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		bool overlapsFragment(glm::vec2 const& relativeCoords, const float radius)
+		{
+			return glm::all(glm::lessThanEqual(glm::abs(relativeCoords), glm::vec2(radius)));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Samples the PSF of a fragment at the parameter pixel (samplePsf in the shaders). */
+		glm::vec3 samplePsf(Context const& context, glm::vec2 const& fragmentPosition, FragmentData const& fragmentData)
+		{
+			const glm::vec2 sampleCoords = fragmentPosition - fragmentData.m_screenPosition;
+			const glm::vec3 psfIds = objectDistanceIndices(context, fragmentData.m_psfIndex.z);
+
+			// Evaluate the PSF for the requested number of channels
+			glm::vec3 weight = glm::vec3(0.0f);
+			for (GLuint channelId = 0; channelId < context.m_renderChannels; ++channelId)
+			{
+				const float radius = blurRadius(context, fragmentData.m_psfIndex, channelId);
+				if (!overlapsFragment(sampleCoords, glm::ceil(radius))) continue;
+
+				const float radiusAlpha = glm::fract(radius);
+				const float weightFloor = samplePsfRadius(context, psfIds, channelId, int(glm::floor(radius)), sampleCoords);
+				weight[channelId] = radiusAlpha == 0.0f ? weightFloor :
+					glm::mix(weightFloor, samplePsfRadius(context, psfIds, channelId, int(glm::ceil(radius)), sampleCoords), radiusAlpha);
+			}
+
+			// Copy over the last channel's PSF for the rest of the channels
+			for (GLuint channelId = context.m_renderChannels; channelId < 3; ++channelId)
+				weight[channelId] = weight[context.m_renderChannels - 1];
+
+			return glm::clamp(scaleWeight(context, glm::clamp(weight, 0.0f, 1.0f), fragmentData.m_fragmentSize), 0.0f, 1.0f);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Fragment buffer
+		////////////////////////////////////////////////////////////////////////////////
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Array index for the merged per-fragment buffer (fragmentArrayIndex in the shaders). */
+		size_t fragmentArrayIndex(Context const& context, glm::ivec2 const& fragmentCoord)
+		{
+			if (context.m_common.m_numMergeSteps == 0)
+				return fragmentCoord.y * context.m_common.m_renderResolution.x + fragmentCoord.x;
+
+			const glm::ivec2 blockCoords = fragmentCoord / 2;
+			const glm::ivec2 innerCoords = fragmentCoord - blockCoords * 2;
+			const int blockStride = roundedDiv(context.m_common.m_renderResolution.x, 2);
+			return (blockCoords.y * blockStride + blockCoords.x) * 4 + innerCoords.y * 2 + innerCoords.x;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void buildFragmentBuffer(Context& context, CpuReferenceInput const& input)
+		{
+			const glm::ivec2 resolution = context.m_common.m_renderResolution;
+			context.m_fragments.assign(context.m_common.m_paddedResolution.x * context.m_common.m_paddedResolution.y, FragmentData{});
+
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t y)
+			{
+				for (int x = 0; x < resolution.x; ++x)
+				{
+					const glm::ivec2 fragmentCoord = glm::ivec2(x, y);
+					const size_t pixelId = y * resolution.x + x;
+
+					FragmentData fragmentData;
+					fragmentData.m_color = input.m_color[pixelId];
+					fragmentData.m_screenPosition = glm::vec2(fragmentCoord);
+					fragmentData.m_psfIndex = glm::vec3(0.0f, 0.0f, glm::max(input.m_distance[pixelId] + context.m_common.m_depthOffset, 1e-4f));
+					fragmentData.m_blurRadius = GLuint(glm::ceil(maxBlurRadius(context, fragmentData.m_psfIndex)));
+					fragmentData.m_fragmentSize = 1;
+					context.m_fragments[fragmentArrayIndex(context, fragmentCoord)] = fragmentData;
+				}
+			},
+			size_t(resolution.y));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Merges 2x2 blocks of similar fragments (fragment_buffer_merge in the shaders). */
+		void mergeFragments(Context& context, TiledSplatBlurComponent::MergePreset const& mergePreset)
+		{
+			const glm::ivec2 resolution = context.m_common.m_renderResolution;
+			const int nextBlockSize = mergePreset.m_blockSize;
+			const int currentBlockSize = nextBlockSize / 2;
+			const glm::ivec2 numBlocks = (resolution + nextBlockSize - 1) / nextBlockSize;
+
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t blockY)
+			{
+				for (int blockX = 0; blockX < numBlocks.x; ++blockX)
+				{
+					const glm::ivec2 fragmentCoord = glm::ivec2(blockX, blockY) * nextBlockSize;
+					const size_t arrayIndex = fragmentArrayIndex(context, fragmentCoord);
+
+					// The four fragments to process
+					std::array<FragmentData, 4> fragments;
+					for (int i = 0; i < 4; ++i)
+						fragments[i] = context.m_fragments[fragmentArrayIndex(context, fragmentCoord + glm::ivec2(i % 2, i / 2) * currentBlockSize)];
+
+					// Thresholds
+					float minRadius = std::numeric_limits<float>::max();
+					for (int i = 0; i < 4; ++i)
+						minRadius = glm::min(minRadius, minBlurRadius(context, fragments[i].m_psfIndex));
+					const float blurSizeThreshold = minRadius >= mergePreset.m_minBlurRadiusThreshold ? 1.0f : 0.0f;
+					const float colorThreshold = blurSizeThreshold * minRadius * mergePreset.m_colorSimilarityThreshold;
+					const float contrastThreshold = blurSizeThreshold * minRadius * mergePreset.m_colorContrastThreshold;
+					const float depthThreshold = blurSizeThreshold * minRadius * mergePreset.m_depthSimilarityThreshold;
+
+					// Evaluate the merge conditions over each pair of fragments
+					bool mergeCondColorSimilarity = true;
+					float maxColorDifference = 0.0f;
+					float depthDifference = 0.0f;
+					for (int i = 0; i < 4; ++i)
+					for (int j = i + 1; j < 4; ++j)
+					{
+						const glm::vec3 colorDifference = glm::abs(fragments[i].m_color - fragments[j].m_color);
+						mergeCondColorSimilarity &= glm::all(glm::lessThan(colorDifference, glm::vec3(colorThreshold)));
+						maxColorDifference = glm::max(maxColorDifference, glm::max(colorDifference.x, glm::max(colorDifference.y, colorDifference.z)));
+						depthDifference += glm::abs(fragments[i].m_psfIndex.z - fragments[j].m_psfIndex.z);
+					}
+					const bool mergeCondColorContrast = maxColorDifference <= contrastThreshold;
+					const bool mergeCondDefocus = depthDifference <= depthThreshold * 6.0f;
+					const bool mergeCondFragmentSize = (fragments[0].m_fragmentSize + fragments[1].m_fragmentSize +
+						fragments[2].m_fragmentSize + fragments[3].m_fragmentSize) == GLuint(currentBlockSize * 4);
+
+					// Merge the fragments if we can
+					int numOutFragments = 4;
+					if (mergeCondFragmentSize && mergeCondColorSimilarity && mergeCondColorContrast && mergeCondDefocus)
+					{
+						numOutFragments = 1;
+						fragments[0].m_color = (fragments[0].m_color + fragments[1].m_color + fragments[2].m_color + fragments[3].m_color) * 0.25f;
+						fragments[0].m_screenPosition = (fragments[0].m_screenPosition + fragments[1].m_screenPosition +
+							fragments[2].m_screenPosition + fragments[3].m_screenPosition) * 0.25f;
+						fragments[0].m_psfIndex = (fragments[0].m_psfIndex + fragments[1].m_psfIndex + fragments[2].m_psfIndex + fragments[3].m_psfIndex) * 0.25f;
+						fragments[0].m_fragmentSize *= 2;
+						fragments[0].m_blurRadius = GLuint(glm::ceil(maxBlurRadius(context, fragments[0].m_psfIndex) + calcFragmentSizeOffset(fragments[0].m_fragmentSize)));
+					}
+
+					// Write out the fragments
+					for (int i = 0; i < numOutFragments; ++i)
+						context.m_fragments[arrayIndex + i] = fragments[i];
+				}
+			},
+			size_t(numBlocks.y));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Tile buffer
+		////////////////////////////////////////////////////////////////////////////////
+
+		////////////////////////////////////////////////////////////////////////////////
+		float computeSortDepth(Context const& context, glm::vec2 const& screenPosition, const float depth)
+		{
+			const glm::vec2 resolution = glm::vec2(context.m_common.m_renderResolution);
+			const float fragmentDist = (screenPosition.y * resolution.x + screenPosition.x) / (resolution.x * resolution.y);
+			const float offset = fragmentDist * context.m_common.m_sortOffsetConstant;
+			const float scale = 1.0f + context.m_common.m_sortOffsetScale;
+			return (offset + depth) * scale;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Calls the parameter function with the array index and fragment count of each merged fragment in a tile, in thread order. */
+		template<typename Fn>
+		void forEachTileFragmentBlock(Context const& context, glm::ivec2 const& tileId, Fn const& fn)
+		{
+			const GLuint mergedFragmentSize = context.m_common.m_mergedFragmentSize;
+			for (int threadY = 0; threadY < context.m_mergedTileSize; ++threadY)
+			for (int threadX = 0; threadX < context.m_mergedTileSize; ++threadX)
+			{
+				const glm::ivec2 fragmentCoord = (tileId * context.m_mergedTileSize + glm::ivec2(threadX, threadY)) * int(mergedFragmentSize);
+				if (glm::any(glm::greaterThanEqual(fragmentCoord, context.m_common.m_renderResolution))) continue;
+
+				const size_t fragmentIndex = fragmentArrayIndex(context, fragmentCoord);
+				const GLuint fragmentSize = context.m_fragments[fragmentIndex].m_fragmentSize;
+				fn(fragmentIndex, (mergedFragmentSize * mergedFragmentSize) / (fragmentSize * fragmentSize));
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Collects the fragments of each tile and generates their splat and sort indices (tile_buffer_build in the shaders). */
+		void buildTileBuffer(Context& context)
+		{
+			const size_t numTotalTiles = numTiles(context);
+			const size_t tileBufferEntries = context.m_common.m_tileBufferTotalSubentries;
+			context.m_tileParameters.assign(numTotalTiles, TileParameters{});
+			context.m_tileSorts.resize(numTotalTiles * tileBufferEntries);
+			context.m_tileSplatOffsets.resize(numTotalTiles + 1);
+
+			// Count the fragments in each tile
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t tileIndex)
+			{
+				GLuint numFragments = 0;
+				forEachTileFragmentBlock(context, tileIdFromIndex(context, tileIndex), [&](const size_t fragmentIndex, const GLuint numBlockFragments)
+				{
+					numFragments += numBlockFragments;
+				});
+				context.m_tileParameters[tileIndex].m_numFragmentsTile = numFragments;
+				context.m_tileParameters[tileIndex].m_numFragmentsTotal = numFragments;
+			},
+			numTotalTiles);
+
+			// Place the tiles in the splat buffer; deterministic, unlike the atomic counter of the GPU path
+			context.m_tileSplatOffsets[0] = 0;
+			for (size_t tileIndex = 0; tileIndex < numTotalTiles; ++tileIndex)
+				context.m_tileSplatOffsets[tileIndex + 1] = context.m_tileSplatOffsets[tileIndex] + context.m_tileParameters[tileIndex].m_numFragmentsTile;
+			context.m_tileSplats.resize(context.m_tileSplatOffsets[numTotalTiles]);
+
+			// Generate the splat and sort indices
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t tileIndex)
+			{
+				const glm::ivec2 tileId = tileIdFromIndex(context, tileIndex);
+				GLuint elementIndex = 0;
+				forEachTileFragmentBlock(context, tileId, [&](const size_t blockFragmentIndex, const GLuint numBlockFragments)
+				{
+					for (GLuint fragmentId = 0; fragmentId < numBlockFragments; ++fragmentId, ++elementIndex)
+					{
+						const size_t fragmentIndex = blockFragmentIndex + fragmentId;
+						FragmentData const& fragmentData = context.m_fragments[fragmentIndex];
+
+						SplatIndex& splatIndex = context.m_tileSplats[context.m_tileSplatOffsets[tileIndex] + elementIndex];
+						splatIndex.m_tileId = tileId;
+						splatIndex.m_fragmentIndex = GLuint(fragmentIndex);
+						splatIndex.m_fragmentDepth = computeSortDepth(context, fragmentData.m_screenPosition, fragmentData.m_psfIndex.z);
+						splatIndex.m_blurRadius = float(fragmentData.m_blurRadius);
+						splatIndex.m_screenPosition = fragmentData.m_screenPosition;
+
+						context.m_tileSorts[tileIndex * tileBufferEntries + elementIndex] = SortIndex{ splatIndex.m_fragmentIndex, splatIndex.m_fragmentDepth };
+					}
+				});
+			},
+			numTotalTiles);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Tests whether a fragment overlaps the parameter tile (overlapsTile in the shaders). */
+		bool overlapsTile(Context const& context, glm::ivec2 const& tileId, glm::vec2 const& fragmentCoord, const float blurRadius)
+		{
+			const glm::vec2 tileMin = glm::vec2(tileId * context.m_tileSize);
+			const glm::vec2 tileMax = tileMin + glm::vec2(context.m_tileSize - 1);
+			const glm::vec2 distToMin = glm::abs(tileMin - fragmentCoord);
+			const glm::vec2 distToMax = glm::abs(tileMax - fragmentCoord);
+
+			return
+				(fragmentCoord.x >= tileMin.x && fragmentCoord.x <= tileMax.x && (distToMin.y <= blurRadius || distToMax.y <= blurRadius)) ||
+				(fragmentCoord.y >= tileMin.y && fragmentCoord.y <= tileMax.y && (distToMin.x <= blurRadius || distToMax.x <= blurRadius)) ||
+				(distToMin.x <= blurRadius && distToMin.y <= blurRadius) ||
+				(distToMin.x <= blurRadius && distToMax.y <= blurRadius) ||
+				(distToMax.x <= blurRadius && distToMin.y <= blurRadius) ||
+				(distToMax.x <= blurRadius && distToMax.y <= blurRadius);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Appends the fragments of the neighboring tiles to each tile (tile_buffer_splat in the shaders).
+			Formulated as a gather over the destination tiles, so no atomics are needed. */
+		void splatFragments(Context& context)
+		{
+			const glm::ivec2 numTilesAxis = glm::ivec2(context.m_common.m_numTiles);
+			const size_t tileBufferEntries = context.m_common.m_tileBufferTotalSubentries;
+			const int numTilesSplat = roundedDiv(int(context.m_common.m_maxBlurRadiusCurrent), context.m_tileSize);
+
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t tileIndex)
+			{
+				const glm::ivec2 tileId = tileIdFromIndex(context, tileIndex);
+				TileParameters& tileParameters = context.m_tileParameters[tileIndex];
+				SortIndex* tileSorts = context.m_tileSorts.data() + tileIndex * tileBufferEntries;
+				size_t numDropped = 0;
+
+				for (int i = -numTilesSplat; i <= numTilesSplat; ++i)
+				for (int j = -numTilesSplat; j <= numTilesSplat; ++j)
+				{
+					const glm::ivec2 neighborTileId = tileId + glm::ivec2(i, j);
+					if (i == 0 && j == 0) continue;
+					if (glm::any(glm::lessThan(neighborTileId, glm::ivec2(0))) || glm::any(glm::greaterThanEqual(neighborTileId, numTilesAxis))) continue;
+
+					const size_t neighborTileIndex = neighborTileId.y * numTilesAxis.x + neighborTileId.x;
+					for (GLuint splatId = context.m_tileSplatOffsets[neighborTileIndex]; splatId < context.m_tileSplatOffsets[neighborTileIndex + 1]; ++splatId)
+					{
+						SplatIndex const& splatIndex = context.m_tileSplats[splatId];
+						if (!overlapsTile(context, tileId, splatIndex.m_screenPosition, splatIndex.m_blurRadius)) continue;
+
+						if (tileParameters.m_numFragmentsTotal < tileBufferEntries)
+							tileSorts[tileParameters.m_numFragmentsTotal++] = SortIndex{ splatIndex.m_fragmentIndex, splatIndex.m_fragmentDepth };
+						else
+							++numDropped;
+					}
+				}
+
+				if (numDropped > 0)
+					context.m_numDroppedSplats += numDropped;
+			},
+			size_t(numTiles(context)));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Sorts each tile buffer front-to-back, using the same bitonic network as the sort shaders. */
+		void sortTileBuffer(Context& context)
+		{
+			const size_t tileBufferEntries = context.m_common.m_tileBufferTotalSubentries;
+
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t tileIndex)
+			{
+				const int numElements = int(context.m_tileParameters[tileIndex].m_numFragmentsTotal);
+				if (numElements <= 1) return;
+
+				// Pad the elements to a power of two with null indices, which sort to the end
+				SortIndex* tileSorts = context.m_tileSorts.data() + tileIndex * tileBufferEntries;
+				std::vector<SortIndex>& elements = context.m_sortScratch[Threading::currentThreadId()];
+				const int numSortElements = Tiling::nextPow2(numElements);
+				elements.assign(tileSorts, tileSorts + numElements);
+				elements.resize(numSortElements, SortIndex{ 0, std::numeric_limits<float>::max() });
+
+				// Bitonic sort
+				for (int k = 2; k <= numSortElements; k *= 2)
+				for (int j = k / 2; j > 0; j /= 2)
+				for (int i = 0; i < numSortElements; ++i)
+				{
+					const int l = i ^ j;
+					if (l <= i) continue;
+
+					SortIndex& a = (i & k) == 0 ? elements[i] : elements[l];
+					SortIndex& b = (i & k) == 0 ? elements[l] : elements[i];
+					if (a.m_depth > b.m_depth) std::swap(a, b);
+				}
+
+				std::copy(elements.begin(), elements.begin() + numElements, tileSorts);
+			},
+			size_t(numTiles(context)));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Convolution
+		////////////////////////////////////////////////////////////////////////////////
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Accumulates the tile fragments for each pixel (convolution in the shaders). */
+		void convolve(Context& context, std::vector<glm::vec3>& result)
+		{
+			const glm::ivec2 resolution = context.m_common.m_renderResolution;
+			const size_t tileBufferEntries = context.m_common.m_tileBufferTotalSubentries;
+			result.resize(resolution.x * resolution.y);
+
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t tileIndex)
+			{
+				const glm::ivec2 tileId = tileIdFromIndex(context, tileIndex);
+
+				// Unpack the tile's fragments into a contiguous array, like the shared memory batches of the shader
+				const SortIndex* tileSorts = context.m_tileSorts.data() + tileIndex * tileBufferEntries;
+				std::vector<FragmentData>& fragments = context.m_tileFragmentScratch[Threading::currentThreadId()];
+				fragments.resize(context.m_tileParameters[tileIndex].m_numFragmentsTotal);
+				for (size_t elementIndex = 0; elementIndex < fragments.size(); ++elementIndex)
+					fragments[elementIndex] = context.m_fragments[tileSorts[elementIndex].m_index];
+
+				for (int threadY = 0; threadY < context.m_tileSize; ++threadY)
+				for (int threadX = 0; threadX < context.m_tileSize; ++threadX)
+				{
+					const glm::ivec2 fragmentCoord = tileId * context.m_tileSize + glm::ivec2(threadX, threadY);
+					if (glm::any(glm::greaterThanEqual(fragmentCoord, resolution))) continue;
+
+					glm::vec3 accumulated = glm::vec3(0.0f);
+					glm::vec3 totalWeight = glm::vec3(0.0f);
+					for (FragmentData const& fragmentData : fragments)
+					{
+						const glm::vec3 weight = samplePsf(context, glm::vec2(fragmentCoord), fragmentData);
+						switch (context.m_common.m_accumulationMethod)
+						{
+						case TiledSplatBlurComponent::FrontToBack:
+							accumulated += (1.0f - totalWeight) * weight * fragmentData.m_color;
+							totalWeight = weight + (1.0f - weight) * totalWeight;
+							break;
+						case TiledSplatBlurComponent::BackToFront:
+							accumulated = weight * fragmentData.m_color + (1.0f - weight) * accumulated;
+							totalWeight = weight + (1.0f - weight) * totalWeight;
+							break;
+						case TiledSplatBlurComponent::Sum:
+							accumulated += weight * fragmentData.m_color;
+							totalWeight += weight;
+							break;
+						}
+					}
+
+					// Normalize back the result
+					if (context.m_common.m_normalizeResult == 1.0f)
+						accumulated /= totalWeight;
+
+					result[fragmentCoord.y * resolution.x + fragmentCoord.x] = accumulated;
+				}
+			},
+			size_t(numTiles(context)));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Dense per-pixel gather over the unmerged fragments, mirroring the PerPixel algorithm of the ground truth: no tiles, merging or buffer limits. */
+		void gatherPerPixel(Context& context, CpuReferenceInput const& input, std::vector<glm::vec3>& result)
+		{
+			const glm::ivec2 resolution = context.m_common.m_renderResolution;
+			result.resize(resolution.x * resolution.y);
+
+			// One fragment per pixel, in the layout of the input
+			std::vector<FragmentData> fragments(resolution.x * resolution.y);
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t y)
+			{
+				for (int x = 0; x < resolution.x; ++x)
+				{
+					const size_t pixelId = y * resolution.x + x;
+					FragmentData& fragmentData = fragments[pixelId];
+					fragmentData.m_color = input.m_color[pixelId];
+					fragmentData.m_screenPosition = glm::vec2(x, y);
+					fragmentData.m_psfIndex = glm::vec3(0.0f, 0.0f, glm::max(input.m_distance[pixelId] + context.m_common.m_depthOffset, 1e-4f));
+					fragmentData.m_blurRadius = GLuint(glm::ceil(maxBlurRadius(context, fragmentData.m_psfIndex)));
+					fragmentData.m_fragmentSize = 1;
+				}
+			},
+			size_t(resolution.y));
+
+			const int maxRadius = int(context.m_common.m_maxBlurRadiusGlobal);
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t y)
+			{
+				std::vector<SortIndex>& samples = context.m_sortScratch[Threading::currentThreadId()];
+				for (int x = 0; x < resolution.x; ++x)
+				{
+					const glm::ivec2 fragmentCoord = glm::ivec2(x, y);
+
+					// Collect every fragment whose PSF reaches this pixel
+					samples.clear();
+					const glm::ivec2 sampleMin = glm::max(fragmentCoord - maxRadius, glm::ivec2(0));
+					const glm::ivec2 sampleMax = glm::min(fragmentCoord + maxRadius, resolution - 1);
+					for (int sampleY = sampleMin.y; sampleY <= sampleMax.y; ++sampleY)
+					for (int sampleX = sampleMin.x; sampleX <= sampleMax.x; ++sampleX)
+					{
+						const size_t pixelId = sampleY * resolution.x + sampleX;
+						if (!overlapsFragment(glm::vec2(fragmentCoord - glm::ivec2(sampleX, sampleY)), float(fragments[pixelId].m_blurRadius))) continue;
+						samples.push_back(SortIndex{ GLuint(pixelId), fragments[pixelId].m_psfIndex.z });
+					}
+
+					// Order the samples for blending
+					if (context.m_common.m_accumulationMethod == TiledSplatBlurComponent::FrontToBack)
+						std::sort(samples.begin(), samples.end(), [](SortIndex const& a, SortIndex const& b) { return a.m_depth < b.m_depth; });
+					else if (context.m_common.m_accumulationMethod == TiledSplatBlurComponent::BackToFront)
+						std::sort(samples.begin(), samples.end(), [](SortIndex const& a, SortIndex const& b) { return a.m_depth > b.m_depth; });
+
+					glm::vec3 accumulated = glm::vec3(0.0f);
+					glm::vec3 totalWeight = glm::vec3(0.0f);
+					for (SortIndex const& sample : samples)
+					{
+						FragmentData const& fragmentData = fragments[sample.m_index];
+						const glm::vec3 weight = samplePsf(context, glm::vec2(fragmentCoord), fragmentData);
+						switch (context.m_common.m_accumulationMethod)
+						{
+						case TiledSplatBlurComponent::FrontToBack:
+							accumulated += (1.0f - totalWeight) * weight * fragmentData.m_color;
+							totalWeight = weight + (1.0f - weight) * totalWeight;
+							break;
+						case TiledSplatBlurComponent::BackToFront:
+							accumulated = weight * fragmentData.m_color + (1.0f - weight) * accumulated;
+							totalWeight = weight + (1.0f - weight) * totalWeight;
+							break;
+						case TiledSplatBlurComponent::Sum:
+							accumulated += weight * fragmentData.m_color;
+							totalWeight += weight;
+							break;
+						}
+
+						// Later samples are fully occluded once the pixel saturates
+						if (context.m_common.m_accumulationMethod == TiledSplatBlurComponent::FrontToBack && glm::all(glm::greaterThanEqual(totalWeight, glm::vec3(1.0f))))
+							break;
+					}
+
+					// Normalize back the result
+					if (context.m_common.m_normalizeResult == 1.0f)
+						accumulated /= totalWeight;
+
+					result[fragmentCoord.y * resolution.x + fragmentCoord.x] = accumulated;
+				}
+			},
+			size_t(resolution.y));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Difference between two images of the same layout. */
+		struct ImageDifference
+		{
+			float m_rmse = 0.0f;
+			float m_maxDifference = 0.0f;
+			float m_psnr = 0.0f;
+
+			// Number of pixels that are non-finite in either image
+			size_t m_numInvalid = 0;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		ImageDifference imageDifference(std::vector<glm::vec3> const& image, std::vector<glm::vec3> const& reference)
+		{
+			auto isFinite = [](glm::vec3 const& color) { return !glm::any(glm::isnan(color)) && !glm::any(glm::isinf(color)); };
+
+			ImageDifference result;
+			double sumSquared = 0.0;
+			float peak = 1.0f;
+			for (size_t pixelId = 0; pixelId < image.size(); ++pixelId)
+			{
+				if (!isFinite(image[pixelId]) || !isFinite(reference[pixelId]))
+				{
+					++result.m_numInvalid;
+					continue;
+				}
+
+				const glm::vec3 difference = glm::abs(image[pixelId] - reference[pixelId]);
+				sumSquared += glm::dot(difference, difference);
+				result.m_maxDifference = glm::max(result.m_maxDifference, glm::max(difference.x, glm::max(difference.y, difference.z)));
+				peak = glm::max(peak, glm::max(reference[pixelId].x, glm::max(reference[pixelId].y, reference[pixelId].z)));
+			}
+
+			const double mse = sumSquared / glm::max(double(3 * (image.size() - result.m_numInvalid)), 1.0);
+			result.m_rmse = float(glm::sqrt(mse));
+			result.m_psnr = mse == 0.0 ? std::numeric_limits<float>::infinity() : float(10.0 * std::log10(double(peak) * double(peak) / mse));
+			return result;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Whether the current settings are supported by the CPU reference. */
+		bool supportsSettings(Scene::Scene& scene, Scene::Object* object)
+		{
+			TiledSplatBlurComponent const& component = object->component<TiledSplatBlurComponent>();
+			if (component.m_psfAxisMethod != TiledSplatBlurComponent::OnAxis)
+			{
+				Debug::log_error() << "The CPU reference only supports on-axis PSFs." << Debug::end;
+				return false;
+			}
+			if (component.m_fragmentMergeSteps > 1)
+			{
+				Debug::log_error() << "The CPU reference supports at most one fragment merge step." << Debug::end;
+				return false;
+			}
+			return true;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Sets up the context for the parameter resolution, generating the PSF weights and interpolating the PSF parameters. */
+		void initContext(Scene::Scene& scene, Scene::Object* object, glm::ivec2 const& resolution, Context& context)
+		{
+			TiledSplatBlurComponent const& component = object->component<TiledSplatBlurComponent>();
+
+			// Some necessary objects
+			Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+			Scene::Object* camera = RenderSettings::getMainCamera(scene, renderSettings);
+
+			// Set up the context
+			context.m_common = Uniforms::commonData(scene, renderSettings, camera, object, resolution);
+			context.m_tileSize = component.m_tileSize;
+			context.m_mergedTileSize = component.m_tileSize / int(context.m_common.m_mergedFragmentSize);
+			context.m_renderChannels = glm::clamp(GLuint(component.m_numWavelengths), GLuint(1), context.m_common.m_numChannels);
+			context.m_apertureIds = axisIndices(camera->component<Camera::CameraComponent>().m_fixedAperture,
+				context.m_common.m_apertureMin, context.m_common.m_apertureStep, context.m_common.m_numApertures);
+			context.m_focusIds = axisIndices(1.0f / camera->component<Camera::CameraComponent>().m_focusDistance,
+				context.m_common.m_focusDistanceMin, context.m_common.m_focusDistanceStep, context.m_common.m_numFocuses);
+
+			// Generate the PSF weights into host memory
+			{
+				const Aberration::PsfIndex startIndex{ 0, 0, 0, 0, 0, 0 };
+				const Aberration::PsfIndex numIndices{ context.m_common.m_numDefocuses, context.m_common.m_numHorizontalAngles, context.m_common.m_numVerticalAngles,
+					context.m_common.m_numChannels, context.m_common.m_numApertures, context.m_common.m_numFocuses };
+				const size_t numTotalWeights = Buffers::buildPsfParams(scene, object, startIndex, numIndices, context.m_psfParams);
+				context.m_psfWeights.resize(numTotalWeights);
+				Buffers::generatePsfWeights(scene, object, startIndex, numIndices, context.m_psfParams, Buffers::hostPsfWeightSink(context.m_psfWeights));
+			}
+
+			// Interpolate the PSF parameters for the current camera
+			{
+				DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, 1, DateTime::Milliseconds, "Interpolation");
+				interpolatePsfParams(context);
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace ResourceLoading
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		void initGPUBuffers(Scene::Scene& scene, Scene::Object* = nullptr)
+		{
+			Scene::createGPUBuffer(scene, "TiledSplatBlurCommon", GL_UNIFORM_BUFFER, false, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_1);
+			Scene::createGPUBuffer(scene, "TiledSplatBlurPass", GL_UNIFORM_BUFFER, false, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_2);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_Fragments", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_3);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_TileParameters", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_4);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_DispatchIndirect", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_5);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_SplatIndex", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_6);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_SortIndex", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_7);
+
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_PsfParams", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_8, GL_DYNAMIC_STORAGE_BIT);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_PsfWeights", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_9, GL_DYNAMIC_STORAGE_BIT);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_PsfInterpolation", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_10);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_CachePsfParams", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_11);
+			Scene::createGPUBuffer(scene, "TiledSplatBlur_InterpolatedPsfParams", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_12);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void initAberrationPresets(Scene::Scene& scene, Scene::Object* object)
+		{
+			Aberration::initAberrationStructure(scene, Psfs::getAberration(scene, object), Psfs::getAberrationPresets(scene, object));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void loadNeuralNetworks(Scene::Scene& scene, Scene::Object* object)
+		{
+			Aberration::loadNeuralNetworks(scene, Psfs::getAberration(scene, object));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void loadShaders(Scene::Scene& scene, Scene::Object* object)
+		{
+			// Load common shaders for the aberration structure (needed for PSF stack computation)
+			Aberration::loadShaders(scene, Psfs::getAberration(scene, object));
+
+			// Load shaders for this component
+			Shaders::loadShaders(scene, object);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace Computations
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		void initPsfStack(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "PSF Computation", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					Psfs::initPsfStack(scene, &object);
+				});
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void computePsfs(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "PSF Computation", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					Psfs::computePsfs(scene, &object);
+				});
+		}
+		////////////////////////////////////////////////////////////////////////////////
+		void clearPsfCache(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "PSF Cache Clear", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					Psfs::clearPsfCache(scene, &object);
+				});
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void updateBuffers(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "Buffer Update", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					Buffers::updateBuffers(scene, &object);
+					PsfTexture::updateTexture(scene, &object);
+				});
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void updateDerivedParameters(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "PSF Data Upload", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					Psfs::updateDerivedParameters(scene, &object);
+				});
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		void uploadPsfData(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "PSF Data Upload", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					Buffers::uploadPsfData(scene, &object);
+				});
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		void loadShaders(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		{
+			DelayedJobs::postJob(scene, object, "Shader Loading", false, delayFrames,
+				[](Scene::Scene& scene, Scene::Object& object)
+				{
+					ResourceLoading::loadShaders(scene, &object);
+				});
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace ReferenceCapture
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** Reads back the first layer of the current gbuffer read color buffer. */
+		void readColor(Scene::Scene& scene, Scene::Object* renderSettings, glm::ivec2 const& resolution, std::vector<glm::vec3>& color)
+		{
+			auto const& gbuffer = scene.m_gbuffer[renderSettings->component<RenderSettings::RenderSettingsComponent>().m_gbufferWrite];
+
+			color.resize(resolution.x * resolution.y);
+			glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+			glPixelStorei(GL_PACK_ALIGNMENT, 1);
+			glGetTextureSubImage(gbuffer.m_colorTextures[gbuffer.m_readBuffer], 0, 0, 0, 0, resolution.x, resolution.y, 1,
+				GL_RGB, GL_FLOAT, GLsizei(color.size() * sizeof(glm::vec3)), color.data());
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Reads back the blur input: the gbuffer color, and the depth converted to distances like the fragment buffer shader does. */
+		void readInput(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera, glm::ivec2 const& resolution, CpuReferenceInput& input)
+		{
+			auto const& gbuffer = scene.m_gbuffer[renderSettings->component<RenderSettings::RenderSettingsComponent>().m_gbufferWrite];
+
+			input.m_resolution = resolution;
+			readColor(scene, renderSettings, resolution, input.m_color);
+
+			std::vector<float> depth(resolution.x * resolution.y);
+			glGetTextureSubImage(gbuffer.m_depthTexture, 0, 0, 0, 0, resolution.x, resolution.y, 1,
+				GL_DEPTH_COMPONENT, GL_FLOAT, GLsizei(depth.size() * sizeof(float)), depth.data());
+
+			input.m_distance.resize(depth.size());
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t y)
+			{
+				for (int x = 0; x < resolution.x; ++x)
+				{
+					const size_t pixelId = y * resolution.x + x;
+					input.m_distance[pixelId] = Camera::screenToSphericalCoordinatesDegM(renderSettings, camera, glm::ivec2(x, y), depth[pixelId]).z;
+				}
+			},
+			size_t(resolution.y));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Largest RMSE accepted between the GPU and the CPU reference, given the precision of the PSF texture. */
+		float gpuTolerance(Scene::Scene& scene, Scene::Object* object)
+		{
+			switch (object->component<TiledSplatBlurComponent>().m_psfTextureFormat)
+			{
+			case TiledSplatBlurComponent::F32: return 1e-3f;
+			case TiledSplatBlurComponent::F16: return 5e-3f;
+			case TiledSplatBlurComponent::F11: return 2e-2f;
+			}
+			return 1e-3f;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Compares the GPU result in the gbuffer read color buffer against the CPU reference for the captured input. */
+		bool compareGpuOutput(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object, CpuReferenceInput const& input)
+		{
+			std::vector<glm::vec3> gpuColor;
+			readColor(scene, renderSettings, input.m_resolution, gpuColor);
+
+			CpuReferenceOutput output;
+			DateTime::Timer referenceTimer(true);
+			if (!renderCpuReference(scene, object, input, output))
+				return false;
+			referenceTimer.stop();
+
+			const CpuReference::ImageDifference difference = CpuReference::imageDifference(gpuColor, output.m_color);
+			const float tolerance = gpuTolerance(scene, object);
+			const bool result = difference.m_numInvalid == 0 && difference.m_rmse <= tolerance;
+
+			Debug::log_info() << "GPU vs CPU reference (" << input.m_resolution.x << "x" << input.m_resolution.y << ", "
+				<< std::string(TiledSplatBlurComponent::PsfTextureFormat_value_to_string(object->component<TiledSplatBlurComponent>().m_psfTextureFormat)) << " PSF texture):" << Debug::end;
+			Debug::log_info() << "  - CPU reference: " << referenceTimer.getElapsedTime() * 1e3 << " ms, " << output.m_numFragments << " fragments, "
+				<< output.m_numSplats << " splats, " << output.m_numDroppedSplats << " dropped" << Debug::end;
+			Debug::log_info() << "  - RMSE: " << difference.m_rmse << " (tolerance: " << tolerance << "), max difference: " << difference.m_maxDifference
+				<< ", PSNR: " << difference.m_psnr << " dB, invalid pixels: " << difference.m_numInvalid << Debug::end;
+			if (result)
+				Debug::log_info() << "GPU output matches the CPU reference." << Debug::end;
+			else
+				Debug::log_error() << "GPU output differs from the CPU reference." << Debug::end;
+
+			return result;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Synthetic inputs with depth discontinuities, smooth depth changes and high-frequency detail, spanning the object distances of the PSF stack. */
+		std::vector<std::pair<std::string, CpuReferenceInput>> syntheticScenes(Scene::Scene& scene, Scene::Object* object, glm::ivec2 const& resolution)
+		{
+			auto const& objectDioptres = Psfs::getAberration(scene, object).m_psfParameters.m_evaluatedParameters.m_objectDioptres;
+			const float minDioptres = glm::max(objectDioptres.front(), 0.05f);
+			const float maxDioptres = glm::max(objectDioptres.back(), minDioptres);
+			const size_t numPixels = resolution.x * resolution.y;
+
+			std::vector<std::pair<std::string, CpuReferenceInput>> result(3);
+			for (auto& [name, input] : result)
+			{
+				input.m_resolution = resolution;
+				input.m_color.resize(numPixels);
+				input.m_distance.resize(numPixels);
+			}
+
+			// Checkered near half against a smooth far half
+			result[0].first = "Depth Step";
+			for (int y = 0; y < resolution.y; ++y)
+			for (int x = 0; x < resolution.x; ++x)
+			{
+				const size_t pixelId = y * resolution.x + x;
+				const bool isNear = x < resolution.x / 2;
+				result[0].second.m_color[pixelId] = isNear ? glm::vec3(((x / 8 + y / 8) % 2) == 0 ? 0.9f : 0.1f) :
+					glm::vec3(float(x) / resolution.x, float(y) / resolution.y, 0.5f);
+				result[0].second.m_distance[pixelId] = 1.0f / (isNear ? maxDioptres : minDioptres);
+			}
+
+			// Stripes over a linear dioptre ramp
+			result[1].first = "Depth Ramp";
+			for (int y = 0; y < resolution.y; ++y)
+			for (int x = 0; x < resolution.x; ++x)
+			{
+				const size_t pixelId = y * resolution.x + x;
+				result[1].second.m_color[pixelId] = (x / 6) % 2 == 0 ? glm::vec3(1.0f, 0.8f, 0.2f) : glm::vec3(0.1f, 0.2f, 0.6f);
+				result[1].second.m_distance[pixelId] = 1.0f / glm::mix(maxDioptres, minDioptres, float(x) / glm::max(resolution.x - 1, 1));
+			}
+
+			// Random blocks of random colors and distances
+			result[2].first = "Random Blocks";
+			std::mt19937 generator(1234);
+			std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+			const glm::ivec2 numBlocks = (resolution + 7) / 8;
+			std::vector<std::pair<glm::vec3, float>> blocks(numBlocks.x * numBlocks.y);
+			for (auto& [color, distance] : blocks)
+			{
+				color = glm::vec3(uniform(generator), uniform(generator), uniform(generator));
+				distance = 1.0f / glm::mix(minDioptres, maxDioptres, uniform(generator));
+			}
+			for (int y = 0; y < resolution.y; ++y)
+			for (int x = 0; x < resolution.x; ++x)
+			{
+				const size_t pixelId = y * resolution.x + x;
+				auto const& [color, distance] = blocks[(y / 8) * numBlocks.x + x / 8];
+				result[2].second.m_color[pixelId] = color;
+				result[2].second.m_distance[pixelId] = distance;
+			}
+
+			return result;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool renderCpuReference(Scene::Scene& scene, Scene::Object* object, CpuReferenceInput const& input, CpuReferenceOutput& output)
+	{
+		TiledSplatBlurComponent const& component = object->component<TiledSplatBlurComponent>();
+
+		// Validate the input
+		const size_t numPixels = size_t(input.m_resolution.x) * size_t(input.m_resolution.y);
+		if (numPixels == 0 || input.m_color.size() != numPixels || input.m_distance.size() != numPixels)
+		{
+			Debug::log_error() << "Invalid input for the CPU reference; expected " << numPixels << " color and distance values." << Debug::end;
+			return false;
+		}
+		if (!CpuReference::supportsSettings(scene, object))
+			return false;
+
+		DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numPixels, DateTime::Milliseconds, "CPU Reference");
+
+		// Set up the context
+		CpuReference::Context context;
+		CpuReference::initContext(scene, object, input.m_resolution, context);
+
+		// Run the individual stages
+		{
+			DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numPixels, DateTime::Milliseconds, "Fragment Buffer");
+			CpuReference::buildFragmentBuffer(context, input);
+			for (int mergeStep = 0; mergeStep < component.m_fragmentMergeSteps; ++mergeStep)
+				CpuReference::mergeFragments(context, component.m_mergePresets[mergeStep]);
+		}
+		{
+			DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, CpuReference::numTiles(context), DateTime::Milliseconds, "Tile Buffer");
+			CpuReference::buildTileBuffer(context);
+			CpuReference::splatFragments(context);
+			if (component.m_sortTileBuffer)
+				CpuReference::sortTileBuffer(context);
+		}
+		{
+			DateTime::ScopedTimer timer = DateTime::ScopedTimer(Debug::Debug, numPixels, DateTime::Milliseconds, "Convolution");
+			CpuReference::convolve(context, output.m_color);
+		}
+
+		// Collect the statistics
+		output.m_numFragments = context.m_tileSplats.size();
+		output.m_numSplats = 0;
+		for (CpuReference::TileParameters const& tileParameters : context.m_tileParameters)
+			output.m_numSplats += tileParameters.m_numFragmentsTotal - tileParameters.m_numFragmentsTile;
+		output.m_numDroppedSplats = context.m_numDroppedSplats;
+
+		if (output.m_numDroppedSplats > 0)
+			Debug::log_warning() << "CPU reference: " << output.m_numDroppedSplats << " splats did not fit in the tile buffers." << Debug::end;
+
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validateCpuReference(Scene::Scene& scene, Scene::Object* object, glm::ivec2 const& resolution)
+	{
+		Debug::log_info() << "Validating the CPU reference of the tiled splat blur..." << Debug::end;
+
+		if (Psfs::getPsfStack(scene, object).m_psfs.empty())
+		{
+			Debug::log_error() << "CPU reference validation needs a computed PSF stack." << Debug::end;
+			return false;
+		}
+		if (!CpuReference::supportsSettings(scene, object))
+			return false;
+
+		// Context of the dense gather, shared by the synthetic scenes
+		CpuReference::Context gatherContext;
+		DateTime::Timer setupTimer(true);
+		CpuReference::initContext(scene, object, resolution, gatherContext);
+		setupTimer.stop();
+
+		Debug::log_info() << "CPU reference vs per-pixel gather (" << resolution.x << "x" << resolution.y << ", max radius " << gatherContext.m_common.m_maxBlurRadiusGlobal
+			<< ", PSF weight setup: " << setupTimer.getElapsedTime() * 1e3 << " ms):" << Debug::end;
 
-				// Get rid of the temporary PSF weights buffer by resizing it
-				Scene::resizeGPUBuffer(scene, "TiledSplatBlur_PsfWeights", sizeof(GLfloat), false);
+		bool result = true;
+		for (auto const& [name, input] : ReferenceCapture::syntheticScenes(scene, object, resolution))
+		{
+			// The tiled pipeline; the timing includes the PSF weight setup
+			CpuReferenceOutput output;
+			DateTime::Timer referenceTimer(true);
+			if (!renderCpuReference(scene, object, input, output))
+				return false;
+			referenceTimer.stop();
 
-				// Log the total raw PSF memory
-				const size_t totalRawMemory = Psfs::numTotalWeights(scene, object) * sizeof(GLfloat);
-				Debug::log_debug() << "Number of raw PSF data: " << Units::bytesToString(totalRawMemory) << Debug::end;
+			// The ground truth style gather
+			std::vector<glm::vec3> gathered;
+			DateTime::Timer gatherTimer(true);
+			CpuReference::gatherPerPixel(gatherContext, input, gathered);
+			gatherTimer.stop();
 
-				// Also do a PSF texture size comparison
-				PsfTexture::textureDimensionsComparisonOffAxis(scene, object);
+			const CpuReference::ImageDifference difference = CpuReference::imageDifference(output.m_color, gathered);
+			Debug::log_info() << "  - " << name << ": tiled " << referenceTimer.getElapsedTime() * 1e3 << " ms (" << output.m_numFragments << " fragments, "
+				<< output.m_numSplats << " splats, " << output.m_numDroppedSplats << " dropped), gather " << gatherTimer.getElapsedTime() * 1e3 << " ms, RMSE: "
+				<< difference.m_rmse << ", max difference: " << difference.m_maxDifference << ", PSNR: " << difference.m_psnr << " dB" << Debug::end;
+
+			if (difference.m_numInvalid > 0)
+			{
+				Debug::log_error() << "  - " << name << ": " << difference.m_numInvalid << " pixels are not finite." << Debug::end;
+				result = false;
 			}
 		}
+
+		// Compare against the GPU on the next rendered frame
+		Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+		if (renderSettings->component<RenderSettings::RenderSettingsComponent>().m_layers.m_numLayers != 1)
+			Debug::log_warning() << "Skipping the GPU comparison; the CPU reference only handles a single gbuffer layer." << Debug::end;
+		else if (Tiling::computeRenderResolution(scene, object) != renderSettings->component<RenderSettings::RenderSettingsComponent>().m_resolution)
+			Debug::log_warning() << "Skipping the GPU comparison; the render resolution must match the output resolution." << Debug::end;
+		else
+		{
+			object->component<TiledSplatBlurComponent>().m_validateCpuReference = true;
+			Debug::log_info() << "GPU comparison scheduled for the next frame." << Debug::end;
+		}
+
+		return result;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	namespace ResourceLoading
+	bool validatePsfWeights(Scene::Scene& scene, Scene::Object* object)
 	{
-		////////////////////////////////////////////////////////////////////////////////
-		void initGPUBuffers(Scene::Scene& scene, Scene::Object* = nullptr)
-		{
-			Scene::createGPUBuffer(scene, "TiledSplatBlurCommon", GL_UNIFORM_BUFFER, false, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_1);
-			Scene::createGPUBuffer(scene, "TiledSplatBlurPass", GL_UNIFORM_BUFFER, false, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_2);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_Fragments", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_3);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_TileParameters", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_4);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_DispatchIndirect", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_5);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_SplatIndex", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_6);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_SortIndex", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_7);
+		Debug::log_info() << "Validating the chunked PSF weight generation..." << Debug::end;
 
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_PsfParams", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_8, GL_DYNAMIC_STORAGE_BIT);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_PsfWeights", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_9, GL_DYNAMIC_STORAGE_BIT);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_PsfInterpolation", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_10);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_CachePsfParams", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_11);
-			Scene::createGPUBuffer(scene, "TiledSplatBlur_InterpolatedPsfParams", GL_SHADER_STORAGE_BUFFER, true, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_GENERIC_12);
+		auto& psfStack = Psfs::getPsfStack(scene, object);
+		if (psfStack.m_psfs.empty())
+		{
+			Debug::log_error() << "PSF weight validation needs a computed PSF stack." << Debug::end;
+			return false;
 		}
 
-		////////////////////////////////////////////////////////////////////////////////
-		void initAberrationPresets(Scene::Scene& scene, Scene::Object* object)
+		// The slices uploaded together, matching uploadPsfData
+		const size_t numDefocuses = psfStack.m_psfs.size();
+		const size_t numHorizontal = psfStack.m_psfs[0].size();
+		const size_t numVertical = psfStack.m_psfs[0][0].size();
+		const size_t numChannels = psfStack.m_psfs[0][0][0].size();
+		const size_t numApertures = psfStack.m_psfs[0][0][0][0].size();
+		const size_t numFocuses = psfStack.m_psfs[0][0][0][0][0].size();
+		std::vector<std::pair<Aberration::PsfIndex, Aberration::PsfIndex>> slices;
+		if (object->component<TiledSplatBlurComponent>().m_psfAxisMethod == TiledSplatBlurComponent::OnAxis)
 		{
-			Aberration::initAberrationStructure(scene, Psfs::getAberration(scene, object), Psfs::getAberrationPresets(scene, object));
+			slices.push_back({ Aberration::PsfIndex{ 0, 0, 0, 0, 0, 0 },
+				Aberration::PsfIndex{ numDefocuses, numHorizontal, numVertical, numChannels, numApertures, numFocuses } });
 		}
-
-		////////////////////////////////////////////////////////////////////////////////
-		void loadNeuralNetworks(Scene::Scene& scene, Scene::Object* object)
+		else
 		{
-			Aberration::loadNeuralNetworks(scene, Psfs::getAberration(scene, object));
+			for (size_t a = 0; a < numApertures; ++a)
+			for (size_t f = 0; f < numFocuses; ++f)
+				slices.push_back({ Aberration::PsfIndex{ 0, 0, 0, 0, a, f },
+					Aberration::PsfIndex{ numDefocuses, numHorizontal, numVertical, numChannels, 1, 1 } });
 		}
 
-		////////////////////////////////////////////////////////////////////////////////
-		void loadShaders(Scene::Scene& scene, Scene::Object* object)
+		// Chunk sizes to test: the production one, one that splits the slices into many chunks, and one PSF per chunk
+		const std::array<size_t, 3> chunkSizes = { Buffers::s_psfWeightChunkSize, 64 * 1024, 1 };
+
+		bool result = true;
+		for (auto const& [startIndex, numIndices] : slices)
 		{
-			// Load common shaders for the aberration structure (needed for PSF stack computation)
-			Aberration::loadShaders(scene, Psfs::getAberration(scene, object));
+			std::vector<UniformDataPsfParam> psfParams;
+			const size_t numTotalWeights = Buffers::buildPsfParams(scene, object, startIndex, numIndices, psfParams);
 
-			// Load shaders for this component
-			Shaders::loadShaders(scene, object);
+			// Reference: the whole slice generated into one buffer
+			const std::vector<GLfloat> monolithic = Buffers::generatePsfWeightsMonolithic(scene, object, startIndex, numIndices, psfParams, numTotalWeights);
+
+			for (size_t chunkSize : chunkSizes)
+			{
+				// Each weight must be written exactly once; start from a pattern the generator never produces
+				std::vector<GLfloat> chunked(numTotalWeights, std::numeric_limits<GLfloat>::quiet_NaN());
+				std::vector<size_t> numWrites(numTotalWeights, 0);
+				Buffers::PsfWeightSink hostSink = Buffers::hostPsfWeightSink(chunked);
+				Buffers::generatePsfWeights(scene, object, startIndex, numIndices, psfParams,
+					[&](const size_t weightOffset, const GLfloat* weights, const size_t numWeights)
+					{
+						if (weightOffset + numWeights > numTotalWeights)
+						{
+							Debug::log_error() << "Chunk [" << weightOffset << ", " << weightOffset + numWeights << ") is outside the "
+								<< numTotalWeights << " weights of the slice." << Debug::end;
+							result = false;
+							return;
+						}
+						for (size_t i = 0; i < numWeights; ++i)
+							++numWrites[weightOffset + i];
+						hostSink(weightOffset, weights, numWeights);
+					},
+					chunkSize);
+
+				const size_t numBadWrites = std::count_if(numWrites.begin(), numWrites.end(), [](size_t n) { return n != 1; });
+				if (numBadWrites > 0)
+				{
+					Debug::log_error() << "Chunk size " << chunkSize << ": " << numBadWrites << " of " << numTotalWeights
+						<< " weights were not written exactly once." << Debug::end;
+					result = false;
+				}
+
+				if (numTotalWeights > 0 && std::memcmp(monolithic.data(), chunked.data(), numTotalWeights * sizeof(GLfloat)) != 0)
+				{
+					size_t firstMismatch = 0;
+					while (std::memcmp(&monolithic[firstMismatch], &chunked[firstMismatch], sizeof(GLfloat)) == 0)
+						++firstMismatch;
+					Debug::log_error() << "Chunk size " << chunkSize << ": weights differ from the monolithic buffer, first at weight "
+						<< firstMismatch << " (" << monolithic[firstMismatch] << " vs " << chunked[firstMismatch] << ")." << Debug::end;
+					result = false;
+				}
+			}
 		}
+
+		if (result)
+			Debug::log_info() << "PSF weight validation passed (" << slices.size() << " slices, " << chunkSizes.size() << " chunk sizes)." << Debug::end;
+		else
+			Debug::log_error() << "PSF weight validation failed." << Debug::end;
+
+		return result;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	namespace Computations
+	bool validateTileBufferSizes(Scene::Scene& scene, Scene::Object* object)
 	{
-		////////////////////////////////////////////////////////////////////////////////
-		void initPsfStack(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		Debug::log_info() << "Validating the tile buffer sizing helpers..." << Debug::end;
+
+		// The grid of settings to check, covering the GUI ranges
+		const int maxLayers = 8;
+		const int minTileSize = 8, maxTileSize = 32;
+		const int maxCoc = 128;
+		const std::vector<int> sortElementLimits = { 1, 2, 4, 8, 16, 32, 64, 100, 128, 256, 512, 1000, 1024, 2048, 3000, 4096, 6000, 8192 };
+
+		size_t numChecks = 0, numMismatches = 0;
+		auto check = [&](const char* name, const int expected, const int actual, const int layers, const int tileSize, const int coc, const int sortElements)
+		{
+			++numChecks;
+			if (expected == actual) return;
+			if (numMismatches++ < 16)
+				Debug::log_error() << name << "(layers: " << layers << ", tile size: " << tileSize << ", max CoC: " << coc << ", max sort elements: " << sortElements
+					<< "): expected " << expected << ", got " << actual << Debug::end;
+		};
+
+		// The integer helpers against the original floating-point ones
+		for (int layers = 1; layers <= maxLayers; ++layers)
+		for (int tileSize = minTileSize; tileSize <= maxTileSize; ++tileSize)
+		for (int coc = 0; coc <= maxCoc; ++coc)
 		{
-			DelayedJobs::postJob(scene, object, "PSF Computation", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
-				{
-					Psfs::initPsfStack(scene, &object);
-				});
+			const int maxFragments = Tiling::tileBufferMaxFragmentsPerEntry(layers, tileSize, coc);
+			check("tileBufferMaxFragmentsPerEntry", Tiling::FloatReference::tileBufferMaxFragmentsPerEntry(layers, tileSize, coc), maxFragments, layers, tileSize, coc, 0);
+			check("tileBufferMaxSortElements", Tiling::FloatReference::tileBufferMaxSortElements(maxFragments), Tiling::tileBufferMaxSortElements(maxFragments), layers, tileSize, coc, 0);
+
+			for (int sortElements : sortElementLimits)
+			{
+				const int sharedElements = Tiling::tileBufferMaxSortSharedElements(sortElements, maxFragments);
+				check("tileBufferMaxSortSharedElements", Tiling::FloatReference::tileBufferMaxSortSharedElements(sortElements, maxFragments), sharedElements, layers, tileSize, coc, sortElements);
+				check("tileBufferMaxSortIterations", Tiling::FloatReference::tileBufferMaxSortIterations(maxFragments, sharedElements),
+					Tiling::tileBufferMaxSortIterations(maxFragments, sharedElements), layers, tileSize, coc, sortElements);
+				check("dispatchBufferMaxDispatchPerEntry", Tiling::FloatReference::dispatchBufferMaxDispatchPerEntry(maxFragments, sharedElements),
+					Tiling::dispatchBufferMaxDispatchPerEntry(maxFragments, sharedElements), layers, tileSize, coc, sortElements);
+
+				// Every sort group size dispatched for this entry size
+				for (int groupSize = sharedElements; groupSize <= Tiling::tileBufferMaxSortElements(maxFragments); groupSize *= 2)
+					check("sortGroupId", Tiling::FloatReference::sortGroupId(groupSize, sharedElements), Tiling::sortGroupId(groupSize, sharedElements), layers, tileSize, coc, sortElements);
+			}
 		}
 
+		// The cached overloads against the direct computation, changing one setting at a time
+		TiledSplatBlurComponent& component = object->component<TiledSplatBlurComponent>();
+		const int oldTileSize = component.m_tileSize, oldMaxCoc = component.m_maxCoC, oldMaxSortElements = component.m_maxSortElements;
+		const TiledSplatBlurComponent::TileBufferSizes oldSizes = component.m_tileBufferSizes;
+		for (int layers = 1; layers <= maxLayers; ++layers)
+		for (int tileSize = minTileSize; tileSize <= maxTileSize; tileSize += 4)
+		for (int coc = 8; coc <= maxCoc; coc += 8)
+		for (int sortElements : sortElementLimits)
+		{
+			component.m_tileSize = tileSize;
+			component.m_maxCoC = coc;
+			component.m_maxSortElements = sortElements;
+
+			const int maxFragments = Tiling::tileBufferMaxFragmentsPerEntry(layers, tileSize, coc);
+			const int sharedElements = Tiling::tileBufferMaxSortSharedElements(sortElements, maxFragments);
+			check("cached tileBufferMaxFragmentsPerEntry", maxFragments, Tiling::tileBufferMaxFragmentsPerEntry(scene, object, layers), layers, tileSize, coc, sortElements);
+			check("cached tileBufferMaxSortSharedElements", sharedElements, Tiling::tileBufferMaxSortSharedElements(scene, object, layers), layers, tileSize, coc, sortElements);
+			check("cached tileBufferMaxSortIterations", Tiling::tileBufferMaxSortIterations(maxFragments, sharedElements),
+				Tiling::tileBufferMaxSortIterations(scene, object, layers), layers, tileSize, coc, sortElements);
+			check("cached dispatchBufferMaxDispatchPerEntry", Tiling::dispatchBufferMaxDispatchPerEntry(maxFragments, sharedElements),
+				Tiling::dispatchBufferMaxDispatchPerEntry(scene, object, layers), layers, tileSize, coc, sortElements);
+		}
+		component.m_tileSize = oldTileSize;
+		component.m_maxCoC = oldMaxCoc;
+		component.m_maxSortElements = oldMaxSortElements;
+		component.m_tileBufferSizes = oldSizes;
+
+		if (numMismatches == 0)
+			Debug::log_info() << "Tile buffer sizing validation passed (" << numChecks << " checks)." << Debug::end;
+		else
+			Debug::log_error() << "Tile buffer sizing validation failed: " << numMismatches << " of " << numChecks << " checks differ." << Debug::end;
+
+		return numMismatches == 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkTileBufferSizes(Scene::Scene& scene, Scene::Object* object, const size_t numLookups, const size_t numUpdates)
+	{
+		TiledSplatBlurComponent const& component = object->component<TiledSplatBlurComponent>();
+		const int layers = GPU::numLayers();
+
+		// The per-call chain of lookups, as done before caching
+		size_t checksumReference = 0;
+		DateTime::Timer referenceTimer(true);
+		for (size_t i = 0; i < numLookups; ++i)
+		{
+			const int maxFragments = Tiling::FloatReference::tileBufferMaxFragmentsPerEntry(layers, component.m_tileSize, component.m_maxCoC);
+			const int sharedElements = Tiling::FloatReference::tileBufferMaxSortSharedElements(component.m_maxSortElements, maxFragments);
+			checksumReference += maxFragments + sharedElements +
+				Tiling::FloatReference::tileBufferMaxSortIterations(maxFragments, sharedElements) +
+				Tiling::FloatReference::dispatchBufferMaxDispatchPerEntry(maxFragments, sharedElements);
+		}
+		referenceTimer.stop();
+
+		// The cached overloads
+		size_t checksumCached = 0;
+		DateTime::Timer cachedTimer(true);
+		for (size_t i = 0; i < numLookups; ++i)
+		{
+			checksumCached += Tiling::tileBufferMaxFragmentsPerEntry(scene, object, layers) +
+				Tiling::tileBufferMaxSortSharedElements(scene, object, layers) +
+				Tiling::tileBufferMaxSortIterations(scene, object, layers) +
+				Tiling::dispatchBufferMaxDispatchPerEntry(scene, object, layers);
+		}
+		cachedTimer.stop();
+
+		// The full buffer update, which also sizes the GPU buffers
+		DateTime::Timer updateTimer(true);
+		for (size_t i = 0; i < numUpdates; ++i)
+			Buffers::updateBuffers(scene, object);
+		updateTimer.stop();
+
+		Debug::log_info() << "Tile buffer sizing benchmark (" << layers << " layers, tile size " << component.m_tileSize << ", max CoC " << component.m_maxCoC << "):" << Debug::end;
+		Debug::log_info() << "  - float lookup chain: " << referenceTimer.getElapsedTime() * 1e9 / numLookups << " ns/call" << Debug::end;
+		Debug::log_info() << "  - cached lookups: " << cachedTimer.getElapsedTime() * 1e9 / numLookups << " ns/call" << Debug::end;
+		Debug::log_info() << "  - updateBuffers: " << updateTimer.getElapsedTime() * 1e3 / numUpdates << " ms/call (CPU)" << Debug::end;
+		if (checksumReference != checksumCached)
+			Debug::log_error() << "  - lookup checksums differ: " << checksumReference << " vs " << checksumCached << Debug::end;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace NeighborValidation
+	{
 		////////////////////////////////////////////////////////////////////////////////
-		void computePsfs(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		/** Row-major strides of a stack with the parameter shape, like the PSF stack storage. */
+		Aberration::PsfIndex stackStrides(Aberration::PsfIndex const& shape)
 		{
-			DelayedJobs::postJob(scene, object, "PSF Computation", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
-				{
-					Psfs::computePsfs(scene, &object);
-				});
+			Aberration::PsfIndex result;
+			result[5] = 1;
+			for (size_t d = 5; d > 0; --d)
+				result[d - 1] = result[d] * shape[d];
+			return result;
 		}
+
 		////////////////////////////////////////////////////////////////////////////////
-		void clearPsfCache(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		Aberration::PsfIndex decodeIndex(Aberration::PsfIndex const& strides, size_t psfId)
 		{
-			DelayedJobs::postJob(scene, object, "PSF Cache Clear", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
-				{
-					Psfs::clearPsfCache(scene, &object);
-				});
+			Aberration::PsfIndex result;
+			for (size_t d = 0; d < 6; ++d)
+			{
+				result[d] = psfId / strides[d];
+				psfId %= strides[d];
+			}
+			return result;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		void updateBuffers(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		/** Blur radius limits of a PSF and its neighbors, using the pairwise predicate over the whole stack. */
+		glm::ivec2 blurRadiusLimitsPairwise(Aberration::PsfIndex const& strides, const size_t numPsfs, const bool offAxis,
+			std::vector<glm::ivec2> const& psfLimits, Aberration::PsfIndex const& psfIndex)
 		{
-			DelayedJobs::postJob(scene, object, "Buffer Update", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
-				{
-					Buffers::updateBuffers(scene, &object);
-					PsfTexture::updateTexture(scene, &object);
-				});
+			glm::ivec2 result = glm::ivec2(INT_MAX, -INT_MAX);
+			for (size_t otherId = 0; otherId < numPsfs; ++otherId)
+			{
+				if (!Psfs::arePsfsSameOrNeighbors(psfIndex, decodeIndex(strides, otherId), offAxis)) continue;
+				result = glm::ivec2(glm::min(result[0], psfLimits[otherId][0]), glm::max(result[1], psfLimits[otherId][1]));
+			}
+			return result;
 		}
+	}
 
-		////////////////////////////////////////////////////////////////////////////////
-		void updateDerivedParameters(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
-		{
-			DelayedJobs::postJob(scene, object, "PSF Data Upload", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
-				{
-					Psfs::updateDerivedParameters(scene, &object);
-				});
-		};
+	////////////////////////////////////////////////////////////////////////////////
+	bool validatePsfNeighbors(const size_t numStacks)
+	{
+		Debug::log_info() << "Validating the PSF neighbor stencil..." << Debug::end;
 
-		////////////////////////////////////////////////////////////////////////////////
-		void uploadPsfData(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
+		std::mt19937 generator(1234);
+		auto extent = [&](const size_t maxExtent) { return std::uniform_int_distribution<size_t>(1, maxExtent)(generator); };
+		std::uniform_int_distribution<int> radius(0, 64);
+
+		size_t numPsfsTotal = 0, numMismatches = 0;
+		for (size_t stackId = 0; stackId < numStacks; ++stackId)
 		{
-			DelayedJobs::postJob(scene, object, "PSF Data Upload", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
+			// Random stack shape: defocus, horizontal, vertical, channel, aperture and focus
+			const Aberration::PsfIndex shape = { extent(6), extent(4), extent(4), extent(2), extent(3), extent(3) };
+			const Aberration::PsfIndex strides = NeighborValidation::stackStrides(shape);
+			const size_t numPsfs = strides[0] * shape[0];
+			numPsfsTotal += numPsfs;
+
+			// Random per-PSF radius limits
+			std::vector<glm::ivec2> psfLimits(numPsfs);
+			for (glm::ivec2& limits : psfLimits)
+			{
+				const int a = radius(generator), b = radius(generator);
+				limits = glm::ivec2(glm::min(a, b), glm::max(a, b));
+			}
+
+			for (const TiledSplatBlurComponent::PsfAxisMethod axisMethod : { TiledSplatBlurComponent::OnAxis, TiledSplatBlurComponent::OffAxis })
+			{
+				const bool offAxis = axisMethod == TiledSplatBlurComponent::OffAxis;
+				TiledSplatBlurComponent::PsfNeighborStencil stencil;
+				Psfs::buildNeighborStencil(shape, strides, axisMethod, stencil);
+
+				std::atomic<size_t> numStackMismatches = 0;
+				Threading::threadedExecuteIndices(Threading::numThreads(),
+					[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
 				{
-					Buffers::uploadPsfData(scene, &object);
-				});
-		};
+					const Aberration::PsfIndex psfIndex = NeighborValidation::decodeIndex(strides, psfId);
 
-		////////////////////////////////////////////////////////////////////////////////
-		void loadShaders(Scene::Scene& scene, Scene::Object* object, int delayFrames = 1)
-		{
-			DelayedJobs::postJob(scene, object, "Shader Loading", false, delayFrames,
-				[](Scene::Scene& scene, Scene::Object& object)
+					// The neighbor set, and the flat index handed out with each neighbor
+					std::vector<size_t> neighbors, neighborsPairwise;
+					bool flatIndicesMatch = true;
+					Psfs::forEachPsfNeighbor(stencil, psfIndex, [&](Aberration::PsfIndex const& neighborIndex, const size_t neighborId)
+					{
+						neighbors.push_back(neighborId);
+						flatIndicesMatch &= Psfs::flatPsfIndex(stencil, neighborIndex) == neighborId;
+					});
+					for (size_t otherId = 0; otherId < numPsfs; ++otherId)
+						if (Psfs::arePsfsNeighbors(psfIndex, NeighborValidation::decodeIndex(strides, otherId), offAxis))
+							neighborsPairwise.push_back(otherId);
+					std::sort(neighbors.begin(), neighbors.end());
+
+					// The combined radius limits
+					const glm::ivec2 limits = Psfs::blurRadiusLimitsEntry(stencil, psfLimits, psfIndex);
+					const glm::ivec2 limitsPairwise = NeighborValidation::blurRadiusLimitsPairwise(strides, numPsfs, offAxis, psfLimits, psfIndex);
+
+					if (neighbors != neighborsPairwise || !flatIndicesMatch || limits != limitsPairwise)
+						++numStackMismatches;
+				},
+				numPsfs);
+
+				if (numStackMismatches > 0)
 				{
-					ResourceLoading::loadShaders(scene, &object);
-				});
+					Debug::log_error() << "Stack " << stackId << " (" << shape[0] << "x" << shape[1] << "x" << shape[2] << "x" << shape[3] << "x" << shape[4] << "x" << shape[5]
+						<< ", " << std::string(TiledSplatBlurComponent::PsfAxisMethod_value_to_string(axisMethod)) << "): "
+						<< numStackMismatches << " of " << numPsfs << " PSFs differ from the pairwise predicates." << Debug::end;
+					numMismatches += numStackMismatches;
+				}
+			}
 		}
+
+		if (numMismatches == 0)
+			Debug::log_info() << "PSF neighbor validation passed (" << numStacks << " stacks, " << numPsfsTotal << " PSFs, both axis methods)." << Debug::end;
+		else
+			Debug::log_error() << "PSF neighbor validation failed." << Debug::end;
+
+		return numMismatches == 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkPsfNeighbors(const size_t numPsfs, const size_t numPairwiseSamples)
+	{
+		// An off-axis stack with about the requested number of PSFs
+		const Aberration::PsfIndex baseShape = { 41, 7, 7, 3, 1, 1 };
+		const size_t numApertureFocus = glm::max(numPsfs / (baseShape[0] * baseShape[1] * baseShape[2] * baseShape[3]), size_t(1));
+		const size_t numApertures = size_t(glm::ceil(glm::sqrt(float(numApertureFocus))));
+		const Aberration::PsfIndex shape = { baseShape[0], baseShape[1], baseShape[2], baseShape[3], numApertures, (numApertureFocus + numApertures - 1) / numApertures };
+		const Aberration::PsfIndex strides = NeighborValidation::stackStrides(shape);
+		const size_t numTotalPsfs = strides[0] * shape[0];
+
+		std::mt19937 generator(1234);
+		std::uniform_int_distribution<int> radius(0, 64);
+		std::vector<glm::ivec2> psfLimits(numTotalPsfs);
+		for (glm::ivec2& limits : psfLimits)
+		{
+			const int a = radius(generator), b = radius(generator);
+			limits = glm::ivec2(glm::min(a, b), glm::max(a, b));
+		}
+
+		// Stencil: build once, then visit the neighbors of every PSF
+		DateTime::Timer stencilTimer(true);
+		TiledSplatBlurComponent::PsfNeighborStencil stencil;
+		Psfs::buildNeighborStencil(shape, strides, TiledSplatBlurComponent::OffAxis, stencil);
+		std::vector<glm::ivec2> limits(numTotalPsfs);
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+		{
+			limits[psfId] = Psfs::blurRadiusLimitsEntry(stencil, psfLimits, NeighborValidation::decodeIndex(strides, psfId));
+		},
+		numTotalPsfs);
+		stencilTimer.stop();
+
+		// Pairwise predicates: O(N^2), so only time a sample of the PSFs and extrapolate
+		const size_t numSamples = glm::min(numPairwiseSamples, numTotalPsfs);
+		const size_t sampleStride = numTotalPsfs / numSamples;
+		size_t numDifferent = 0;
+		std::vector<glm::ivec2> limitsPairwise(numSamples);
+		DateTime::Timer pairwiseTimer(true);
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t sampleId)
+		{
+			limitsPairwise[sampleId] = NeighborValidation::blurRadiusLimitsPairwise(strides, numTotalPsfs, true, psfLimits,
+				NeighborValidation::decodeIndex(strides, sampleId * sampleStride));
+		},
+		numSamples);
+		pairwiseTimer.stop();
+		for (size_t sampleId = 0; sampleId < numSamples; ++sampleId)
+			numDifferent += limitsPairwise[sampleId] != limits[sampleId * sampleStride] ? 1 : 0;
+
+		Debug::log_info() << "PSF neighbor benchmark (" << numTotalPsfs << " PSFs, " << stencil.m_offsets.size() << " stencil entries):" << Debug::end;
+		Debug::log_info() << "  - stencil: " << stencilTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - pairwise: " << pairwiseTimer.getElapsedTime() * 1e3 << " ms for " << numSamples << " PSFs, "
+			<< pairwiseTimer.getElapsedTime() * 1e3 * numTotalPsfs / numSamples << " ms estimated for the full stack" << Debug::end;
+		if (numDifferent > 0)
+			Debug::log_error() << "  - " << numDifferent << " of " << numSamples << " sampled PSFs have different limits" << Debug::end;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -1924,17 +4001,6 @@ namespace TiledSplatBlur
 	void renderObjectOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, 
 		Scene::Object* camera, std::string const& functionName, Scene::Object* object)
 	{
-		// Aberration and PSF stack
-		auto& aberration = Psfs::getAberration(scene, object);
-		auto& psfStack = Psfs::getPsfStack(scene, object);
-		const size_t numDefocuses = psfStack.m_psfs.size();
-		const size_t numHorizontal = psfStack.m_psfs[0].size();
-		const size_t numVertical = psfStack.m_psfs[0][0].size();
-		const size_t numChannels = psfStack.m_psfs[0][0][0].size();
-		const size_t numApertures = psfStack.m_psfs[0][0][0][0].size();
-		const size_t numFocuses = psfStack.m_psfs[0][0][0][0][0].size();
-		auto const& psfParameters = aberration.m_psfParameters.m_evaluatedParameters;
-
 		// Compute the number of work groups
 		const glm::ivec2 numTiles = Tiling::computeNumTiles(scene, object);
 
@@ -1963,30 +4029,23 @@ namespace TiledSplatBlur
 			RenderSettings::swapGbufferBuffers(scene, simulationSettings, renderSettings);
 		}
 
-		// Compute the padded resolution (size of the area spanned by the spawned tiles)
-		const glm::ivec2 paddedResolution = Tiling::computePaddedResolution(scene, object);
+		// Capture the input for comparing against the CPU reference
+		const bool compareCpuReference = object->component<TiledSplatBlurComponent>().m_validateCpuReference;
+		CpuReferenceInput cpuReferenceInput;
+		if (compareCpuReference)
+			ReferenceCapture::readInput(scene, renderSettings, camera, renderResolution, cpuReferenceInput);
 
-		// Merged block size
-		const size_t mergedFragmentSize = Tiling::fragmentBlockSize(scene, object);
-
-		// Find the minimum and maximum blur radius
-		// TODO: consider the current aperture and focus settings to determine this
+		// Find the maximum blur radius
 		const glm::ivec2 minMaxRadiusCurrent = Psfs::blurRadiusLimitsCurrent(scene, object);
-		const glm::ivec2 minMaxRadiusGlobal = Psfs::blurRadiusLimitsGlobal(scene, object);
 
 		// Maximum buffer sizes with the current configuration
 		const size_t tileSize = object->component<TiledSplatBlurComponent>().m_tileSize;
 		const size_t numLayers = renderSettings->component<RenderSettings::RenderSettingsComponent>().m_layers.m_numLayers;
-		const size_t maxDiameter = size_t(minMaxRadiusCurrent[1]) * 2 + 1;
-		const size_t fragmentBufferMaxSubentries = Tiling::fragmentBufferMaxFragmentsPerEntry(scene, object, numLayers);
-		const size_t tileBufferMaxCenterSubentries = Tiling::tileBufferMaxCenterFragmentsPerEntry(numLayers, tileSize);
 		const size_t tileBufferMaxSubentries = Tiling::tileBufferMaxFragmentsPerEntry(numLayers, tileSize, minMaxRadiusCurrent[1]);
 
 		// Maximum sort values
 		const size_t maxSharedIndices = Tiling::tileBufferMaxSortSharedElements(scene, object, tileBufferMaxSubentries);
 		const size_t maxSortElements = Tiling::tileBufferMaxSortElements(tileBufferMaxSubentries);
-		const size_t numSortIterations = Tiling::tileBufferMaxSortIterations(tileBufferMaxSubentries, maxSharedIndices);
-		const size_t dispatchBufferMaxSubentries = Tiling::dispatchBufferMaxDispatchPerEntry(tileBufferMaxSubentries, maxSharedIndices);
 
 		// Distance between consecutive dispatch commands
 		const size_t dispatchBufferElementStride = 4 * sizeof(GLuint);
@@ -2013,67 +4072,8 @@ namespace TiledSplatBlur
 		{
 			Profiler::ScopedGpuPerfCounter category(scene, "Uniforms");
 
-			blurDataCommon.m_numTiles = numTiles;
-			blurDataCommon.m_renderResolution = renderResolution;
-			blurDataCommon.m_paddedResolution = paddedResolution;
-			blurDataCommon.m_cameraFov = glm::degrees(Camera::getFieldOfView(renderSettings, camera));
-			blurDataCommon.m_fragmentBufferSubentries = fragmentBufferMaxSubentries;
-			blurDataCommon.m_tileBufferCenterSubentries = tileBufferMaxCenterSubentries;
-			blurDataCommon.m_tileBufferTotalSubentries = tileBufferMaxSubentries;
-			blurDataCommon.m_numSortIterations = numSortIterations;
-
-			blurDataCommon.m_psfAxisMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfAxisMethod;
-			blurDataCommon.m_psfTextureFormat = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfTextureFormat;
-			blurDataCommon.m_psfTextureDepthLayout = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfTextureDepthLayout;
-			blurDataCommon.m_psfTextureAngleLayout = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfTextureAngleLayout;
-			blurDataCommon.m_weightScaleMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_weightScaleMethod;
-			blurDataCommon.m_weightRescaleMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_weightRescaleMethod;
-			blurDataCommon.m_outputMode = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_outputMode;
-			blurDataCommon.m_overlayMode = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_overlayMode;
-			blurDataCommon.m_accumulationMethod = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_accumulationMethod;
-
-			blurDataCommon.m_psfLayersS = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersS, 0.0f);
-			blurDataCommon.m_psfLayersP = glm::vec4(object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_psfLayersP, 0.0f);
-
-			blurDataCommon.m_numMergeSteps = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_fragmentMergeSteps;
-			blurDataCommon.m_mergedFragmentSize = mergedFragmentSize;
-
-			blurDataCommon.m_sortOffsetConstant = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_sortDepthOffset;
-			blurDataCommon.m_sortOffsetScale = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_sortDepthScale;
-
-			blurDataCommon.m_renderChannels = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_numWavelengths;
-			blurDataCommon.m_renderLayers = renderSettings->component<RenderSettings::RenderSettingsComponent>().m_layers.m_numLayers;
-			blurDataCommon.m_depthOffset = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_depthOffset;
-			blurDataCommon.m_alphaThreshold = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_alphaThreshold;
-			blurDataCommon.m_normalizeResult = object->component<TiledSplatBlur::TiledSplatBlurComponent>().m_normalizeResult ? 1.0f : 0.0f;
-
-			blurDataCommon.m_minBlurRadiusCurrent = minMaxRadiusCurrent[0];
-			blurDataCommon.m_maxBlurRadiusCurrent = minMaxRadiusCurrent[1];
-			blurDataCommon.m_minBlurRadiusGlobal = minMaxRadiusGlobal[0];
-			blurDataCommon.m_maxBlurRadiusGlobal = minMaxRadiusGlobal[1];
-			blurDataCommon.m_numDefocuses = numDefocuses;
-			blurDataCommon.m_numHorizontalAngles = numHorizontal;
-			blurDataCommon.m_numVerticalAngles = numVertical;
-			blurDataCommon.m_numChannels = numChannels;
-			blurDataCommon.m_numApertures = numApertures;
-			blurDataCommon.m_numFocuses = numFocuses;
-			blurDataCommon.m_objectDistancesMin = psfParameters.m_objectDioptres.front();
-			blurDataCommon.m_objectDistancesMax = psfParameters.m_objectDioptres.back();
-			blurDataCommon.m_objectDistancesStep = psfParameters.m_objectDistancesRange.m_step;
-			blurDataCommon.m_apertureMin = psfParameters.m_apertureDiameters.front();
-			blurDataCommon.m_apertureMax = psfParameters.m_apertureDiameters.back();
-			blurDataCommon.m_apertureStep = psfParameters.m_apertureDiametersRange.m_step;
-			blurDataCommon.m_focusDistanceMin = psfParameters.m_focusDioptres.front();
-			blurDataCommon.m_focusDistanceMax = psfParameters.m_focusDioptres.back();
-			blurDataCommon.m_focusDistanceStep = psfParameters.m_focusDistancesRange.m_step;
-			blurDataCommon.m_incidentAnglesHorMin = psfParameters.m_incidentAnglesHorizontal.front();
-			blurDataCommon.m_incidentAnglesHorMax = psfParameters.m_incidentAnglesHorizontal.back();
-			blurDataCommon.m_incidentAnglesHorStep = psfParameters.m_incidentAnglesHorizontalRange.m_step;
-			blurDataCommon.m_incidentAnglesVertMin = psfParameters.m_incidentAnglesVertical.front();
-			blurDataCommon.m_incidentAnglesVertMax = psfParameters.m_incidentAnglesVertical.back();
-			blurDataCommon.m_incidentAnglesVertStep = psfParameters.m_incidentAnglesVerticalRange.m_step;
-
-			uploadBufferData(scene, "TiledSplatBlurCommon", blurDataCommon);
+			blurDataCommon = Uniforms::commonData(scene, renderSettings, camera, object, renderResolution);
+			uploadTransientBufferData(scene, "TiledSplatBlurCommon", blurDataCommon);
 		}
 
 		// Bind the SSBOs
@@ -2431,6 +4431,13 @@ namespace TiledSplatBlur
 		// Swap read buffers
 		RenderSettings::swapGbufferBuffers(scene, simulationSettings, renderSettings);
 
+		// Compare the result against the CPU reference
+		if (compareCpuReference)
+		{
+			object->component<TiledSplatBlurComponent>().m_validateCpuReference = false;
+			ReferenceCapture::compareGpuOutput(scene, renderSettings, object, cpuReferenceInput);
+		}
+
 		// Upscale, if needed
 		if (renderResolution != outputResolution)
 		{
@@ -2575,6 +4582,40 @@ namespace TiledSplatBlur
 			ImGui::EndTabItem();
 		}
 
+		// Validation and benchmarks
+		if (ImGui::BeginTabItem("Validation", activeTab.c_str()))
+		{
+			if (ImGui::Button("Validate CPU Reference"))
+			{
+				validateCpuReference(scene, object);
+			}
+			if (ImGui::Button("Validate PSF Weights"))
+			{
+				validatePsfWeights(scene, object);
+			}
+			if (ImGui::Button("Validate PSF Neighbors"))
+			{
+				validatePsfNeighbors();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark PSF Neighbors"))
+			{
+				benchmarkPsfNeighbors();
+			}
+			if (ImGui::Button("Validate Tile Buffer Sizes"))
+			{
+				validateTileBufferSizes(scene, object);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Tile Buffer Sizes"))
+			{
+				benchmarkTileBufferSizes(scene, object);
+			}
+
+			EditorSettings::editorProperty<std::string>(scene, object, "MainTabBar_SelectedTab") = ImGui::CurrentTabItemName();
+			ImGui::EndTabItem();
+		}
+
 		// End the tab bar
 		ImGui::EndTabBar();
 
@@ -182,79 +182,121 @@ namespace TiledSplatBlur
 			float m_blurRadiusDeg;
 		};
 		std::vector<DerivedPsfParameters> m_derivedPsfParameters;
+
+		// Cached tile buffer sizes, along with the settings they were computed for
+		struct TileBufferSizes
+		{
+			int m_layers = -1;
+			int m_tileSize = -1;
+			int m_maxCoc = -1;
+			int m_maxSortElements = -1;
+
+			int m_maxFragmentsPerEntry = 0;
+			int m_maxSortSharedElements = 0;
+			int m_maxSortIterations = 0;
+			int m_maxDispatchPerEntry = 0;
+		};
+		TileBufferSizes m_tileBufferSizes;
+
+		// Whether the next frame should be compared against the CPU reference
+		bool m_validateCpuReference = false;
+
+		// Cached neighborhood of a PSF in the stack, along with the stack shape and axis method it was built for
+		struct PsfNeighborStencil
+		{
+			Aberration::PsfIndex m_shape{};
+			Aberration::PsfIndex m_strides{};
+			int m_psfAxisMethod = -1;
+
+			// Per-axis offsets of each neighbor, and the matching offsets of their flat indices
+			std::vector<std::array<int, 6>> m_offsets;
+			std::vector<ptrdiff_t> m_flatOffsets;
+		};
+		PsfNeighborStencil m_psfNeighborStencil;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Tiled splat blur common parameters. */
-	struct UniformDataCommon
-	{
+	make_gpu_struct(UniformDataCommon, std140,
 		// Common, pre-computed values
-		glm::uvec2 m_numTiles;
-		glm::ivec2 m_renderResolution;
-		glm::ivec2 m_paddedResolution;
-		glm::vec2 m_cameraFov;
-		GLuint m_fragmentBufferSubentries;
-		GLuint m_tileBufferCenterSubentries;
-		GLuint m_tileBufferTotalSubentries;
-		GLuint m_numSortIterations;
+		(glm::uvec2, m_numTiles)
+		(glm::ivec2, m_renderResolution)
+		(glm::ivec2, m_paddedResolution)
+		(glm::vec2, m_cameraFov)
+		(GLuint, m_fragmentBufferSubentries)
+		(GLuint, m_tileBufferCenterSubentries)
+		(GLuint, m_tileBufferTotalSubentries)
+		(GLuint, m_numSortIterations)
 
 		// Run modes
-		GLuint m_psfAxisMethod;
-		GLuint m_psfTextureFormat;
-		GLuint m_psfTextureDepthLayout;
-		GLuint m_psfTextureAngleLayout;
-		GLuint m_weightScaleMethod;
-		GLuint m_weightRescaleMethod;
-		GLuint m_outputMode;
-		GLuint m_overlayMode;
-		GLuint m_accumulationMethod;
+		(GLuint, m_psfAxisMethod)
+		(GLuint, m_psfTextureFormat)
+		(GLuint, m_psfTextureDepthLayout)
+		(GLuint, m_psfTextureAngleLayout)
+		(GLuint, m_weightScaleMethod)
+		(GLuint, m_weightRescaleMethod)
+		(GLuint, m_outputMode)
+		(GLuint, m_overlayMode)
+		(GLuint, m_accumulationMethod)
 
 		// PSF texture settings
-		alignas(sizeof(glm::vec4)) glm::vec4 m_psfLayersS;
-		alignas(sizeof(glm::vec4)) glm::vec4 m_psfLayersP;
+		(glm::vec4, m_psfLayersS)
+		(glm::vec4, m_psfLayersP)
 
 		// Merge settings
-		GLuint m_numMergeSteps;
-		GLuint m_mergedFragmentSize;
+		(GLuint, m_numMergeSteps)
+		(GLuint, m_mergedFragmentSize)
 
 		// Sort settings
-		GLfloat m_sortOffsetConstant;
-		GLfloat m_sortOffsetScale;
+		(GLfloat, m_sortOffsetConstant)
+		(GLfloat, m_sortOffsetScale)
 
 		// Convolution settings
-		GLuint m_renderChannels;
-		GLuint m_renderLayers;
-		GLfloat m_depthOffset;
-		GLfloat m_alphaThreshold;
-		GLfloat m_normalizeResult;
+		(GLuint, m_renderChannels)
+		(GLuint, m_renderLayers)
+		(GLfloat, m_depthOffset)
+		(GLfloat, m_alphaThreshold)
+		(GLfloat, m_normalizeResult)
 
 		// PSF properties
-		GLuint m_minBlurRadiusCurrent;
-		GLuint m_maxBlurRadiusCurrent;
-		GLuint m_minBlurRadiusGlobal;
-		GLuint m_maxBlurRadiusGlobal;
-		GLuint m_numDefocuses;
-		GLuint m_numHorizontalAngles;
-		GLuint m_numVerticalAngles;
-		GLuint m_numChannels;
-		GLuint m_numApertures;
-		GLuint m_numFocuses;
-		GLfloat m_objectDistancesMin;
-		GLfloat m_objectDistancesMax;
-		GLfloat m_objectDistancesStep;
-		GLfloat m_apertureMin;
-		GLfloat m_apertureMax;
-		GLfloat m_apertureStep;
-		GLfloat m_focusDistanceMin;
-		GLfloat m_focusDistanceMax;
-		GLfloat m_focusDistanceStep;
-		GLfloat m_incidentAnglesHorMin;
-		GLfloat m_incidentAnglesHorMax;
-		GLfloat m_incidentAnglesHorStep;
-		GLfloat m_incidentAnglesVertMin;
-		GLfloat m_incidentAnglesVertMax;
-		GLfloat m_incidentAnglesVertStep;
-	};
+		(GLuint, m_minBlurRadiusCurrent)
+		(GLuint, m_maxBlurRadiusCurrent)
+		(GLuint, m_minBlurRadiusGlobal)
+		(GLuint, m_maxBlurRadiusGlobal)
+		(GLuint, m_numDefocuses)
+		(GLuint, m_numHorizontalAngles)
+		(GLuint, m_numVerticalAngles)
+		(GLuint, m_numChannels)
+		(GLuint, m_numApertures)
+		(GLuint, m_numFocuses)
+		(GLfloat, m_objectDistancesMin)
+		(GLfloat, m_objectDistancesMax)
+		(GLfloat, m_objectDistancesStep)
+		(GLfloat, m_apertureMin)
+		(GLfloat, m_apertureMax)
+		(GLfloat, m_apertureStep)
+		(GLfloat, m_focusDistanceMin)
+		(GLfloat, m_focusDistanceMax)
+		(GLfloat, m_focusDistanceStep)
+		(GLfloat, m_incidentAnglesHorMin)
+		(GLfloat, m_incidentAnglesHorMax)
+		(GLfloat, m_incidentAnglesHorStep)
+		(GLfloat, m_incidentAnglesVertMin)
+		(GLfloat, m_incidentAnglesVertMax)
+		(GLfloat, m_incidentAnglesVertStep)
+	);
+
+	// Offsets of the TiledSplatBlurData uniform block of common.glsl
+	static_assert(offsetof(UniformDataCommon, m_cameraFov) == 24, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_fragmentBufferSubentries) == 32, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_accumulationMethod) == 80, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_psfLayersS) == 96, "vec4 members must be aligned to a vec4.");
+	static_assert(offsetof(UniformDataCommon, m_psfLayersP) == 112, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_numMergeSteps) == 128, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_normalizeResult) == 160, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_numFocuses) == 200, "Unexpected UniformDataCommon layout.");
+	static_assert(offsetof(UniformDataCommon, m_incidentAnglesVertStep) == 260, "Unexpected UniformDataCommon layout.");
+	static_assert(sizeof(UniformDataCommon) == 272, "UniformDataCommon must be padded to a vec4.");
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Tiled splat blur PSF interpolation parameters. */
@@ -286,14 +328,74 @@ namespace TiledSplatBlur
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Tiled splat blur psf parameters. */
-	struct UniformDataPsfParam
+	make_gpu_struct(UniformDataPsfParam, std430,
+		(GLuint, m_minBlurRadius)
+		(GLuint, m_maxBlurRadius)
+		(GLuint, m_weightStartId)
+		(GLfloat, m_blurRadiusDeg)
+	);
+
+	static_assert(offsetof(UniformDataPsfParam, m_blurRadiusDeg) == 12 && sizeof(UniformDataPsfParam) == 16, "Unexpected UniformDataPsfParam layout.");
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Input of the CPU reference implementation. */
+	struct CpuReferenceInput
+	{
+		// Resolution of the input images
+		glm::ivec2 m_resolution;
+
+		// Per-pixel color, in row-major order
+		std::vector<glm::vec3> m_color;
+
+		// Per-pixel distance to the eye (in meters), in row-major order
+		std::vector<float> m_distance;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Output of the CPU reference implementation. */
+	struct CpuReferenceOutput
 	{
-		GLuint m_minBlurRadius;
-		GLuint m_maxBlurRadius;
-		GLuint m_weightStartId;
-		GLfloat m_blurRadiusDeg;
+		// The blurred image, in the layout of the input
+		std::vector<glm::vec3> m_color;
+
+		// Number of fragments left after merging
+		size_t m_numFragments = 0;
+
+		// Number of fragments splatted onto neighboring tiles
+		size_t m_numSplats = 0;
+
+		// Number of splats that did not fit in the tile buffers
+		size_t m_numDroppedSplats = 0;
 	};
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Runs the full blur pipeline on the CPU, for validating the GPU implementation without a GL context. */
+	bool renderCpuReference(Scene::Scene& scene, Scene::Object* object, CpuReferenceInput const& input, CpuReferenceOutput& output);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times the CPU reference against a dense per-pixel gather on synthetic scenes, and schedules a comparison against the GPU output of the next frame. */
+	bool validateCpuReference(Scene::Scene& scene, Scene::Object* object, glm::ivec2 const& resolution = glm::ivec2(192, 108));
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks that the chunked PSF weight generation reproduces the monolithic weight buffer bit for bit. */
+	bool validatePsfWeights(Scene::Scene& scene, Scene::Object* object);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the integer and cached tile buffer sizing helpers against the original floating-point formulas over a grid of settings. */
+	bool validateTileBufferSizes(Scene::Scene& scene, Scene::Object* object);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times the tile buffer size lookups, cached and uncached, and the CPU side of the buffer update. */
+	void benchmarkTileBufferSizes(Scene::Scene& scene, Scene::Object* object, const size_t numLookups = 1 << 22, const size_t numUpdates = 16);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the PSF neighbor stencil against the pairwise neighbor predicates over random stack shapes. */
+	bool validatePsfNeighbors(const size_t numStacks = 64);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times the neighbor radius limits from the stencil against the pairwise predicates, on a stack of about the requested size. */
+	void benchmarkPsfNeighbors(const size_t numPsfs = 100000, const size_t numPairwiseSamples = 1024);
+
 	////////////////////////////////////////////////////////////////////////////////
 	void initObject(Scene::Scene& scene, Scene::Object& object);
 
@@ -1,6 +1,9 @@
 #include "PCH.h"
 #include "WavefrontAberration.h"
 
+#include <immintrin.h>
+#include <random>
+
 // TODO: make a custom object for previewing aberrations, instead of 'PSF' inside the preview settings
 
 namespace Aberration
@@ -1116,18 +1119,97 @@ namespace Aberration
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	Psf resizePsf(Scene::Scene& scene, WavefrontAberration& aberration, Psf const& psf, size_t radius)
+	namespace PsfResizing
 	{
-		static std::unordered_map<PSFStackParameters::InterpolationType, cv::InterpolationFlags> s_interpolationModes =
+		////////////////////////////////////////////////////////////////////////////////
+		/** OpenCV interpolation flags, in the order of PSFStackParameters::InterpolationType. */
+		static constexpr std::array<cv::InterpolationFlags, 5> s_interpolationModes =
+		{
+			cv::INTER_NEAREST,  // Nearest
+			cv::INTER_LINEAR,   // Bilinear
+			cv::INTER_CUBIC,    // Cubic
+			cv::INTER_LANCZOS4, // Lanczos
+			cv::INTER_AREA,     // Area
+		};
+		static_assert(PSFStackParameters::Area == s_interpolationModes.size() - 1, "Interpolation mode table out of sync.");
+
+		////////////////////////////////////////////////////////////////////////////////
+		cv::InterpolationFlags interpolationMode(WavefrontAberration const& aberration)
+		{
+			return s_interpolationModes[aberration.m_psfParameters.m_interpolationType];
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Scratch OpenCV buffers, reused between consecutive resizes. */
+		struct ResizeBuffers
 		{
-			{ PSFStackParameters::InterpolationType::Nearest, cv::INTER_NEAREST },
-			{ PSFStackParameters::InterpolationType::Bilinear, cv::INTER_LINEAR },
-			{ PSFStackParameters::InterpolationType::Cubic, cv::INTER_CUBIC },
-			{ PSFStackParameters::InterpolationType::Lanczos, cv::INTER_LANCZOS4 },
-			{ PSFStackParameters::InterpolationType::Area, cv::INTER_AREA },
+			cv::Mat m_in;
+			cv::Mat m_out;
 		};
 
-		return Eigen::resize(psf, Eigen::Vector2i(radius * 2 + 1, radius * 2 + 1), s_interpolationModes[aberration.m_psfParameters.m_interpolationType]);
+		////////////////////////////////////////////////////////////////////////////////
+		void resize(ResizeBuffers& buffers, const int interpolation, Psf const& psf, const size_t radius, Psf& out)
+		{
+			const int diameter = int(radius * 2 + 1);
+			cv::eigen2cv(psf, buffers.m_in);
+			cv::resize(buffers.m_in, buffers.m_out, cv::Size(diameter, diameter), 0, 0, interpolation);
+			cv::cv2eigen(buffers.m_out, out);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Resizes to a fractional radius: blends the normalized PSFs for the two closest integer radii, in place in the output. */
+		void resize(ResizeBuffers& buffers, const int interpolation, Psf const& psf, const float radius, Psf& smaller, Psf& out)
+		{
+			// Special case for when the output radius is exactly 0
+			if (radius < 1e-3f)
+			{
+				resize(buffers, interpolation, psf, size_t(0), out);
+				return;
+			}
+
+			const size_t radiusLarger = size_t(glm::ceil(radius));
+			const size_t radiusSmaller = size_t(glm::floor(radius));
+			const float alpha = glm::fract(radius);
+
+			// Start from the larger PSF
+			resize(buffers, interpolation, psf, radiusLarger, out);
+			if (radiusLarger == radiusSmaller)
+			{
+				out /= out.sum();
+				return;
+			}
+			out *= alpha / out.sum();
+
+			// Blend the smaller one into the center
+			resize(buffers, interpolation, psf, radiusSmaller, smaller);
+			const Eigen::Index offset = Eigen::Index(radiusLarger - radiusSmaller);
+			out.block(offset, offset, smaller.rows(), smaller.cols()) += ((1.0f - alpha) / smaller.sum()) * smaller;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** The original fractional-radius resize, with two full resizes and a padded blend; kept as the validation reference. */
+		Psf resizeReference(const int interpolation, Psf const& psf, const float radius)
+		{
+			if (radius < 1e-3f) return Eigen::resize(psf, Eigen::Vector2i(1, 1), interpolation);
+
+			const int diameterLarger = int(glm::ceil(radius)) * 2 + 1, diameterSmaller = int(glm::floor(radius)) * 2 + 1;
+			Psf larger = Eigen::resize(psf, Eigen::Vector2i(diameterLarger, diameterLarger), interpolation);
+			larger = larger / larger.sum();
+
+			Psf smaller = Eigen::pad(Eigen::resize(psf, Eigen::Vector2i(diameterSmaller, diameterSmaller), interpolation), larger.rows(), larger.cols());
+			smaller = smaller / smaller.sum();
+
+			return (1.0f - glm::fract(radius)) * smaller + glm::fract(radius) * larger;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Psf resizePsf(Scene::Scene& scene, WavefrontAberration& aberration, Psf const& psf, size_t radius)
+	{
+		PsfResizing::ResizeBuffers buffers;
+		Psf result;
+		PsfResizing::resize(buffers, PsfResizing::interpolationMode(aberration), psf, radius, result);
+		return result;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -1140,18 +1222,25 @@ namespace Aberration
 	////////////////////////////////////////////////////////////////////////////////
 	Psf resizePsf(Scene::Scene& scene, WavefrontAberration& aberration, Psf const& psf, float radius)
 	{
-		// Special case for when the output radius is exactly 0
-		if (radius < 1e-3f) return resizePsf(scene, aberration, psf, size_t(0));
+		PsfResizing::ResizeBuffers buffers;
+		Psf smaller, result;
+		PsfResizing::resize(buffers, PsfResizing::interpolationMode(aberration), psf, radius, smaller, result);
+		return result;
+	}
 
-		// Resize to the two closest radii
-		Psf larger = resizePsf(scene, aberration, psf, size_t(glm::ceil(radius)));
-		larger = larger / larger.sum();
+	////////////////////////////////////////////////////////////////////////////////
+	void resizePsfBatch(Scene::Scene& scene, WavefrontAberration& aberration, std::vector<Psf> const& psfs, std::vector<float> const& radii, std::vector<Psf>& out)
+	{
+		assert(psfs.size() == radii.size());
 
-		Psf smaller = Eigen::pad(resizePsf(scene, aberration, psf, size_t(glm::floor(radius))), larger.rows(), larger.cols());
-		smaller = smaller / smaller.sum();
+		// Shared setup for the whole batch
+		const int interpolation = PsfResizing::interpolationMode(aberration);
+		PsfResizing::ResizeBuffers buffers;
+		Psf smaller;
 
-		// Interpolate between the two
-		return (1.0f - glm::fract(radius)) * smaller + glm::fract(radius) * larger;
+		out.resize(psfs.size());
+		for (size_t psfId = 0; psfId < psfs.size(); ++psfId)
+			PsfResizing::resize(buffers, interpolation, psfs[psfId], radii[psfId], smaller, out[psfId]);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -1161,71 +1250,1041 @@ namespace Aberration
 		return psfResized / psfResized.sum();	
 	}
 
-	////////////////////////////////////////////////////////////////////////////////
-	Psf getProjectedPsf(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfStackElements::PsfEntry const& psf, const glm::ivec2 renderResolution, const float fovy)
-	{
-		return resizePsf(scene, aberration, psf.m_psf, blurRadiusPixels(psf, renderResolution, fovy));
-	}
+	////////////////////////////////////////////////////////////////////////////////
+	namespace PsfCompaction
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		// Dynamic range of the log-quantized samples, in powers of two below the PSF maximum
+		static constexpr float s_logQuantizedRange = 24.0f;
+
+		// Largest log-quantized code; code 0 is reserved for zero
+		static constexpr uint32_t s_logQuantizedMaxCode = 65535;
+
+		////////////////////////////////////////////////////////////////////////////////
+		uint16_t encodeLogQuantized(const float normalized)
+		{
+			if (normalized <= 0.0f) return 0;
+			const float t = (glm::log2(glm::min(normalized, 1.0f)) + s_logQuantizedRange) / s_logQuantizedRange;
+			if (t < 0.0f) return 0;
+			return uint16_t(1 + uint32_t(glm::round(t * float(s_logQuantizedMaxCode - 1))));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Maps each log-quantized code to its normalized value. */
+		std::array<float, 65536> const& logQuantizedTable()
+		{
+			static const std::array<float, 65536> s_table = []()
+			{
+				std::array<float, 65536> result;
+				result[0] = 0.0f;
+				for (uint32_t code = 1; code <= s_logQuantizedMaxCode; ++code)
+					result[code] = glm::exp2(float(code - 1) / float(s_logQuantizedMaxCode - 1) * s_logQuantizedRange - s_logQuantizedRange);
+				return result;
+			}();
+			return s_table;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void encodeSamples(const PSFStackParameters::PsfStorage storage, const float* samples, const float scale, const size_t numSamples, uint16_t* out)
+		{
+			const float invScale = 1.0f / scale;
+			if (storage == PSFStackParameters::Float16)
+			{
+				// Convert 8 samples at a time
+				const __m256 scaleVec = _mm256_set1_ps(invScale);
+				size_t i = 0;
+				for (; i + 8 <= numSamples; i += 8)
+					_mm_storeu_si128((__m128i*)(out + i), _mm256_cvtps_ph(_mm256_mul_ps(_mm256_loadu_ps(samples + i), scaleVec), _MM_FROUND_TO_NEAREST_INT));
+				for (; i < numSamples; ++i)
+					out[i] = _cvtss_sh(samples[i] * invScale, _MM_FROUND_TO_NEAREST_INT);
+			}
+			else if (storage == PSFStackParameters::LogQuantized)
+			{
+				for (size_t i = 0; i < numSamples; ++i)
+					out[i] = encodeLogQuantized(samples[i] * invScale);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		void decodeSamples(const PSFStackParameters::PsfStorage storage, const uint16_t* samples, const float scale, const size_t numSamples, float* out)
+		{
+			if (storage == PSFStackParameters::Float16)
+			{
+				// Convert 8 samples at a time
+				const __m256 scaleVec = _mm256_set1_ps(scale);
+				size_t i = 0;
+				for (; i + 8 <= numSamples; i += 8)
+					_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(samples + i))), scaleVec));
+				for (; i < numSamples; ++i)
+					out[i] = _cvtsh_ss(samples[i]) * scale;
+			}
+			else if (storage == PSFStackParameters::LogQuantized)
+			{
+				std::array<float, 65536> const& table = logQuantizedTable();
+				for (size_t i = 0; i < numSamples; ++i)
+					out[i] = table[samples[i]] * scale;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void decodePsfSamples(const PSFStackParameters::PsfStorage storage, const uint16_t* samples, const float scale, const size_t numSamples, float* out)
+	{
+		PsfCompaction::decodeSamples(storage, samples, scale, numSamples, out);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Psf const& getPsf(Scene::Scene& scene, WavefrontAberration const& aberration, PsfStackElements::PsfEntry const& psf, Psf& scratch)
+	{
+		PsfStackElements::CompactPsf const& compact = psf.m_compact;
+		if (compact.m_storage == PSFStackParameters::Full)
+			return psf.m_psf;
+
+		scratch.resize(compact.m_rows, compact.m_cols);
+		PsfCompaction::decodeSamples(compact.m_storage, aberration.m_psfStack.m_compactPsfSamples.data() + compact.m_offset,
+			compact.m_scale, scratch.size(), scratch.data());
+		return scratch;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Psf getPsf(Scene::Scene& scene, WavefrontAberration const& aberration, PsfStackElements::PsfEntry const& psf)
+	{
+		Psf scratch;
+		return getPsf(scene, aberration, psf, scratch);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::pair<size_t, size_t> getPsfSize(PsfStackElements::PsfEntry const& psf)
+	{
+		if (psf.m_compact.m_storage == PSFStackParameters::Full)
+			return { size_t(psf.m_psf.rows()), size_t(psf.m_psf.cols()) };
+		return { size_t(psf.m_compact.m_rows), size_t(psf.m_compact.m_cols) };
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace PsfResampling
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		float sinc(const float x)
+		{
+			return glm::abs(x) < 1e-5f ? 1.0f : glm::sin(glm::pi<float>() * x) / (glm::pi<float>() * x);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Cubic convolution kernel; uses the same sharpness as OpenCV. */
+		float cubic(const float x)
+		{
+			static const float A = -0.75f;
+			const float t = glm::abs(x);
+			if (t <= 1.0f) return ((A + 2.0f) * t - (A + 3.0f)) * t * t + 1.0f;
+			if (t < 2.0f) return ((A * t - 5.0f * A) * t + 8.0f * A) * t - 4.0f * A;
+			return 0.0f;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float lanczos4(const float x)
+		{
+			return glm::abs(x) < 4.0f ? sinc(x) * sinc(x / 4.0f) : 0.0f;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Accumulates a single tap into the weight matrix, replicating the border pixels. */
+		void addTap(EigenTypes::ScalarMatrixFinal& weights, const size_t dst, const int src, const float weight)
+		{
+			weights(dst, glm::clamp(src, 0, int(weights.cols()) - 1)) += weight;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Builds the 1D (dstSize x srcSize) filter matrix, following the sampling conventions of cv::resize. */
+		EigenTypes::ScalarMatrixFinal filterWeights(PSFStackParameters::InterpolationType interpolation, const size_t srcSize, const size_t dstSize)
+		{
+			EigenTypes::ScalarMatrixFinal weights = EigenTypes::ScalarMatrixFinal::Zero(dstSize, srcSize);
+			const float scale = float(srcSize) / float(dstSize);
+
+			// Area filtering only applies to downscaling; OpenCV also falls back to bilinear when upscaling
+			if (interpolation == PSFStackParameters::Area && scale < 1.0f)
+				interpolation = PSFStackParameters::Bilinear;
+
+			for (size_t dst = 0; dst < dstSize; ++dst)
+			{
+				const float center = (dst + 0.5f) * scale - 0.5f;
+				const int base = int(glm::floor(center));
+				const float t = center - base;
+
+				switch (interpolation)
+				{
+				case PSFStackParameters::Nearest:
+					addTap(weights, dst, int(glm::floor(dst * scale)), 1.0f);
+					break;
+
+				case PSFStackParameters::Bilinear:
+					addTap(weights, dst, base, 1.0f - t);
+					addTap(weights, dst, base + 1, t);
+					break;
+
+				case PSFStackParameters::Cubic:
+					for (int tap = -1; tap <= 2; ++tap)
+						addTap(weights, dst, base + tap, cubic(t - tap));
+					break;
+
+				case PSFStackParameters::Lanczos:
+					for (int tap = -3; tap <= 4; ++tap)
+						addTap(weights, dst, base + tap, lanczos4(t - tap));
+					break;
+
+				case PSFStackParameters::Area:
+				{
+					// Integrate the source pixels covered by the destination pixel's footprint
+					const float begin = dst * scale, end = (dst + 1) * scale;
+					for (int src = int(glm::floor(begin)); src < int(glm::ceil(end)) && src < int(srcSize); ++src)
+					{
+						const float overlap = glm::min(end, float(src + 1)) - glm::max(begin, float(src));
+						if (overlap > 0.0f) weights(dst, src) += overlap / scale;
+					}
+				}
+				break;
+				}
+			}
+
+			// Normalize each tap set, like OpenCV does for its truncated kernels
+			weights.array().colwise() /= weights.rowwise().sum().array();
+
+			return weights;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Synthetic off-axis PSF: a rotated, elongated and shifted Gaussian lobe. */
+		Psf syntheticPsf(const size_t rows, const size_t cols, std::mt19937& generator)
+		{
+			std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+			const float angle = uniform(generator) * glm::pi<float>();
+			const float sigmaMajor = (0.05f + 0.15f * uniform(generator)) * glm::min(rows, cols);
+			const float sigmaMinor = sigmaMajor * (0.2f + 0.8f * uniform(generator));
+			const glm::vec2 center = glm::vec2(cols, rows) * (0.4f + 0.2f * glm::vec2(uniform(generator), uniform(generator)));
+
+			Psf psf(rows, cols);
+			for (size_t row = 0; row < rows; ++row)
+			for (size_t col = 0; col < cols; ++col)
+			{
+				const glm::vec2 offset = glm::vec2(col, row) - center;
+				const float u = offset.x * glm::cos(angle) + offset.y * glm::sin(angle);
+				const float v = offset.y * glm::cos(angle) - offset.x * glm::sin(angle);
+				psf(row, col) = glm::exp(-0.5f * (u * u / (sigmaMajor * sigmaMajor) + v * v / (sigmaMinor * sigmaMinor)));
+			}
+			return psf;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void initPsfResampler(Scene::Scene& scene, WavefrontAberration& aberration, PsfResampler& resampler,
+		std::vector<std::pair<size_t, size_t>> const& psfSizes, const size_t minRadius, const size_t maxRadius)
+	{
+		resampler.m_interpolationType = aberration.m_psfParameters.m_interpolationType;
+		resampler.m_minRadius = minRadius;
+		resampler.m_maxRadius = maxRadius;
+		resampler.m_weights.clear();
+
+		// The 1D filters only depend on the source and target lengths, so share them between the two axes
+		std::map<std::pair<size_t, size_t>, EigenTypes::ScalarMatrixFinal> filters;
+		auto const& filter = [&](const size_t srcSize, const size_t dstSize) -> EigenTypes::ScalarMatrixFinal const&
+		{
+			auto it = filters.find({ srcSize, dstSize });
+			if (it == filters.end())
+				it = filters.emplace(std::make_pair(srcSize, dstSize), PsfResampling::filterWeights(resampler.m_interpolationType, srcSize, dstSize)).first;
+			return it->second;
+		};
+
+		for (auto const& psfSize : psfSizes)
+		{
+			if (resampler.m_weights.find(psfSize) != resampler.m_weights.end()) continue;
+
+			std::vector<PsfResampleWeights>& weights = resampler.m_weights[psfSize];
+			weights.resize(maxRadius - minRadius + 1);
+			for (size_t radius = minRadius; radius <= maxRadius; ++radius)
+			{
+				const size_t diameter = radius * 2 + 1;
+				PsfResampleWeights& radiusWeights = weights[radius - minRadius];
+				radiusWeights.m_rows = filter(psfSize.first, diameter);
+				radiusWeights.m_cols = filter(psfSize.second, diameter);
+				radiusWeights.m_colSums = radiusWeights.m_cols.colwise().sum().transpose();
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void resamplePsfNormalized(PsfResampler& resampler, Psf const& psf, const size_t radius, float* out)
+	{
+		PsfResampleWeights const& weights = resampler.m_weights.at({ size_t(psf.rows()), size_t(psf.cols()) })[radius - resampler.m_minRadius];
+		const size_t diameter = radius * 2 + 1;
+		const size_t threadId = Threading::currentThreadId();
+
+		// Filter vertically, then horizontally
+		EigenTypes::ScalarMatrixFinal& vertical = resampler.m_scratchVertical[threadId];
+		vertical.noalias() = weights.m_rows * psf;
+
+		EigenTypes::ScalarMatrixFinal& result = resampler.m_scratchResult[threadId];
+		result.noalias() = vertical * weights.m_cols.transpose();
+
+		// The sum of the result is the column sums of the intermediate, weighted by the horizontal column sums
+		const ScalarFinal sum = vertical.colwise().sum().dot(weights.m_colSums.transpose());
+		PsfGpu::Map(out, diameter, diameter) = result / sum;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkPsfResampler(Scene::Scene& scene, WavefrontAberration& aberration, const size_t numPsfs, const size_t maxRadius, const size_t radiiPerPsf)
+	{
+		// Synthetic off-axis PSFs: rotated, elongated and shifted lobes, in the handful of sizes a real stack ends up with
+		const std::array<size_t, 6> sizes = { 33, 65, 97, 129, 193, 257 };
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+		std::vector<Psf> psfs(numPsfs);
+		std::vector<std::pair<size_t, size_t>> psfSizes;
+		std::vector<std::pair<size_t, size_t>> psfRadii(numPsfs);
+		std::vector<size_t> weightOffsets(numPsfs + 1, 0);
+		for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+		{
+			const size_t rows = sizes[psfId % sizes.size()];
+			const size_t cols = psfId % 7 == 0 ? sizes[(psfId / 7) % sizes.size()] : rows;
+			psfs[psfId] = PsfResampling::syntheticPsf(rows, cols, generator);
+
+			if (std::find(psfSizes.begin(), psfSizes.end(), std::make_pair(rows, cols)) == psfSizes.end())
+				psfSizes.push_back({ rows, cols });
+
+			// Each PSF covers a band of radii, like the per-PSF blur radius limits of the splat blur
+			const size_t minRadius = 1 + size_t(uniform(generator) * (maxRadius - glm::min(maxRadius, radiiPerPsf)));
+			psfRadii[psfId] = { minRadius, glm::min(minRadius + radiiPerPsf - 1, maxRadius) };
+			weightOffsets[psfId + 1] = weightOffsets[psfId];
+			for (size_t radius = psfRadii[psfId].first; radius <= psfRadii[psfId].second; ++radius)
+				weightOffsets[psfId + 1] += (radius * 2 + 1) * (radius * 2 + 1);
+		}
+
+		std::vector<float> resampled(weightOffsets.back()), reference(weightOffsets.back());
+
+		// Shared filters
+		DateTime::Timer setupTimer(true);
+		PsfResampler resampler;
+		initPsfResampler(scene, aberration, resampler, psfSizes, 1, maxRadius);
+		setupTimer.stop();
+
+		DateTime::Timer resamplerTimer(true);
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+			{
+				float* writePtr = resampled.data() + weightOffsets[psfId];
+				for (size_t radius = psfRadii[psfId].first; radius <= psfRadii[psfId].second; ++radius)
+				{
+					resamplePsfNormalized(resampler, psfs[psfId], radius, writePtr);
+					writePtr += (radius * 2 + 1) * (radius * 2 + 1);
+				}
+			},
+			numPsfs);
+		resamplerTimer.stop();
+
+		// Independent resize for every PSF and radius
+		DateTime::Timer referenceTimer(true);
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+			{
+				float* writePtr = reference.data() + weightOffsets[psfId];
+				for (size_t radius = psfRadii[psfId].first; radius <= psfRadii[psfId].second; ++radius)
+				{
+					const size_t diameter = radius * 2 + 1;
+					PsfGpu::Map(writePtr, diameter, diameter) = resizePsfNormalized(scene, aberration, psfs[psfId], radius).cast<float>();
+					writePtr += diameter * diameter;
+				}
+			},
+			numPsfs);
+		referenceTimer.stop();
+
+		float maxDifference = 0.0f;
+		for (size_t weightId = 0; weightId < resampled.size(); ++weightId)
+			maxDifference = glm::max(maxDifference, glm::abs(resampled[weightId] - reference[weightId]));
+
+		Debug::log_info() << "PSF resampler benchmark (" << numPsfs << " PSFs, " << psfSizes.size() << " sizes, " << radiiPerPsf << " of " << maxRadius << " radii per PSF, "
+			<< std::string(PSFStackParameters::InterpolationType_value_to_string(aberration.m_psfParameters.m_interpolationType)) << "):" << Debug::end;
+		Debug::log_info() << "  - filter setup: " << setupTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - shared resampler: " << resamplerTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - independent resize: " << referenceTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - speedup: " << referenceTimer.getElapsedTime() / glm::max(setupTimer.getElapsedTime() + resamplerTimer.getElapsedTime(), 1e-9) << "x" << Debug::end;
+		Debug::log_info() << "  - " << resampled.size() << " weights, max difference: " << maxDifference << Debug::end;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace ResizeValidation
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** Synthetic PSFs of mixed sizes, with fractional, integer and zero target radii. */
+		void syntheticBatch(const size_t numPsfs, const float maxRadius, std::vector<Psf>& psfs, std::vector<float>& radii)
+		{
+			const std::array<size_t, 6> sizes = { 33, 65, 97, 129, 193, 257 };
+			std::mt19937 generator(1234);
+			std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+			psfs.resize(numPsfs);
+			radii.resize(numPsfs);
+			for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+			{
+				const size_t rows = sizes[psfId % sizes.size()];
+				psfs[psfId] = PsfResampling::syntheticPsf(rows, rows, generator);
+				radii[psfId] = psfId % 11 == 0 ? 0.0f : psfId % 5 == 0 ? glm::floor(uniform(generator) * maxRadius) : uniform(generator) * maxRadius;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validatePsfResize(Scene::Scene& scene, WavefrontAberration& aberration, const size_t numPsfs, const float maxRadius)
+	{
+		Debug::log_info() << "Validating the PSF resize..." << Debug::end;
+
+		std::vector<Psf> psfs, batch;
+		std::vector<float> radii;
+		ResizeValidation::syntheticBatch(numPsfs, maxRadius, psfs, radii);
+		resizePsfBatch(scene, aberration, psfs, radii, batch);
+
+		const int interpolation = PsfResizing::interpolationMode(aberration);
+		size_t numBatchMismatches = 0, numReferenceMismatches = 0;
+		float maxDifference = 0.0f;
+		for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+		{
+			// The batch must reproduce the single resize exactly
+			const Psf single = resizePsf(scene, aberration, psfs[psfId], radii[psfId]);
+			if (batch[psfId].rows() != single.rows() || batch[psfId].cols() != single.cols() || batch[psfId] != single)
+			{
+				++numBatchMismatches;
+				continue;
+			}
+
+			// The fused blend must match the original padded blend up to rounding
+			const Psf reference = PsfResizing::resizeReference(interpolation, psfs[psfId], radii[psfId]);
+			if (reference.rows() != single.rows() || reference.cols() != single.cols())
+			{
+				++numReferenceMismatches;
+				continue;
+			}
+			const float difference = (single - reference).cwiseAbs().maxCoeff() / glm::max(reference.cwiseAbs().maxCoeff(), 1e-12f);
+			maxDifference = glm::max(maxDifference, difference);
+			if (difference > 1e-5f) ++numReferenceMismatches;
+		}
+
+		if (numBatchMismatches == 0 && numReferenceMismatches == 0)
+			Debug::log_info() << "PSF resize validation passed (" << numPsfs << " PSFs, "
+				<< std::string(PSFStackParameters::InterpolationType_value_to_string(aberration.m_psfParameters.m_interpolationType))
+				<< ", max relative difference to the padded blend: " << maxDifference << ")." << Debug::end;
+		else
+			Debug::log_error() << "PSF resize validation failed: " << numBatchMismatches << " batch mismatches, "
+				<< numReferenceMismatches << " mismatches against the padded blend (max relative difference: " << maxDifference << ")." << Debug::end;
+
+		return numBatchMismatches == 0 && numReferenceMismatches == 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkPsfResize(Scene::Scene& scene, WavefrontAberration& aberration, const size_t numPsfs, const float maxRadius)
+	{
+		std::vector<Psf> psfs, single(numPsfs), batch, reference(numPsfs);
+		std::vector<float> radii;
+		ResizeValidation::syntheticBatch(numPsfs, maxRadius, psfs, radii);
+
+		const int interpolation = PsfResizing::interpolationMode(aberration);
+		DateTime::Timer referenceTimer(true);
+		for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+			reference[psfId] = PsfResizing::resizeReference(interpolation, psfs[psfId], radii[psfId]);
+		referenceTimer.stop();
+
+		DateTime::Timer singleTimer(true);
+		for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+			single[psfId] = resizePsf(scene, aberration, psfs[psfId], radii[psfId]);
+		singleTimer.stop();
+
+		// Run the batch twice: the second run reuses the storage of the output PSFs
+		DateTime::Timer batchTimer(true);
+		resizePsfBatch(scene, aberration, psfs, radii, batch);
+		batchTimer.stop();
+
+		DateTime::Timer batchReuseTimer(true);
+		resizePsfBatch(scene, aberration, psfs, radii, batch);
+		batchReuseTimer.stop();
+
+		Debug::log_info() << "PSF resize benchmark (" << numPsfs << " PSFs, radii up to " << maxRadius << ", "
+			<< std::string(PSFStackParameters::InterpolationType_value_to_string(aberration.m_psfParameters.m_interpolationType)) << "):" << Debug::end;
+		Debug::log_info() << "  - padded blend: " << referenceTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - fused blend: " << singleTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - batch: " << batchTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - batch, reused output: " << batchReuseTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validatePsfStorage(Scene::Scene& scene, WavefrontAberration& aberration, const size_t maxPsfs, const float tolerance)
+	{
+		Debug::log_info() << "Validating the compact PSF storage..." << Debug::end;
+
+		PsfStackElements::PsfEntries const& psfs = aberration.m_psfStack.m_psfs;
+		const size_t numPsfs = psfs.num_elements();
+		if (numPsfs == 0)
+		{
+			Debug::log_error() << "The PSF stack is empty, nothing to validate." << Debug::end;
+			return false;
+		}
+		if (aberration.m_psfParameters.m_psfStorage != PSFStackParameters::Full)
+			Debug::log_warning() << "The PSF stack is already compacted; its decoded PSFs serve as the reference." << Debug::end;
+
+		// Test image with sharp edges and isolated bright points, the worst case for kernel errors
+		const Eigen::Index imageSize = 64;
+		EigenTypes::ScalarMatrixFinal image(imageSize, imageSize);
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+		for (Eigen::Index col = 0; col < imageSize; ++col)
+		for (Eigen::Index row = 0; row < imageSize; ++row)
+			image(row, col) = ((row / 8 + col / 8) % 2 == 0 ? 0.2f : 0.05f) + (uniform(generator) < 0.01f ? 10.0f : 0.0f);
+
+		// Blur the test image with a sample of the stack, at the preview resolution and field of view
+		const size_t numSampled = glm::min(maxPsfs, numPsfs);
+		const std::array<PSFStackParameters::PsfStorage, 2> storages = { PSFStackParameters::Float16, PSFStackParameters::LogQuantized };
+		std::vector<std::array<float, 2>> sampleErrors(numSampled), imageErrors(numSampled);
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t sampleId)
+			{
+				PsfStackElements::PsfEntry const& entry = psfs.data()[sampleId * numPsfs / numSampled];
+				Psf scratch;
+				Psf const& reference = getPsf(scene, aberration, entry, scratch);
+				const float radius = blurRadiusPixels(entry, aberration.m_psfPreview.m_resolution, aberration.m_psfPreview.m_fovy);
+
+				EigenTypes::ScalarMatrixFinal blurredReference, blurred;
+				convolvePsf(resizePsfNormalized(scene, aberration, reference, radius), image, blurredReference);
+				const float peak = glm::max(blurredReference.maxCoeff(), std::numeric_limits<float>::min());
+				const float scale = reference.size() > 0 && reference.maxCoeff() > 0.0f ? reference.maxCoeff() : 1.0f;
+
+				for (size_t storageId = 0; storageId < storages.size(); ++storageId)
+				{
+					// Round trip through the compact format
+					std::vector<uint16_t> samples(reference.size());
+					Psf decoded(reference.rows(), reference.cols());
+					PsfCompaction::encodeSamples(storages[storageId], reference.data(), scale, reference.size(), samples.data());
+					PsfCompaction::decodeSamples(storages[storageId], samples.data(), scale, reference.size(), decoded.data());
+					sampleErrors[sampleId][storageId] = (decoded - reference).cwiseAbs().maxCoeff() / scale;
+
+					// Impact on the blurred image
+					convolvePsf(resizePsfNormalized(scene, aberration, decoded, radius), image, blurred);
+					imageErrors[sampleId][storageId] = (blurred - blurredReference).cwiseAbs().maxCoeff() / peak;
+				}
+			},
+			numSampled);
+
+		bool valid = true;
+		for (size_t storageId = 0; storageId < storages.size(); ++storageId)
+		{
+			float maxSampleError = 0.0f, maxImageError = 0.0f;
+			for (size_t sampleId = 0; sampleId < numSampled; ++sampleId)
+			{
+				maxSampleError = glm::max(maxSampleError, sampleErrors[sampleId][storageId]);
+				maxImageError = glm::max(maxImageError, imageErrors[sampleId][storageId]);
+			}
+
+			Debug::log_info() << PSFStackParameters::PsfStorage_meta.members[storages[storageId]].name << ": "
+				<< "max. sample error: " << maxSampleError << " (relative to the PSF peak), "
+				<< "max. blurred image error: " << maxImageError << " (relative to the image peak, "
+				<< -20.0f * std::log10(glm::max(maxImageError, 1e-12f)) << " dB)" << Debug::end;
+			if (maxImageError > tolerance)
+			{
+				Debug::log_error() << PSFStackParameters::PsfStorage_meta.members[storages[storageId]].name << ": blurred image error exceeds the tolerance." << Debug::end;
+				valid = false;
+			}
+		}
+
+		if (valid)
+			Debug::log_info() << "PSF storage validation passed (" << numSampled << " of " << numPsfs << " PSFs, tolerance: " << tolerance << ")." << Debug::end;
+		else
+			Debug::log_error() << "PSF storage validation failed (tolerance: " << tolerance << ")." << Debug::end;
+
+		return valid;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace PsfConvolution
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** Accumulates 'weight' times the input, shifted by (rowShift, colShift), into the output; samples outside the input are zero. */
+		void accumulateShifted(EigenTypes::ScalarMatrixFinal const& in, const ScalarFinal weight, const Eigen::Index rowShift, const Eigen::Index colShift, EigenTypes::ScalarMatrixFinal& out)
+		{
+			if (weight == 0.0f) return;
+
+			const Eigen::Index rowBegin = std::max(Eigen::Index(0), -rowShift), rowEnd = std::min(in.rows(), in.rows() - rowShift);
+			const Eigen::Index colBegin = std::max(Eigen::Index(0), -colShift), colEnd = std::min(in.cols(), in.cols() - colShift);
+			if (rowBegin >= rowEnd || colBegin >= colEnd) return;
+
+			out.block(rowBegin, colBegin, rowEnd - rowBegin, colEnd - colBegin) +=
+				weight * in.block(rowBegin + rowShift, colBegin + colShift, rowEnd - rowBegin, colEnd - colBegin);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfStackElements::SeparablePsf decomposePsf(Psf const& psf, const float energyThreshold, const int maxRank)
+	{
+		PsfStackElements::SeparablePsf result;
+		if (psf.size() == 0) return result;
+
+		Eigen::BDCSVD<EigenTypes::ScalarMatrixFinal> svd(psf, Eigen::ComputeThinU | Eigen::ComputeThinV);
+		auto const& singularValues = svd.singularValues();
+
+		// Keep the fewest terms that capture the requested fraction of the energy
+		const ScalarFinal totalEnergy = singularValues.squaredNorm();
+		const Eigen::Index maxTerms = std::min(Eigen::Index(std::max(maxRank, 1)), singularValues.size());
+		ScalarFinal energy = 0.0f;
+		Eigen::Index rank = 0;
+		while (rank < maxTerms && (rank == 0 || energy < energyThreshold * totalEnergy))
+		{
+			energy += singularValues[rank] * singularValues[rank];
+			++rank;
+		}
+
+		result.m_rows = svd.matrixU().leftCols(rank) * singularValues.head(rank).asDiagonal();
+		result.m_cols = svd.matrixV().leftCols(rank);
+		result.m_energy = totalEnergy > 0.0f ? energy / totalEnergy : 1.0f;
+		result.m_error = (reconstructPsf(result) - psf).cwiseAbs().maxCoeff() / std::max(psf.maxCoeff(), std::numeric_limits<ScalarFinal>::min());
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Psf reconstructPsf(PsfStackElements::SeparablePsf const& separable)
+	{
+		return separable.m_rows * separable.m_cols.transpose();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void convolvePsf(Psf const& psf, EigenTypes::ScalarMatrixFinal const& image, EigenTypes::ScalarMatrixFinal& out)
+	{
+		const Eigen::Index centerRow = psf.rows() / 2, centerCol = psf.cols() / 2;
+
+		out.setZero(image.rows(), image.cols());
+		for (Eigen::Index col = 0; col < psf.cols(); ++col)
+		for (Eigen::Index row = 0; row < psf.rows(); ++row)
+			PsfConvolution::accumulateShifted(image, psf(row, col), centerRow - row, centerCol - col, out);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void convolvePsfSeparable(PsfStackElements::SeparablePsf const& separable, EigenTypes::ScalarMatrixFinal const& image, EigenTypes::ScalarMatrixFinal& out)
+	{
+		const Eigen::Index centerRow = separable.m_rows.rows() / 2, centerCol = separable.m_cols.rows() / 2;
+
+		out.setZero(image.rows(), image.cols());
+		EigenTypes::ScalarMatrixFinal vertical;
+		for (Eigen::Index term = 0; term < separable.m_rows.cols(); ++term)
+		{
+			// Filter vertically with the row factor...
+			vertical.setZero(image.rows(), image.cols());
+			for (Eigen::Index row = 0; row < separable.m_rows.rows(); ++row)
+				PsfConvolution::accumulateShifted(image, separable.m_rows(row, term), centerRow - row, 0, vertical);
+
+			// ... then horizontally with the column factor
+			for (Eigen::Index col = 0; col < separable.m_cols.rows(); ++col)
+				PsfConvolution::accumulateShifted(vertical, separable.m_cols(col, term), 0, centerCol - col, out);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkSeparableConvolution(Scene::Scene& scene, WavefrontAberration& aberration, const size_t imageSize, const size_t numSizes, const size_t numIterations)
+	{
+		PsfStackElements::PsfEntries const& psfs = aberration.m_psfStack.m_psfs;
+		const size_t numPsfs = psfs.num_elements();
+		if (numPsfs == 0)
+		{
+			Debug::log_error() << "The PSF stack is empty, nothing to benchmark." << Debug::end;
+			return;
+		}
+
+		// First PSF of each distinct kernel size; only kernels at most a quarter of the image wide, so that most taps land inside it
+		std::map<Eigen::Index, size_t> psfsBySize;
+		for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+		{
+			PsfStackElements::PsfEntry const& entry = psfs.data()[psfId];
+			const Eigen::Index size = entry.m_compact.m_storage == PSFStackParameters::Full ?
+				std::max(entry.m_psf.rows(), entry.m_psf.cols()) : Eigen::Index(std::max(entry.m_compact.m_rows, entry.m_compact.m_cols));
+			if (size > 0 && (size * 4 <= Eigen::Index(imageSize) || psfsBySize.empty()))
+				psfsBySize.emplace(size, psfId);
+		}
+
+		// Spread the benchmarked sizes evenly over the available ones
+		std::vector<size_t> psfIds;
+		for (auto const& [size, psfId] : psfsBySize) psfIds.push_back(psfId);
+		if (psfIds.size() > numSizes)
+		{
+			std::vector<size_t> spread(std::max(numSizes, size_t(1)));
+			for (size_t i = 0; i < spread.size(); ++i)
+				spread[i] = psfIds[spread.size() == 1 ? psfIds.size() - 1 : i * (psfIds.size() - 1) / (spread.size() - 1)];
+			psfIds = spread;
+		}
+
+		// Test image with sharp edges and isolated bright points, the worst case for kernel errors
+		EigenTypes::ScalarMatrixFinal image(imageSize, imageSize);
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+		for (Eigen::Index col = 0; col < image.cols(); ++col)
+		for (Eigen::Index row = 0; row < image.rows(); ++row)
+			image(row, col) = ((row / 8 + col / 8) % 2 == 0 ? 0.2f : 0.05f) + (uniform(generator) < 0.01f ? 10.0f : 0.0f);
+
+		Debug::log_info() << "Separable PSF convolution benchmark (" << imageSize << "x" << imageSize << " image, " << numIterations << " iterations, "
+			<< "energy threshold: " << aberration.m_psfParameters.m_separableEnergyThreshold << ", max. rank: " << aberration.m_psfParameters.m_separableMaxRank << "):" << Debug::end;
+
+		Psf scratch;
+		EigenTypes::ScalarMatrixFinal fullResult, separableResult;
+		double totalFullTime = 0.0, totalSeparableTime = 0.0;
+		for (size_t psfId : psfIds)
+		{
+			// Reuse the factors of the stack if they were computed, decompose the PSF otherwise
+			PsfStackElements::PsfEntry const& entry = psfs.data()[psfId];
+			Psf const& psf = getPsf(scene, aberration, entry, scratch);
+			const PsfStackElements::SeparablePsf separable = entry.m_separable.m_rows.rows() == psf.rows() ? entry.m_separable :
+				decomposePsf(psf, aberration.m_psfParameters.m_separableEnergyThreshold, aberration.m_psfParameters.m_separableMaxRank);
+
+			DateTime::Timer fullTimer(true);
+			for (size_t iteration = 0; iteration < numIterations; ++iteration)
+				convolvePsf(psf, image, fullResult);
+			fullTimer.stop();
+
+			DateTime::Timer separableTimer(true);
+			for (size_t iteration = 0; iteration < numIterations; ++iteration)
+				convolvePsfSeparable(separable, image, separableResult);
+			separableTimer.stop();
+
+			const double fullTime = fullTimer.getElapsedTime() / numIterations, separableTime = separableTimer.getElapsedTime() / numIterations;
+			totalFullTime += fullTime;
+			totalSeparableTime += separableTime;
+
+			Debug::log_info() << "  - PSF" << aberration.m_psfStack.m_psfIndexDecoder.decode(psfId) << ": "
+				<< "size: " << psf.rows() << "x" << psf.cols() << ", "
+				<< "rank: " << separable.m_rows.cols() << ", "
+				<< "reconstruction error: " << separable.m_error << ", "
+				<< "full: " << fullTime * 1e3 << " ms, "
+				<< "separable: " << separableTime * 1e3 << " ms (" << fullTime / std::max(separableTime, 1e-9) << "x), "
+				<< "max. image difference: " << (fullResult - separableResult).cwiseAbs().maxCoeff() / std::max(fullResult.cwiseAbs().maxCoeff(), std::numeric_limits<ScalarFinal>::min())
+				<< Debug::end;
+		}
+
+		Debug::log_info() << "  - total: full: " << totalFullTime * 1e3 << " ms, separable: " << totalSeparableTime * 1e3 << " ms per iteration" << Debug::end;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Psf getProjectedPsf(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfStackElements::PsfEntry const& psf, const glm::ivec2 renderResolution, const float fovy)
+	{
+		Psf scratch;
+		return resizePsf(scene, aberration, getPsf(scene, aberration, psf, scratch), blurRadiusPixels(psf, renderResolution, fovy));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Psf getProjectedPsfNormalized(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfStackElements::PsfEntry const& psf, const glm::ivec2 renderResolution, const float fovy)
+	{
+		Psf const& psfProjected = getProjectedPsf(scene, aberration, psf, renderResolution, fovy);
+		return psfProjected / psfProjected.sum();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	FastDivisor::FastDivisor(const uint32_t divisor):
+		m_divisor(divisor)
+	{
+		// Smallest l with 2^l >= divisor
+		uint32_t l = 0;
+		while ((uint64_t(1) << l) < divisor) ++l;
+
+		m_multiplier = uint32_t(((uint64_t(1) << 32) * ((uint64_t(1) << l) - divisor)) / divisor + 1);
+		m_shift1 = std::min(l, 1u);
+		m_shift2 = l > 0 ? l - 1 : 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfIndexDecoder::PsfIndexDecoder(PsfIndex const& shape)
+	{
+		PsfStackElements::PsfEntries::size_type shapes[6];
+		PsfStackElements::PsfEntries::index strides[6];
+		for (size_t d = 0, stride = 1; d < 6; ++d)
+		{
+			shapes[5 - d] = shape[5 - d];
+			strides[5 - d] = PsfStackElements::PsfEntries::index(stride);
+			stride *= shape[5 - d];
+		}
+		*this = PsfIndexDecoder(shapes, strides);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfIndexDecoder::PsfIndexDecoder(const PsfStackElements::PsfEntries::size_type* shape, const PsfStackElements::PsfEntries::index* strides)
+	{
+		m_fastDivision = true;
+		for (size_t d = 0; d < 6; ++d)
+		{
+			m_shape[d] = shape[d];
+			m_strides[d] = strides[d];
+			m_fastDivision &= m_shape[d] >= 1 && m_shape[d] <= UINT32_MAX && m_strides[d] >= 1 && m_strides[d] <= UINT32_MAX;
+		}
+
+		// Only build the divisors if every value is representable
+		if (m_fastDivision)
+		{
+			for (size_t d = 0; d < 6; ++d)
+			{
+				m_strideDivisors[d] = FastDivisor(uint32_t(m_strides[d]));
+				m_shapeDivisors[d] = FastDivisor(uint32_t(m_shape[d]));
+			}
+		}
+
+		// The odometer advances the dimension with the smallest stride first
+		std::stable_sort(m_axisOrder.begin(), m_axisOrder.end(), [&](size_t a, size_t b) { return m_strides[a] < m_strides[b]; });
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfIndex getPsfIndex(const PsfStackElements::PsfEntries::size_type* shape, const PsfStackElements::PsfEntries::index* strides, const size_t psfIndex)
+	{
+		PsfIndex result;
+		for (size_t d = 0; d < 6; ++d)
+			result[d] = (psfIndex / strides[d] % shape[d]);
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfIndex getPsfIndex(Scene::Scene& scene, WavefrontAberration& aberration, const size_t psfIndex)
+	{
+		// Use the cached decoder, unless the PSF array changed shape since it was built
+		PsfStackElements::PsfEntries const& psfs = aberration.m_psfStack.m_psfs;
+		if (aberration.m_psfStack.m_psfIndexDecoder.matches(psfs.shape(), psfs.strides()))
+			return aberration.m_psfStack.m_psfIndexDecoder.decode(psfIndex);
+		return getPsfIndex(psfs.shape(), psfs.strides(), psfIndex);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfStackElements::PsfEntryParams& getPsfEntryParameters(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfIndex const& psfIndex)
+	{
+		return aberration.m_psfStack.m_psfEntryParameters(psfIndex);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfStackElements::PsfEntry& getPsfEntry(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfIndex const& psfIndex)
+	{
+		return aberration.m_psfStack.m_psfs(psfIndex);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool isIndexNeighbor(const size_t a, const size_t b)
+	{
+		return (a - b) <= 1 || (b - a) <= 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfIndexIterator psfStackBegin(Scene::Scene& scene, WavefrontAberration& aberration)
+	{
+		return PsfIndexIterator(
+			PsfIndexDecoder(aberration.m_psfStack.m_psfEntryParameters.shape(), aberration.m_psfStack.m_psfEntryParameters.strides()),
+			0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	PsfIndexIterator psfStackEnd(Scene::Scene& scene, WavefrontAberration& aberration)
+	{
+		return PsfIndexIterator(
+			PsfIndexDecoder(aberration.m_psfStack.m_psfEntryParameters.shape(), aberration.m_psfStack.m_psfEntryParameters.strides()),
+			aberration.m_psfStack.m_psfEntryParameters.num_elements());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace DecoderValidation
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** Decodes the parameter id with plain divisions, like getPsfIndex on the PSF array. */
+		PsfIndex decodeReference(PsfIndexDecoder const& decoder, const size_t psfId)
+		{
+			PsfStackElements::PsfEntries::size_type shape[6];
+			PsfStackElements::PsfEntries::index strides[6];
+			for (size_t d = 0; d < 6; ++d)
+			{
+				shape[d] = decoder.m_shape[d];
+				strides[d] = PsfStackElements::PsfEntries::index(decoder.m_strides[d]);
+			}
+			return getPsfIndex(shape, strides, psfId);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Number of numerators in the parameter list that the fast divisor gets wrong. */
+		size_t numDivisionMismatches(FastDivisor const& divisor, std::vector<uint32_t> const& numerators)
+		{
+			size_t result = 0;
+			for (const uint32_t n : numerators)
+				result += divisor.divide(n) != n / divisor.m_divisor ? 1 : 0;
+			return result;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validatePsfIndexDecoder(const size_t numShapes, const size_t numRandom)
+	{
+		Debug::log_info() << "Validating the PSF index decoder..." << Debug::end;
+
+		std::mt19937 generator(1234);
+		std::uniform_int_distribution<uint32_t> uniform32(0, UINT32_MAX);
+		size_t numFailed = 0;
+
+		// Fast divisor: every divisor up to 2^12 with every numerator up to 2^16
+		const uint32_t maxDenseDivisor = 1 << 12, maxDenseNumerator = 1 << 16;
+		std::vector<uint32_t> denseNumerators(maxDenseNumerator);
+		std::iota(denseNumerators.begin(), denseNumerators.end(), 0);
+
+		std::atomic<size_t> numDenseMismatches = 0;
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t divisorId)
+			{
+				numDenseMismatches += DecoderValidation::numDivisionMismatches(FastDivisor(uint32_t(divisorId + 1)), denseNumerators);
+			},
+			maxDenseDivisor);
+
+		// Fast divisor: every divisor up to 2^16, around the multiples of the divisor at both ends of the 32-bit range
+		const uint32_t maxBoundaryDivisor = 1 << 16;
+		std::atomic<size_t> numBoundaryMismatches = 0;
+		Threading::threadedExecuteIndices(Threading::numThreads(),
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t divisorId)
+			{
+				const uint32_t divisor = uint32_t(divisorId + 1);
+				const uint64_t lastMultiple = (uint64_t(UINT32_MAX) / divisor) * divisor;
+				std::vector<uint32_t> numerators;
+				for (uint64_t k = 1; k <= 64; ++k)
+				{
+					for (const uint64_t multiple : { k * divisor, lastMultiple - (k - 1) * divisor })
+					for (int64_t offset = -1; offset <= 1; ++offset)
+					{
+						const int64_t n = int64_t(multiple) + offset;
+						if (n >= 0 && n <= int64_t(UINT32_MAX)) numerators.push_back(uint32_t(n));
+					}
+					numerators.push_back(uint32_t(UINT32_MAX - (k - 1)));
+				}
+				numBoundaryMismatches += DecoderValidation::numDivisionMismatches(FastDivisor(divisor), numerators);
+			},
+			maxBoundaryDivisor);
+
+		// Fast divisor: random 32-bit numerators and divisors, including the largest divisors
+		size_t numRandomMismatches = 0;
+		for (size_t sampleId = 0; sampleId < numRandom; ++sampleId)
+		{
+			const uint32_t divisor = sampleId < 64 ? uint32_t(UINT32_MAX - sampleId) : glm::max(uniform32(generator) >> (sampleId % 32), 1u);
+			const uint32_t n = uniform32(generator);
+			numRandomMismatches += FastDivisor(divisor).divide(n) != n / divisor ? 1 : 0;
+		}
+
+		if (numDenseMismatches > 0 || numBoundaryMismatches > 0 || numRandomMismatches > 0)
+		{
+			Debug::log_error() << "Fast divisor mismatches: " << numDenseMismatches << " dense, " << numBoundaryMismatches << " boundary, "
+				<< numRandomMismatches << " random." << Debug::end;
+			++numFailed;
+		}
+
+		// Decoder: every id of random stack shapes, through the fast and the fallback paths, and the odometer
+		std::uniform_int_distribution<size_t> extent(1, 8);
+		size_t numIdsTotal = 0;
+		for (size_t shapeId = 0; shapeId < numShapes; ++shapeId)
+		{
+			const PsfIndex shape = { extent(generator), extent(generator), extent(generator), extent(generator), extent(generator), extent(generator) };
+			const PsfIndexDecoder decoder(shape);
+			PsfIndexDecoder fallbackDecoder = decoder;
+			fallbackDecoder.m_fastDivision = false;
+
+			const size_t numIds = decoder.numElements();
+			numIdsTotal += numIds;
+
+			std::atomic<size_t> numMismatches = 0;
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+				{
+					const PsfIndex reference = DecoderValidation::decodeReference(decoder, psfId);
+					bool valid = decoder.decode(psfId) == reference && fallbackDecoder.decode(psfId) == reference;
+
+					// Iterators started at this id must agree for the next few ids
+					PsfIndexIterator it(decoder, psfId);
+					for (size_t step = 0; step < 4 && psfId + step < numIds; ++step, ++it)
+						valid &= *it == DecoderValidation::decodeReference(decoder, psfId + step);
+
+					if (!valid) ++numMismatches;
+				},
+				numIds);
+
+			// A full odometer walk must visit every id in order
+			size_t walkId = 0;
+			for (PsfIndexIterator it(decoder, 0), end(decoder, numIds); it != end; ++it, ++walkId)
+				numMismatches += *it != DecoderValidation::decodeReference(decoder, walkId) ? 1 : 0;
+
+			if (numMismatches > 0)
+			{
+				Debug::log_error() << "Decoder shape " << shape[0] << "x" << shape[1] << "x" << shape[2] << "x" << shape[3] << "x" << shape[4] << "x" << shape[5] << ": "
+					<< numMismatches << " of " << numIds << " ids decoded wrong." << Debug::end;
+				++numFailed;
+			}
+		}
 
-	////////////////////////////////////////////////////////////////////////////////
-	Psf getProjectedPsfNormalized(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfStackElements::PsfEntry const& psf, const glm::ivec2 renderResolution, const float fovy)
-	{
-		Psf const& psfProjected = getProjectedPsf(scene, aberration, psf, renderResolution, fovy);
-		return psfProjected / psfProjected.sum();
+		// Decoder: a stack with more than 2^32 entries, so ids past the 32-bit range take the fallback path
+		{
+			const PsfIndexDecoder decoder(PsfIndex{ 1 << 10, 1 << 9, 1 << 8, 3, 7, 5 });
+			std::uniform_int_distribution<size_t> uniformId(0, decoder.numElements() - 1);
+			size_t numMismatches = 0;
+			for (size_t sampleId = 0; sampleId < numRandom; ++sampleId)
+			{
+				const size_t psfId = sampleId < 64 ? size_t(UINT32_MAX) - 32 + sampleId : uniformId(generator);
+				numMismatches += decoder.decode(psfId) != DecoderValidation::decodeReference(decoder, psfId) ? 1 : 0;
+			}
+			if (numMismatches > 0)
+			{
+				Debug::log_error() << "Large decoder: " << numMismatches << " of " << numRandom << " ids decoded wrong." << Debug::end;
+				++numFailed;
+			}
+		}
+
+		if (numFailed == 0)
+			Debug::log_info() << "PSF index decoder validation passed (" << maxDenseDivisor << "x" << maxDenseNumerator << " dense divisions, "
+				<< maxBoundaryDivisor << " boundary divisors, " << numShapes << " shapes, " << numIdsTotal << " ids)." << Debug::end;
+		else
+			Debug::log_error() << "PSF index decoder validation failed." << Debug::end;
+
+		return numFailed == 0;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	PsfIndex getPsfIndex(const PsfStackElements::PsfEntries::size_type* shape, const PsfStackElements::PsfEntries::index* strides, const size_t psfIndex)
+	void benchmarkPsfIndexDecoder(const size_t numIds)
 	{
-		PsfIndex result;
+		// A typical off-axis stack, walked repeatedly
+		const PsfIndexDecoder decoder(PsfIndex{ 41, 7, 7, 3, 4, 4 });
+		const size_t numElements = decoder.numElements();
+		PsfStackElements::PsfEntries::size_type shape[6];
+		PsfStackElements::PsfEntries::index strides[6];
 		for (size_t d = 0; d < 6; ++d)
-			result[d] = (psfIndex / strides[d] % shape[d]);
-		return result;
-	}
+		{
+			shape[d] = decoder.m_shape[d];
+			strides[d] = PsfStackElements::PsfEntries::index(decoder.m_strides[d]);
+		}
 
-	////////////////////////////////////////////////////////////////////////////////
-	PsfIndex getPsfIndex(Scene::Scene& scene, WavefrontAberration& aberration, const size_t psfIndex)
-	{
-		return getPsfIndex(
-			aberration.m_psfStack.m_psfs.shape(),
-			aberration.m_psfStack.m_psfs.strides(),
-			psfIndex);
-	}
+		auto checksum = [](PsfIndex const& psfIndex)
+		{
+			return psfIndex[0] + psfIndex[1] + psfIndex[2] + psfIndex[3] + psfIndex[4] + psfIndex[5];
+		};
 
-	////////////////////////////////////////////////////////////////////////////////
-	PsfStackElements::PsfEntryParams& getPsfEntryParameters(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfIndex const& psfIndex)
-	{
-		return aberration.m_psfStack.m_psfEntryParameters(psfIndex);
-	}
+		size_t checksumDivision = 0, checksumDecoder = 0, checksumIterator = 0;
 
-	////////////////////////////////////////////////////////////////////////////////
-	PsfStackElements::PsfEntry& getPsfEntry(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfIndex const& psfIndex)
-	{
-		return aberration.m_psfStack.m_psfs(psfIndex);
-	}
+		DateTime::Timer divisionTimer(true);
+		for (size_t id = 0; id < numIds; ++id)
+			checksumDivision += checksum(getPsfIndex(shape, strides, id % numElements));
+		divisionTimer.stop();
 
-	////////////////////////////////////////////////////////////////////////////////
-	bool isIndexNeighbor(const size_t a, const size_t b)
-	{
-		return (a - b) <= 1 || (b - a) <= 1;
-	}
+		DateTime::Timer decoderTimer(true);
+		for (size_t id = 0; id < numIds; ++id)
+			checksumDecoder += checksum(decoder.decode(id % numElements));
+		decoderTimer.stop();
 
-	////////////////////////////////////////////////////////////////////////////////
-	PsfIndexIterator psfStackBegin(Scene::Scene& scene, WavefrontAberration& aberration)
-	{
-		return PsfIndexIterator(
-			aberration.m_psfStack.m_psfEntryParameters.shape(),
-			aberration.m_psfStack.m_psfEntryParameters.strides(),
-			0);
-	}
+		DateTime::Timer iteratorTimer(true);
+		for (size_t id = 0; id < numIds; id += numElements)
+		{
+			const size_t numWalked = glm::min(numElements, numIds - id);
+			for (PsfIndexIterator it(decoder, 0), end(decoder, numWalked); it != end; ++it)
+				checksumIterator += checksum(*it);
+		}
+		iteratorTimer.stop();
 
-	////////////////////////////////////////////////////////////////////////////////
-	PsfIndexIterator psfStackEnd(Scene::Scene& scene, WavefrontAberration& aberration)
-	{
-		return PsfIndexIterator(
-			aberration.m_psfStack.m_psfEntryParameters.shape(),
-			aberration.m_psfStack.m_psfEntryParameters.strides(),
-			aberration.m_psfStack.m_psfEntryParameters.num_elements());
+		Debug::log_info() << "PSF index decoder benchmark (" << numIds << " ids, " << numElements << " PSFs per stack):" << Debug::end;
+		Debug::log_info() << "  - plain division: " << divisionTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - fast divisors: " << decoderTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		Debug::log_info() << "  - odometer: " << iteratorTimer.getElapsedTime() * 1e3 << " ms" << Debug::end;
+		if (checksumDivision != checksumDecoder || checksumDivision != checksumIterator)
+			Debug::log_error() << "  - checksums differ: " << checksumDivision << ", " << checksumDecoder << ", " << checksumIterator << Debug::end;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -3838,6 +4897,467 @@ namespace Aberration
 			}
 		}
 
+		////////////////////////////////////////////////////////////////////////////////
+		namespace AdaptiveSampling
+		{
+			////////////////////////////////////////////////////////////////////////////////
+			/** Size of one PSF sample, in micrometers. */
+			float psfPitchMuM(PsfStackElements::PsfEntry const& entry)
+			{
+				return entry.m_kernelSizePx > 0 ? entry.m_blurSizeMuM / float(entry.m_kernelSizePx) : 1.0f;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Bilinearly resamples the PSF of the entry onto a centered grid with the parameter size and sample pitch,
+			    accumulating it into 'out' with the parameter weight. */
+			void accumulateResampled(PsfStackElements::PsfEntry const& entry, const float weight, const float pitchMuM, Psf& out)
+			{
+				Psf const& psf = entry.m_psf;
+				if (weight == 0.0f || psf.size() == 0) return;
+
+				// Source coordinates of the target rows and columns
+				const float scale = pitchMuM / psfPitchMuM(entry);
+				auto const& sourceCoords = [&](const Eigen::Index targetSize, const Eigen::Index sourceSize)
+				{
+					std::vector<std::pair<Eigen::Index, float>> result(targetSize);
+					for (Eigen::Index i = 0; i < targetSize; ++i)
+					{
+						const float coord = float(sourceSize / 2) + float(i - targetSize / 2) * scale;
+						result[i] = { Eigen::Index(glm::floor(coord)), coord - glm::floor(coord) };
+					}
+					return result;
+				};
+				const auto rowCoords = sourceCoords(out.rows(), psf.rows());
+				const auto colCoords = sourceCoords(out.cols(), psf.cols());
+
+				// Zero outside the source PSF
+				auto const& sample = [&](const Eigen::Index row, const Eigen::Index col)
+				{
+					return (row < 0 || row >= psf.rows() || col < 0 || col >= psf.cols()) ? 0.0f : psf(row, col);
+				};
+
+				for (Eigen::Index col = 0; col < out.cols(); ++col)
+				for (Eigen::Index row = 0; row < out.rows(); ++row)
+				{
+					const auto [r, fr] = rowCoords[row];
+					const auto [c, fc] = colCoords[col];
+					out(row, col) += weight * (
+						(1.0f - fr) * ((1.0f - fc) * sample(r, c) + fc * sample(r, c + 1)) +
+						fr * ((1.0f - fc) * sample(r + 1, c) + fc * sample(r + 1, c + 1)));
+				}
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Normalized blend of two PSFs, resampled onto the parameter grid. */
+			Psf interpolatePsf(PsfStackElements::PsfEntry const& lower, PsfStackElements::PsfEntry const& upper, const float weight,
+				const float pitchMuM, const Eigen::Index rows, const Eigen::Index cols)
+			{
+				Psf result = Psf::Zero(rows, cols);
+				accumulateResampled(lower, 1.0f - weight, pitchMuM, result);
+				accumulateResampled(upper, weight, pitchMuM, result);
+				const ScalarFinal sum = result.sum();
+				if (sum > 0.0f) result /= sum;
+				return result;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Difference between two PSFs on the same grid, according to the parameter metric. */
+			float psfDifference(const PSFStackParameters::AdaptiveErrorMetric metric, Psf const& interpolated, Psf const& reference)
+			{
+				const ScalarFinal referenceSum = reference.sum();
+				const Psf normalized = referenceSum > 0.0f ? Psf(reference / referenceSum) : reference;
+
+				if (metric == PSFStackParameters::L1)
+					return (interpolated - normalized).cwiseAbs().sum();
+
+				// Energy centroids, in PSF samples
+				auto const& centroid = [](Psf const& psf)
+				{
+					const ScalarFinal sum = std::max(psf.sum(), std::numeric_limits<ScalarFinal>::min());
+					const Eigen::Matrix<ScalarFinal, 1, Eigen::Dynamic> rowIds = Eigen::Matrix<ScalarFinal, 1, Eigen::Dynamic>::LinSpaced(psf.rows(), 0, psf.rows() - 1);
+					const Eigen::Matrix<ScalarFinal, Eigen::Dynamic, 1> colIds = Eigen::Matrix<ScalarFinal, Eigen::Dynamic, 1>::LinSpaced(psf.cols(), 0, psf.cols() - 1);
+					return glm::vec2((rowIds * psf).sum() / sum, (psf * colIds).sum() / sum);
+				};
+				return glm::distance(centroid(interpolated), centroid(normalized));
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Interpolation error of a computed PSF, predicted from its two neighbors. */
+			float interpolationError(const PSFStackParameters::AdaptiveErrorMetric metric, PsfStackElements::PsfEntry const& lower,
+				PsfStackElements::PsfEntry const& upper, const float weight, PsfStackElements::PsfEntry const& reference)
+			{
+				const Psf interpolated = interpolatePsf(lower, upper, weight, psfPitchMuM(reference), reference.m_psf.rows(), reference.m_psf.cols());
+				return psfDifference(metric, interpolated, reference.m_psf);
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Fills an entry by interpolating its two computed neighbors; the grid and kernel sizes are blended too. */
+			void interpolatePsfEntry(PsfStackElements::PsfEntry const& lower, PsfStackElements::PsfEntry const& upper, const float weight,
+				PsfStackElements::PsfEntry& result)
+			{
+				const float pitchMuM = glm::mix(psfPitchMuM(lower), psfPitchMuM(upper), weight);
+				const Eigen::Index rows = Eigen::Index(glm::round(glm::mix(float(lower.m_psf.rows()), float(upper.m_psf.rows()), weight)));
+				const Eigen::Index cols = Eigen::Index(glm::round(glm::mix(float(lower.m_psf.cols()), float(upper.m_psf.cols()), weight)));
+
+				result.m_psf = interpolatePsf(lower, upper, weight, pitchMuM, rows, cols);
+				result.m_kernelSizePx = result.m_psf.cols();
+				result.m_blurRadiusMuM = (result.m_kernelSizePx / 2) * pitchMuM;
+				result.m_blurRadiusDeg = blurRadiusAngle(result.m_blurRadiusMuM);
+				result.m_blurSizeMuM = result.m_kernelSizePx * pitchMuM;
+				result.m_blurSizeDeg = blurRadiusAngle(result.m_blurSizeMuM);
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Interpolation weight of an object distance between two others; 0 when the two coincide. */
+			float interpolationWeight(std::vector<float> const& dioptres, const size_t lowerId, const size_t upperId, const size_t defocusId)
+			{
+				const float range = dioptres[upperId] - dioptres[lowerId];
+				return range != 0.0f ? (dioptres[defocusId] - dioptres[lowerId]) / range : 0.0f;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			/** Indices of every PSF in the parameter object distance slices. */
+			std::vector<PsfIndex> sliceIndices(PSFStack const& result, std::vector<size_t> const& defocusIds)
+			{
+				auto const* shape = result.m_psfs.shape();
+				const PsfIndexDecoder sliceDecoder(PsfIndex{ 1, shape[1], shape[2], shape[3], shape[4], shape[5] });
+
+				std::vector<PsfIndex> indices;
+				indices.reserve(defocusIds.size() * sliceDecoder.numElements());
+				for (size_t defocusId : defocusIds)
+				for (size_t sliceId = 0; sliceId < sliceDecoder.numElements(); ++sliceId)
+				{
+					PsfIndex psfIndex = sliceDecoder.decode(sliceId);
+					psfIndex[0] = defocusId;
+					indices.push_back(psfIndex);
+				}
+				return indices;
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Computes every PSF in the parameter object distance slices, using the selected backend. */
+		void computePsfSlices(Scene::Scene& scene, WavefrontAberration& aberration, PSFStack& result, std::vector<size_t> const& defocusIds)
+		{
+			const std::vector<PsfIndex> indices = AdaptiveSampling::sliceIndices(result, defocusIds);
+			const bool gpu = aberration.m_psfParameters.m_backend == Aberration::PSFStackParameters::GPU;
+
+			Threading::threadedExecuteIndices(
+				Threading::ThreadedExecuteParams(gpu ? 1 : Threading::numThreads(), " > PSFs", "PSF", progressLogLevel(scene, aberration)),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t id)
+				{
+					if (gpu)
+						computePsfGPU(scene, aberration, result, indices[id]);
+					else
+						computePsfCPU(scene, aberration, result, indices[id]);
+				},
+				indices.size());
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Computes the PSFs on a coarse object distance grid, refines it where interpolating the neighboring
+		    slices is not accurate enough, and fills the remaining slices by interpolation. */
+		void computePsfsAdaptive(Scene::Scene& scene, WavefrontAberration& aberration, PsfStackComputation computation, PSFStack& result)
+		{
+			const size_t numDefocuses = result.m_psfs.shape()[0];
+			const size_t numPsfsPerSlice = numDefocuses > 0 ? result.m_psfs.num_elements() / numDefocuses : 0;
+			const PSFStackParameters::AdaptiveErrorMetric metric = aberration.m_psfParameters.m_adaptiveErrorMetric;
+			std::vector<float> const& dioptres = aberration.m_psfParameters.m_evaluatedParameters.m_objectDioptres;
+			if (numDefocuses == 0 || numPsfsPerSlice == 0)
+				return;
+
+			PsfStackElements::AdaptiveSamples& samples = result.m_adaptiveSamples;
+			samples.assign(numDefocuses, PsfStackElements::AdaptiveSample{});
+			for (auto& sample : samples) sample.m_computed = false;
+
+			const bool gpu = aberration.m_psfParameters.m_backend == Aberration::PSFStackParameters::GPU;
+			if (gpu)
+			{
+				auto timer = result.m_timers.startComputation("GPU Init", 1);
+				initPsfComputationGpu(scene, aberration, computation, result);
+			}
+
+			// Start with the coarse grid
+			std::vector<size_t> slices;
+			for (size_t defocusId = 0; defocusId < numDefocuses; defocusId += size_t(std::max(aberration.m_psfParameters.m_adaptiveCoarseStep, 1)))
+				slices.push_back(defocusId);
+			if (slices.back() != numDefocuses - 1)
+				slices.push_back(numDefocuses - 1);
+
+			size_t numComputedSlices = 0;
+			{
+				auto timer = result.m_timers.startComputation("PSFs (Adaptive)", numDefocuses * numPsfsPerSlice);
+
+				std::vector<std::pair<size_t, size_t>> intervals;
+				while (!slices.empty())
+				{
+					computePsfSlices(scene, aberration, result, slices);
+					for (size_t defocusId : slices) samples[defocusId].m_computed = true;
+					numComputedSlices += slices.size();
+
+					// Test the midpoints inserted in the previous round against their neighbors
+					std::vector<float> errors(intervals.size() * numPsfsPerSlice, 0.0f);
+					std::vector<size_t> lowerIds, upperIds;
+					for (auto const& interval : intervals)
+					{
+						lowerIds.push_back(interval.first);
+						upperIds.push_back(interval.second);
+					}
+					const std::vector<PsfIndex> lowerIndices = AdaptiveSampling::sliceIndices(result, lowerIds);
+					const std::vector<PsfIndex> upperIndices = AdaptiveSampling::sliceIndices(result, upperIds);
+					if (!errors.empty())
+					{
+						Threading::threadedExecuteIndices(Threading::numThreads(),
+							[&](Threading::ThreadedExecuteEnvironment const& environment, size_t id)
+							{
+								const auto& interval = intervals[id / numPsfsPerSlice];
+								const size_t midpoint = (interval.first + interval.second) / 2;
+								const float weight = AdaptiveSampling::interpolationWeight(dioptres, interval.first, interval.second, midpoint);
+								PsfIndex midpointIndex = lowerIndices[id];
+								midpointIndex[0] = midpoint;
+								errors[id] = AdaptiveSampling::interpolationError(metric, result.m_psfs(lowerIndices[id]), result.m_psfs(upperIndices[id]), weight, result.m_psfs(midpointIndex));
+							},
+							errors.size());
+					}
+
+					// Split the intervals that are not accurate enough
+					std::vector<std::pair<size_t, size_t>> nextIntervals;
+					for (size_t intervalId = 0; intervalId < intervals.size(); ++intervalId)
+					{
+						auto const& interval = intervals[intervalId];
+						const size_t midpoint = (interval.first + interval.second) / 2;
+						samples[midpoint].m_error = *std::max_element(errors.begin() + intervalId * numPsfsPerSlice, errors.begin() + (intervalId + 1) * numPsfsPerSlice);
+						if (samples[midpoint].m_error <= aberration.m_psfParameters.m_adaptiveErrorThreshold) continue;
+						nextIntervals.emplace_back(interval.first, midpoint);
+						nextIntervals.emplace_back(midpoint, interval.second);
+					}
+
+					// The very first round only has the coarse grid to split
+					if (intervals.empty())
+					{
+						for (size_t defocusId = 0, lower = 0; defocusId < numDefocuses; ++defocusId)
+						{
+							if (!samples[defocusId].m_computed) continue;
+							if (defocusId > lower) nextIntervals.emplace_back(lower, defocusId);
+							lower = defocusId;
+						}
+					}
+
+					// Only intervals with interior slices can be refined
+					intervals.clear();
+					slices.clear();
+					for (auto const& interval : nextIntervals)
+					{
+						if (interval.second - interval.first < 2) continue;
+						intervals.push_back(interval);
+						slices.push_back((interval.first + interval.second) / 2);
+					}
+				}
+			}
+
+			// Build the interpolation index
+			std::vector<size_t> skippedSlices;
+			for (size_t defocusId = 0, lower = 0; defocusId < numDefocuses; ++defocusId)
+			{
+				PsfStackElements::AdaptiveSample& sample = samples[defocusId];
+				if (sample.m_computed)
+				{
+					sample.m_lowerId = sample.m_upperId = lower = defocusId;
+					continue;
+				}
+
+				size_t upper = defocusId + 1;
+				while (!samples[upper].m_computed) ++upper;
+				sample.m_lowerId = lower;
+				sample.m_upperId = upper;
+				sample.m_weight = AdaptiveSampling::interpolationWeight(dioptres, lower, upper, defocusId);
+				skippedSlices.push_back(defocusId);
+			}
+
+			// Interpolate the skipped slices
+			const std::vector<PsfIndex> skippedIndices = AdaptiveSampling::sliceIndices(result, skippedSlices);
+			if (!skippedIndices.empty())
+			{
+				auto timer = result.m_timers.startComputation("PSF Interpolation", skippedIndices.size());
+
+				Threading::threadedExecuteIndices(Threading::numThreads(),
+					[&](Threading::ThreadedExecuteEnvironment const& environment, size_t id)
+					{
+						PsfIndex psfIndex = skippedIndices[id];
+						PsfStackElements::AdaptiveSample const& sample = samples[psfIndex[0]];
+						PsfIndex lowerIndex = psfIndex, upperIndex = psfIndex;
+						lowerIndex[0] = sample.m_lowerId;
+						upperIndex[0] = sample.m_upperId;
+						AdaptiveSampling::interpolatePsfEntry(result.m_psfs(lowerIndex), result.m_psfs(upperIndex), sample.m_weight, result.m_psfs(psfIndex));
+					},
+					skippedIndices.size());
+			}
+
+			if (aberration.m_psfParameters.m_logStats)
+			{
+				Debug::log_debug() << "Adaptive sampling: computed " << numComputedSlices << " of " << numDefocuses << " object distances "
+					<< "(" << numComputedSlices * numPsfsPerSlice << " of " << numDefocuses * numPsfsPerSlice << " PSFs)" << Debug::end;
+			}
+
+			// Compare the interpolated PSFs against the ones of the dense grid
+			if (aberration.m_psfParameters.m_adaptiveValidate && !skippedIndices.empty())
+			{
+				auto timer = result.m_timers.startComputation("PSFs (Validation)", skippedIndices.size());
+
+				std::vector<PsfStackElements::PsfEntry> interpolated(skippedIndices.size());
+				for (size_t id = 0; id < skippedIndices.size(); ++id)
+					interpolated[id] = result.m_psfs(skippedIndices[id]);
+
+				computePsfSlices(scene, aberration, result, skippedSlices);
+
+				std::vector<float> errorsL1(skippedIndices.size()), errorsCentroid(skippedIndices.size());
+				Threading::threadedExecuteIndices(Threading::numThreads(),
+					[&](Threading::ThreadedExecuteEnvironment const& environment, size_t id)
+					{
+						PsfStackElements::PsfEntry const& reference = result.m_psfs(skippedIndices[id]);
+						errorsL1[id] = AdaptiveSampling::interpolationError(PSFStackParameters::L1, interpolated[id], interpolated[id], 0.0f, reference);
+						errorsCentroid[id] = AdaptiveSampling::interpolationError(PSFStackParameters::CentroidShift, interpolated[id], interpolated[id], 0.0f, reference);
+						result.m_psfs(skippedIndices[id]) = std::move(interpolated[id]);
+					},
+					skippedIndices.size());
+
+				Debug::log_debug() << "Adaptive sampling error over " << skippedIndices.size() << " interpolated PSFs: "
+					<< "L1: " << std::accumulate(errorsL1.begin(), errorsL1.end(), 0.0f) / errorsL1.size() << " (mean), "
+					<< *std::max_element(errorsL1.begin(), errorsL1.end()) << " (max), "
+					<< "centroid shift: " << std::accumulate(errorsCentroid.begin(), errorsCentroid.end(), 0.0f) / errorsCentroid.size() << " (mean), "
+					<< *std::max_element(errorsCentroid.begin(), errorsCentroid.end()) << " (max) samples"
+					<< Debug::end;
+			}
+
+			if (gpu)
+			{
+				auto timer = result.m_timers.startComputation("GPU Cleanup", 1);
+				finishPsfComputationGpu(scene, aberration, computation, result);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Computes the separable factors of every PSF in the stack, if requested. */
+		void decomposePsfs(Scene::Scene& scene, WavefrontAberration& aberration, PSFStack& result)
+		{
+			if (!aberration.m_psfParameters.m_computeSeparable)
+				return;
+
+			PsfStackElements::PsfEntry* entries = result.m_psfs.data();
+			const size_t numPsfs = result.m_psfs.num_elements();
+
+			{
+				auto timer = result.m_timers.startComputation("Separable PSFs", numPsfs);
+
+				Threading::threadedExecuteIndices(Threading::numThreads(),
+					[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+					{
+						entries[psfId].m_separable = decomposePsf(entries[psfId].m_psf,
+							aberration.m_psfParameters.m_separableEnergyThreshold, aberration.m_psfParameters.m_separableMaxRank);
+					},
+					numPsfs);
+			}
+
+			if (!aberration.m_psfParameters.m_logStats || numPsfs == 0)
+				return;
+
+			// Per-PSF reconstruction error and convolution cost (multiply-adds per pixel)
+			size_t totalRank = 0, fullCost = 0, separableCost = 0;
+			float maxError = 0.0f;
+			for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+			{
+				Psf const& psf = entries[psfId].m_psf;
+				PsfStackElements::SeparablePsf const& separable = entries[psfId].m_separable;
+				const size_t rank = separable.m_rows.cols();
+
+				totalRank += rank;
+				fullCost += psf.size();
+				separableCost += rank * (psf.rows() + psf.cols());
+				maxError = glm::max(maxError, separable.m_error);
+
+				if (aberration.m_psfParameters.m_logDebug)
+				{
+					Debug::log_debug() << "PSF" << result.m_psfIndexDecoder.decode(psfId) << ": "
+						<< "size: " << psf.rows() << "x" << psf.cols() << ", "
+						<< "rank: " << rank << ", "
+						<< "energy: " << separable.m_energy << ", "
+						<< "max. error: " << separable.m_error << ", "
+						<< "cost: " << rank * (psf.rows() + psf.cols()) << " vs " << psf.size()
+						<< Debug::end;
+				}
+			}
+			Debug::log_info() << "Separable PSFs: average rank: " << float(totalRank) / float(numPsfs)
+				<< ", max. reconstruction error: " << maxError << " (relative to the PSF peak)"
+				<< ", convolution cost: " << separableCost << " vs " << fullCost << " multiply-adds per pixel"
+				<< Debug::end;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Moves the computed PSFs into the compact sample arena, if requested, and releases the full-precision ones. */
+		void compactPsfs(Scene::Scene& scene, WavefrontAberration& aberration, PSFStack& result)
+		{
+			const PSFStackParameters::PsfStorage storage = aberration.m_psfParameters.m_psfStorage;
+
+			// Release the previous arena
+			result.m_compactPsfSamples.clear();
+			result.m_compactPsfSamples.shrink_to_fit();
+			if (storage == PSFStackParameters::Full)
+				return;
+
+			// Nothing to compact; the threaded encoding below would still visit the first entry
+			const size_t numPsfs = result.m_psfs.num_elements();
+			if (numPsfs == 0)
+				return;
+
+			auto timer = result.m_timers.startComputation("PSF Compaction", numPsfs);
+
+			// Lay out the PSFs in the arena
+			PsfStackElements::PsfEntry* entries = result.m_psfs.data();
+			size_t numSamples = 0;
+			for (size_t psfId = 0; psfId < numPsfs; ++psfId)
+			{
+				PsfStackElements::CompactPsf& compact = entries[psfId].m_compact;
+				compact.m_storage = storage;
+				compact.m_offset = numSamples;
+				compact.m_rows = int(entries[psfId].m_psf.rows());
+				compact.m_cols = int(entries[psfId].m_psf.cols());
+				numSamples += entries[psfId].m_psf.size();
+			}
+			result.m_compactPsfSamples.resize(numSamples);
+
+			// Encode the PSFs, tracking the largest decoding error (relative to the PSF maximum) if needed
+			std::array<float, Constants::s_maxThreads> maxErrors;
+			std::fill(maxErrors.begin(), maxErrors.end(), 0.0f);
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t psfId)
+				{
+					PsfStackElements::PsfEntry& entry = entries[psfId];
+					PsfStackElements::CompactPsf& compact = entry.m_compact;
+					uint16_t* samples = result.m_compactPsfSamples.data() + compact.m_offset;
+
+					compact.m_scale = entry.m_psf.size() > 0 ? entry.m_psf.maxCoeff() : 0.0f;
+					if (compact.m_scale <= 0.0f) compact.m_scale = 1.0f;
+					PsfCompaction::encodeSamples(storage, entry.m_psf.data(), compact.m_scale, entry.m_psf.size(), samples);
+
+					if (aberration.m_psfParameters.m_logStats)
+					{
+						Psf decoded(compact.m_rows, compact.m_cols);
+						PsfCompaction::decodeSamples(storage, samples, compact.m_scale, decoded.size(), decoded.data());
+						float& maxError = maxErrors[Threading::currentThreadId()];
+						maxError = glm::max(maxError, (decoded - entry.m_psf).cwiseAbs().maxCoeff() / compact.m_scale);
+					}
+
+					entry.m_psf = Psf();
+				},
+				numPsfs);
+
+			if (aberration.m_psfParameters.m_logStats)
+			{
+				Debug::log_debug() << "PSF storage: " << PSFStackParameters::PsfStorage_meta.members[storage].name
+					<< ", max. decoding error: " << *std::max_element(maxErrors.begin(), maxErrors.end()) << " (relative to the PSF peak)" << Debug::end;
+			}
+		}
+
 		////////////////////////////////////////////////////////////////////////////////
 		void phasePsfs(Scene::Scene& scene, WavefrontAberration& aberration, PsfStackComputation computation, PSFStack& result)
 		{
@@ -3872,9 +5392,17 @@ namespace Aberration
 				[aberration.m_psfParameters.m_evaluatedParameters.m_apertureDiameters.size()]
 				[aberration.m_psfParameters.m_evaluatedParameters.m_focusDistances.size()]
 			);
+			result.m_psfIndexDecoder = PsfIndexDecoder(result.m_psfs.shape(), result.m_psfs.strides());
+			result.m_adaptiveSamples.clear();
+
+			// Refine the object distances adaptively, interpolating the skipped PSFs
+			if (aberration.m_psfParameters.m_adaptiveSampling)
+			{
+				computePsfsAdaptive(scene, aberration, computation, result);
+			}
 
 			// Perform the PSF computation on the CPU
-			if (aberration.m_psfParameters.m_backend == Aberration::PSFStackParameters::CPU)
+			if (!aberration.m_psfParameters.m_adaptiveSampling && aberration.m_psfParameters.m_backend == Aberration::PSFStackParameters::CPU)
 			{
 				auto timer = result.m_timers.startComputation("PSFs", numPsfs);
 
@@ -3894,7 +5422,7 @@ namespace Aberration
 			}
 
 			// Perform the PSF computation on the GPU
-			if (aberration.m_psfParameters.m_backend == Aberration::PSFStackParameters::GPU)
+			if (!aberration.m_psfParameters.m_adaptiveSampling && aberration.m_psfParameters.m_backend == Aberration::PSFStackParameters::GPU)
 			{
 				auto timer = result.m_timers.startComputation("PSFs", numPsfs);
 
@@ -3931,15 +5459,29 @@ namespace Aberration
 				}
 			}
 
+			// Compute the separable factors
+			decomposePsfs(scene, aberration, result);
+
+			// Move the PSFs to the compact storage
+			compactPsfs(scene, aberration, result);
+
 			// Print out some useful stats
 			if (aberration.m_psfParameters.m_logStats)
 			{
 				size_t totalPsfBytes = 0;
 				for (size_t psfId = 0; psfId < result.m_psfEntryParameters.num_elements(); ++psfId)
 				{
-					totalPsfBytes += result.m_psfs.data()[psfId].m_psf.size() * sizeof(ScalarComputation);
+					const auto psfSize = getPsfSize(result.m_psfs.data()[psfId]);
+					totalPsfBytes += psfSize.first * psfSize.second * sizeof(ScalarComputation);
 				}
 				Debug::log_debug() << "Total memory consumed by the PSFs: " << Units::bytesToString(totalPsfBytes) << Debug::end;
+
+				if (aberration.m_psfParameters.m_psfStorage != PSFStackParameters::Full)
+				{
+					const size_t compactPsfBytes = result.m_compactPsfSamples.size() * sizeof(uint16_t);
+					Debug::log_debug() << "Total memory consumed by the compacted PSFs: " << Units::bytesToString(compactPsfBytes)
+						<< " (saved " << Units::bytesToString(totalPsfBytes - compactPsfBytes) << ")" << Debug::end;
+				}
 			}
 		}
 	}
@@ -4650,7 +6192,8 @@ namespace Aberration
 			float fovy = aberration.m_psfPreview.m_fovy;
 
 			// Extract the psf images
-			auto const& psfFullRes = psf.m_psf;
+			Psf psfScratch;
+			auto const& psfFullRes = getPsf(scene, aberration, psf, psfScratch);
 
 			// Target size for the upscaled PSFs
 			Eigen::Vector2i targetSize = Eigen::Vector2i(psfFullRes.cols(), psfFullRes.rows());
@@ -5473,6 +7016,44 @@ namespace Aberration
 			generateGuiParameterRange(scene, guiSettings, owner, aberration, "Aperture Diameters (mm)", aberration.m_psfParameters.m_apertureDiameters); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
 			generateGuiParameterRange(scene, guiSettings, owner, aberration, "Focus Distances (Dioptres)", aberration.m_psfParameters.m_focusDistances); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
 
+			ImGui::Separator();
+			ImGui::TextDisabled("Validation");
+
+			if (ImGui::Button("Benchmark PSF Resampler"))
+			{
+				benchmarkPsfResampler(scene, aberration);
+			}
+
+			if (ImGui::Button("Validate PSF Resize"))
+			{
+				validatePsfResize(scene, aberration);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark PSF Resize"))
+			{
+				benchmarkPsfResize(scene, aberration);
+			}
+
+			if (ImGui::Button("Validate PSF Storage"))
+			{
+				validatePsfStorage(scene, aberration);
+			}
+
+			if (ImGui::Button("Benchmark Separable Convolution"))
+			{
+				benchmarkSeparableConvolution(scene, aberration);
+			}
+
+			if (ImGui::Button("Validate PSF Index Decoder"))
+			{
+				validatePsfIndexDecoder();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark PSF Index Decoder"))
+			{
+				benchmarkPsfIndexDecoder();
+			}
+
 			ImGui::EndTabItem();
 			EditorSettings::editorProperty<std::string>(scene, owner, "Aberration_SelectedTab") = ImGui::CurrentTabItemName();
 		}
@@ -5515,6 +7096,19 @@ namespace Aberration
 			ImGui::SliderFloat("Crop Threshold (Sum)", &aberration.m_psfParameters.m_cropThresholdSum, 0.0f, 1.0f); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
 			ImGui::SliderFloat("Crop Threshold (Coeff)", &aberration.m_psfParameters.m_cropThresholdCoeff, 0.0f, 1.0f); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
 			aberrationChanged = ImGui::Combo("Interpolation Method", &aberration.m_psfParameters.m_interpolationType, Aberration::PSFStackParameters::InterpolationType_meta) || aberrationChanged;
+			aberrationChanged = ImGui::Combo("PSF Storage", &aberration.m_psfParameters.m_psfStorage, Aberration::PSFStackParameters::PsfStorage_meta) || aberrationChanged;
+			aberrationChanged = ImGui::Checkbox("Separable PSFs", &aberration.m_psfParameters.m_computeSeparable) || aberrationChanged;
+			ImGui::SliderFloat("Separable Energy Threshold", &aberration.m_psfParameters.m_separableEnergyThreshold, 0.9f, 1.0f); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
+			ImGui::SliderInt("Separable Max Rank", &aberration.m_psfParameters.m_separableMaxRank, 1, 16); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
+
+			ImGui::Separator();
+
+			ImGui::TextDisabled("Adaptive Sampling");
+			aberrationChanged = ImGui::Checkbox("Adaptive Object Distances", &aberration.m_psfParameters.m_adaptiveSampling) || aberrationChanged;
+			ImGui::SliderInt("Coarse Step", &aberration.m_psfParameters.m_adaptiveCoarseStep, 1, 32); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
+			aberrationChanged = ImGui::Combo("Error Metric", &aberration.m_psfParameters.m_adaptiveErrorMetric, Aberration::PSFStackParameters::AdaptiveErrorMetric_meta) || aberrationChanged;
+			ImGui::SliderFloat("Error Threshold", &aberration.m_psfParameters.m_adaptiveErrorThreshold, 0.0f, 1.0f); aberrationChanged = ImGui::IsItemDeactivatedAfterEdit() || aberrationChanged;
+			aberrationChanged = ImGui::Checkbox("Validate Against Full Grid", &aberration.m_psfParameters.m_adaptiveValidate) || aberrationChanged;
 
 			ImGui::EndTabItem();
 			EditorSettings::editorProperty<std::string>(scene, owner, "Aberration_SelectedTab") = ImGui::CurrentTabItemName();
@@ -181,6 +181,12 @@ namespace Aberration
 		// Which aberration coefficient to use
 		meta_enum(CoefficientVariation, int, AlphaOpd, AlphaPhaseCumulative, AlphaPhaseResidual, Beta);
 
+		// In-memory storage formats for the computed PSFs
+		meta_enum(PsfStorage, int, Full, Float16, LogQuantized);
+
+		// Error metrics for the adaptive sampling
+		meta_enum(AdaptiveErrorMetric, int, L1, CentroidShift);
+
 		/** Represents a parameter range. */
 		struct ParameterRange
 		{
@@ -243,6 +249,21 @@ namespace Aberration
 		float m_cropThresholdSum = 1.0f; // Threshold for cropping the PSF sum; 1.0 means no cropping
 		float m_cropThresholdCoeff = 0.0f; // Threshold for cropping the PSF coeffs; 0.0 means no cropping
 
+		// PSF storage parameters
+		PsfStorage m_psfStorage = Full; // How the computed PSFs are kept in memory
+
+		// Separable decomposition parameters
+		bool m_computeSeparable = false; // Whether a truncated SVD of each PSF should be computed
+		float m_separableEnergyThreshold = 0.995f; // Fraction of the PSF energy the kept separable terms must capture
+		int m_separableMaxRank = 4; // Maximum number of separable terms to keep
+
+		// Adaptive sampling parameters
+		bool m_adaptiveSampling = false; // Whether the object distances are refined adaptively, interpolating the skipped PSFs
+		int m_adaptiveCoarseStep = 8; // Spacing of the initial coarse grid, in object distance samples
+		AdaptiveErrorMetric m_adaptiveErrorMetric = L1; // How the interpolation error is measured
+		float m_adaptiveErrorThreshold = 0.05f; // Refinement threshold; L1 distance of the normalized PSFs, or centroid shift in PSF samples
+		bool m_adaptiveValidate = false; // Whether the skipped PSFs should also be computed, to measure the interpolation error
+
 		// Logging, debugging, etc.
 		bool m_omitVnmCalculation = false; // Whether we should omit the computation of the actual Vnm; for timing purposes only
 		bool m_omitPsfCalculation = false; // Whether we should omit the computation of the actual PSF; for timing purposes only
@@ -589,6 +610,27 @@ namespace Aberration
 		*/
 		using EnzTerms = boost::multi_array<EnzTermsEntry, 2>;
 
+		////////////////////////////////////////////////////////////////////////////////
+		/** Location and format of a compacted PSF in the sample arena of its stack. */
+		struct CompactPsf
+		{
+			PSFStackParameters::PsfStorage m_storage = PSFStackParameters::Full; // Storage format; Full means the PSF is kept in the entry itself
+			size_t m_offset = 0; // Offset of the first sample in the sample arena of the stack
+			int m_rows = 0; // Number of rows
+			int m_cols = 0; // Number of columns
+			float m_scale = 1.0f; // Scale of the stored samples (the largest coefficient)
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Truncated SVD of a PSF; the PSF is approximated by m_rows * m_cols^T, with the singular values folded into m_rows. */
+		struct SeparablePsf
+		{
+			EigenTypes::ScalarMatrixFinal m_rows; // Vertical factors (rows x rank)
+			EigenTypes::ScalarMatrixFinal m_cols; // Horizontal factors (cols x rank)
+			float m_energy = 0.0f; // Fraction of the PSF energy captured by the kept terms
+			float m_error = 0.0f; // Largest reconstruction error, relative to the PSF peak
+		};
+
 		////////////////////////////////////////////////////////////////////////////////
 		/** Structure holding a PSF corresponding to a certain wavelength and object distance. */
 		struct PsfEntry
@@ -598,9 +640,26 @@ namespace Aberration
 			float m_blurRadiusDeg; // Size of the PSF on the retina (in degrees).
 			float m_blurSizeMuM; // Size of the PSF on the retina (in micrometers).
 			float m_blurSizeDeg; // Size of the PSF on the retina (in degrees).
-			Psf m_psf; // The PSF itself.
+			Psf m_psf; // The PSF itself; empty if the stack is compacted.
+			CompactPsf m_compact; // Location of the compacted PSF.
+			SeparablePsf m_separable; // Separable factors of the PSF; empty if not computed.
 		};
 
+		////////////////////////////////////////////////////////////////////////////////
+		/** Origin of an object distance slice of the stack, when it is sampled adaptively. */
+		struct AdaptiveSample
+		{
+			bool m_computed = true; // Whether the PSFs of the slice were computed or interpolated
+			size_t m_lowerId = 0; // Nearest computed slice below (the slice itself if computed)
+			size_t m_upperId = 0; // Nearest computed slice above (the slice itself if computed)
+			float m_weight = 0.0f; // Interpolation weight of the upper slice
+			float m_error = 0.0f; // Interpolation error measured when the slice was tested as a midpoint
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** Interpolation index of an adaptively sampled stack, one entry per object distance. */
+		using AdaptiveSamples = std::vector<AdaptiveSample>;
+
 		////////////////////////////////////////////////////////////////////////////////
 		/** A set of PSFs. Follows the same organization as the entry parameters. They are organized as follows:
 		*     [0] Object depth;
@@ -624,6 +683,96 @@ namespace Aberration
 		};
 	}
 	
+	////////////////////////////////////////////////////////////////////////////////
+	/** Division by a fixed divisor, replaced with a multiplication and two shifts (Granlund-Montgomery).
+	    Only valid for 32-bit numerators and divisors. */
+	struct FastDivisor
+	{
+		FastDivisor(const uint32_t divisor = 1);
+
+		uint32_t divide(const uint32_t n) const
+		{
+			const uint32_t t = uint32_t((uint64_t(m_multiplier) * n) >> 32);
+			return (t + ((n - t) >> m_shift1)) >> m_shift2;
+		}
+
+		uint32_t m_divisor;
+		uint32_t m_multiplier;
+		uint32_t m_shift1;
+		uint32_t m_shift2;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Converts linear PSF ids into PsfIndex values, using precomputed divisors for each dimension. */
+	struct PsfIndexDecoder
+	{
+		PsfIndexDecoder() = default;
+
+		/** Decoder for a row-major array with the parameter shape. */
+		PsfIndexDecoder(PsfIndex const& shape);
+
+		/** Decoder for a multi_array with the parameter shape and strides. */
+		PsfIndexDecoder(const PsfStackElements::PsfEntries::size_type* shape, const PsfStackElements::PsfEntries::index* strides);
+
+		/** Whether the decoder describes the parameter shape and strides. */
+		bool matches(const PsfStackElements::PsfEntries::size_type* shape, const PsfStackElements::PsfEntries::index* strides) const
+		{
+			for (size_t d = 0; d < 6; ++d)
+				if (m_shape[d] != size_t(shape[d]) || m_strides[d] != size_t(strides[d])) return false;
+			return true;
+		}
+
+		/** Decodes a linear PSF id. */
+		PsfIndex decode(const size_t psfId) const
+		{
+			PsfIndex result;
+			if (m_fastDivision && psfId <= UINT32_MAX)
+			{
+				for (size_t d = 0; d < 6; ++d)
+				{
+					const uint32_t quotient = m_strideDivisors[d].divide(uint32_t(psfId));
+					result[d] = quotient - m_shapeDivisors[d].divide(quotient) * uint32_t(m_shape[d]);
+				}
+			}
+			else
+			{
+				for (size_t d = 0; d < 6; ++d)
+					result[d] = psfId / m_strides[d] % m_shape[d];
+			}
+			return result;
+		}
+
+		/** Moves the parameter index to that of the next linear id, odometer-style. */
+		void advance(PsfIndex& psfIndex) const
+		{
+			for (size_t axis : m_axisOrder)
+			{
+				if (++psfIndex[axis] < m_shape[axis]) return;
+				psfIndex[axis] = 0;
+			}
+		}
+
+		/** Total number of entries. */
+		size_t numElements() const
+		{
+			return std::accumulate(m_shape.begin(), m_shape.end(), size_t(1), std::multiplies<size_t>());
+		}
+
+		// Shape and strides of the array
+		PsfIndex m_shape{};
+		PsfIndex m_strides{};
+
+		// Dimensions ordered from the smallest stride to the largest
+		PsfIndex m_axisOrder{ 5, 4, 3, 2, 1, 0 };
+
+		// Divisors for the strides and dimension sizes
+		std::array<FastDivisor, 6> m_strideDivisors;
+		std::array<FastDivisor, 6> m_shapeDivisors;
+
+		// Whether every stride and dimension size fits in 32 bits
+		bool m_fastDivision = false;
+	};
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** A "PSF stack" - a collection of PSFs with all the necessary data. */
 	struct PSFStack
@@ -658,6 +807,15 @@ namespace Aberration
 		/** The actual PSFs. */
 		PsfStackElements::PsfEntries m_psfs;
 
+		/** Linear id decoder for the PSF array. */
+		PsfIndexDecoder m_psfIndexDecoder;
+
+		/** Sample arena for the compacted PSFs. */
+		std::vector<uint16_t> m_compactPsfSamples;
+
+		/** Interpolation index of the adaptive sampling; empty if the full grid was computed. */
+		PsfStackElements::AdaptiveSamples m_adaptiveSamples;
+
 		/** Common debug information. */
 		PsfStackElements::DebugInformationCommon m_debugInformationCommon;
 
@@ -758,6 +916,105 @@ namespace Aberration
 	////////////////////////////////////////////////////////////////////////////////
 	Psf resizePsfNormalized(Scene::Scene& scene, WavefrontAberration& aberration, Psf const& psf, float radius);
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Decodes compacted PSF samples, in bulk. */
+	void decodePsfSamples(const PSFStackParameters::PsfStorage storage, const uint16_t* samples, const float scale, const size_t numSamples, float* out);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Returns the PSF of the parameter entry; compacted PSFs are decoded into the scratch matrix. */
+	Psf const& getPsf(Scene::Scene& scene, WavefrontAberration const& aberration, PsfStackElements::PsfEntry const& psf, Psf& scratch);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Returns the PSF of the parameter entry, decoding it if needed. */
+	Psf getPsf(Scene::Scene& scene, WavefrontAberration const& aberration, PsfStackElements::PsfEntry const& psf);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Dimensions (rows, cols) of the PSF of the parameter entry, without decoding it. */
+	std::pair<size_t, size_t> getPsfSize(PsfStackElements::PsfEntry const& psf);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Resizes each PSF to the matching fractional radius, like resizePsf, sharing the setup and scratch buffers; reuses the storage of the output PSFs. */
+	void resizePsfBatch(Scene::Scene& scene, WavefrontAberration& aberration, std::vector<Psf> const& psfs, std::vector<float> const& radii, std::vector<Psf>& out);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Separable resampling filter for one source PSF size and target radius. */
+	struct PsfResampleWeights
+	{
+		// Vertical (diameter x rows) and horizontal (diameter x cols) filter weights
+		EigenTypes::ScalarMatrixFinal m_rows;
+		EigenTypes::ScalarMatrixFinal m_cols;
+
+		// Column sums of the horizontal weights, used to normalize without a second pass
+		Eigen::Matrix<ScalarFinal, Eigen::Dynamic, 1> m_colSums;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Resamples many PSFs into a range of radii, sharing the filter weights between them. */
+	struct PsfResampler
+	{
+		// The interpolation kernel the weights were built with
+		PSFStackParameters::InterpolationType m_interpolationType;
+
+		// Range of target radii
+		size_t m_minRadius = 0;
+		size_t m_maxRadius = 0;
+
+		// Filter weights, for each source size and each radius in the range
+		std::map<std::pair<size_t, size_t>, std::vector<PsfResampleWeights>> m_weights;
+
+		// Per-thread scratch for the intermediate (vertically filtered) and final products
+		std::array<EigenTypes::ScalarMatrixFinal, Constants::s_maxThreads> m_scratchVertical;
+		std::array<EigenTypes::ScalarMatrixFinal, Constants::s_maxThreads> m_scratchResult;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Builds a resampler for the parameter source PSF sizes and radius range. */
+	void initPsfResampler(Scene::Scene& scene, WavefrontAberration& aberration, PsfResampler& resampler,
+		std::vector<std::pair<size_t, size_t>> const& psfSizes, const size_t minRadius, const size_t maxRadius);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Writes the normalized, resized PSF into 'out', as a (2 * radius + 1)^2 row-major block. */
+	void resamplePsfNormalized(PsfResampler& resampler, Psf const& psf, const size_t radius, float* out);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Generates the weight pyramids of a synthetic off-axis stack (an 8x8 angle grid at 16 distances by default)
+	    with the shared resampler and with independent per-radius resizes, and logs the timings and largest difference. */
+	void benchmarkPsfResampler(Scene::Scene& scene, WavefrontAberration& aberration, const size_t numPsfs = 1024, const size_t maxRadius = 32, const size_t radiiPerPsf = 8);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks that resizePsfBatch matches resizePsf exactly, and that the fused blend matches the original padded blend. */
+	bool validatePsfResize(Scene::Scene& scene, WavefrontAberration& aberration, const size_t numPsfs = 256, const float maxRadius = 32.0f);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times the padded blend, the fused single resize and the batch resize on synthetic PSFs. */
+	void benchmarkPsfResize(Scene::Scene& scene, WavefrontAberration& aberration, const size_t numPsfs = 1024, const float maxRadius = 32.0f);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Round-trips a sample of the stack through each compact storage format and compares test images blurred
+	    with the resulting projected PSFs against the full-precision ones. */
+	bool validatePsfStorage(Scene::Scene& scene, WavefrontAberration& aberration, const size_t maxPsfs = 64, const float tolerance = 2e-3f);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Truncated SVD of the PSF, keeping the fewest terms that capture the requested fraction of its energy. */
+	PsfStackElements::SeparablePsf decomposePsf(Psf const& psf, const float energyThreshold, const int maxRank);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Reconstructs the PSF from its separable factors. */
+	Psf reconstructPsf(PsfStackElements::SeparablePsf const& separable);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Convolves the image with the full 2D PSF; zero padded, the output has the size of the image. */
+	void convolvePsf(Psf const& psf, EigenTypes::ScalarMatrixFinal const& image, EigenTypes::ScalarMatrixFinal& out);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Convolves the image with the separable factors of a PSF, one vertical and one horizontal pass per term. */
+	void convolvePsfSeparable(PsfStackElements::SeparablePsf const& separable, EigenTypes::ScalarMatrixFinal const& image, EigenTypes::ScalarMatrixFinal& out);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Convolves a test image with PSFs of several sizes from the stack, both with the full kernels and with their separable
+	    factors, and logs the rank, the reconstruction error and the time of both paths for each PSF. */
+	void benchmarkSeparableConvolution(Scene::Scene& scene, WavefrontAberration& aberration, const size_t imageSize = 512, const size_t numSizes = 4, const size_t numIterations = 3);
+
 	////////////////////////////////////////////////////////////////////////////////
 	Psf getProjectedPsf(Scene::Scene& scene, WavefrontAberration& aberration, Aberration::PsfStackElements::PsfEntry const& psf, const glm::ivec2 renderResolution, const float fovy);
 
@@ -822,23 +1079,20 @@ namespace Aberration
 		using pointer = PsfIndex*;
 		using reference = PsfIndex&;
 
-		using size_ptr_type = const PsfStackElements::PsfEntries::size_type*;
-		using index_ptr_type = const PsfStackElements::PsfEntries::index*;
-
-		PsfIndexIterator(size_ptr_type shape, index_ptr_type strides, const size_t id = 0) :
-			m_shape(shape), m_strides(strides), m_id(id) {}
+		PsfIndexIterator(PsfIndexDecoder const& decoder, const size_t id = 0) :
+			m_decoder(decoder), m_index(id < decoder.numElements() ? decoder.decode(id) : PsfIndex{}), m_id(id) {}
 
-		PsfIndex operator*() const { return getPsfIndex(m_shape, m_strides, m_id); }
+		PsfIndex operator*() const { return m_index; }
 
-		PsfIndexIterator& operator++() { ++m_id; return *this; }
-		PsfIndexIterator operator++(int) { PsfIndexIterator tmp = *this; ++m_id; return tmp; }
+		PsfIndexIterator& operator++() { ++m_id; m_decoder.advance(m_index); return *this; }
+		PsfIndexIterator operator++(int) { PsfIndexIterator tmp = *this; ++(*this); return tmp; }
 
 		friend bool operator== (PsfIndexIterator const& a, PsfIndexIterator const& b) { return a.m_id == b.m_id; };
 		friend bool operator!= (PsfIndexIterator const& a, PsfIndexIterator const& b) { return a.m_id != b.m_id; };
 
 	private:
-		size_ptr_type m_shape;
-		index_ptr_type m_strides;
+		PsfIndexDecoder m_decoder;
+		PsfIndex m_index;
 		size_t m_id;
 	};
 
@@ -848,19 +1102,29 @@ namespace Aberration
 	////////////////////////////////////////////////////////////////////////////////
 	PsfIndexIterator psfStackEnd(Scene::Scene& scene, WavefrontAberration& aberration);
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the fast divisors and the index decoder against plain division: densely for small values, around
+	    the divisor multiples, on random 32-bit values, and on every id of random stack shapes. */
+	bool validatePsfIndexDecoder(const size_t numShapes = 256, const size_t numRandom = 1 << 20);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times decoding with plain division, with the fast divisors and with the odometer iterator. */
+	void benchmarkPsfIndexDecoder(const size_t numIds = 1 << 24);
+
 	////////////////////////////////////////////////////////////////////////////////
 	template<typename Fn, typename Fp>
 	void forEachPsfIndex(Scene::Scene& scene, WavefrontAberration& aberration, Fp const& filterPred, Fn const& fn)
 	{
+		const PsfIndexDecoder decoder(PsfIndex
+		{
+			getNumObjectDistances(scene, aberration), getNumHorizontalAngles(scene, aberration), getNumVerticalAngles(scene, aberration),
+			getNumLambdas(scene, aberration), getNumApertures(scene, aberration), getNumFocuses(scene, aberration)
+		});
+
 		// Traverse the PSF indices
-		for (size_t defocusId = 0; defocusId < getNumObjectDistances(scene, aberration); ++defocusId)
-		for (size_t horizontalId = 0; horizontalId < getNumHorizontalAngles(scene, aberration); ++horizontalId)
-		for (size_t verticalId = 0; verticalId < getNumVerticalAngles(scene, aberration); ++verticalId)
-		for (size_t lambdaId = 0; lambdaId < getNumLambdas(scene, aberration); ++lambdaId)
-		for (size_t apertureId = 0; apertureId < getNumApertures(scene, aberration); ++apertureId)
-		for (size_t focusId = 0; focusId < getNumFocuses(scene, aberration); ++focusId)
+		for (PsfIndexIterator it(decoder, 0), end(decoder, decoder.numElements()); it != end; ++it)
 		{
-			PsfIndex const& index = PsfIndex{ defocusId, horizontalId, verticalId, lambdaId, apertureId, focusId };
+			PsfIndex const& index = *it;
 			if (filterPred(index)) fn(scene, aberration, index);
 		}
 	}
@@ -19,6 +19,7 @@ namespace DirectionalLight
 		shaderParameters.m_defines =
 		{
 			"LIGHT_TYPE DIRECTIONAL",
+			"MAX_SHADOW_CASCADES "s + std::to_string(DirectionalLight::MAX_SHADOW_CASCADES),
 			"VOXEL_GBUFFER_TEXTURE_FORMAT " + RenderSettings::voxelGbufferGlShaderFormat(scene),
 			"VOXEL_RADIANCE_TEXTURE_FORMAT " + RenderSettings::voxelRadianceGlShaderFormat(scene)
 		};
@@ -50,6 +51,9 @@ namespace DirectionalLight
 		Scene::appendResourceInitializer(scene, object.m_name, Scene::Shader, initShaders, "Shaders");
 		Scene::appendResourceInitializer(scene, object.m_name, Scene::GenericBuffer, initGPUBuffers, "Generic GPU Buffers");
 
+		// Keep track of the light in the shadow caster list
+		ShadowMap::registerShadowCaster(scene, &object);
+
 		// Set the default shadow map layout
 		object.component<ShadowMap::ShadowMapComponent>().m_layout = ShadowMap::ShadowMapComponent::Traditional;
 
@@ -64,15 +68,23 @@ namespace DirectionalLight
 	////////////////////////////////////////////////////////////////////////////////
 	void releaseObject(Scene::Scene& scene, Scene::Object& object)
 	{
-
+		ShadowMap::unregisterShadowCaster(scene, &object);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	void updateObject(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object)
 	{
 		// Keep the shadow map slices updated
+		const size_t numSlices = object->component<ShadowMap::ShadowMapComponent>().m_slices.size();
 		updateShadowMapSlices(scene, object);
 
+		// Resize the shadow map if the number of cascades changed
+		if (object->component<ShadowMap::ShadowMapComponent>().m_slices.size() != numSlices)
+		{
+			updateShadowMapTexture(scene, object);
+			ShadowMap::regenerateShadowMap(scene, object);
+		}
+
 		// Regenerate the shadow maps if the object's transform has changed
 		if (object->component<Transform::TransformComponent>().m_transformChanged)
 		{
@@ -126,18 +138,78 @@ namespace DirectionalLight
 		return result;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	int numCascades(Scene::Object* object)
+	{
+		return glm::clamp(object->component<DirectionalLight::DirectionalLightComponent>().m_numCascades, 1, int(MAX_SHADOW_CASCADES));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::vector<ShadowCascades::Cascade<float>> computeCascades(Scene::Scene& scene, Scene::Object* object)
+	{
+		// Access the render settings and the camera that the cascades follow
+		Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+		Scene::Object* camera = RenderSettings::getMainCamera(scene, renderSettings);
+		if (camera == nullptr) return {};
+
+		// Range of the camera frustum to cover
+		const float near = RenderSettings::metersToUnits(renderSettings, camera->component<Camera::CameraComponent>().m_near);
+		const float far = RenderSettings::metersToUnits(renderSettings, glm::min(camera->component<Camera::CameraComponent>().m_far,
+			object->component<DirectionalLight::DirectionalLightComponent>().m_cascadeMaxDistance));
+
+		// Everything in the scene can cast a shadow into the cascades
+		return ShadowCascades::computeCascades<float>(Camera::getViewMatrix(camera), Camera::getProjectionMatrix(renderSettings, camera),
+			lightSourceDirection(scene, object), near, far, numCascades(object),
+			object->component<DirectionalLight::DirectionalLightComponent>().m_cascadeSplitLambda,
+			object->component<ShadowMap::ShadowMapComponent>().m_resolution,
+			renderSettings->component<RenderSettings::RenderSettingsComponent>().m_sceneAabb);
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	void updateShadowMapSlices(Scene::Scene& scene, Scene::Object* object)
 	{
-		// Create the corrent number of slices
 		auto& slices = object->component<ShadowMap::ShadowMapComponent>().m_slices;
-		slices.resize(1);
+		auto& cascades = object->component<DirectionalLight::DirectionalLightComponent>().m_cascades;
+		const int resolution = object->component<ShadowMap::ShadowMapComponent>().m_resolution;
+
+		// Fit the cascades to the camera, if requested
+		cascades.clear();
+		if (numCascades(object) > 1)
+			cascades = computeCascades(scene, object);
+
+		// Fall back to a single slice that covers the entire scene
+		if (cascades.empty())
+		{
+			object->component<ShadowMap::ShadowMapComponent>().m_layout = ShadowMap::ShadowMapComponent::Traditional;
+			object->component<ShadowMap::ShadowMapComponent>().m_numSlices = glm::ivec2(1, 1);
+
+			// Create the corrent number of slices
+			slices.resize(1);
+
+			// Configure the slices
+			auto& slice = slices.front();
+			slice.m_startCoords = glm::ivec2(0, 0);
+			slice.m_extents = glm::ivec2(resolution);
+			slice.m_transform = lightSourceTransform(scene, object);
+			return;
+		}
 
-		// Configure the slices
-		auto& slice = slices.front();
-		slice.m_startCoords = glm::ivec2(0, 0);
-		slice.m_extents = glm::ivec2(object->component<ShadowMap::ShadowMapComponent>().m_resolution);
-		slice.m_transform = lightSourceTransform(scene, object);
+		// Lay the cascades out next to each other
+		object->component<ShadowMap::ShadowMapComponent>().m_layout = ShadowMap::ShadowMapComponent::Cascaded;
+		object->component<ShadowMap::ShadowMapComponent>().m_numSlices = glm::ivec2(cascades.size(), 1);
+		slices.resize(cascades.size());
+		for (size_t cascadeId = 0; cascadeId < cascades.size(); ++cascadeId)
+		{
+			auto& slice = slices[cascadeId];
+			slice.m_startCoords = glm::ivec2(cascadeId * resolution, 0);
+			slice.m_extents = glm::ivec2(resolution);
+
+			// The snapped cascades only move in whole texels, so only re-render them when they actually moved
+			const ShadowMap::ShadowMapTransform transform = ShadowCascades::cascadeTransform(cascades[cascadeId]);
+			if (slice.m_transform.m_transform != transform.m_transform)
+				slice.m_needsUpdate = true;
+			slice.m_transform = transform;
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -164,6 +236,17 @@ namespace DirectionalLight
 		lightingChanged |= ImGui::DragFloat("Ambient Intensity", &object->component<DirectionalLight::DirectionalLightComponent>().m_ambientIntensity, 0.01f);
 		lightingChanged |= ImGui::DragFloat("Diffuse Intensity", &object->component<DirectionalLight::DirectionalLightComponent>().m_diffuseIntensity, 0.01f);
 		lightingChanged |= ImGui::DragFloat("Specular Intensity", &object->component<DirectionalLight::DirectionalLightComponent>().m_specularItensity, 0.01f);
+		recreateShadowMap |= ImGui::SliderInt("Cascades", &object->component<DirectionalLight::DirectionalLightComponent>().m_numCascades, 1, int(MAX_SHADOW_CASCADES));
+		refreshShadowMap |= ImGui::SliderFloat("Cascade Split Lambda", &object->component<DirectionalLight::DirectionalLightComponent>().m_cascadeSplitLambda, 0.0f, 1.0f);
+		refreshShadowMap |= ImGui::DragFloat("Cascade Max Distance", &object->component<DirectionalLight::DirectionalLightComponent>().m_cascadeMaxDistance, 1.0f, 0.0f, 10000.0f);
+		if (Scene::Object* camera = RenderSettings::getMainCamera(scene, renderSettings); camera != nullptr && ImGui::Button("Validate Cascades"))
+		{
+			ShadowCascades::validate(Camera::getProjectionMatrix(renderSettings, camera),
+				RenderSettings::metersToUnits(renderSettings, camera->component<Camera::CameraComponent>().m_near),
+				RenderSettings::metersToUnits(renderSettings, glm::min(camera->component<Camera::CameraComponent>().m_far, object->component<DirectionalLight::DirectionalLightComponent>().m_cascadeMaxDistance)),
+				numCascades(object), object->component<DirectionalLight::DirectionalLightComponent>().m_cascadeSplitLambda,
+				object->component<ShadowMap::ShadowMapComponent>().m_resolution);
+		}
 		auto shadowMapChanged = ShadowMap::generateGui(scene, guiSettings, object);
 		recreateShadowMap |= shadowMapChanged[0];
 		refreshShadowMap |= shadowMapChanged[1];
@@ -195,6 +278,7 @@ namespace DirectionalLight
 		lightData.m_diffuseIntensity = object->component<DirectionalLight::DirectionalLightComponent>().m_diffuseIntensity;
 		lightData.m_specularIntensity = object->component<DirectionalLight::DirectionalLightComponent>().m_specularItensity;
 		lightData.m_castsShadow = castsShadow(renderSettings, object) ? 1.0f : 0.0f;
+		lightData.m_numCascades = 1;
 		if (castsShadow(renderSettings, object))
 		{
 			lightData.m_shadowAlgorithm = object->component<ShadowMap::ShadowMapComponent>().m_algorithm;
@@ -204,7 +288,15 @@ namespace DirectionalLight
 			lightData.m_shadowLightBleedBias = object->component<ShadowMap::ShadowMapComponent>().m_lightBleedBias;
 			lightData.m_shadowMomentsBias = object->component<ShadowMap::ShadowMapComponent>().m_momentsBias;
 			lightData.m_shadowExponentialConstants = object->component<ShadowMap::ShadowMapComponent>().m_exponentialConstants;
-			lightData.m_lightSpaceTransform = object->component<ShadowMap::ShadowMapComponent>().m_slices[0].m_transform.m_transform;
+
+			// Upload the per-cascade transforms and atlas locations
+			auto const& slices = object->component<ShadowMap::ShadowMapComponent>().m_slices;
+			lightData.m_numCascades = GLint(glm::min(slices.size(), MAX_SHADOW_CASCADES));
+			for (GLint cascadeId = 0; cascadeId < lightData.m_numCascades; ++cascadeId)
+			{
+				lightData.m_lightSpaceTransforms[cascadeId] = slices[cascadeId].m_transform.m_transform;
+				lightData.m_shadowMapOffsetScales[cascadeId] = glm::vec4(slices[cascadeId].m_textureOffset, slices[cascadeId].m_textureScale);
+			}
 		}
 
 		// Return the final result
@@ -249,7 +341,7 @@ namespace DirectionalLight
 		for (auto const& lightData : lightBatches)
 		{
 			// Upload the parameters
-			uploadBufferData(scene, "DirectionalLight", lightData);
+			uploadTransientBufferData(scene, "DirectionalLight", lightData);
 
 			// inject radiance at level 0 of texture
 			glDispatchCompute(numWorkGroups, numWorkGroups, numWorkGroups);
@@ -291,7 +383,7 @@ namespace DirectionalLight
 		for (auto const& lightData : lightBatches)
 		{
 			// Upload the parameters
-			uploadBufferData(scene, "DirectionalLight", lightData);
+			uploadTransientBufferData(scene, "DirectionalLight", lightData);
 
 			// Render the fullscreen quad
 			RenderSettings::renderFullscreenPlaneOpenGL(scene, simulationSettings, renderSettings);
@@ -7,6 +7,7 @@
 #include "PCH.h"
 #include "Common.h"
 #include "ShadowMap.h"
+#include "ShadowCascades.h"
 
 namespace DirectionalLight
 {
@@ -20,6 +21,10 @@ namespace DirectionalLight
 	// Number of light sources to render per batch
 	static const size_t LIGHT_SOURCES_PER_BATCH = 32;
 
+	////////////////////////////////////////////////////////////////////////////////
+	// Maximum number of shadow map cascades
+	static const size_t MAX_SHADOW_CASCADES = 4;
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** A directional light component. */
 	struct DirectionalLightComponent
@@ -35,6 +40,20 @@ namespace DirectionalLight
 
 		// Specular intensity.
 		float m_specularItensity = 1.0f;
+
+		// Number of shadow map cascades; a single cascade fits the whole scene instead.
+		int m_numCascades = 1;
+
+		// Blend factor between the uniform (0) and logarithmic (1) cascade splits.
+		float m_cascadeSplitLambda = 0.75f;
+
+		// Maximum camera distance covered by the cascades (in meters).
+		float m_cascadeMaxDistance = 50.0f;
+
+		// ---- Private members
+
+		// Cascades fitted to the main camera
+		std::vector<ShadowCascades::Cascade<float>> m_cascades;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -54,7 +73,9 @@ namespace DirectionalLight
 		GLfloat m_shadowLightBleedBias;
 		GLfloat m_shadowMomentsBias;
 		alignas(sizeof(glm::vec2)) glm::vec2 m_shadowExponentialConstants;
-		alignas(sizeof(glm::vec4)) glm::mat4 m_lightSpaceTransform;
+		GLint m_numCascades;
+		alignas(sizeof(glm::vec4)) glm::mat4 m_lightSpaceTransforms[MAX_SHADOW_CASCADES];
+		glm::vec4 m_shadowMapOffsetScales[MAX_SHADOW_CASCADES];
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
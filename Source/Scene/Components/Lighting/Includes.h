@@ -1,7 +1,9 @@
 #pragma once
 
 #include "DirectionalLight.h"
+#include "LightClusters.h"
 #include "PointLight.h"
 #include "SpotLight.h"
 #include "ShadowMap.h"
+#include "ShadowCascades.h"
 #include "VoxelGlobalIllumination.h"
\ No newline at end of file
@@ -0,0 +1,403 @@
+#include "PCH.h"
+#include "LightClusters.h"
+
+#include <immintrin.h>
+#include <random>
+
+namespace LightClusters
+{
+	////////////////////////////////////////////////////////////////////////////////
+	ClusterGrid buildClusterGrid(glm::mat4 const& projection, float near, float far, glm::ivec3 numClusters)
+	{
+		ClusterGrid grid;
+		grid.m_numClusters = glm::max(numClusters, glm::ivec3(1));
+		grid.m_far = glm::max(far, 1e-3f);
+		grid.m_near = glm::clamp(near, grid.m_far * 1e-4f, grid.m_far);
+		grid.m_frustumScale = glm::vec2(1.0f / projection[0][0], 1.0f / projection[1][1]);
+
+		// Allocate the bounds, padded for the SIMD loads
+		const size_t numPadded = grid.numClusters() + SIMD_WIDTH;
+		for (auto bounds : { &grid.m_minX, &grid.m_minY, &grid.m_minZ, &grid.m_maxX, &grid.m_maxY, &grid.m_maxZ,
+			&grid.m_centerX, &grid.m_centerY, &grid.m_centerZ, &grid.m_radius })
+			bounds->assign(numPadded, 0.0f);
+
+		// Compute the cluster bounds
+		const float depthRatio = grid.m_far / grid.m_near;
+		for (int z = 0; z < grid.m_numClusters.z; ++z)
+		for (int y = 0; y < grid.m_numClusters.y; ++y)
+		for (int x = 0; x < grid.m_numClusters.x; ++x)
+		{
+			// Exponential depth slices, uniform tiles in NDC
+			const glm::vec2 depth = grid.m_near * glm::pow(glm::vec2(depthRatio), glm::vec2(z, z + 1) / float(grid.m_numClusters.z));
+			const glm::vec2 ndcMin = glm::vec2(-1.0f) + 2.0f * glm::vec2(x, y) / glm::vec2(grid.m_numClusters);
+			const glm::vec2 ndcMax = glm::vec2(-1.0f) + 2.0f * glm::vec2(x + 1, y + 1) / glm::vec2(grid.m_numClusters);
+
+			// The sides of the froxel are slanted, so take the extremes over both depth planes
+			const glm::vec3 minimum = glm::vec3(glm::min(ndcMin * depth[0], ndcMin * depth[1]) * grid.m_frustumScale, -depth[1]);
+			const glm::vec3 maximum = glm::vec3(glm::max(ndcMax * depth[0], ndcMax * depth[1]) * grid.m_frustumScale, -depth[0]);
+			const glm::vec3 center = 0.5f * (minimum + maximum);
+
+			const size_t clusterId = grid.clusterId(x, y, z);
+			grid.m_minX[clusterId] = minimum.x;
+			grid.m_minY[clusterId] = minimum.y;
+			grid.m_minZ[clusterId] = minimum.z;
+			grid.m_maxX[clusterId] = maximum.x;
+			grid.m_maxY[clusterId] = maximum.y;
+			grid.m_maxZ[clusterId] = maximum.z;
+			grid.m_centerX[clusterId] = center.x;
+			grid.m_centerY[clusterId] = center.y;
+			grid.m_centerZ[clusterId] = center.z;
+			grid.m_radius[clusterId] = glm::length(maximum - center);
+		}
+
+		return grid;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	ClusterGrid buildClusterGrid(Scene::Object* renderSettings, Scene::Object* camera, glm::ivec3 numClusters)
+	{
+		return buildClusterGrid(Camera::getProjectionMatrix(renderSettings, camera),
+			RenderSettings::metersToUnits(renderSettings, camera->component<Camera::CameraComponent>().m_near),
+			RenderSettings::metersToUnits(renderSettings, camera->component<Camera::CameraComponent>().m_far),
+			numClusters);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void clearLights(LightVolumes& lights)
+	{
+		for (auto attribute : { &lights.m_positionX, &lights.m_positionY, &lights.m_positionZ, &lights.m_radius,
+			&lights.m_directionX, &lights.m_directionY, &lights.m_directionZ, &lights.m_cosAngle, &lights.m_sinAngle })
+			attribute->clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void reserveLights(LightVolumes& lights, size_t numLights)
+	{
+		for (auto attribute : { &lights.m_positionX, &lights.m_positionY, &lights.m_positionZ, &lights.m_radius,
+			&lights.m_directionX, &lights.m_directionY, &lights.m_directionZ, &lights.m_cosAngle, &lights.m_sinAngle })
+			attribute->reserve(numLights);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void appendLight(LightVolumes& lights, glm::vec3 position, float radius, glm::vec3 direction, float cosAngle, float sinAngle)
+	{
+		lights.m_positionX.push_back(position.x);
+		lights.m_positionY.push_back(position.y);
+		lights.m_positionZ.push_back(position.z);
+		lights.m_radius.push_back(radius);
+		lights.m_directionX.push_back(direction.x);
+		lights.m_directionY.push_back(direction.y);
+		lights.m_directionZ.push_back(direction.z);
+		lights.m_cosAngle.push_back(cosAngle);
+		lights.m_sinAngle.push_back(sinAngle);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void appendPointLight(LightVolumes& lights, glm::mat4 const& view, glm::vec3 position, float radius)
+	{
+		appendLight(lights, glm::vec3(view * glm::vec4(position, 1.0f)), radius, glm::vec3(0.0f), -1.0f, 0.0f);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void appendSpotLight(LightVolumes& lights, glm::mat4 const& view, glm::vec3 position, glm::vec3 direction, float radius, float cosOuterAngle)
+	{
+		// The cone test only holds for half-angles below 90 degrees; treat wider cones as point lights
+		if (cosOuterAngle <= 0.0f)
+		{
+			appendPointLight(lights, view, position, radius);
+			return;
+		}
+
+		appendLight(lights, glm::vec3(view * glm::vec4(position, 1.0f)), radius,
+			glm::normalize(glm::mat3(view) * direction), cosOuterAngle, glm::sqrt(glm::max(1.0f - cosOuterAngle * cosOuterAngle, 0.0f)));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace Intersection
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		// Sphere-AABB distance along a single axis
+		inline float axisDistance(float minimum, float maximum, float position)
+		{
+			return glm::max(minimum - position, 0.0f) + glm::max(position - maximum, 0.0f);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Scalar light-cluster test. The SIMD version performs the exact same operations, in the same order.
+		bool testCluster(ClusterGrid const& grid, size_t clusterId, LightVolumes const& lights, size_t lightId)
+		{
+			// Light range versus the cluster AABB
+			const float dx = axisDistance(grid.m_minX[clusterId], grid.m_maxX[clusterId], lights.m_positionX[lightId]);
+			const float dy = axisDistance(grid.m_minY[clusterId], grid.m_maxY[clusterId], lights.m_positionY[lightId]);
+			const float dz = axisDistance(grid.m_minZ[clusterId], grid.m_maxZ[clusterId], lights.m_positionZ[lightId]);
+			const float radiusSq = lights.m_radius[lightId] * lights.m_radius[lightId];
+			if ((dx * dx + dy * dy) + dz * dz > radiusSq)
+				return false;
+
+			// Light cone versus the cluster bounding sphere
+			// SOURCE: https://bartwronski.com/2017/04/13/cull-that-cone/
+			const float vx = grid.m_centerX[clusterId] - lights.m_positionX[lightId];
+			const float vy = grid.m_centerY[clusterId] - lights.m_positionY[lightId];
+			const float vz = grid.m_centerZ[clusterId] - lights.m_positionZ[lightId];
+			const float lengthSq = (vx * vx + vy * vy) + vz * vz;
+			const float axial = (vx * lights.m_directionX[lightId] + vy * lights.m_directionY[lightId]) + vz * lights.m_directionZ[lightId];
+			const float closest = lights.m_cosAngle[lightId] * std::sqrt(glm::max(lengthSq - axial * axial, 0.0f)) - axial * lights.m_sinAngle[lightId];
+			const float radius = grid.m_radius[clusterId];
+			return !(closest > radius || axial > radius + lights.m_radius[lightId] || axial < 0.0f - radius);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Tests a light against SIMD_WIDTH consecutive clusters, starting at the parameter cluster
+		int testClustersSimd(ClusterGrid const& grid, size_t clusterId, LightVolumes const& lights, size_t lightId, bool isCone)
+		{
+			const __m256 zero = _mm256_setzero_ps();
+
+			// Light range versus the cluster AABBs
+			const __m256 px = _mm256_set1_ps(lights.m_positionX[lightId]);
+			const __m256 py = _mm256_set1_ps(lights.m_positionY[lightId]);
+			const __m256 pz = _mm256_set1_ps(lights.m_positionZ[lightId]);
+			const __m256 dx = _mm256_add_ps(
+				_mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(grid.m_minX.data() + clusterId), px), zero),
+				_mm256_max_ps(_mm256_sub_ps(px, _mm256_loadu_ps(grid.m_maxX.data() + clusterId)), zero));
+			const __m256 dy = _mm256_add_ps(
+				_mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(grid.m_minY.data() + clusterId), py), zero),
+				_mm256_max_ps(_mm256_sub_ps(py, _mm256_loadu_ps(grid.m_maxY.data() + clusterId)), zero));
+			const __m256 dz = _mm256_add_ps(
+				_mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(grid.m_minZ.data() + clusterId), pz), zero),
+				_mm256_max_ps(_mm256_sub_ps(pz, _mm256_loadu_ps(grid.m_maxZ.data() + clusterId)), zero));
+			const __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			const __m256 radiusSq = _mm256_set1_ps(lights.m_radius[lightId] * lights.m_radius[lightId]);
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(distanceSq, radiusSq, _CMP_LE_OQ));
+
+			// Point lights are done at this point
+			if (!isCone || mask == 0)
+				return mask;
+
+			// Light cone versus the cluster bounding spheres
+			const __m256 vx = _mm256_sub_ps(_mm256_loadu_ps(grid.m_centerX.data() + clusterId), px);
+			const __m256 vy = _mm256_sub_ps(_mm256_loadu_ps(grid.m_centerY.data() + clusterId), py);
+			const __m256 vz = _mm256_sub_ps(_mm256_loadu_ps(grid.m_centerZ.data() + clusterId), pz);
+			const __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+			const __m256 axial = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(vx, _mm256_set1_ps(lights.m_directionX[lightId])),
+				_mm256_mul_ps(vy, _mm256_set1_ps(lights.m_directionY[lightId]))),
+				_mm256_mul_ps(vz, _mm256_set1_ps(lights.m_directionZ[lightId])));
+			const __m256 closest = _mm256_sub_ps(
+				_mm256_mul_ps(_mm256_set1_ps(lights.m_cosAngle[lightId]), _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(lengthSq, _mm256_mul_ps(axial, axial)), zero))),
+				_mm256_mul_ps(axial, _mm256_set1_ps(lights.m_sinAngle[lightId])));
+			const __m256 radius = _mm256_loadu_ps(grid.m_radius.data() + clusterId);
+			const __m256 culled = _mm256_or_ps(_mm256_or_ps(
+				_mm256_cmp_ps(closest, radius, _CMP_GT_OQ),
+				_mm256_cmp_ps(axial, _mm256_add_ps(radius, _mm256_set1_ps(lights.m_radius[lightId])), _CMP_GT_OQ)),
+				_mm256_cmp_ps(axial, _mm256_sub_ps(zero, radius), _CMP_LT_OQ));
+			return mask & ~_mm256_movemask_ps(culled);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Conservative range of tiles along one axis, using the bounds of a single row or column of the slice.
+		// Any cluster that passes the full test also passes this, since the squared distances are non-negative.
+		bool tileRange(float const* minimum, float const* maximum, size_t stride, int numTiles, float position, float radiusSq, int& first, int& last)
+		{
+			first = numTiles;
+			last = -1;
+			for (int tile = 0; tile < numTiles; ++tile)
+			{
+				const float distance = axisDistance(minimum[tile * stride], maximum[tile * stride], position);
+				if (distance * distance <= radiusSq)
+				{
+					first = glm::min(first, tile);
+					last = tile;
+				}
+			}
+			return first <= last;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void assignLights(ClusterGrid const& grid, LightVolumes const& lights, ClusterLightLists& result, size_t numThreads)
+	{
+		const size_t numClusters = grid.numClusters();
+		const size_t numClustersPerSlice = grid.numClustersPerSlice();
+		const size_t numSlices = grid.m_numClusters.z;
+		const size_t numLights = lights.size();
+
+		result.m_clusters.assign(numClusters, glm::uvec2(0));
+
+		// Per-slice light lists, merged into the flat buffer after the threaded part
+		std::vector<std::vector<GLuint>> sliceIndices(numSlices);
+
+		// Per-thread (cluster, light) pairs
+		std::array<std::vector<glm::uvec2>, Constants::s_maxThreads> hitScratch;
+
+		Threading::threadedExecuteIndices(numThreads,
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t sliceId)
+			{
+				std::vector<glm::uvec2>& hits = hitScratch[Threading::currentThreadId()];
+				hits.clear();
+
+				// Collect the hits in light order
+				const size_t sliceBase = sliceId * numClustersPerSlice;
+				for (size_t lightId = 0; lightId < numLights; ++lightId)
+				{
+					const float radiusSq = lights.m_radius[lightId] * lights.m_radius[lightId];
+
+					// Reject the lights outside the slice and find the overlapped tiles
+					const float dz = Intersection::axisDistance(grid.m_minZ[sliceBase], grid.m_maxZ[sliceBase], lights.m_positionZ[lightId]);
+					if (dz * dz > radiusSq) continue;
+
+					glm::ivec2 first, last;
+					if (!Intersection::tileRange(grid.m_minX.data() + sliceBase, grid.m_maxX.data() + sliceBase, 1, grid.m_numClusters.x,
+						lights.m_positionX[lightId], radiusSq, first.x, last.x)) continue;
+					if (!Intersection::tileRange(grid.m_minY.data() + sliceBase, grid.m_maxY.data() + sliceBase, grid.m_numClusters.x, grid.m_numClusters.y,
+						lights.m_positionY[lightId], radiusSq, first.y, last.y)) continue;
+
+					// Test the overlapped tiles, one row at a time
+					const bool isCone = lights.m_cosAngle[lightId] > -1.0f;
+					for (int y = first.y; y <= last.y; ++y)
+					for (int x = first.x; x <= last.x; x += SIMD_WIDTH)
+					{
+						const size_t clusterId = grid.clusterId(x, y, int(sliceId));
+						const int numLanes = glm::min(int(SIMD_WIDTH), last.x - x + 1);
+						int mask = Intersection::testClustersSimd(grid, clusterId, lights, lightId, isCone) & ((1 << numLanes) - 1);
+						for (; mask != 0; mask &= mask - 1)
+						{
+							const GLuint lane = GLuint(glm::findLSB(mask));
+							hits.emplace_back(GLuint(clusterId - sliceBase) + lane, GLuint(lightId));
+						}
+					}
+				}
+
+				// Count the lights per cluster, and turn the counts into offsets within the slice
+				glm::uvec2* clusters = result.m_clusters.data() + sliceBase;
+				for (auto const& hit : hits)
+					++clusters[hit.x].y;
+				GLuint offset = 0;
+				for (size_t clusterId = 0; clusterId < numClustersPerSlice; ++clusterId)
+				{
+					clusters[clusterId].x = offset;
+					offset += clusters[clusterId].y;
+				}
+
+				// Scatter the light indices; the hits are in light order, so the per-cluster lists come out sorted
+				std::vector<GLuint>& indices = sliceIndices[sliceId];
+				indices.resize(hits.size());
+				std::vector<GLuint> cursors(numClustersPerSlice);
+				for (size_t clusterId = 0; clusterId < numClustersPerSlice; ++clusterId)
+					cursors[clusterId] = clusters[clusterId].x;
+				for (auto const& hit : hits)
+					indices[cursors[hit.x]++] = hit.y;
+			},
+			numSlices);
+
+		// Merge the slices into the flat index buffer
+		size_t numIndices = 0;
+		for (auto const& indices : sliceIndices)
+			numIndices += indices.size();
+		result.m_lightIndices.resize(numIndices);
+
+		size_t sliceOffset = 0;
+		for (size_t sliceId = 0; sliceId < numSlices; ++sliceId)
+		{
+			for (size_t clusterId = sliceId * numClustersPerSlice; clusterId < (sliceId + 1) * numClustersPerSlice; ++clusterId)
+				result.m_clusters[clusterId].x += GLuint(sliceOffset);
+			std::copy(sliceIndices[sliceId].begin(), sliceIndices[sliceId].end(), result.m_lightIndices.begin() + sliceOffset);
+			sliceOffset += sliceIndices[sliceId].size();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void assignLightsBruteForce(ClusterGrid const& grid, LightVolumes const& lights, ClusterLightLists& result)
+	{
+		result.m_clusters.assign(grid.numClusters(), glm::uvec2(0));
+		result.m_lightIndices.clear();
+
+		for (size_t clusterId = 0; clusterId < grid.numClusters(); ++clusterId)
+		{
+			result.m_clusters[clusterId].x = GLuint(result.m_lightIndices.size());
+			for (size_t lightId = 0; lightId < lights.size(); ++lightId)
+				if (Intersection::testCluster(grid, clusterId, lights, lightId))
+					result.m_lightIndices.push_back(GLuint(lightId));
+			result.m_clusters[clusterId].y = GLuint(result.m_lightIndices.size()) - result.m_clusters[clusterId].x;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	size_t countMismatches(ClusterLightLists const& lhs, ClusterLightLists const& rhs)
+	{
+		if (lhs.m_clusters.size() != rhs.m_clusters.size())
+			return glm::max(lhs.m_clusters.size(), rhs.m_clusters.size());
+
+		size_t numMismatches = 0;
+		for (size_t clusterId = 0; clusterId < lhs.m_clusters.size(); ++clusterId)
+		{
+			const glm::uvec2 left = lhs.m_clusters[clusterId], right = rhs.m_clusters[clusterId];
+			if (left.y != right.y || !std::equal(lhs.m_lightIndices.begin() + left.x, lhs.m_lightIndices.begin() + left.x + left.y, rhs.m_lightIndices.begin() + right.x))
+				++numMismatches;
+		}
+		return numMismatches;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::vector<bool> visibleLights(ClusterLightLists const& lists, size_t numLights)
+	{
+		std::vector<bool> result(numLights, false);
+		for (GLuint lightId : lists.m_lightIndices)
+			result[lightId] = true;
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmark(ClusterGrid const& grid, std::vector<size_t> const& lightCounts, bool bruteForce)
+	{
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		const glm::mat4 view = glm::mat4(1.0f);
+
+		Debug::log_info() << "Light cluster benchmark: " << grid.m_numClusters << " clusters, " << Threading::numThreads() << " threads" << Debug::end;
+
+		for (size_t numLights : lightCounts)
+		{
+			// Random lights inside the view frustum, half of them spot lights
+			LightVolumes lights;
+			reserveLights(lights, numLights);
+			for (size_t lightId = 0; lightId < numLights; ++lightId)
+			{
+				const float depth = glm::mix(grid.m_near, grid.m_far, unit(generator));
+				const glm::vec2 ndc = glm::vec2(unit(generator), unit(generator)) * 2.0f - 1.0f;
+				const glm::vec3 position = glm::vec3(ndc * grid.m_frustumScale * depth, -depth);
+				const float radius = glm::mix(0.005f, 0.02f, unit(generator)) * grid.m_far;
+				if (lightId % 2 == 0)
+				{
+					appendPointLight(lights, view, position, radius);
+				}
+				else
+				{
+					const glm::vec3 direction = glm::vec3(unit(generator), unit(generator), unit(generator)) * 2.0f - 1.0f;
+					appendSpotLight(lights, view, position, glm::length2(direction) > 1e-6f ? direction : glm::vec3(0.0f, 0.0f, -1.0f),
+						radius, glm::cos(glm::mix(glm::radians(10.0f), glm::radians(60.0f), unit(generator))));
+				}
+			}
+
+			// Clustered assignment
+			ClusterLightLists clustered;
+			DateTime::Timer clusteredTimer(true);
+			assignLights(grid, lights, clustered);
+			clusteredTimer.stop();
+
+			Debug::log_info() << "  - " << numLights << " lights: clustered assignment: " << clusteredTimer.getElapsedTime(DateTime::Milliseconds, false)
+				<< ", " << clustered.m_lightIndices.size() << " indices (" << float(clustered.m_lightIndices.size()) / float(grid.numClusters()) << " per cluster)" << Debug::end;
+
+			if (!bruteForce) continue;
+
+			// Reference assignment
+			ClusterLightLists reference;
+			DateTime::Timer referenceTimer(true);
+			assignLightsBruteForce(grid, lights, reference);
+			referenceTimer.stop();
+
+			Debug::log_info() << "  - " << numLights << " lights: brute-force assignment: " << referenceTimer.getElapsedTime(DateTime::Milliseconds, false)
+				<< ", speedup: " << referenceTimer.getElapsedTime() / glm::max(clusteredTimer.getElapsedTime(), 1e-9)
+				<< ", mismatching clusters: " << countMismatches(clustered, reference) << Debug::end;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+//  Headers
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PCH.h"
+#include "Common.h"
+
+namespace LightClusters
+{
+	////////////////////////////////////////////////////////////////////////////////
+	// Number of clusters processed together by the SIMD intersection tests
+	static const size_t SIMD_WIDTH = 8;
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** View-space froxel grid. Clusters are laid out as x + y * numX + z * numX * numY,
+		and their bounds are stored as SoA arrays, padded so that SIMD loads never run past the end. */
+	struct ClusterGrid
+	{
+		// Number of clusters along the individual axes
+		glm::ivec3 m_numClusters{ 0 };
+
+		// Near and far plane distances (in world units)
+		float m_near = 0.0f;
+		float m_far = 0.0f;
+
+		// Half-extents of the view frustum at unit depth
+		glm::vec2 m_frustumScale{ 0.0f };
+
+		// View-space AABBs of the clusters
+		std::vector<float> m_minX, m_minY, m_minZ;
+		std::vector<float> m_maxX, m_maxY, m_maxZ;
+
+		// View-space bounding spheres of the clusters
+		std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+
+		// Total number of clusters
+		inline size_t numClusters() const { return size_t(m_numClusters.x) * size_t(m_numClusters.y) * size_t(m_numClusters.z); }
+
+		// Number of clusters in a single Z-slice
+		inline size_t numClustersPerSlice() const { return size_t(m_numClusters.x) * size_t(m_numClusters.y); }
+
+		// Linear index of a cluster
+		inline size_t clusterId(int x, int y, int z) const { return size_t(x) + size_t(y) * m_numClusters.x + size_t(z) * numClustersPerSlice(); }
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** View-space light volumes in SoA form. Point lights are stored as cones with a zero
+		direction, which makes the cone test a no-op for them. */
+	struct LightVolumes
+	{
+		// Position and range of the lights
+		std::vector<float> m_positionX, m_positionY, m_positionZ, m_radius;
+
+		// Direction, and the cosine and sine of the outer cone half-angle
+		std::vector<float> m_directionX, m_directionY, m_directionZ, m_cosAngle, m_sinAngle;
+
+		// Number of lights stored
+		inline size_t size() const { return m_radius.size(); }
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Flat per-cluster light index lists, laid out for direct upload into a shader storage buffer. */
+	struct ClusterLightLists
+	{
+		// Offset and count into the light index buffer, for each cluster
+		std::vector<glm::uvec2> m_clusters;
+
+		// Light indices, sorted in ascending order for each cluster
+		std::vector<GLuint> m_lightIndices;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Builds the froxel grid for the parameter projection matrix, using exponential Z-slices between near and far. */
+	ClusterGrid buildClusterGrid(glm::mat4 const& projection, float near, float far, glm::ivec3 numClusters);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Builds the froxel grid for the parameter camera. */
+	ClusterGrid buildClusterGrid(Scene::Object* renderSettings, Scene::Object* camera, glm::ivec3 numClusters);
+
+	////////////////////////////////////////////////////////////////////////////////
+	void clearLights(LightVolumes& lights);
+
+	////////////////////////////////////////////////////////////////////////////////
+	void reserveLights(LightVolumes& lights, size_t numLights);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a point light to the light list. The view matrix transforms the position into view-space. */
+	void appendPointLight(LightVolumes& lights, glm::mat4 const& view, glm::vec3 position, float radius);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a spot light to the light list. The angle is the cosine of the outer cone half-angle. */
+	void appendSpotLight(LightVolumes& lights, glm::mat4 const& view, glm::vec3 position, glm::vec3 direction, float radius, float cosOuterAngle);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Assigns the lights to the clusters with SIMD intersection tests, parallelized over the Z-slices. */
+	void assignLights(ClusterGrid const& grid, LightVolumes const& lights, ClusterLightLists& result, size_t numThreads = Threading::numThreads());
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Reference assignment, which tests every light against every cluster. */
+	void assignLightsBruteForce(ClusterGrid const& grid, LightVolumes const& lights, ClusterLightLists& result);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Number of clusters whose light lists differ between the two assignments. */
+	size_t countMismatches(ClusterLightLists const& lhs, ClusterLightLists const& rhs);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Marks the lights that are referenced by at least one cluster. */
+	std::vector<bool> visibleLights(ClusterLightLists const& lists, size_t numLights);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Generates random lights in the grid's view frustum, and times the SIMD and brute-force assignments against each other. */
+	void benchmark(ClusterGrid const& grid, std::vector<size_t> const& lightCounts = { 1000, 10000, 100000 }, bool bruteForce = true);
+}
@@ -0,0 +1,333 @@
+#include "PCH.h"
+#include "ShadowCascades.h"
+
+#include <random>
+
+namespace ShadowCascades
+{
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	std::vector<T> computeSplitDistances(T near, T far, int numCascades, T lambda)
+	{
+		numCascades = glm::max(numCascades, 1);
+		far = glm::max(far, near + T(1e-3));
+
+		std::vector<T> result(numCascades + 1);
+		for (int i = 0; i <= numCascades; ++i)
+		{
+			const T t = T(i) / T(numCascades);
+			const T logSplit = near * glm::pow(far / near, t);
+			const T uniformSplit = near + (far - near) * t;
+			result[i] = glm::mix(uniformSplit, logSplit, glm::clamp(lambda, T(0), T(1)));
+		}
+
+		// Make sure the end points are exact
+		result.front() = near;
+		result.back() = far;
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	std::array<glm::tvec2<T>, 4> frustumCornerOffsets(glm::tmat4x4<T> const& projection)
+	{
+		const glm::tmat4x4<T> inverseProjection = glm::inverse(projection);
+		const std::array<glm::tvec2<T>, 4> ndcCorners = { glm::tvec2<T>(-1, -1), glm::tvec2<T>(1, -1), glm::tvec2<T>(-1, 1), glm::tvec2<T>(1, 1) };
+
+		std::array<glm::tvec2<T>, 4> result;
+		for (size_t i = 0; i < ndcCorners.size(); ++i)
+		{
+			const glm::tvec4<T> corner = inverseProjection * glm::tvec4<T>(ndcCorners[i], T(-1), T(1));
+			result[i] = glm::tvec2<T>(corner) / -corner.z;
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	std::array<glm::tvec3<T>, 8> computeFrustumSliceCorners(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, T near, T far)
+	{
+		const glm::tmat4x4<T> inverseView = glm::inverse(view);
+		const std::array<glm::tvec2<T>, 4> offsets = frustumCornerOffsets(projection);
+
+		std::array<glm::tvec3<T>, 8> result;
+		for (size_t i = 0; i < offsets.size(); ++i)
+		{
+			result[i] = glm::tvec3<T>(inverseView * glm::tvec4<T>(offsets[i] * near, -near, T(1)));
+			result[i + 4] = glm::tvec3<T>(inverseView * glm::tvec4<T>(offsets[i] * far, -far, T(1)));
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	glm::tvec2<T> computeSliceBoundingSphere(glm::tmat4x4<T> const& projection, T near, T far)
+	{
+		// Largest distance of a corner from the view axis, at unit depth
+		T spread = T(0);
+		for (auto const& offset : frustumCornerOffsets(projection))
+			spread = glm::max(spread, glm::length(offset));
+		const T spread2 = spread * spread;
+
+		// Place the center on the view axis, where it is equidistant from the near and far corners
+		const T center = glm::min(T(0.5) * (near + far) * (T(1) + spread2), far);
+		const T radius = glm::max(
+			glm::sqrt((center - near) * (center - near) + near * near * spread2),
+			glm::sqrt((far - center) * (far - center) + far * far * spread2));
+		return glm::tvec2<T>(center, radius);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	glm::tmat4x4<T> computeLightRotation(glm::tvec3<T> direction)
+	{
+		direction = glm::normalize(direction);
+		const glm::tvec3<T> up = glm::abs(direction.y) > T(0.999) ? glm::tvec3<T>(0, 0, 1) : glm::tvec3<T>(0, 1, 0);
+		return glm::lookAt(glm::tvec3<T>(0), direction, up);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	Cascade<T> fitCascade(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, glm::tvec3<T> lightDirection,
+		T splitNear, T splitFar, int resolution, BVH::AABB const& casterAabb)
+	{
+		Cascade<T> result;
+		result.m_splitNear = splitNear;
+		result.m_splitFar = splitFar;
+
+		// Bounding sphere of the frustum slice; its size is independent of the camera orientation
+		const glm::tvec2<T> sphere = computeSliceBoundingSphere(projection, splitNear, splitFar);
+		result.m_center = glm::tvec3<T>(glm::inverse(view) * glm::tvec4<T>(T(0), T(0), -sphere.x, T(1)));
+		result.m_radius = sphere.y;
+
+		// Grow the bounds by one texel, to leave room for the snapping
+		resolution = glm::max(resolution, 4);
+		result.m_texelSize = T(2) * result.m_radius / T(resolution - 2);
+		const T extent = result.m_texelSize * T(resolution);
+
+		// Snap the light-space bounds to the texel grid, so that it stays fixed in the world as the camera moves
+		const glm::tmat4x4<T> lightView = computeLightRotation(lightDirection);
+		const glm::tvec3<T> center = glm::tvec3<T>(lightView * glm::tvec4<T>(result.m_center, T(1)));
+		const glm::tvec2<T> boundsMin = glm::floor((glm::tvec2<T>(center) - (result.m_radius + result.m_texelSize)) / result.m_texelSize) * result.m_texelSize;
+		const glm::tvec2<T> boundsMax = boundsMin + extent;
+
+		// Closest caster to the light, in light space
+		T casterMaxZ = -std::numeric_limits<T>::max();
+		for (int cornerId = 0; cornerId < 8; ++cornerId)
+		{
+			const glm::tvec3<T> corner(
+				(cornerId & 1) ? casterAabb.m_max.x : casterAabb.m_min.x,
+				(cornerId & 2) ? casterAabb.m_max.y : casterAabb.m_min.y,
+				(cornerId & 4) ? casterAabb.m_max.z : casterAabb.m_min.z);
+			casterMaxZ = glm::max(casterMaxZ, (lightView * glm::tvec4<T>(corner, T(1))).z);
+		}
+
+		// Depth range of the receivers, extended towards the light to include every caster
+		result.m_near = glm::min(-(center.z + result.m_radius + result.m_texelSize), -casterMaxZ);
+		result.m_far = -(center.z - result.m_radius - result.m_texelSize);
+		result.m_view = lightView;
+		result.m_projection = glm::ortho(boundsMin.x, boundsMax.x, boundsMin.y, boundsMax.y, result.m_near, result.m_far);
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	std::vector<Cascade<T>> computeCascades(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, glm::tvec3<T> lightDirection,
+		T near, T far, int numCascades, T lambda, int resolution, BVH::AABB const& casterAabb)
+	{
+		const std::vector<T> splits = computeSplitDistances(near, far, numCascades, lambda);
+
+		std::vector<Cascade<T>> result(splits.size() - 1);
+		for (size_t i = 0; i < result.size(); ++i)
+			result[i] = fitCascade(view, projection, lightDirection, splits[i], splits[i + 1], resolution, casterAabb);
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	size_t countUncoveredCorners(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, std::vector<Cascade<T>> const& cascades)
+	{
+		size_t result = 0;
+		for (auto const& cascade : cascades)
+		for (auto const& corner : computeFrustumSliceCorners(view, projection, cascade.m_splitNear, cascade.m_splitFar))
+		{
+			// The projection is orthographic, so the clip-space position is already normalized
+			const glm::tvec3<T> ndc = glm::tvec3<T>(cascade.m_projection * cascade.m_view * glm::tvec4<T>(corner, T(1)));
+			if (glm::any(glm::greaterThan(glm::abs(ndc), glm::tvec3<T>(1))))
+				++result;
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	T computeTexelDrift(std::vector<Cascade<T>> const& lhs, std::vector<Cascade<T>> const& rhs, glm::tvec3<T> point)
+	{
+		// Texel coordinates of the point in the parameter cascade
+		auto texelCoords = [&](Cascade<T> const& cascade)
+		{
+			const glm::tvec2<T> ndc = glm::tvec2<T>(cascade.m_projection * cascade.m_view * glm::tvec4<T>(point, T(1)));
+			const T numTexels = T(2) / (cascade.m_projection[0][0] * cascade.m_texelSize);
+			return (ndc * T(0.5) + T(0.5)) * numTexels;
+		};
+
+		T result = T(0);
+		for (size_t i = 0; i < glm::min(lhs.size(), rhs.size()); ++i)
+		{
+			// Whole-texel shifts are fine, only the fractional part matters
+			const glm::tvec2<T> delta = texelCoords(lhs[i]) - texelCoords(rhs[i]);
+			const glm::tvec2<T> drift = glm::abs(delta - glm::round(delta));
+			result = glm::max(result, glm::max(drift.x, drift.y));
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	#define INSTANTIATE_CASCADE_FUNCTIONS(T) \
+		template std::vector<T> computeSplitDistances<T>(T, T, int, T); \
+		template std::array<glm::tvec2<T>, 4> frustumCornerOffsets<T>(glm::tmat4x4<T> const&); \
+		template std::array<glm::tvec3<T>, 8> computeFrustumSliceCorners<T>(glm::tmat4x4<T> const&, glm::tmat4x4<T> const&, T, T); \
+		template glm::tvec2<T> computeSliceBoundingSphere<T>(glm::tmat4x4<T> const&, T, T); \
+		template glm::tmat4x4<T> computeLightRotation<T>(glm::tvec3<T>); \
+		template Cascade<T> fitCascade<T>(glm::tmat4x4<T> const&, glm::tmat4x4<T> const&, glm::tvec3<T>, T, T, int, BVH::AABB const&); \
+		template std::vector<Cascade<T>> computeCascades<T>(glm::tmat4x4<T> const&, glm::tmat4x4<T> const&, glm::tvec3<T>, T, T, int, T, int, BVH::AABB const&); \
+		template size_t countUncoveredCorners<T>(glm::tmat4x4<T> const&, glm::tmat4x4<T> const&, std::vector<Cascade<T>> const&); \
+		template T computeTexelDrift<T>(std::vector<Cascade<T>> const&, std::vector<Cascade<T>> const&, glm::tvec3<T>)
+
+	INSTANTIATE_CASCADE_FUNCTIONS(float);
+	INSTANTIATE_CASCADE_FUNCTIONS(double);
+
+	#undef INSTANTIATE_CASCADE_FUNCTIONS
+
+	////////////////////////////////////////////////////////////////////////////////
+	ShadowMap::ShadowMapTransform cascadeTransform(Cascade<float> const& cascade)
+	{
+		ShadowMap::ShadowMapTransform result;
+		result.m_near = cascade.m_near;
+		result.m_far = cascade.m_far;
+		result.m_isPerspective = false;
+		result.m_view = cascade.m_view;
+		result.m_projection = cascade.m_projection;
+		result.m_transform = result.m_projection * result.m_view;
+		result.m_frustum = BVH::Frustum(result.m_transform);
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Widens the parameter cascades to double precision
+	std::vector<Cascade<double>> toDouble(std::vector<Cascade<float>> const& cascades)
+	{
+		std::vector<Cascade<double>> result(cascades.size());
+		for (size_t i = 0; i < cascades.size(); ++i)
+		{
+			result[i].m_splitNear = cascades[i].m_splitNear;
+			result[i].m_splitFar = cascades[i].m_splitFar;
+			result[i].m_center = glm::dvec3(cascades[i].m_center);
+			result[i].m_radius = cascades[i].m_radius;
+			result[i].m_texelSize = cascades[i].m_texelSize;
+			result[i].m_near = cascades[i].m_near;
+			result[i].m_far = cascades[i].m_far;
+			result[i].m_view = glm::dmat4(cascades[i].m_view);
+			result[i].m_projection = glm::dmat4(cascades[i].m_projection);
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Validation results of a single instantiation of the fitting
+	template<typename T>
+	struct ValidationStats
+	{
+		size_t m_numUncoveredCorners = 0;
+		size_t m_numUnstableRadii = 0;
+		size_t m_numShimmering = 0;
+		T m_maxDrift = T(0);
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validate(glm::mat4 const& projection, float near, float far, int numCascades, float lambda, int resolution, size_t numSamples)
+	{
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		auto randomVector = [&](float scale) { return (glm::vec3(unit(generator), unit(generator), unit(generator)) * 2.0f - 1.0f) * scale; };
+		auto cameraView = [](auto position, auto angles)
+		{
+			using Vec3 = decltype(position);
+			return glm::inverse(glm::translate(position) * glm::rotate(angles.x, Vec3(0, 1, 0)) *
+				glm::rotate(angles.y, Vec3(1, 0, 0)) * glm::rotate(angles.z, Vec3(0, 0, 1)));
+		};
+
+		// Validate the split scheme
+		const std::vector<float> splits = computeSplitDistances(near, far, numCascades, lambda);
+		bool splitsValid = splits.front() == near && splits.back() == far;
+		for (size_t i = 1; i < splits.size(); ++i)
+			splitsValid &= splits[i] > splits[i - 1];
+
+		// Random camera paths, with a small translation and rotation between consecutive frames
+		const float sceneSize = 4.0f * far;
+		const BVH::AABB casterAabb(glm::vec3(-sceneSize), glm::vec3(sceneSize));
+
+		// Fits the cascades for both frames of a path with the scalar type of the parameters, and checks them
+		auto validateFrames = [&](auto& stats, auto lightDirection, auto position, auto angles, auto nextPosition, auto nextAngles, auto point, auto maxDrift)
+		{
+			using T = decltype(maxDrift);
+			const glm::tmat4x4<T> projectionT(projection);
+			const glm::tmat4x4<T> view = cameraView(position, angles);
+			const glm::tmat4x4<T> nextView = cameraView(nextPosition, nextAngles);
+			const std::vector<Cascade<T>> cascades = computeCascades(view, projectionT, lightDirection, T(near), T(far), numCascades, T(lambda), resolution, casterAabb);
+			const std::vector<Cascade<T>> nextCascades = computeCascades(nextView, projectionT, lightDirection, T(near), T(far), numCascades, T(lambda), resolution, casterAabb);
+
+			// Every cascade must fully contain its frustum slice
+			stats.m_numUncoveredCorners += countUncoveredCorners(view, projectionT, cascades) + countUncoveredCorners(nextView, projectionT, nextCascades);
+
+			// The cascade sizes must not depend on the camera orientation
+			for (size_t i = 0; i < cascades.size(); ++i)
+				if (cascades[i].m_radius != nextCascades[i].m_radius || cascades[i].m_texelSize != nextCascades[i].m_texelSize)
+					++stats.m_numUnstableRadii;
+
+			// World-space points must stay on the same position within their texels
+			const T drift = computeTexelDrift(cascades, nextCascades, point);
+			stats.m_maxDrift = glm::max(stats.m_maxDrift, drift);
+			if (drift > maxDrift) ++stats.m_numShimmering;
+			return cascades;
+		};
+
+		ValidationStats<float> statsFloat;
+		ValidationStats<double> statsDouble;
+		size_t numMismatches = 0;
+		double maxMismatch = 0.0;
+		for (size_t sampleId = 0; sampleId < numSamples; ++sampleId)
+		{
+			const glm::vec3 lightDirection = glm::normalize(randomVector(1.0f) + glm::vec3(0.0f, -1.5f, 0.0f));
+			const glm::vec3 position = randomVector(far);
+			const glm::vec3 angles = randomVector(glm::pi<float>());
+			const glm::vec3 nextPosition = position + randomVector(0.01f * far);
+			const glm::vec3 nextAngles = angles + glm::vec3(0.05f, -0.03f, 0.0f);
+			const glm::vec3 point = position + randomVector(0.5f * far);
+
+			// Single-precision rounding may leave a small drift, but without it the drift must vanish
+			const std::vector<Cascade<float>> cascadesFloat = validateFrames(statsFloat, lightDirection, position, angles, nextPosition, nextAngles, point, 1e-2f);
+			const std::vector<Cascade<double>> cascadesDouble = validateFrames(statsDouble, glm::dvec3(lightDirection), glm::dvec3(position), glm::dvec3(angles),
+				glm::dvec3(nextPosition), glm::dvec3(nextAngles), glm::dvec3(point), 1e-6);
+
+			// The two instantiations must put the texel grid at the same place
+			const double mismatch = computeTexelDrift(toDouble(cascadesFloat), cascadesDouble, glm::dvec3(point));
+			maxMismatch = glm::max(maxMismatch, mismatch);
+			if (mismatch > 1e-2) ++numMismatches;
+		}
+
+		const bool passed = splitsValid &&
+			statsFloat.m_numUncoveredCorners == 0 && statsFloat.m_numUnstableRadii == 0 && statsFloat.m_numShimmering == 0 &&
+			statsDouble.m_numUncoveredCorners == 0 && statsDouble.m_numUnstableRadii == 0 && statsDouble.m_numShimmering == 0 &&
+			numMismatches == 0;
+		Debug::log_info() << "Shadow cascade validation (" << numCascades << " cascades, lambda " << lambda << ", " << resolution << " texels, " << numSamples << " camera samples): "
+			<< (passed ? "passed" : "FAILED") << Debug::end;
+		Debug::log_info() << "  - split distances: " << splits << (splitsValid ? "" : " (invalid)") << Debug::end;
+		Debug::log_info() << "  - uncovered frustum corners: " << statsFloat.m_numUncoveredCorners << " (float), " << statsDouble.m_numUncoveredCorners << " (double)" << Debug::end;
+		Debug::log_info() << "  - cascades with rotation-dependent size: " << statsFloat.m_numUnstableRadii << " (float), " << statsDouble.m_numUnstableRadii << " (double)" << Debug::end;
+		Debug::log_info() << "  - samples with texel drift: " << statsFloat.m_numShimmering << " (float, max drift: " << statsFloat.m_maxDrift << " texels), "
+			<< statsDouble.m_numShimmering << " (double, max drift: " << statsDouble.m_maxDrift << " texels)" << Debug::end;
+		Debug::log_info() << "  - samples where the float and double texel grids differ: " << numMismatches << " (max difference: " << maxMismatch << " texels)" << Debug::end;
+		return passed;
+	}
+}
\ No newline at end of file
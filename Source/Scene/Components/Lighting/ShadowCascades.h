@@ -0,0 +1,96 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+//  Headers
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PCH.h"
+#include "Common.h"
+#include "ShadowMap.h"
+
+namespace ShadowCascades
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/** A single cascade of a cascaded shadow map. The fitting is templated on the scalar type, so that the
+		validation can compare the single-precision cascades against the same scheme evaluated in double precision. */
+	template<typename T>
+	struct Cascade
+	{
+		// View-space distance range of the camera frustum covered by the cascade
+		T m_splitNear = T(0);
+		T m_splitFar = T(0);
+
+		// World-space bounding sphere of the covered frustum slice, before snapping
+		glm::tvec3<T> m_center{ T(0) };
+		T m_radius = T(0);
+
+		// World-space size of a single shadow map texel
+		T m_texelSize = T(0);
+
+		// Light-space depth range, rotation and snapped orthographic projection of the cascade
+		T m_near = T(0);
+		T m_far = T(0);
+		glm::tmat4x4<T> m_view{ T(1) };
+		glm::tmat4x4<T> m_projection{ T(1) };
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Practical split scheme, which blends the logarithmic (lambda = 1) and uniform (lambda = 0) splits.
+		Returns numCascades + 1 view-space distances, starting with near and ending with far. */
+	template<typename T>
+	std::vector<T> computeSplitDistances(T near, T far, int numCascades, T lambda);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** View-space offsets of the frustum corners at unit distance from the camera. */
+	template<typename T>
+	std::array<glm::tvec2<T>, 4> frustumCornerOffsets(glm::tmat4x4<T> const& projection);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** World-space corners of the camera frustum between the two view-space distances; the near plane corners come first. */
+	template<typename T>
+	std::array<glm::tvec3<T>, 8> computeFrustumSliceCorners(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, T near, T far);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Bounding sphere of the camera frustum slice, as (distance of the center along the view axis, radius).
+		It only depends on the projection and the split distances, so it does not change when the camera rotates. */
+	template<typename T>
+	glm::tvec2<T> computeSliceBoundingSphere(glm::tmat4x4<T> const& projection, T near, T far);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Rotation-only view matrix looking along the parameter light direction. */
+	template<typename T>
+	glm::tmat4x4<T> computeLightRotation(glm::tvec3<T> direction);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Fits a single cascade to the camera frustum slice. The light-space bounds are snapped to whole texels,
+		and the near plane is pulled back to include every caster inside the caster AABB. */
+	template<typename T>
+	Cascade<T> fitCascade(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, glm::tvec3<T> lightDirection,
+		T splitNear, T splitFar, int resolution, BVH::AABB const& casterAabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Computes the splits and fits all the cascades for the parameter camera. */
+	template<typename T>
+	std::vector<Cascade<T>> computeCascades(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, glm::tvec3<T> lightDirection,
+		T near, T far, int numCascades, T lambda, int resolution, BVH::AABB const& casterAabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Number of frustum slice corners that lie outside the frustum of their cascade. */
+	template<typename T>
+	size_t countUncoveredCorners(glm::tmat4x4<T> const& view, glm::tmat4x4<T> const& projection, std::vector<Cascade<T>> const& cascades);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Largest sub-texel shift of the world-space point between the two cascade sets, in texels.
+		Zero means that the shadow map texel grid stayed fixed in the world, i.e. the cascades do not shimmer. */
+	template<typename T>
+	T computeTexelDrift(std::vector<Cascade<T>> const& lhs, std::vector<Cascade<T>> const& rhs, glm::tvec3<T> point);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Shadow map transformation properties of the parameter cascade. */
+	ShadowMap::ShadowMapTransform cascadeTransform(Cascade<float> const& cascade);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the coverage and the stability of the cascades along randomly generated camera paths, with both the
+		float and double instantiations of the fitting, compares the two, and logs the results. Returns whether all the checks passed. */
+	bool validate(glm::mat4 const& projection, float near, float far, int numCascades, float lambda, int resolution, size_t numSamples = 1000);
+}
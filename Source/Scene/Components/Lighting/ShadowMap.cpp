@@ -81,6 +81,22 @@ namespace ShadowMap
 			ImGui::TreePop();
 		}
 
+		if (ImGui::TreeNode("Slice Statistics"))
+		{
+			auto const& slices = object->component<ShadowMap::ShadowMapComponent>().m_slices;
+			const std::vector<int> numOccluders = countSliceOccluders(scene, object);
+			for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId)
+			{
+				ImGui::Text("Slice #%d: %d visible occluders, %d rendered, last updated in frame %d", int(sliceId + 1),
+					numOccluders[sliceId], slices[sliceId].m_numRenderedOccluders, slices[sliceId].m_lastUpdated);
+			}
+			if (ImGui::Button("Validate Slice Invalidation"))
+			{
+				validateSliceInvalidation();
+			}
+			ImGui::TreePop();
+		}
+
 		return { textureSettingsChanged, shadowSettingsChanged };
 	}
 
@@ -340,13 +356,259 @@ namespace ShadowMap
 		}
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	ShadowCasterRegistry* getShadowCasterRegistry(Scene::Scene& scene)
+	{
+		// The registry lives in the render settings; objects created before it are picked up by the initial scan
+		Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+		if (renderSettings == nullptr) return nullptr;
+
+		ShadowCasterRegistry& registry = RenderSettings::renderPayload<ShadowCasterRegistry>(scene, renderSettings,
+			RenderSettings::renderPayloadCategory({ "ShadowMap", "ShadowCasterRegistry" }), true);
+		if (!registry.m_initialized)
+		{
+			registry.m_objects = Scene::filterObjects(scene, Scene::OBJECT_TYPE_SHADOW_CASTER, [](Scene::Object* object) { return true; }, false, true);
+			registry.m_initialized = true;
+		}
+		return &registry;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void registerShadowCaster(Scene::Scene& scene, Scene::Object* object)
+	{
+		if (ShadowCasterRegistry* registry = getShadowCasterRegistry(scene); registry != nullptr)
+		{
+			if (std::find(registry->m_objects.begin(), registry->m_objects.end(), object) == registry->m_objects.end())
+				registry->m_objects.push_back(object);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void unregisterShadowCaster(Scene::Scene& scene, Scene::Object* object)
+	{
+		if (ShadowCasterRegistry* registry = getShadowCasterRegistry(scene); registry != nullptr)
+		{
+			registry->m_objects.erase(std::remove(registry->m_objects.begin(), registry->m_objects.end(), object), registry->m_objects.end());
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	std::vector<Scene::Object*> getShadowCasters(Scene::Scene& scene)
 	{
-		return Scene::filterObjects(scene, Scene::OBJECT_TYPE_SHADOW_CASTER, [](Scene::Object* object)
+		// Fall back to a full scan if the registry is not available yet
+		ShadowCasterRegistry* registry = getShadowCasterRegistry(scene);
+		if (registry == nullptr)
+		{
+			return Scene::filterObjects(scene, Scene::OBJECT_TYPE_SHADOW_CASTER, [](Scene::Object* object)
+			{
+				return object->component<ShadowMap::ShadowMapComponent>().m_castsShadow;
+			}, false, false);
+		}
+
+		// Filter the registered objects
+		Scene::Object* simulationSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_SIMULATION_SETTINGS);
+		std::vector<Scene::Object*> result;
+		result.reserve(registry->m_objects.size());
+		for (auto object : registry->m_objects)
+		{
+			if (object->component<ShadowMap::ShadowMapComponent>().m_castsShadow && SimulationSettings::isObjectEnabled(scene, simulationSettings, object))
+				result.push_back(object);
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool isOccluderVisible(ShadowMapSlice const& slice, BVH::AABB const& aabb)
+	{
+		return slice.m_transform.m_frustum.intersection(aabb) != BVH::Outside;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool rendersOccluder(ShadowMapSlice const& slice, BVH::AABB const& aabb)
+	{
+		return slice.m_needsUpdate && isOccluderVisible(slice, aabb);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void invalidateSlices(std::vector<ShadowMapSlice>& slices, BVH::AABB const& aabb)
+	{
+		for (auto& slice : slices)
+		{
+			if (!slice.m_needsUpdate && isOccluderVisible(slice, aabb))
+				slice.m_needsUpdate = true;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void invalidateSlices(Scene::Scene& scene, BVH::AABB const& aabb)
+	{
+		for (auto object : getShadowCasters(scene))
+			invalidateSlices(object->component<ShadowMap::ShadowMapComponent>().m_slices, aabb);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void moveOccluder(std::vector<ShadowMapSlice>& slices, BVH::AABB const& previousAabb, BVH::AABB const& aabb)
+	{
+		// The occluder has to disappear from the slices it left, and appear in the ones it entered
+		invalidateSlices(slices, previousAabb);
+		invalidateSlices(slices, aabb);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void moveOccluder(Scene::Scene& scene, BVH::AABB& shadowAabb, BVH::AABB const& aabb)
+	{
+		for (auto object : getShadowCasters(scene))
+			moveOccluder(object->component<ShadowMap::ShadowMapComponent>().m_slices, shadowAabb, aabb);
+		shadowAabb = aabb;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::vector<int> countSliceOccluders(Scene::Scene& scene, Scene::Object* object)
+	{
+		auto const& slices = object->component<ShadowMap::ShadowMapComponent>().m_slices;
+		std::vector<int> result(slices.size(), 0);
+
+		for (auto occluder : Scene::filterObjects(scene, Scene::OBJECT_TYPE_MESH))
 		{
-			return object->component<ShadowMap::ShadowMapComponent>().m_castsShadow;
-		}, false, false);
+			auto const& meshName = occluder->component<Mesh::MeshComponent>().m_meshName;
+			if (!Mesh::isMeshValid(scene, occluder)) continue;
+
+			const BVH::AABB aabb = scene.m_meshes[meshName].m_aabb.transform(Transform::getModelMatrix(occluder));
+			for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId)
+				if (isOccluderVisible(slices[sliceId], aabb))
+					++result[sliceId];
+		}
+
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Builds a validation slice from the parameter light transformation, the same way the light sources do. */
+	ShadowMapSlice makeValidationSlice(glm::mat4 const& view, glm::mat4 const& projection, bool isPerspective, float near, float far)
+	{
+		ShadowMapSlice slice{};
+		slice.m_transform.m_view = view;
+		slice.m_transform.m_projection = projection;
+		slice.m_transform.m_transform = projection * view;
+		slice.m_transform.m_frustum = BVH::Frustum(slice.m_transform.m_transform);
+		slice.m_transform.m_isPerspective = isPerspective;
+		slice.m_transform.m_near = near;
+		slice.m_transform.m_far = far;
+		slice.m_needsUpdate = true;
+		slice.m_lastUpdated = -1;
+		return slice;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validateSliceInvalidation()
+	{
+		bool passed = true;
+		auto check = [&](bool condition, std::string const& name)
+		{
+			Debug::log_info() << "  - " << name << ": " << (condition ? "passed" : "FAILED") << Debug::end;
+			passed &= condition;
+		};
+
+		Debug::log_info() << "Shadow map slice invalidation validation" << Debug::end;
+
+		// Bounds of a small box around the parameter point
+		auto box = [](glm::vec3 const& center)
+		{
+			return BVH::AABB(center - glm::vec3(0.25f), center + glm::vec3(0.25f));
+		};
+
+		// Renders a single frame with the cached update policy: every slice marked for update renders the occluders
+		// that the shadow map pass would select, then drops its dirty flag
+		auto renderFrame = [&](std::vector<ShadowMapSlice>& slices, std::vector<BVH::AABB> const& occluders, int frameId,
+			std::vector<int> const& expectedSlices, std::vector<int> const& expectedOccluders, std::string const& name)
+		{
+			std::vector<int> updatedSlices, renderedOccluders;
+			for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId)
+			{
+				auto& slice = slices[sliceId];
+				if (!slice.m_needsUpdate) continue;
+
+				slice.m_numRenderedOccluders = 0;
+				for (auto const& occluder : occluders)
+					if (rendersOccluder(slice, occluder))
+						++slice.m_numRenderedOccluders;
+
+				slice.m_lastUpdated = frameId;
+				slice.m_needsUpdate = false;
+				updatedSlices.push_back(int(sliceId));
+				renderedOccluders.push_back(slice.m_numRenderedOccluders);
+			}
+			check(updatedSlices == expectedSlices, name + ", invalidated slices");
+			check(renderedOccluders == expectedOccluders, name + ", rendered occluders");
+		};
+
+		// Cube map of a point light at the origin, in the +X, -X, +Y, -Y, +Z, -Z face order
+		{
+			const std::array<glm::vec3, 6> directions = { glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1) };
+			const std::array<glm::vec3, 6> ups = { glm::vec3(0, -1, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(0, -1, 0), glm::vec3(0, -1, 0) };
+			const float near = 0.1f, far = 20.0f;
+			std::vector<ShadowMapSlice> slices;
+			for (size_t faceId = 0; faceId < directions.size(); ++faceId)
+				slices.push_back(makeValidationSlice(glm::lookAt(glm::vec3(0.0f), directions[faceId], ups[faceId]),
+					glm::perspective(glm::radians(90.0f), 1.0f, near, far), true, near, far));
+
+			// A static occluder below the light, and the caster, which starts on the +X axis
+			BVH::AABB casterAabb = box(glm::vec3(5.0f, 0.0f, 0.0f));
+			std::vector<BVH::AABB> occluders = { box(glm::vec3(0.0f, -5.0f, 0.0f)), casterAabb };
+
+			// Initial frame, with every slice out of date
+			renderFrame(slices, occluders, 0, { 0, 1, 2, 3, 4, 5 }, { 1, 0, 0, 1, 0, 0 }, "cube map, initial frame");
+
+			// Move the caster to the +Z face; the +X face is cleared, the +Z face picks it up
+			moveOccluder(slices, casterAabb, box(glm::vec3(0.0f, 0.0f, 5.0f)));
+			casterAabb = occluders[1] = box(glm::vec3(0.0f, 0.0f, 5.0f));
+			renderFrame(slices, occluders, 1, { 0, 4 }, { 0, 1 }, "cube map, caster moved across faces");
+
+			// Frame without any movement
+			renderFrame(slices, occluders, 2, {}, {}, "cube map, static frame");
+
+			// Move the caster onto the diagonal of the +X and +Y faces
+			moveOccluder(slices, casterAabb, box(glm::vec3(3.5f, 3.5f, 0.0f)));
+			casterAabb = occluders[1] = box(glm::vec3(3.5f, 3.5f, 0.0f));
+			renderFrame(slices, occluders, 3, { 0, 2, 4 }, { 1, 1, 0 }, "cube map, caster on a face edge");
+
+			// Move the caster within the same faces
+			moveOccluder(slices, casterAabb, box(glm::vec3(4.0f, 4.0f, 0.0f)));
+			casterAabb = occluders[1] = box(glm::vec3(4.0f, 4.0f, 0.0f));
+			renderFrame(slices, occluders, 4, { 0, 2 }, { 1, 1 }, "cube map, caster moved within faces");
+		}
+
+		// Three nested cascades of a directional light pointing down
+		{
+			const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 50.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+			const float near = 1.0f, far = 100.0f;
+			std::vector<ShadowMapSlice> slices;
+			for (float halfExtent : { 4.0f, 12.0f, 36.0f })
+				slices.push_back(makeValidationSlice(view, glm::ortho(-halfExtent, halfExtent, -halfExtent, halfExtent, near, far), false, near, far));
+
+			// The caster starts inside every cascade
+			BVH::AABB casterAabb = box(glm::vec3(2.0f, 0.0f, 0.0f));
+			std::vector<BVH::AABB> occluders = { casterAabb };
+			renderFrame(slices, occluders, 0, { 0, 1, 2 }, { 1, 1, 1 }, "cascades, initial frame");
+
+			// Leave the first cascade
+			moveOccluder(slices, casterAabb, box(glm::vec3(10.0f, 0.0f, 0.0f)));
+			casterAabb = occluders[0] = box(glm::vec3(10.0f, 0.0f, 0.0f));
+			renderFrame(slices, occluders, 1, { 0, 1, 2 }, { 0, 1, 1 }, "cascades, caster left the first cascade");
+
+			// Leave the second cascade; the first one holds no trace of the caster anymore
+			moveOccluder(slices, casterAabb, box(glm::vec3(30.0f, 0.0f, 0.0f)));
+			casterAabb = occluders[0] = box(glm::vec3(30.0f, 0.0f, 0.0f));
+			renderFrame(slices, occluders, 2, { 1, 2 }, { 0, 1 }, "cascades, caster left the second cascade");
+
+			// Leave the shadow map altogether
+			moveOccluder(slices, casterAabb, box(glm::vec3(100.0f, 0.0f, 0.0f)));
+			casterAabb = occluders[0] = box(glm::vec3(100.0f, 0.0f, 0.0f));
+			renderFrame(slices, occluders, 3, { 2 }, { 0 }, "cascades, caster left the shadow map");
+		}
+
+		Debug::log_info() << "Shadow map slice invalidation validation " << (passed ? "passed" : "FAILED") << Debug::end;
+		return passed;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
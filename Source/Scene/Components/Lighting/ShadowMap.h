@@ -62,6 +62,9 @@ namespace ShadowMap
 
 		// Frame in which the slice was last rendered
 		int m_lastUpdated;
+
+		// Number of occluders rendered into the slice during its last update
+		int m_numRenderedOccluders = 0;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +154,17 @@ namespace ShadowMap
 		glm::ivec2 m_shadowMapDimensions;
 	};
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Persistent list of the objects with a shadow map, updated as they are created and removed. */
+	struct ShadowCasterRegistry
+	{
+		// All the objects with a shadow map, including the disabled ones
+		std::vector<Scene::Object*> m_objects;
+
+		// Whether the list was built yet or not
+		bool m_initialized = false;
+	};
+
 	////////////////////////////////////////////////////////////////////////////////
 	std::array<bool, 2> generateGui(Scene::Scene& scene, Scene::Object* guiSettings, Scene::Object* object);
 
@@ -169,9 +183,48 @@ namespace ShadowMap
 	////////////////////////////////////////////////////////////////////////////////
 	void updateShadowMap(Scene::Scene& scene, Scene::Object* object);
 
+	////////////////////////////////////////////////////////////////////////////////
+	void registerShadowCaster(Scene::Scene& scene, Scene::Object* object);
+
+	////////////////////////////////////////////////////////////////////////////////
+	void unregisterShadowCaster(Scene::Scene& scene, Scene::Object* object);
+
 	////////////////////////////////////////////////////////////////////////////////
 	std::vector<Scene::Object*> getShadowCasters(Scene::Scene& scene);
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether an occluder with the parameter world-space bounds can contribute to the slice or not. */
+	bool isOccluderVisible(ShadowMapSlice const& slice, BVH::AABB const& aabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether an occluder with the parameter world-space bounds must be rendered into the slice during this frame or not. */
+	bool rendersOccluder(ShadowMapSlice const& slice, BVH::AABB const& aabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Marks the parameter slices whose frustum intersects the parameter world-space bounds for update. */
+	void invalidateSlices(std::vector<ShadowMapSlice>& slices, BVH::AABB const& aabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Marks the slices of every shadow caster whose frustum intersects the parameter world-space bounds for update. */
+	void invalidateSlices(Scene::Scene& scene, BVH::AABB const& aabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Marks the parameter slices that an occluder left or entered by moving between the parameter bounds for update. */
+	void moveOccluder(std::vector<ShadowMapSlice>& slices, BVH::AABB const& previousAabb, BVH::AABB const& aabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Invalidates the slices of every shadow caster that the occluder left or entered, and stores its new bounds. */
+	void moveOccluder(Scene::Scene& scene, BVH::AABB& shadowAabb, BVH::AABB const& aabb);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Number of occluders whose bounds intersect each slice of the shadow caster. */
+	std::vector<int> countSliceOccluders(Scene::Scene& scene, Scene::Object* object);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Moves a caster across the slices of a cube map and a set of cascades over several frames, and checks which slices
+		are invalidated and how many occluders each updated slice renders. Returns whether all the checks passed. */
+	bool validateSliceInvalidation();
+
 	////////////////////////////////////////////////////////////////////////////////
 	void updateBlurKernels(Scene::Scene& scene, Scene::Object* object);
 
@@ -52,6 +52,9 @@ namespace SpotLight
 		Scene::appendResourceInitializer(scene, object.m_name, Scene::Shader, initShaders, "Shaders");
 		Scene::appendResourceInitializer(scene, object.m_name, Scene::GenericBuffer, initGPUBuffers, "Generic GPU Buffers");
 
+		// Keep track of the light in the shadow caster list
+		ShadowMap::registerShadowCaster(scene, &object);
+
 		// Set the default shadow map layout
 		object.component<ShadowMap::ShadowMapComponent>().m_layout = ShadowMap::ShadowMapComponent::CubeMaps;
 
@@ -67,7 +70,7 @@ namespace SpotLight
 	////////////////////////////////////////////////////////////////////////////////
 	void releaseObject(Scene::Scene& scene, Scene::Object& object)
 	{
-
+		ShadowMap::unregisterShadowCaster(scene, &object);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -159,6 +162,38 @@ namespace SpotLight
 		return result;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	void updateLightClusters(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera, Scene::Object* object)
+	{
+		Profiler::ScopedCpuPerfCounter perfCounter(scene, "Light Clusters");
+
+		auto const& lighting = renderSettings->component<RenderSettings::RenderSettingsComponent>().m_lighting;
+		auto& lightGrid = object->component<SpotLight::SpotLightGridComponent>();
+
+		// Build the froxel grid of the camera
+		const LightClusters::ClusterGrid grid = LightClusters::buildClusterGrid(renderSettings, camera, lighting.m_lightClusters);
+
+		// Collect the view-space light volumes
+		const glm::mat4 view = Camera::getViewMatrix(camera);
+		LightClusters::clearLights(lightGrid.m_lightVolumes);
+		LightClusters::reserveLights(lightGrid.m_lightVolumes, lightGrid.m_lightSources.size());
+		for (auto const& lightSource : lightGrid.m_lightSources)
+			LightClusters::appendSpotLight(lightGrid.m_lightVolumes, view, lightSource.m_lightLocation, lightSource.m_lightDirection, lightSource.m_radius, lightSource.m_cosOuterAngle);
+
+		// Assign the light sources to the clusters
+		LightClusters::assignLights(grid, lightGrid.m_lightVolumes, lightGrid.m_lightClusters);
+
+		// Compare against the brute-force assignment, if requested
+		if (lighting.m_validateLightClusters)
+		{
+			LightClusters::ClusterLightLists reference;
+			LightClusters::assignLightsBruteForce(grid, lightGrid.m_lightVolumes, reference);
+			const size_t numMismatches = LightClusters::countMismatches(lightGrid.m_lightClusters, reference);
+			if (numMismatches > 0)
+				Debug::log_error() << object->m_name << ": " << numMismatches << " light clusters differ from the brute-force assignment" << Debug::end;
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	void updateShadowMapSlices(Scene::Scene& scene, Scene::Object* object)
 	{
@@ -252,7 +287,7 @@ namespace SpotLight
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	std::vector<UniformData> getLightBatches(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object)
+	std::vector<UniformData> getLightBatches(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object, std::vector<bool> const& visibleLights = {})
 	{
 		std::vector<UniformData> result;
 
@@ -283,6 +318,10 @@ namespace SpotLight
 		auto const& lightSources = object->component<SpotLight::SpotLightGridComponent>().m_lightSources;
 		for (size_t lightId = 0; lightId < lightSources.size(); ++lightId)
 		{
+			// Skip the light sources that don't affect any of the camera's clusters
+			if (!visibleLights.empty() && !visibleLights[lightId])
+				continue;
+
 			// Access the light source
 			auto& lightSource = lightSources[lightId];
 
@@ -361,7 +400,7 @@ namespace SpotLight
 		for (auto const& lightData : lightBatches)
 		{
 			// Upload the parameters
-			uploadBufferData(scene, "SpotLight", lightData);
+			uploadTransientBufferData(scene, "SpotLight", lightData);
 
 			// inject radiance at level 0 of texture
 			glDispatchCompute(numWorkGroups, numWorkGroups, numWorkGroups);
@@ -395,12 +434,20 @@ namespace SpotLight
 			glBindTexture(GL_TEXTURE_2D, scene.m_textures[object->component<ShadowMap::ShadowMapComponent>().m_shadowMapFBO].m_texture);
 		}
 
+		// Cull the light sources against the clusters of the camera
+		std::vector<bool> visibleLights;
+		if (renderSettings->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_clusteredLightCulling)
+		{
+			updateLightClusters(scene, renderSettings, camera, object);
+			visibleLights = LightClusters::visibleLights(object->component<SpotLight::SpotLightGridComponent>().m_lightClusters, object->component<SpotLight::SpotLightGridComponent>().m_lightSources.size());
+		}
+
 		// Construct light batches
-		auto const& lightBatches = getLightBatches(scene, renderSettings, object);
+		auto const& lightBatches = getLightBatches(scene, renderSettings, object, visibleLights);
 		for (auto const& lightData : lightBatches)
 		{
 			// Upload the parameters
-			uploadBufferData(scene, "SpotLight", lightData);
+			uploadTransientBufferData(scene, "SpotLight", lightData);
 
 			// Render the fullscreen quad
 			RenderSettings::renderFullscreenPlaneOpenGL(scene, simulationSettings, renderSettings);
@@ -7,6 +7,7 @@
 #include "PCH.h"
 #include "Common.h"
 #include "ShadowMap.h"
+#include "LightClusters.h"
 
 namespace SpotLight
 {
@@ -111,6 +112,12 @@ namespace SpotLight
 
 		// A list of all the light sources in the grid
 		std::vector<SpotLightSource> m_lightSources;
+
+		// View-space light volumes of the light sources, for the clustered culling
+		LightClusters::LightVolumes m_lightVolumes;
+
+		// Per-cluster light lists for the current camera
+		LightClusters::ClusterLightLists m_lightClusters;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -166,6 +173,9 @@ namespace SpotLight
 	////////////////////////////////////////////////////////////////////////////////
 	void updateLightSources(Scene::Scene& scene, Scene::Object* object);
 
+	////////////////////////////////////////////////////////////////////////////////
+	void updateLightClusters(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera, Scene::Object* object);
+
 	////////////////////////////////////////////////////////////////////////////////
 	void updateShadowMapSlices(Scene::Scene& scene, Scene::Object* object);
 
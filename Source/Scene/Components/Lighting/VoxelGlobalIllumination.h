@@ -73,37 +73,39 @@ namespace VoxelGlobalIllumination
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
-	struct UniformDataDiffuseTrace
-	{
-		GLint m_contribution;
-		GLfloat m_intensity;
-		GLfloat m_aperture;
-		GLfloat m_mipOffset;
-		GLfloat m_startOffset;
-		GLfloat m_normalOffset;
-		GLfloat m_maxTraceDistance;
-		GLuint m_anisotropic;
-		GLfloat m_radianceDecayRate;
-		GLfloat m_occlusionDecayRate;
-		GLfloat m_occlusionExponent;
-		GLfloat m_minOcclusion;
-	};
-
-	////////////////////////////////////////////////////////////////////////////////
-	struct UniformDataSpecularTrace
-	{
-		GLuint m_contribution;
-		GLfloat m_intensity;
-		GLfloat m_apertureMin;
-		GLfloat m_apertureMax;
-		GLfloat m_mipLevelMin;
-		GLfloat m_mipLevelMax;
-		GLfloat m_startOffset;
-		GLfloat m_normalOffset;
-		GLfloat m_maxTraceDistance;
-		GLuint m_anisotropic;
-		GLfloat m_radianceDecayRate;
-	};
+	make_gpu_struct(UniformDataDiffuseTrace, std140,
+		(GLint, m_contribution)
+		(GLfloat, m_intensity)
+		(GLfloat, m_aperture)
+		(GLfloat, m_mipOffset)
+		(GLfloat, m_startOffset)
+		(GLfloat, m_normalOffset)
+		(GLfloat, m_maxTraceDistance)
+		(GLuint, m_anisotropic)
+		(GLfloat, m_radianceDecayRate)
+		(GLfloat, m_occlusionDecayRate)
+		(GLfloat, m_occlusionExponent)
+		(GLfloat, m_minOcclusion)
+	);
+
+	static_assert(offsetof(UniformDataDiffuseTrace, m_minOcclusion) == 44 && sizeof(UniformDataDiffuseTrace) == 48, "Unexpected UniformDataDiffuseTrace layout.");
+
+	////////////////////////////////////////////////////////////////////////////////
+	make_gpu_struct(UniformDataSpecularTrace, std140,
+		(GLuint, m_contribution)
+		(GLfloat, m_intensity)
+		(GLfloat, m_apertureMin)
+		(GLfloat, m_apertureMax)
+		(GLfloat, m_mipLevelMin)
+		(GLfloat, m_mipLevelMax)
+		(GLfloat, m_startOffset)
+		(GLfloat, m_normalOffset)
+		(GLfloat, m_maxTraceDistance)
+		(GLuint, m_anisotropic)
+		(GLfloat, m_radianceDecayRate)
+	);
+
+	static_assert(offsetof(UniformDataSpecularTrace, m_radianceDecayRate) == 40 && sizeof(UniformDataSpecularTrace) == 48, "Unexpected UniformDataSpecularTrace layout.");
 
 	////////////////////////////////////////////////////////////////////////////////
 	/** Uniform buffer for the indirect injection pass. */
@@ -116,8 +118,8 @@ namespace VoxelGlobalIllumination
 	/** Uniform buffer for the GI pass. */
 	struct UniformDataGIPass
 	{
-		alignas(sizeof(glm::vec4)) UniformDataDiffuseTrace m_diffuseTraceParams;
-		alignas(sizeof(glm::vec4)) UniformDataSpecularTrace m_specularTraceParams;
+		UniformDataDiffuseTrace m_diffuseTraceParams;
+		UniformDataSpecularTrace m_specularTraceParams;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
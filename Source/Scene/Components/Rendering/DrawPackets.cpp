@@ -0,0 +1,235 @@
+#include "PCH.h"
+#include "DrawPackets.h"
+
+#include <random>
+
+namespace DrawPackets
+{
+	////////////////////////////////////////////////////////////////////////////////
+	// Lists shorter than this are sorted with insertion sort
+	static constexpr size_t INSERTION_SORT_THRESHOLD = 64;
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint64_t fieldMask(uint32_t bits)
+	{
+		return (uint64_t(1) << bits) - 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint64_t makeSortKey(uint32_t pass, uint32_t shader, uint32_t material, uint32_t depthBucket)
+	{
+		return
+			((uint64_t(pass) & fieldMask(PASS_BITS)) << PASS_SHIFT) |
+			((uint64_t(shader) & fieldMask(SHADER_BITS)) << SHADER_SHIFT) |
+			((uint64_t(material) & fieldMask(MATERIAL_BITS)) << MATERIAL_SHIFT) |
+			((uint64_t(depthBucket) & fieldMask(DEPTH_BITS)) << DEPTH_SHIFT);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint32_t keyPass(uint64_t key)
+	{
+		return uint32_t((key >> PASS_SHIFT) & fieldMask(PASS_BITS));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint32_t keyShader(uint64_t key)
+	{
+		return uint32_t((key >> SHADER_SHIFT) & fieldMask(SHADER_BITS));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint32_t keyMaterial(uint64_t key)
+	{
+		return uint32_t((key >> MATERIAL_SHIFT) & fieldMask(MATERIAL_BITS));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint32_t keyDepth(uint64_t key)
+	{
+		return uint32_t((key >> DEPTH_SHIFT) & fieldMask(DEPTH_BITS));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint32_t depthBucket(float depth, float near, float far)
+	{
+		if (far <= near) return 0;
+		const float t = glm::clamp((depth - near) / (far - near), 0.0f, 1.0f);
+		return uint32_t(t * float(fieldMask(DEPTH_BITS)));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void reset(DrawList& list)
+	{
+		list.m_packets.clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void addPacket(DrawList& list, uint64_t key, uint32_t objectId, uint32_t submeshId)
+	{
+		DrawPacket packet;
+		packet.m_key = key;
+		packet.m_objectId = objectId;
+		packet.m_submeshId = submeshId;
+		list.m_packets.push_back(packet);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void sortPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch)
+	{
+		const size_t numPackets = packets.size();
+
+		// Insertion sort for the short lists, such as views with only a few visible submeshes
+		if (numPackets < INSERTION_SORT_THRESHOLD)
+		{
+			for (size_t i = 1; i < numPackets; ++i)
+			{
+				const DrawPacket packet = packets[i];
+				size_t j = i;
+				for (; j > 0 && packets[j - 1].m_key > packet.m_key; --j)
+					packets[j] = packets[j - 1];
+				packets[j] = packet;
+			}
+			return;
+		}
+
+		// Build the histograms of every digit in a single pass
+		static constexpr size_t NUM_DIGITS = sizeof(uint64_t);
+		std::array<std::array<uint32_t, 256>, NUM_DIGITS> histograms{};
+		for (auto const& packet : packets)
+			for (size_t digit = 0; digit < NUM_DIGITS; ++digit)
+				++histograms[digit][(packet.m_key >> (digit * 8)) & 0xFF];
+
+		// Scatter the packets back and forth between the two buffers
+		scratch.resize(numPackets);
+		DrawPacket* source = packets.data();
+		DrawPacket* target = scratch.data();
+		for (size_t digit = 0; digit < NUM_DIGITS; ++digit)
+		{
+			auto& histogram = histograms[digit];
+			const size_t shift = digit * 8;
+
+			// Skip the digit if every key shares it
+			if (histogram[(source[0].m_key >> shift) & 0xFF] == numPackets) continue;
+
+			// Turn the counts into offsets
+			uint32_t offset = 0;
+			for (auto& count : histogram)
+			{
+				const uint32_t current = count;
+				count = offset;
+				offset += current;
+			}
+
+			for (size_t i = 0; i < numPackets; ++i)
+				target[histogram[(source[i].m_key >> shift) & 0xFF]++] = source[i];
+			std::swap(source, target);
+		}
+
+		// Make sure the results end up in the input vector
+		if (source != packets.data())
+			std::copy(source, source + numPackets, packets.data());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void computeStateChanges(std::vector<DrawPacket>& packets)
+	{
+		for (size_t i = 0; i < packets.size(); ++i)
+		{
+			DrawPacket& packet = packets[i];
+
+			// The first packet sets up everything
+			if (i == 0)
+			{
+				packet.m_stateChanges = CHANGE_PASS | CHANGE_SHADER | CHANGE_MATERIAL | CHANGE_OBJECT;
+				continue;
+			}
+
+			// Changing a field invalidates the state of every field below it
+			DrawPacket const& previous = packets[i - 1];
+			uint32_t changes = CHANGE_NONE;
+			if (keyPass(packet.m_key) != keyPass(previous.m_key))
+				changes |= CHANGE_PASS | CHANGE_SHADER | CHANGE_MATERIAL;
+			if (keyShader(packet.m_key) != keyShader(previous.m_key))
+				changes |= CHANGE_SHADER | CHANGE_MATERIAL;
+			if (keyMaterial(packet.m_key) != keyMaterial(previous.m_key))
+				changes |= CHANGE_MATERIAL;
+			if (packet.m_objectId != previous.m_objectId)
+				changes |= CHANGE_OBJECT;
+			packet.m_stateChanges = changes;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void finalize(DrawList& list)
+	{
+		sortPackets(list.m_packets, list.m_scratch);
+		computeStateChanges(list.m_packets);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool benchmark(size_t numPackets, size_t numObjects, size_t numMaterials, size_t numFrames)
+	{
+		std::mt19937 generator(0);
+		std::uniform_int_distribution<uint32_t> objectDistribution(0, uint32_t(glm::max(numObjects, size_t(1)) - 1));
+		std::uniform_int_distribution<uint32_t> materialDistribution(0, uint32_t(glm::max(numMaterials, size_t(1)) - 1));
+		std::uniform_int_distribution<uint32_t> passDistribution(0, 3);
+		std::uniform_real_distribution<float> depthDistribution(0.1f, 1000.0f);
+
+		// Synthetic packets, in submission order
+		std::vector<DrawPacket> input(numPackets);
+		for (size_t i = 0; i < numPackets; ++i)
+		{
+			input[i].m_key = makeSortKey(passDistribution(generator), 0, materialDistribution(generator), depthBucket(depthDistribution(generator), 0.1f, 1000.0f));
+			input[i].m_objectId = objectDistribution(generator);
+			input[i].m_submeshId = uint32_t(i);
+		}
+
+		// Build the draw lists with the radix sort
+		DrawList list;
+		DateTime::Timer radixTimer(true);
+		for (size_t frameId = 0; frameId < numFrames; ++frameId)
+		{
+			reset(list);
+			for (auto const& packet : input)
+				addPacket(list, packet.m_key, packet.m_objectId, packet.m_submeshId);
+			finalize(list);
+		}
+		radixTimer.stop();
+
+		// Reference results
+		std::vector<DrawPacket> reference;
+		DateTime::Timer referenceTimer(true);
+		for (size_t frameId = 0; frameId < numFrames; ++frameId)
+		{
+			reference = input;
+			std::stable_sort(reference.begin(), reference.end(), [](DrawPacket const& a, DrawPacket const& b) { return a.m_key < b.m_key; });
+			computeStateChanges(reference);
+		}
+		referenceTimer.stop();
+
+		// Compare the results
+		bool matches = list.m_packets.size() == reference.size();
+		for (size_t i = 0; matches && i < reference.size(); ++i)
+		{
+			matches = list.m_packets[i].m_key == reference[i].m_key &&
+				list.m_packets[i].m_objectId == reference[i].m_objectId &&
+				list.m_packets[i].m_submeshId == reference[i].m_submeshId &&
+				list.m_packets[i].m_stateChanges == reference[i].m_stateChanges;
+		}
+
+		size_t numMaterialChanges = 0, numObjectChanges = 0;
+		for (auto const& packet : list.m_packets)
+		{
+			if (packet.m_stateChanges & CHANGE_MATERIAL) ++numMaterialChanges;
+			if (packet.m_stateChanges & CHANGE_OBJECT) ++numObjectChanges;
+		}
+
+		const double radixTime = radixTimer.getElapsedTime() * 1000.0 / double(numFrames);
+		const double referenceTime = referenceTimer.getElapsedTime() * 1000.0 / double(numFrames);
+		Debug::log_info() << "Draw packet benchmark (" << numPackets << " packets, " << numObjects << " objects, " << numMaterials << " materials): "
+			<< (matches ? "results match" : "RESULTS DIFFER") << Debug::end;
+		Debug::log_info() << "  - radix sort: " << radixTime << " ms per frame (std::stable_sort: " << referenceTime << " ms)" << Debug::end;
+		Debug::log_info() << "  - material changes: " << numMaterialChanges << ", object changes: " << numObjectChanges << Debug::end;
+		return matches;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+//  Headers
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PCH.h"
+#include "Common.h"
+
+namespace DrawPackets
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/** Bit layout of the sort keys, from the most significant field to the least significant one. */
+	static constexpr uint32_t PASS_BITS = 8;
+	static constexpr uint32_t SHADER_BITS = 12;
+	static constexpr uint32_t MATERIAL_BITS = 24;
+	static constexpr uint32_t DEPTH_BITS = 20;
+
+	static constexpr uint32_t DEPTH_SHIFT = 0;
+	static constexpr uint32_t MATERIAL_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+	static constexpr uint32_t SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	static constexpr uint32_t PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+
+	static_assert(PASS_SHIFT + PASS_BITS == 64, "Sort key fields must fill the 64-bit key.");
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** State changes that must be performed before submitting a packet. */
+	enum StateChange : uint32_t
+	{
+		CHANGE_NONE = 0,
+		CHANGE_PASS = 1 << 0,
+		CHANGE_SHADER = 1 << 1,
+		CHANGE_MATERIAL = 1 << 2,
+		CHANGE_OBJECT = 1 << 3,
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A single draw: one submesh of one object. */
+	struct DrawPacket
+	{
+		// Sort key of the draw
+		uint64_t m_key = 0;
+
+		// Object and submesh to draw
+		uint32_t m_objectId = 0;
+		uint32_t m_submeshId = 0;
+
+		// Combination of StateChange flags, relative to the previous packet
+		uint32_t m_stateChanges = CHANGE_NONE;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Packet storage for a single draw list. Reset before building the packets of a view; the storage is kept
+		around between frames, so building the packets does not allocate once the lists reached their peak size. */
+	struct DrawList
+	{
+		// The packets themselves
+		std::vector<DrawPacket> m_packets;
+
+		// Scratch storage for the radix sort
+		std::vector<DrawPacket> m_scratch;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Builds a sort key from its fields; the fields are truncated to their bit widths. */
+	uint64_t makeSortKey(uint32_t pass, uint32_t shader, uint32_t material, uint32_t depthBucket);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Extracts the fields of the parameter sort key. */
+	uint32_t keyPass(uint64_t key);
+	uint32_t keyShader(uint64_t key);
+	uint32_t keyMaterial(uint64_t key);
+	uint32_t keyDepth(uint64_t key);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Quantizes the parameter view depth into a depth bucket, between the near and far distances. */
+	uint32_t depthBucket(float depth, float near, float far);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Empties the draw list, without releasing its storage. */
+	void reset(DrawList& list);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a new packet to the draw list. */
+	void addPacket(DrawList& list, uint64_t key, uint32_t objectId, uint32_t submeshId);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Stable LSD radix sort of the packets by their keys, 8 bits per pass. Passes where every key shares the same digit
+		are skipped, and short lists fall back to an insertion sort. */
+	void sortPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Computes the state changes of the sorted packets, so that the submission can skip the redundant ones. */
+	void computeStateChanges(std::vector<DrawPacket>& packets);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Sorts the packets of the draw list and computes their state changes. */
+	void finalize(DrawList& list);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Builds, sorts and finalizes synthetic draw lists, compares the results with std::stable_sort,
+		and logs the per-frame timings. Returns whether the sorted lists matched. */
+	bool benchmark(size_t numPackets = 100000, size_t numObjects = 10000, size_t numMaterials = 1000, size_t numFrames = 10);
+}
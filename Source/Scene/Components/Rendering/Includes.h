@@ -2,4 +2,7 @@
 
 #include "Transform.h"
 #include "Camera.h"
-#include "Mesh.h"
\ No newline at end of file
+#include "Mesh.h"
+#include "Visibility.h"
+#include "DrawPackets.h"
+#include "MaterialTable.h"
\ No newline at end of file
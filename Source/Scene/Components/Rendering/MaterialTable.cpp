@@ -0,0 +1,400 @@
+#include "PCH.h"
+#include "MaterialTable.h"
+#include "Scene/Components/Rendering/Includes.h"
+#include "Scene/Components/Settings/RenderSettings.h"
+
+#include <random>
+
+namespace MaterialTable
+{
+	////////////////////////////////////////////////////////////////////////////////
+	// Initial number of records in the GPU buffer
+	static constexpr size_t MIN_GPU_CAPACITY = 64;
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Records are compared bytewise, so the padding must be zeroed as well
+	MaterialData emptyRecord()
+	{
+		MaterialData result;
+		std::memset(&result, 0, sizeof(MaterialData));
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	MaterialData packMaterial(GPU::Material const& material, bool alphaMapsEnabled, bool normalMapsEnabled)
+	{
+		MaterialData result = emptyRecord();
+		result.m_albedoTint = material.m_diffuse;
+		result.m_opacity = material.m_opacity;
+		result.m_emissiveColor = material.m_emissive;
+		result.m_metallic = material.m_metallic;
+		result.m_specularMask = material.m_specularMask;
+		result.m_roughnessMask = material.m_roughnessMask;
+		result.m_metallicMask = material.m_metallicMask;
+		result.m_roughness = material.m_roughness;
+		result.m_specular = material.m_specular;
+		result.m_normalMapStrength = material.m_normalMapStrength;
+		result.m_displacementScale = material.m_displacementScale;
+
+		result.m_flags = 0;
+		if (material.m_twoSided)
+			result.m_flags |= TwoSided;
+		if (!material.m_diffuseMap.empty() && material.m_diffuseMap != "default_diffuse_map")
+			result.m_flags |= AlbedoMap;
+		if (!material.m_normalMap.empty() && material.m_normalMap != "default_normal_map" && normalMapsEnabled)
+			result.m_flags |= NormalMap;
+		if (!material.m_specularMap.empty() && material.m_specularMap != "default_specular_map")
+			result.m_flags |= SpecularMap;
+		if (!material.m_alphaMap.empty() && material.m_alphaMap != "default_alpha_map" && alphaMapsEnabled)
+			result.m_flags |= AlphaMap;
+		if (!material.m_displacementMap.empty() && material.m_displacementMap != "default_displacement_map")
+			result.m_flags |= DisplacementMap;
+
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	uint32_t registerMaterial(Table& table, std::string const& name)
+	{
+		if (auto it = table.m_ids.find(name); it != table.m_ids.end())
+			return it->second;
+
+		// Reuse the id of a removed material, if any
+		if (!table.m_freeIds.empty())
+		{
+			const uint32_t id = table.m_freeIds.back();
+			table.m_freeIds.pop_back();
+			table.m_ids[name] = id;
+			table.m_names[id] = name;
+			table.m_records[id] = emptyRecord();
+			table.m_dirty[id] = 1;
+			return id;
+		}
+
+		const uint32_t id = uint32_t(table.m_names.size());
+		table.m_ids[name] = id;
+		table.m_names.push_back(name);
+		table.m_records.push_back(emptyRecord());
+		table.m_dirty.push_back(1);
+		return id;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void releaseMaterial(Table& table, std::string const& name)
+	{
+		auto it = table.m_ids.find(name);
+		if (it == table.m_ids.end()) return;
+
+		// The record stays in place, but no draw references it anymore
+		table.m_names[it->second].clear();
+		table.m_freeIds.push_back(it->second);
+		table.m_ids.erase(it);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool updateRecord(Table& table, uint32_t id, MaterialData const& record)
+	{
+		// The records are plain data, so a bytewise comparison is enough
+		if (std::memcmp(&table.m_records[id], &record, sizeof(MaterialData)) == 0)
+			return false;
+
+		std::memcpy(&table.m_records[id], &record, sizeof(MaterialData));
+		table.m_dirty[id] = 1;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void markAllDirty(Table& table)
+	{
+		std::fill(table.m_dirty.begin(), table.m_dirty.end(), 1);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::vector<DirtyRange> collectDirtyRanges(Table& table, size_t maxGap)
+	{
+		std::vector<DirtyRange> result;
+		for (uint32_t id = 0; id < table.m_dirty.size(); ++id)
+		{
+			if (!table.m_dirty[id]) continue;
+			table.m_dirty[id] = 0;
+
+			// Extend the previous range if the gap is small enough, otherwise start a new one
+			if (!result.empty() && id - result.back().m_end <= maxGap)
+				result.back().m_end = id + 1;
+			else
+				result.push_back(DirtyRange{ id, id + 1 });
+		}
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void markMaterialChanged(Table& table, std::string const& name)
+	{
+		table.m_changedMaterials.insert(name);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void markAllMaterialsChanged(Table& table)
+	{
+		table.m_syncAll = true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void syncMaterials(Table& table, std::unordered_map<std::string, GPU::Material> const& materials, bool alphaMapsEnabled, bool normalMapsEnabled)
+	{
+		// Only repack the reported materials, unless the whole table is out of date
+		const bool syncAll = table.m_syncAll || materials.size() != table.m_ids.size() ||
+			alphaMapsEnabled != table.m_alphaMapsEnabled || normalMapsEnabled != table.m_normalMapsEnabled;
+		if (!syncAll)
+		{
+			for (auto const& name : table.m_changedMaterials)
+			{
+				if (auto it = materials.find(name); it != materials.end())
+					updateRecord(table, registerMaterial(table, name), packMaterial(it->second, alphaMapsEnabled, normalMapsEnabled));
+				else
+					releaseMaterial(table, name);
+			}
+			table.m_changedMaterials.clear();
+			return;
+		}
+
+		// Drop the entries of the removed materials
+		for (uint32_t id = 0; id < table.m_names.size(); ++id)
+		{
+			if (!table.m_names[id].empty() && materials.find(table.m_names[id]) == materials.end())
+				releaseMaterial(table, std::string(table.m_names[id]));
+		}
+
+		// Register the new materials and repack every material
+		for (auto const& material : materials)
+			updateRecord(table, registerMaterial(table, material.first), packMaterial(material.second, alphaMapsEnabled, normalMapsEnabled));
+
+		table.m_changedMaterials.clear();
+		table.m_syncAll = false;
+		table.m_alphaMapsEnabled = alphaMapsEnabled;
+		table.m_normalMapsEnabled = normalMapsEnabled;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	Table& getMaterialTable(Scene::Scene& scene)
+	{
+		Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+		return RenderSettings::renderPayload<Table>(scene, renderSettings, RenderSettings::renderPayloadCategory({ "MaterialTable", "Table" }), true);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void markMaterialChanged(Scene::Scene& scene, std::string const& name)
+	{
+		// The table starts with a full synchronization once it is created
+		if (Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS) == nullptr) return;
+		markMaterialChanged(getMaterialTable(scene), name);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void markAllMaterialsChanged(Scene::Scene& scene)
+	{
+		if (Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS) == nullptr) return;
+		markAllMaterialsChanged(getMaterialTable(scene));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void updateMaterialTable(Scene::Scene& scene, Scene::Object* renderSettings)
+	{
+		Profiler::ScopedCpuPerfCounter perfCounter(scene, "Material Table");
+
+		Table& table = getMaterialTable(scene);
+
+		// Synchronize the records with the scene
+		auto const& features = renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features;
+		syncMaterials(table, scene.m_materials,
+			features.m_transparencyMethod != RenderSettings::DisableTransparency,
+			features.m_normalMapping != RenderSettings::DisableNormalMapping);
+
+		// Create the GPU buffer
+		if (scene.m_genericBuffers.find(BUFFER_NAME) == scene.m_genericBuffers.end())
+		{
+			table.m_gpuCapacity = glm::max(table.m_records.size(), MIN_GPU_CAPACITY);
+			Scene::createGPUBuffer(scene, BUFFER_NAME, GL_SHADER_STORAGE_BUFFER, false, true, GPU::UniformBufferIndices::UNIFORM_BUFFER_MATERIALS,
+				0, table.m_gpuCapacity * sizeof(MaterialData), sizeof(MaterialData));
+			markAllDirty(table);
+		}
+
+		// Grow it if needed; resizing discards the contents
+		if (table.m_records.size() > table.m_gpuCapacity)
+		{
+			table.m_gpuCapacity = glm::max(table.m_records.size(), table.m_gpuCapacity * 2);
+			Scene::resizeGPUBuffer(scene, BUFFER_NAME, table.m_gpuCapacity * sizeof(MaterialData));
+			markAllDirty(table);
+		}
+
+		// Upload the changed records
+		const std::vector<DirtyRange> ranges = collectDirtyRanges(table);
+		table.m_numUploadRanges = ranges.size();
+		table.m_numUploadedRecords = 0;
+		for (auto const& range : ranges)
+		{
+			Scene::uploadBufferSubData(scene, BUFFER_NAME, range.m_begin * sizeof(MaterialData), (range.m_end - range.m_begin) * sizeof(MaterialData), table.m_records.data() + range.m_begin);
+			table.m_numUploadedRecords += range.m_end - range.m_begin;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void bindMaterialTable(Scene::Scene& scene)
+	{
+		Scene::bindBuffer(scene, BUFFER_NAME);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validate()
+	{
+		bool passed = true;
+		auto check = [&](bool condition, std::string const& name)
+		{
+			Debug::log_info() << "  - " << name << ": " << (condition ? "passed" : "FAILED") << Debug::end;
+			passed &= condition;
+		};
+
+		Debug::log_info() << "Material table validation" << Debug::end;
+
+		// Layout metadata
+		check(MaterialData_meta.alignment == 16 && MaterialData_meta.members.size() == 12, "record layout metadata");
+
+		// Packing of a default material
+		GPU::Material material;
+		MaterialData record = packMaterial(material, true, true);
+		check(record.m_flags == 0 && record.m_opacity == material.m_opacity && record.m_roughness == material.m_roughness, "default material packing");
+
+		// Packing of a fully textured material, with the global toggles on and off
+		material.m_twoSided = true;
+		material.m_diffuseMap = "albedo";
+		material.m_normalMap = "normal";
+		material.m_specularMap = "specular";
+		material.m_alphaMap = "alpha";
+		material.m_displacementMap = "displacement";
+		material.m_metallicMask = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		record = packMaterial(material, true, true);
+		check(record.m_flags == (TwoSided | AlbedoMap | NormalMap | SpecularMap | AlphaMap | DisplacementMap) && record.m_metallicMask == material.m_metallicMask, "textured material packing");
+		record = packMaterial(material, false, false);
+		check(record.m_flags == (TwoSided | AlbedoMap | SpecularMap | DisplacementMap), "global map toggles");
+
+		// Registration
+		Table table;
+		const uint32_t firstId = registerMaterial(table, "first");
+		const uint32_t secondId = registerMaterial(table, "second");
+		check(firstId == 0 && secondId == 1 && registerMaterial(table, "first") == 0 && table.m_records.size() == 2, "material registration");
+		check(collectDirtyRanges(table).size() == 1 && collectDirtyRanges(table).empty(), "new records are dirty once");
+
+		// Change detection
+		const MaterialData unchanged = table.m_records[firstId];
+		MaterialData changed = unchanged;
+		changed.m_roughness += 0.5f;
+		check(!updateRecord(table, firstId, unchanged) && updateRecord(table, firstId, changed) && table.m_dirty[firstId] && !table.m_dirty[secondId], "change detection");
+
+		// Range merging
+		for (size_t i = table.m_records.size(); i < 40; ++i)
+			registerMaterial(table, "material_" + std::to_string(i));
+		collectDirtyRanges(table);
+		for (uint32_t id : { 1, 2, 3, 10, 12, 30 })
+			table.m_dirty[id] = 1;
+		std::vector<DirtyRange> ranges = collectDirtyRanges(table, 1);
+		check(ranges.size() == 3 &&
+			ranges[0].m_begin == 1 && ranges[0].m_end == 4 &&
+			ranges[1].m_begin == 10 && ranges[1].m_end == 13 &&
+			ranges[2].m_begin == 30 && ranges[2].m_end == 31, "dirty range merging");
+		for (uint32_t id : { 10, 12 })
+			table.m_dirty[id] = 1;
+		ranges = collectDirtyRanges(table, 0);
+		check(ranges.size() == 2 && ranges[0].m_end == 11 && ranges[1].m_begin == 12, "dirty ranges without merging");
+		check(collectDirtyRanges(table).empty(), "dirty flags cleared");
+
+		// Synchronization with a material map
+		std::unordered_map<std::string, GPU::Material> materials;
+		materials["first"] = material;
+		materials["new"] = GPU::Material();
+		Table syncTable;
+		syncMaterials(syncTable, materials, true, true);
+		collectDirtyRanges(syncTable);
+		syncMaterials(syncTable, materials, true, true);
+		const bool unchangedSync = collectDirtyRanges(syncTable).empty();
+		materials["new"].m_opacity = 0.5f;
+		syncMaterials(syncTable, materials, true, true);
+		const bool unreportedSync = collectDirtyRanges(syncTable).empty();
+		markMaterialChanged(syncTable, "new");
+		syncMaterials(syncTable, materials, true, true);
+		ranges = collectDirtyRanges(syncTable, 0);
+		check(unchangedSync && unreportedSync && ranges.size() == 1 && ranges[0].m_begin == syncTable.m_ids["new"] && ranges[0].m_end == ranges[0].m_begin + 1, "material synchronization");
+		syncMaterials(syncTable, materials, false, true);
+		check(collectDirtyRanges(syncTable, 0).size() == 1, "global toggle changes");
+
+		// Removal, and reuse of the released ids
+		const uint32_t removedId = syncTable.m_ids["first"];
+		materials.erase("first");
+		markMaterialChanged(syncTable, "first");
+		syncMaterials(syncTable, materials, false, true);
+		check(syncTable.m_ids.count("first") == 0 && syncTable.m_names[removedId].empty() && syncTable.m_freeIds.size() == 1, "material removal");
+		materials["third"] = GPU::Material();
+		syncMaterials(syncTable, materials, false, true);
+		check(syncTable.m_ids["third"] == removedId && syncTable.m_freeIds.empty() && syncTable.m_records.size() == 2, "released id reuse");
+
+		Debug::log_info() << "Material table validation " << (passed ? "passed" : "FAILED") << Debug::end;
+		return passed;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmark(size_t numMaterials, size_t numChangedMaterials, size_t numFrames)
+	{
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		// Synthetic materials
+		std::unordered_map<std::string, GPU::Material> materials;
+		std::vector<std::string> names(numMaterials);
+		for (size_t i = 0; i < numMaterials; ++i)
+		{
+			names[i] = "material_" + std::to_string(i);
+			GPU::Material& material = materials[names[i]];
+			material.m_name = names[i];
+			material.m_diffuse = glm::vec3(unit(generator), unit(generator), unit(generator));
+			material.m_roughness = unit(generator);
+			material.m_metallic = unit(generator);
+			if (unit(generator) < 0.5f) material.m_diffuseMap = names[i] + "_albedo";
+		}
+
+		// Initial build
+		Table table;
+		DateTime::Timer buildTimer(true);
+		syncMaterials(table, materials, true, true);
+		const size_t numInitialRanges = collectDirtyRanges(table).size();
+		buildTimer.stop();
+
+		// Steady state, with a few materials changing every frame
+		size_t numUploadedRecords = 0, numUploadRanges = 0;
+		std::uniform_int_distribution<size_t> materialDistribution(0, numMaterials - 1);
+		DateTime::Timer updateTimer(true);
+		for (size_t frameId = 0; frameId < numFrames; ++frameId)
+		{
+			for (size_t i = 0; i < numChangedMaterials; ++i)
+			{
+				std::string const& name = names[materialDistribution(generator)];
+				materials[name].m_roughness = unit(generator);
+				markMaterialChanged(table, name);
+			}
+
+			syncMaterials(table, materials, true, true);
+			for (auto const& range : collectDirtyRanges(table))
+			{
+				numUploadedRecords += range.m_end - range.m_begin;
+				++numUploadRanges;
+			}
+		}
+		updateTimer.stop();
+
+		const double buildTime = buildTimer.getElapsedTime() * 1000.0;
+		const double updateTime = updateTimer.getElapsedTime() * 1000.0 / double(numFrames);
+		Debug::log_info() << "Material table benchmark (" << numMaterials << " materials, " << numChangedMaterials << " changes per frame, " << numFrames << " frames)" << Debug::end;
+		Debug::log_info() << "  - initial build: " << buildTime << " ms, " << numInitialRanges << " upload range(s), " << Units::bytesToString(numMaterials * sizeof(MaterialData)) << Debug::end;
+		Debug::log_info() << "  - per-frame update: " << updateTime << " ms, " << double(numUploadRanges) / double(numFrames) << " upload ranges, "
+			<< Units::bytesToString(numUploadedRecords * sizeof(MaterialData) / numFrames) << " uploaded" << Debug::end;
+		Debug::log_info() << "  - previous path: 15 glUniform calls per material switch, " << 15 * numMaterials << " calls per frame if every material is drawn" << Debug::end;
+	}
+}
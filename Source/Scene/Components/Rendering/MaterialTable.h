@@ -0,0 +1,157 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+//  Headers
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PCH.h"
+#include "Common.h"
+
+namespace MaterialTable
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/** Name of the GPU buffer holding the table. */
+	static const std::string BUFFER_NAME = "MaterialTable";
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Per-material flags, packed into MaterialData::m_flags. */
+	meta_enum(MaterialFlag, int,
+		TwoSided = 1,
+		AlbedoMap = 2,
+		NormalMap = 4,
+		SpecularMap = 8,
+		AlphaMap = 16,
+		DisplacementMap = 32
+	);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** GPU record of a single material; matches the MaterialData struct of material.glsl. */
+	make_gpu_struct(MaterialData, std430,
+		(glm::vec3, m_albedoTint)(float, m_opacity)
+		(glm::vec3, m_emissiveColor)(float, m_metallic)
+		(glm::vec4, m_specularMask)
+		(glm::vec4, m_roughnessMask)
+		(glm::vec4, m_metallicMask)
+		(float, m_roughness)(float, m_specular)(float, m_normalMapStrength)(float, m_displacementScale)
+		(GLuint, m_flags)
+	);
+
+	// The array stride of the shader-side struct, and the packed scalars after the vec3s
+	static_assert(sizeof(MaterialData) == 112, "MaterialData must match the std430 array stride of the shader struct.");
+	static_assert(offsetof(MaterialData, m_opacity) == 12, "Scalars must pack into the tail of the preceding vec3.");
+	static_assert(offsetof(MaterialData, m_metallic) == 28, "Scalars must pack into the tail of the preceding vec3.");
+	static_assert(offsetof(MaterialData, m_specularMask) == 32, "Unexpected MaterialData layout.");
+	static_assert(offsetof(MaterialData, m_roughness) == 80, "Unexpected MaterialData layout.");
+	static_assert(offsetof(MaterialData, m_flags) == 96, "Unexpected MaterialData layout.");
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A contiguous range of records, [m_begin, m_end). */
+	struct DirtyRange
+	{
+		uint32_t m_begin = 0;
+		uint32_t m_end = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** CPU side of the material table. */
+	struct Table
+	{
+		// Id of each material in the table
+		std::unordered_map<std::string, uint32_t> m_ids;
+
+		// Name of each material, indexed by its id
+		std::vector<std::string> m_names;
+
+		// Packed records, mirroring the GPU buffer
+		std::vector<MaterialData> m_records;
+
+		// Whether each record changed since the last upload
+		std::vector<uint8_t> m_dirty;
+
+		// Ids released by removed materials, reused by the next registrations
+		std::vector<uint32_t> m_freeIds;
+
+		// Materials whose source changed since the last synchronization
+		std::unordered_set<std::string> m_changedMaterials;
+
+		// Whether every material must be repacked at the next synchronization
+		bool m_syncAll = true;
+
+		// Global map toggles of the last synchronization
+		bool m_alphaMapsEnabled = true;
+		bool m_normalMapsEnabled = true;
+
+		// Number of records that fit into the GPU buffer
+		size_t m_gpuCapacity = 0;
+
+		// Statistics of the last upload
+		size_t m_numUploadedRecords = 0;
+		size_t m_numUploadRanges = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Packs the parameter material into its GPU record. The map flags honor the global alpha and normal map toggles. */
+	MaterialData packMaterial(GPU::Material const& material, bool alphaMapsEnabled, bool normalMapsEnabled);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Id of the parameter material, appending it to the table if needed. */
+	uint32_t registerMaterial(Table& table, std::string const& name);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Removes the parameter material from the table, and frees its id for reuse. */
+	void releaseMaterial(Table& table, std::string const& name);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Stores the parameter record, and marks it dirty if it differs from the stored one. Returns whether it changed. */
+	bool updateRecord(Table& table, uint32_t id, MaterialData const& record);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Marks every record as dirty. */
+	void markAllDirty(Table& table);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Merges the dirty records into ranges, bridging gaps of at most maxGap clean records, and clears the dirty flags. */
+	std::vector<DirtyRange> collectDirtyRanges(Table& table, size_t maxGap = 4);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Reports that the source of the parameter material was edited, loaded or removed. */
+	void markMaterialChanged(Table& table, std::string const& name);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Requests a full synchronization, for bulk changes of the scene materials. */
+	void markAllMaterialsChanged(Table& table);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Repacks the materials that were reported as changed, and drops the entries of the ones that no longer exist.
+		Every material is repacked if a full synchronization was requested, the global toggles changed, or materials
+		were added or removed without being reported. Only the records that changed are marked dirty. */
+	void syncMaterials(Table& table, std::unordered_map<std::string, GPU::Material> const& materials, bool alphaMapsEnabled, bool normalMapsEnabled);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Accesses the material table of the scene. */
+	Table& getMaterialTable(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Reports a change of the parameter scene material to the material table of the scene, if it exists yet. */
+	void markMaterialChanged(Scene::Scene& scene, std::string const& name);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Requests a full synchronization of the material table of the scene, if it exists yet. */
+	void markAllMaterialsChanged(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Synchronizes the table with the scene materials, and uploads the changed records. */
+	void updateMaterialTable(Scene::Scene& scene, Scene::Object* renderSettings);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Binds the material table buffer. */
+	void bindMaterialTable(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the record packing and the dirty range tracking, and logs the results. Returns whether all the checks passed. */
+	bool validate();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Measures the per-frame CPU cost of keeping a table of synthetic materials in sync, and logs the results. */
+	void benchmark(size_t numMaterials = 5000, size_t numChangedMaterials = 50, size_t numFrames = 100);
+}
@@ -32,7 +32,8 @@ namespace Mesh
 			RenderSettings::NormalMappingMethod_meta,
 			RenderSettings::DisplacementMappingMethod_meta,
 			ShadowMap::ShadowMapComponent::ShadowMapPrecision_meta,
-			ShadowMap::ShadowMapComponent::ShadowMapAlgorithm_meta
+			ShadowMap::ShadowMapComponent::ShadowMapAlgorithm_meta,
+			MaterialTable::MaterialFlag_meta
 		);
 
 		// Depth pre-pass
@@ -86,9 +87,10 @@ namespace Mesh
 		// Name of the mesh
 		std::string const& meshName = object->component<Mesh::MeshComponent>().m_meshName;
 		bool valid = isMeshValid(scene, object);
+		bool meshChanged = object->component<Mesh::MeshComponent>().m_lastMeshName != meshName;
 
 		// Extract the new material names
-		if (valid && object->component<Mesh::MeshComponent>().m_lastMeshName != meshName)
+		if (valid && meshChanged)
 		{
 			updateMaterialList(scene, object);
 		}
@@ -101,6 +103,18 @@ namespace Mesh
 		{
 			RenderSettings::updateVoxelGrid(scene);
 		}
+
+		// Invalidate the shadow map slices that the mesh left or entered
+		if (valid && meshChanged)
+		{
+			RenderSettings::updateShadowMaps(scene);
+			object->component<Mesh::MeshComponent>().m_shadowAabb = scene.m_meshes[meshName].m_aabb.transform(Transform::getModelMatrix(object));
+		}
+		else if (valid && object->component<Transform::TransformComponent>().m_transformChanged)
+		{
+			const BVH::AABB aabb = scene.m_meshes[meshName].m_aabb.transform(Transform::getModelMatrix(object));
+			ShadowMap::moveOccluder(scene, object->component<Mesh::MeshComponent>().m_shadowAabb, aabb);
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -130,6 +144,11 @@ namespace Mesh
 	////////////////////////////////////////////////////////////////////////////////
 	bool isMeshVisible(Scene::Scene& scene, Scene::Object* object, Scene::Object* camera)
 	{
+		// Use the results of the visibility pass, if the camera was part of it
+		Visibility::VisibilityCache const& cache = Visibility::getVisibilityCache(scene);
+		if (Visibility::ViewVisibility const* view = Visibility::findView(cache, camera); view != nullptr)
+			return Visibility::findObject(cache, *view, object) != nullptr;
+
 		return isAABBVisible(
 			camera->component<Camera::CameraComponent>().m_viewFrustum, 
 			Transform::getModelMatrix(object), 
@@ -193,55 +212,280 @@ namespace Mesh
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
+	// Non-owning list of submesh ids to render
+	struct SubmeshRange
+	{
+		uint32_t const* m_begin = nullptr;
+		uint32_t const* m_end = nullptr;
+
+		uint32_t const* begin() const { return m_begin; }
+		uint32_t const* end() const { return m_end; }
+		bool empty() const { return m_begin == m_end; }
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Collects the submeshes of the object to render into the parameter view, sorted by material. The lists of the visibility
+	// pass are referenced directly if the view was part of it; otherwise the submeshes are culled into the scratch storage.
+	// A null frustum disables culling.
+	SubmeshRange collectSubmeshes(Scene::Scene& scene, Scene::Object* viewOwner, int sliceId, BVH::Frustum const* frustum, Scene::Object* object, std::vector<uint32_t>& scratch)
+	{
+		// Use the visible submesh list of the view, if available
+		Visibility::VisibilityCache const& cache = Visibility::getVisibilityCache(scene);
+		if (Visibility::ViewVisibility const* view = frustum ? Visibility::findView(cache, viewOwner, sliceId) : nullptr; view != nullptr)
+		{
+			Visibility::VisibleObject const* visibleObject = Visibility::findObject(cache, *view, object);
+			if (visibleObject == nullptr || visibleObject->m_numSubmeshes == 0) return SubmeshRange{};
+
+			uint32_t const* first = view->m_submeshes.data() + visibleObject->m_firstSubmesh;
+			return SubmeshRange{ first, first + visibleObject->m_numSubmeshes };
+		}
+
+		// Reference the material order of the visibility pass if no culling is needed
+		auto const& mesh = scene.m_meshes.find(object->component<Mesh::MeshComponent>().m_meshName)->second;
+		auto it = cache.m_objectIds.find(object);
+		if (it != cache.m_objectIds.end() && frustum == nullptr)
+		{
+			uint32_t const* submeshIds = cache.m_submeshIds.data();
+			return SubmeshRange{ submeshIds + cache.m_submeshOffsets[it->second], submeshIds + cache.m_submeshOffsets[it->second + 1] };
+		}
+
+		// Sort the submeshes by material, reusing the order of the visibility pass if possible
+		if (it != cache.m_objectIds.end())
+		{
+			scratch.assign(cache.m_submeshIds.begin() + cache.m_submeshOffsets[it->second], cache.m_submeshIds.begin() + cache.m_submeshOffsets[it->second + 1]);
+		}
+		else
+		{
+			scratch.resize(mesh.m_subMeshes.size());
+			std::iota(scratch.begin(), scratch.end(), 0);
+			std::stable_sort(scratch.begin(), scratch.end(), [&](uint32_t a, uint32_t b)
+			{
+				return mesh.m_subMeshes[a].m_materialId < mesh.m_subMeshes[b].m_materialId;
+			});
+		}
+
+		// Cull them against the frustum
+		if (frustum != nullptr)
+		{
+			const glm::mat4 model = Transform::getModelMatrix(object);
+			scratch.erase(std::remove_if(scratch.begin(), scratch.end(), [&](uint32_t submeshId)
+			{
+				return !isAABBVisible(*frustum, model, mesh.m_subMeshes[submeshId].m_aabb);
+			}), scratch.end());
+		}
+		return SubmeshRange{ scratch.data(), scratch.data() + scratch.size() };
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Passes of the mesh draw packets
+	enum MeshDrawPass : uint32_t
+	{
+		DRAW_PASS_DEPTH_PREPASS,
+		DRAW_PASS_GBUFFER_BASEPASS,
+		DRAW_PASS_VOXEL_BASEPASS,
+		DRAW_PASS_SHADOW_MAP,
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// View that the draw packets are built for
+	struct DrawView
+	{
+		// Pass of the packets
+		MeshDrawPass m_pass;
+
+		// View matrix and depth range, for the depth buckets
+		glm::mat4 m_view = glm::mat4(1.0f);
+		float m_near = 0.0f;
+		float m_far = 0.0f;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	DrawView cameraDrawView(MeshDrawPass pass, Scene::Object* camera)
+	{
+		DrawView result;
+		result.m_pass = pass;
+		result.m_view = Camera::getViewMatrix(camera);
+		result.m_near = camera->component<Camera::CameraComponent>().m_near;
+		result.m_far = camera->component<Camera::CameraComponent>().m_far;
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// An object whose packets were added to the draw lists of the current pass
+	struct DrawObject
+	{
+		// The object and its mesh
+		Scene::Object* m_object = nullptr;
+		GPU::Mesh const* m_mesh = nullptr;
+
+		// Offset of the object's material slots in the material arrays
+		uint32_t m_firstMaterial = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Storage for building the draw packets of a pass. Every object of the pass adds its packets to the list of each
+	// view it is visible in, and the lists are sorted and submitted once per view when the pass ends. The storage is
+	// reused between the passes and frames.
+	struct DrawPacketStorage
+	{
+		// Program bound for the pass, whose name goes into the shader field of the sort keys
+		GLuint m_program = 0;
+
+		// Views of the pass, and the draw list of each view
+		std::vector<DrawView> m_views;
+		std::vector<DrawPackets::DrawList> m_drawLists;
+
+		// Objects referenced by the packets
+		std::vector<DrawObject> m_objects;
+
+		// Material of each material slot of the objects, and its id in the material table
+		std::vector<GPU::Material const*> m_materials;
+		std::vector<uint32_t> m_materialHandles;
+
+		// Scratch storage for the submeshes of the current object, when they are culled here
+		std::vector<uint32_t> m_submeshIds;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	DrawPacketStorage& getDrawPacketStorage(Scene::Scene& scene, Scene::Object* renderSettings)
+	{
+		return RenderSettings::renderPayload<DrawPacketStorage>(scene, renderSettings, RenderSettings::renderPayloadCategory({ "Mesh", "DrawPackets" }), true);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Starts collecting the packets of a new pass, with the parameter number of views; must be called after binding the
+	// shader of the pass
+	DrawPacketStorage& beginDrawLists(Scene::Scene& scene, Scene::Object* renderSettings, size_t numViews)
+	{
+		DrawPacketStorage& storage = getDrawPacketStorage(scene, renderSettings);
+
+		GLint program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		storage.m_program = GLuint(program);
+
+		storage.m_views.assign(numViews, DrawView{});
+		storage.m_drawLists.resize(numViews);
+		for (auto& drawList : storage.m_drawLists)
+			DrawPackets::reset(drawList);
+		storage.m_objects.clear();
+		storage.m_materials.clear();
+		storage.m_materialHandles.clear();
+		return storage;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Registers the parameter object with the draw lists, and looks up its materials in the material table; the table
+	// was synchronized with the scene materials before rendering, so slots whose material is unknown have no uploaded
+	// record and are skipped. Returns the id of the object in the packets.
+	uint32_t addDrawObject(Scene::Scene& scene, DrawPacketStorage& storage, Scene::Object* object)
+	{
+		auto const& materialNames = object->component<Mesh::MeshComponent>().m_materials;
+		MaterialTable::Table const& materialTable = MaterialTable::getMaterialTable(scene);
+
+		DrawObject drawObject;
+		drawObject.m_object = object;
+		drawObject.m_mesh = &scene.m_meshes.find(object->component<Mesh::MeshComponent>().m_meshName)->second;
+		drawObject.m_firstMaterial = uint32_t(storage.m_materials.size());
+		for (auto const& materialName : materialNames)
+		{
+			auto materialIt = scene.m_materials.find(materialName);
+			auto idIt = materialTable.m_ids.find(materialName);
+			const bool hasRecord = materialIt != scene.m_materials.end() && idIt != materialTable.m_ids.end();
+			storage.m_materials.push_back(hasRecord ? &materialIt->second : nullptr);
+			storage.m_materialHandles.push_back(hasRecord ? idIt->second : 0);
+		}
+
+		storage.m_objects.push_back(drawObject);
+		return uint32_t(storage.m_objects.size() - 1);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Adds the packets of the parameter submeshes that pass the filter to the draw list of the view
 	template<typename P>
-	void renderMesh(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, Scene::Object* object, P const& pred)
+	void addDrawPackets(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, 
+		DrawPacketStorage& storage, uint32_t objectId, size_t viewId, SubmeshRange const& submeshIds, P const& pred)
 	{
-		// Extract the mesh
-		auto const& mesh = scene.m_meshes[object->component<Mesh::MeshComponent>().m_meshName];
+		DrawObject const& drawObject = storage.m_objects[objectId];
+		DrawView const& view = storage.m_views[viewId];
+		DrawPackets::DrawList& drawList = storage.m_drawLists[viewId];
+		GPU::Mesh const& mesh = *drawObject.m_mesh;
 
-		// Extract the submeshes and sort them by material
-		std::vector<GPU::SubMesh> sortedSubMeshes = mesh.m_subMeshes;
-		std::sort(sortedSubMeshes.begin(), sortedSubMeshes.end(), [](GPU::SubMesh const& a, GPU::SubMesh const& b)
+		const glm::mat4 viewModel = view.m_view * Transform::getModelMatrix(drawObject.m_object);
+		for (uint32_t submeshId : submeshIds)
 		{
-			return a.m_materialId < b.m_materialId;
-		});
+			auto const& subMesh = mesh.m_subMeshes[submeshId];
+			const uint32_t slot = drawObject.m_firstMaterial + subMesh.m_materialId;
+			if (storage.m_materials[slot] == nullptr) continue;
+			auto const& material = *storage.m_materials[slot];
+			if (!pred(SubmeshFilterParams(scene, simulationSettings, renderSettings, camera, drawObject.m_object, mesh, subMesh, material))) continue;
+
+			const float depth = -(viewModel * glm::vec4(subMesh.m_aabb.getCenter(), 1.0f)).z;
+			const uint64_t key = DrawPackets::makeSortKey(view.m_pass, storage.m_program, storage.m_materialHandles[slot], DrawPackets::depthBucket(depth, view.m_near, view.m_far));
+			DrawPackets::addPacket(drawList, key, objectId, submeshId);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Sorts the draw list of the view, then submits it; the per-object uniforms are uploaded with the parameter
+	// callback whenever the object changes
+	template<typename U>
+	void submitDrawList(Scene::Scene& scene, Scene::Object* renderSettings, DrawPacketStorage& storage, size_t viewId, U const& uploadObjectUniforms)
+	{
+		DrawPackets::DrawList& drawList = storage.m_drawLists[viewId];
+		if (drawList.m_packets.empty()) return;
+
+		// Sort them by material, then front to back, and find the redundant state changes
+		DrawPackets::finalize(drawList);
 
-		// Index of the last used material
-		size_t lastMaterialId = -1;
+		MaterialTable::Table const& materialTable = MaterialTable::getMaterialTable(scene);
 
 		// Get the initial face culling state
 		GLboolean cullFace = false;
 		glGetBooleanv(GL_CULL_FACE, &cullFace);
 
-		// Render the mesh
-		glBindVertexArray(mesh.m_vao);
-		for (size_t submeshId = 0; submeshId < sortedSubMeshes.size(); ++submeshId)
+		// Global material settings
+		glUniform1ui(10, renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_normalMapping);
+		glUniform1ui(11, renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_displacementMapping);
+
+		// Render the packets
+		GLuint boundVao = 0;
+		for (auto const& packet : drawList.m_packets)
 		{
-			// Extract the relevant submesh and material
-			auto const& subMesh = sortedSubMeshes[submeshId];
-			auto const& material = scene.m_materials[object->component<Mesh::MeshComponent>().m_materials[subMesh.m_materialId]];
+			// Extract the relevant object and submesh
+			DrawObject const& drawObject = storage.m_objects[packet.m_objectId];
+			auto const& subMesh = drawObject.m_mesh->m_subMeshes[packet.m_submeshId];
 
-			// Apply the submesh filter
-			if (!pred(SubmeshFilterParams(scene, simulationSettings, renderSettings, camera, object, mesh, subMesh, material))) continue;
+			// Select the object
+			if (packet.m_stateChanges & DrawPackets::CHANGE_OBJECT)
+			{
+				uploadObjectUniforms(scene, renderSettings, drawObject.m_object);
+
+				if (drawObject.m_mesh->m_vao != boundVao)
+				{
+					boundVao = drawObject.m_mesh->m_vao;
+					glBindVertexArray(boundVao);
+				}
+			}
 
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Submesh #" + std::to_string(submeshId) + " (" + subMesh.m_name + ")");
+			Profiler::ScopedGpuPerfCounter perfCounter(scene, subMesh.m_profilerName);
 
-			// Upload the material uniforms
-			if (subMesh.m_materialId != lastMaterialId)
+			// Select the material
+			if (packet.m_stateChanges & DrawPackets::CHANGE_MATERIAL)
 			{
 				Profiler::ScopedGpuPerfCounter perfCounter(scene, "Material Uniforms");
 
-				// Upload the material data
-				auto const& material = scene.m_materials[object->component<Mesh::MeshComponent>().m_materials[subMesh.m_materialId]];
+				// The parameters themselves live in the material table
+				const uint32_t materialId = DrawPackets::keyMaterial(packet.m_key);
+				glUniform1ui(0, materialId);
 
+				auto const& material = *storage.m_materials[drawObject.m_firstMaterial + subMesh.m_materialId];
+				const GLuint flags = materialTable.m_records[materialId].m_flags;
 				const bool twoSided = material.m_twoSided;
-				const bool hasDiffuseMap = !material.m_diffuseMap.empty() && material.m_diffuseMap != "default_diffuse_map";
-				const bool hasSpecularMap = !material.m_specularMap.empty() && material.m_specularMap != "default_specular_map";
-				const bool hasAlphaMap = !material.m_alphaMap.empty() && material.m_alphaMap != "default_alpha_map" &&
-					renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_transparencyMethod != RenderSettings::DisableTransparency;
-				const bool hasNormalMap = !material.m_normalMap.empty() && material.m_normalMap != "default_normal_map" &&
-					renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_normalMapping != RenderSettings::DisableNormalMapping;
-				const bool hasDisplacementMap = !material.m_displacementMap.empty() && material.m_displacementMap != "default_displacement_map";
+				const bool hasDiffuseMap = (flags & MaterialTable::AlbedoMap) != 0;
+				const bool hasSpecularMap = (flags & MaterialTable::SpecularMap) != 0;
+				const bool hasAlphaMap = (flags & MaterialTable::AlphaMap) != 0;
+				const bool hasNormalMap = (flags & MaterialTable::NormalMap) != 0;
+				const bool hasDisplacementMap = (flags & MaterialTable::DisplacementMap) != 0;
 
 				// Set backface culling
 				if (!twoSided && cullFace)
@@ -249,24 +493,6 @@ namespace Mesh
 				else
 					glDisable(GL_CULL_FACE);
 
-				#define BOOLF(B) (B ? 1.0f : 0.0f)
-
-				glUniform4f(0, BOOLF(twoSided), BOOLF(hasDiffuseMap), BOOLF(hasNormalMap), BOOLF(hasSpecularMap));
-				glUniform4f(1, BOOLF(hasAlphaMap), BOOLF(hasDisplacementMap), 0.0f, 0.0f);
-				glUniform3fv(2, 1, glm::value_ptr(material.m_diffuse));
-				glUniform3fv(3, 1, glm::value_ptr(material.m_emissive));
-				glUniform1f(4, material.m_opacity);
-				glUniform1f(5, material.m_metallic);
-				glUniform1f(6, material.m_roughness);
-				glUniform1f(7, material.m_specular);
-				glUniform1f(8, material.m_normalMapStrength);
-				glUniform1f(9, material.m_displacementScale);
-				glUniform1ui(10, renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_normalMapping);
-				glUniform1ui(11, renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_displacementMapping);
-				glUniform4fv(12, 1, glm::value_ptr(material.m_specularMask));
-				glUniform4fv(13, 1, glm::value_ptr(material.m_roughnessMask));
-				glUniform4fv(14, 1, glm::value_ptr(material.m_metallicMask));
-
 				// Bind the textures
 				if (hasDiffuseMap)
 				{
@@ -299,17 +525,50 @@ namespace Mesh
 				}
 			}
 
-			// Render the mesh
+			// Render the submesh
 			{
 				Profiler::ScopedGpuPerfCounter perfCounter(scene, "Render");
 
 				glDrawElementsBaseVertex(GL_TRIANGLES, subMesh.m_indexCount, GL_UNSIGNED_INT, (const void*)(subMesh.m_indexStartID * sizeof(GL_UNSIGNED_INT)), subMesh.m_vertexStartID);
 			}
-
-			// Update the last material id
-			lastMaterialId = subMesh.m_materialId;
 		}
 		glBindVertexArray(0);
+
+		// Restore the face culling state
+		if (cullFace)
+			glEnable(GL_CULL_FACE);
+		else
+			glDisable(GL_CULL_FACE);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void uploadDepthPrepassObjectUniforms(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object)
+	{
+		Profiler::ScopedGpuPerfCounter perfCounter(scene, "Model Uniforms");
+
+		// Upload the model uniforms
+		glm::mat4 model = Transform::getModelMatrix(object);
+		glm::mat4 prevModel = Transform::getPrevModelMatrix(object);
+		glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
+		glUniformMatrix4fv(17, 1, GL_FALSE, glm::value_ptr(prevModel));
+		glUniform1f(18, object->component<MeshComponent>().m_meshToUv);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void uploadGbufferBasePassObjectUniforms(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object)
+	{
+		Profiler::ScopedGpuPerfCounter perfCounter(scene, "Model Uniforms");
+
+		// Upload the model uniforms
+		const glm::mat4 model = Transform::getModelMatrix(object);
+		const glm::mat4 normal = Transform::getNormalMatrix(object);
+		const glm::mat4 prevModel = Transform::getPrevModelMatrix(object);
+		const glm::mat4 prevNormal = Transform::getPrevNormalMatrix(object);
+		glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
+		glUniformMatrix4fv(17, 1, GL_FALSE, glm::value_ptr(normal));
+		glUniformMatrix4fv(18, 1, GL_FALSE, glm::value_ptr(prevModel));
+		glUniformMatrix4fv(19, 1, GL_FALSE, glm::value_ptr(prevNormal));
+		glUniform1f(20, object->component<MeshComponent>().m_meshToUv);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -336,21 +595,27 @@ namespace Mesh
 
 		// Bind the corresponding shader
 		Scene::bindShader(scene, "Mesh", "depth_prepass");
+		MaterialTable::bindMaterialTable(scene);
+
+		// Collect the packets of the camera view
+		DrawPacketStorage& storage = beginDrawLists(scene, renderSettings, 1);
+		storage.m_views[0] = cameraDrawView(DRAW_PASS_DEPTH_PREPASS, camera);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	void depthPrepassEndOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName)
 	{
-		Mesh::gbufferBasePassEndOpenGL(scene, simulationSettings, renderSettings, camera, functionName);
+		// Render the packets of every object at once
+		submitDrawList(scene, renderSettings, getDrawPacketStorage(scene, renderSettings), 0, uploadDepthPrepassObjectUniforms);
+
+		// Reset the polygon mode
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	bool depthPrepassSubmeshFilter(SubmeshFilterParams const& params)
 	{
 		return 
-			// Visibility test for the camera frustum
-			isAABBVisible(params.m_camera->component<Camera::CameraComponent>().m_viewFrustum, Transform::getModelMatrix(params.m_object), params.m_subMesh.m_aabb) &&
-
 			// Ignore invisible submeshes
 			params.m_material.m_opacity >= 0.01f &&
 		
@@ -361,22 +626,11 @@ namespace Mesh
 	////////////////////////////////////////////////////////////////////////////////
 	void depthPrepassOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName, Scene::Object* object)
 	{
-		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Model Uniforms");
-
-			// Upload the model uniforms
-			glm::mat4 model = Transform::getModelMatrix(object);
-			glm::mat4 prevModel = Transform::getPrevModelMatrix(object);
-			glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
-			glUniformMatrix4fv(17, 1, GL_FALSE, glm::value_ptr(prevModel));
-			glUniform1f(18, object->component<MeshComponent>().m_meshToUv);
-		}
-
-		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Render");
-
-			renderMesh(scene, simulationSettings, renderSettings, camera, object, depthPrepassSubmeshFilter);
-		}
+		// Add the packets of the object to the draw list of the camera
+		DrawPacketStorage& storage = getDrawPacketStorage(scene, renderSettings);
+		const SubmeshRange submeshIds = collectSubmeshes(scene, camera, -1, &camera->component<Camera::CameraComponent>().m_viewFrustum, object, storage.m_submeshIds);
+		if (submeshIds.empty()) return;
+		addDrawPackets(scene, simulationSettings, renderSettings, camera, storage, addDrawObject(scene, storage, object), 0, submeshIds, depthPrepassSubmeshFilter);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -397,6 +651,7 @@ namespace Mesh
 	{
 		// Bind the corresponding shader
 		Scene::bindShader(scene, "Mesh", "gbuffer_basepass");
+		MaterialTable::bindMaterialTable(scene);
 
 		if (renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_wireframeMesh)
 		{
@@ -412,11 +667,18 @@ namespace Mesh
 		{
 			glEnable(GL_CULL_FACE);
 		}
+
+		// Collect the packets of the camera view
+		DrawPacketStorage& storage = beginDrawLists(scene, renderSettings, 1);
+		storage.m_views[0] = cameraDrawView(DRAW_PASS_GBUFFER_BASEPASS, camera);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	void gbufferBasePassEndOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName)
 	{
+		// Render the packets of every object at once
+		submitDrawList(scene, renderSettings, getDrawPacketStorage(scene, renderSettings), 0, uploadGbufferBasePassObjectUniforms);
+
 		// Reset the polygon mode
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	}
@@ -425,9 +687,6 @@ namespace Mesh
 	bool gbufferBasePassSubmeshFilter(SubmeshFilterParams const& params)
 	{
 		return
-			// Visibility test for the camera frustum
-			isAABBVisible(params.m_camera->component<Camera::CameraComponent>().m_viewFrustum, Transform::getModelMatrix(params.m_object), params.m_subMesh.m_aabb) &&
-
 			// Ignore invisible submeshes
 			params.m_material.m_opacity >= 0.01f;
 	}
@@ -435,26 +694,24 @@ namespace Mesh
 	////////////////////////////////////////////////////////////////////////////////
 	void gbufferBasePassOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName, Scene::Object* object)
 	{
-		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Model Uniforms");
-
-			// Upload the model uniforms
-			const glm::mat4 model = Transform::getModelMatrix(object);
-			const glm::mat4 normal = Transform::getNormalMatrix(object);
-			const glm::mat4 prevModel = Transform::getPrevModelMatrix(object);
-			const glm::mat4 prevNormal = Transform::getPrevNormalMatrix(object);
-			glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
-			glUniformMatrix4fv(17, 1, GL_FALSE, glm::value_ptr(normal));
-			glUniformMatrix4fv(18, 1, GL_FALSE, glm::value_ptr(prevModel));
-			glUniformMatrix4fv(19, 1, GL_FALSE, glm::value_ptr(prevNormal));
-			glUniform1f(20, object->component<MeshComponent>().m_meshToUv);
-		}
+		// Add the packets of the object to the draw list of the camera
+		DrawPacketStorage& storage = getDrawPacketStorage(scene, renderSettings);
+		const SubmeshRange submeshIds = collectSubmeshes(scene, camera, -1, &camera->component<Camera::CameraComponent>().m_viewFrustum, object, storage.m_submeshIds);
+		if (submeshIds.empty()) return;
+		addDrawPackets(scene, simulationSettings, renderSettings, camera, storage, addDrawObject(scene, storage, object), 0, submeshIds, gbufferBasePassSubmeshFilter);
+	}
 
-		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Render");
+	////////////////////////////////////////////////////////////////////////////////
+	void uploadVoxelBasePassObjectUniforms(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object)
+	{
+		Profiler::ScopedGpuPerfCounter perfCounter(scene, "Model Uniforms");
 
-			renderMesh(scene, simulationSettings, renderSettings, camera, object, gbufferBasePassSubmeshFilter);
-		}
+		// Upload the model uniforms
+		glm::mat4 model = Transform::getModelMatrix(object);
+		glm::mat4 normal = Transform::getNormalMatrix(object);
+		glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
+		glUniformMatrix4fv(17, 1, GL_FALSE, glm::value_ptr(normal));
+		glUniform1f(18, object->component<MeshComponent>().m_meshToUv);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -475,11 +732,26 @@ namespace Mesh
 	{
 		// Bind the corresponding shader
 		Scene::bindShader(scene, "Mesh", "voxel_basepass");
+		MaterialTable::bindMaterialTable(scene);
+
+		// Collect the packets of the voxel grid; the packets are not depth sorted
+		DrawPacketStorage& storage = beginDrawLists(scene, renderSettings, 1);
+		storage.m_views[0].m_pass = DRAW_PASS_VOXEL_BASEPASS;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	void voxelBasePassEndOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName)
 	{
+		// Upload the voxel grid uniforms
+		glUniformMatrix4fv(19, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_voxelMatrices[0]));
+		glUniformMatrix4fv(20, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_voxelMatrices[1]));
+		glUniformMatrix4fv(21, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_voxelMatrices[2]));
+		glUniformMatrix4fv(22, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_inverseVoxelMatrices[0]));
+		glUniformMatrix4fv(23, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_inverseVoxelMatrices[1]));
+		glUniformMatrix4fv(24, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_inverseVoxelMatrices[2]));
+
+		// Render the packets of every object at once
+		submitDrawList(scene, renderSettings, getDrawPacketStorage(scene, renderSettings), 0, uploadVoxelBasePassObjectUniforms);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -491,28 +763,20 @@ namespace Mesh
 	////////////////////////////////////////////////////////////////////////////////
 	void voxelBasePassOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName, Scene::Object* object)
 	{
-		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Model Uniforms");
-
-			// Upload the model uniforms
-			glm::mat4 model = Transform::getModelMatrix(object);
-			glm::mat4 normal = Transform::getNormalMatrix(object);
-			glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
-			glUniformMatrix4fv(17, 1, GL_FALSE, glm::value_ptr(normal));
-			glUniform1f(18, object->component<MeshComponent>().m_meshToUv);
-			glUniformMatrix4fv(19, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_voxelMatrices[0]));
-			glUniformMatrix4fv(20, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_voxelMatrices[1]));
-			glUniformMatrix4fv(21, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_voxelMatrices[2]));
-			glUniformMatrix4fv(22, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_inverseVoxelMatrices[0]));
-			glUniformMatrix4fv(23, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_inverseVoxelMatrices[1]));
-			glUniformMatrix4fv(24, 1, GL_FALSE, glm::value_ptr(renderSettings->component<RenderSettings::RenderSettingsComponent>().m_inverseVoxelMatrices[2]));
-		}
-
-		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Render");
+		// Add the packets of the object to the draw list of the voxel grid
+		DrawPacketStorage& storage = getDrawPacketStorage(scene, renderSettings);
+		const SubmeshRange submeshIds = collectSubmeshes(scene, camera, -1, nullptr, object, storage.m_submeshIds);
+		if (submeshIds.empty()) return;
+		addDrawPackets(scene, simulationSettings, renderSettings, camera, storage, addDrawObject(scene, storage, object), 0, submeshIds, voxelBasePassSubmeshFilter);
+	}
 
-			renderMesh(scene, simulationSettings, renderSettings, camera, object, voxelBasePassSubmeshFilter);
-		}
+	////////////////////////////////////////////////////////////////////////////////
+	void uploadShadowMapObjectUniforms(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* object)
+	{
+		// Upload the model uniforms
+		glm::mat4 model = Transform::getModelMatrix(object);
+		glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
+		glUniform1f(17, object->component<MeshComponent>().m_meshToUv);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -577,6 +841,7 @@ namespace Mesh
 	{
 		// Access the current shadow caster
 		Scene::Object* shadowCaster = getShadowCaster(scene, renderSettings, functionName);
+		auto& slices = shadowCaster->component<ShadowMap::ShadowMapComponent>().m_slices;
 
 		// Set the OpenGL state
 		glDepthMask(GL_TRUE);
@@ -590,6 +855,7 @@ namespace Mesh
 
 		// Bind the corresponding shader
 		Scene::bindShader(scene, "Mesh", "shadow_map");
+		MaterialTable::bindMaterialTable(scene);
 
 		// Unbind the shadow map texture, if any
 		glActiveTexture(GPU::TextureEnums::TEXTURE_SHADOW_MAP_ENUM);
@@ -597,11 +863,76 @@ namespace Mesh
 
 		// Bind the target FBO
 		glBindFramebuffer(GL_FRAMEBUFFER, scene.m_textures[shadowCaster->component<ShadowMap::ShadowMapComponent>().m_shadowMapFBO].m_framebuffer);
+
+		// Clear the slices that need to be updated, once, before any of the occluders are rendered
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClearDepth(1.0f);
+		for (auto& slice : slices)
+		{
+			if (!slice.m_needsUpdate) continue;
+
+			glViewport(slice.m_startCoords.x, slice.m_startCoords.y, slice.m_extents.x, slice.m_extents.y);
+			glScissor(slice.m_startCoords.x, slice.m_startCoords.y, slice.m_extents.x, slice.m_extents.y);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			slice.m_numRenderedOccluders = 0;
+		}
+
+		// Collect the packets of each slice
+		DrawPacketStorage& storage = beginDrawLists(scene, renderSettings, slices.size());
+		for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId)
+		{
+			auto const& transform = slices[sliceId].m_transform;
+			storage.m_views[sliceId].m_pass = DRAW_PASS_SHADOW_MAP;
+			storage.m_views[sliceId].m_view = transform.m_view;
+			storage.m_views[sliceId].m_near = transform.m_near;
+			storage.m_views[sliceId].m_far = transform.m_far;
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	void shadowMapEndOpenGL(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* renderSettings, Scene::Object* camera, std::string const& functionName)
 	{
+		// Access the current shadow caster
+		Scene::Object* shadowCaster = getShadowCaster(scene, renderSettings, functionName);
+		auto& slices = shadowCaster->component<ShadowMap::ShadowMapComponent>().m_slices;
+		DrawPacketStorage& storage = getDrawPacketStorage(scene, renderSettings);
+
+		{
+			Profiler::ScopedGpuPerfCounter perfCounter(scene, shadowCaster->m_name, true);
+
+			// Render the packets of every occluder into each slice
+			for (size_t sliceId = 0; sliceId < slices.size() && sliceId < storage.m_drawLists.size(); ++sliceId)
+			{
+				// Extract the slice
+				auto const& slice = slices[sliceId];
+				auto const& transform = slice.m_transform;
+
+				// Skip slices that don't need to be updated, or have nothing to render
+				if (!slice.m_needsUpdate || storage.m_drawLists[sliceId].m_packets.empty()) continue;
+
+				Profiler::ScopedGpuPerfCounter perfCounter(scene, "Slice " + std::to_string(sliceId));
+
+				// Configure the shadow map viewports
+				glViewport(slice.m_startCoords.x, slice.m_startCoords.y, slice.m_extents.x, slice.m_extents.y);
+				glScissor(slice.m_startCoords.x, slice.m_startCoords.y, slice.m_extents.x, slice.m_extents.y);
+
+				// Slice-specific attributes
+				glUniform1ui(18, shadowCaster->component<ShadowMap::ShadowMapComponent>().m_algorithm);
+				glUniform1ui(19, shadowCaster->component<ShadowMap::ShadowMapComponent>().m_precision);
+				glUniform2fv(20, 1, glm::value_ptr(shadowCaster->component<ShadowMap::ShadowMapComponent>().m_exponentialConstants));
+
+				// Upload the light transform
+				glUniformMatrix4fv(21, 1, GL_FALSE, glm::value_ptr(transform.m_transform));
+				glUniform1f(22, transform.m_isPerspective ? 1.0f : 0.0f);
+				glUniform1f(23, transform.m_near);
+				glUniform1f(24, transform.m_far);
+
+				// Render the occluders
+				submitDrawList(scene, renderSettings, storage, sliceId, uploadShadowMapObjectUniforms);
+			}
+		}
+
 		// Reset some of the special state
 		glDisable(GL_SCISSOR_TEST);
 		glDisable(GL_POLYGON_OFFSET_FILL);
@@ -613,9 +944,6 @@ namespace Mesh
 		auto const& ignoreMaterials = shadowCaster->component<ShadowMap::ShadowMapComponent>().m_ignoreMaterials;
 
 		return
-			// Visibility test for the camera frustum
-			isAABBVisible(slice.m_transform.m_frustum, Transform::getModelMatrix(params.m_object), params.m_subMesh.m_aabb) &&
-
 			// Ignore invisible submeshes
 			params.m_material.m_opacity >= 0.01f &&
 
@@ -628,55 +956,34 @@ namespace Mesh
 	{
 		// Access the current shadow caster
 		Scene::Object* shadowCaster = getShadowCaster(scene, renderSettings, functionName);
-		auto const& slices = shadowCaster->component<ShadowMap::ShadowMapComponent>().m_slices;
-
-		Profiler::ScopedGpuPerfCounter perfCounter(scene, shadowCaster->m_name, true);
+		auto& slices = shadowCaster->component<ShadowMap::ShadowMapComponent>().m_slices;
+		DrawPacketStorage& storage = getDrawPacketStorage(scene, renderSettings);
 
-		// Upload the model uniforms
-		glm::mat4 model = Transform::getModelMatrix(object);
-		glUniformMatrix4fv(16, 1, GL_FALSE, glm::value_ptr(model));
-		glUniform1f(17, object->component<MeshComponent>().m_meshToUv);
+		// World-space bounds of the mesh, for culling it against the slices
+		auto const& mesh = scene.m_meshes.find(object->component<Mesh::MeshComponent>().m_meshName)->second;
+		const BVH::AABB aabb = mesh.m_aabb.transform(Transform::getModelMatrix(object));
 
-		// Render to each slice of the shadow map
-		auto const& mesh = scene.m_meshes[object->component<Mesh::MeshComponent>().m_meshName];
-		glBindVertexArray(mesh.m_vao);
+		// Add the packets of the object to the draw list of each slice it is visible in
+		int objectId = -1;
 		for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId)
 		{
-			Profiler::ScopedGpuPerfCounter perfCounter(scene, "Slice " + std::to_string(sliceId));
-
 			// Extract the slice
-			auto const& slice = slices[sliceId];
+			auto& slice = slices[sliceId];
 			auto const& transform = slice.m_transform;
 
-			// Skip slices that don't need to be updated
-			if (!slice.m_needsUpdate) continue;
-
-			// Configure the shadow map viewports
-			glViewport(slice.m_startCoords.x, slice.m_startCoords.y, slice.m_extents.x, slice.m_extents.y);
-			glScissor(slice.m_startCoords.x, slice.m_startCoords.y, slice.m_extents.x, slice.m_extents.y);
-
-			// Clear the slice
-			glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-			glClearDepth(1.0f);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-			// Slice-specific attributes
-			glUniform1ui(18, shadowCaster->component<ShadowMap::ShadowMapComponent>().m_algorithm);
-			glUniform1ui(19, shadowCaster->component<ShadowMap::ShadowMapComponent>().m_precision);
-			glUniform2fv(20, 1, glm::value_ptr(shadowCaster->component<ShadowMap::ShadowMapComponent>().m_exponentialConstants));
+			// Skip slices that don't need to be updated, or that the mesh cannot cast a shadow into
+			if (!ShadowMap::rendersOccluder(slice, aabb)) continue;
+			const SubmeshRange submeshIds = collectSubmeshes(scene, shadowCaster, int(sliceId), &transform.m_frustum, object, storage.m_submeshIds);
+			if (submeshIds.empty()) continue;
+			++slice.m_numRenderedOccluders;
 
-			// Upload the light transform
-			glUniformMatrix4fv(21, 1, GL_FALSE, glm::value_ptr(transform.m_transform));
-			glUniform1f(22, transform.m_isPerspective ? 1.0f : 0.0f);
-			glUniform1f(23, transform.m_near);
-			glUniform1f(24, transform.m_far);
+			// Register the object on its first visible slice
+			if (objectId < 0) objectId = int(addDrawObject(scene, storage, object));
 
-			// Render the mesh
-			renderMesh(scene, simulationSettings, renderSettings, camera, object, [&](SubmeshFilterParams const& params)
+			addDrawPackets(scene, simulationSettings, renderSettings, camera, storage, uint32_t(objectId), sliceId, submeshIds, [&](SubmeshFilterParams const& params)
 			{
 				return shadowMapSubmeshFilter(params, shadowCaster, slice);
 			});
 		}
-		glBindVertexArray(0);
 	}
 }
\ No newline at end of file
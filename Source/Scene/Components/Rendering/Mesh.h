@@ -30,6 +30,9 @@ namespace Mesh
 
 		std::string m_lastMeshName;
 
+		// World-space bounds of the mesh, as last seen by the shadow maps
+		BVH::AABB m_shadowAabb;
+
 		// List of materials to override
 		std::vector<std::string> m_materials;
 	};
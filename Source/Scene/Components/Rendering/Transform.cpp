@@ -1,6 +1,9 @@
 #include "PCH.h"
 #include "Transform.h"
 
+#include <immintrin.h>
+#include <random>
+
 namespace Transform
 {
 	////////////////////////////////////////////////////////////////////////////////
@@ -10,18 +13,29 @@ namespace Transform
 	REGISTER_OBJECT_UPDATE_CALLBACK(ACTOR, BEFORE, INPUT);
 
 	////////////////////////////////////////////////////////////////////////////////
-	void updateObject(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object)
+	void updateTransform(TransformComponent& transform)
 	{
 		// Check if the object moved since the last frame or not
-		object->component<Transform::TransformComponent>().m_transformChanged = false;
-		object->component<Transform::TransformComponent>().m_transformChanged |= object->component<Transform::TransformComponent>().m_prevPosition != object->component<Transform::TransformComponent>().m_position;
-		object->component<Transform::TransformComponent>().m_transformChanged |= object->component<Transform::TransformComponent>().m_prevOrientation != object->component<Transform::TransformComponent>().m_orientation;
-		object->component<Transform::TransformComponent>().m_transformChanged |= object->component<Transform::TransformComponent>().m_prevScale != object->component<Transform::TransformComponent>().m_scale;
+		transform.m_transformChanged = false;
+		transform.m_transformChanged |= transform.m_prevPosition != transform.m_position;
+		transform.m_transformChanged |= transform.m_prevOrientation != transform.m_orientation;
+		transform.m_transformChanged |= transform.m_prevScale != transform.m_scale;
 
 		// Store the old position
-		object->component<Transform::TransformComponent>().m_prevPosition = object->component<Transform::TransformComponent>().m_position;
-		object->component<Transform::TransformComponent>().m_prevOrientation = object->component<Transform::TransformComponent>().m_orientation;
-		object->component<Transform::TransformComponent>().m_prevScale = object->component<Transform::TransformComponent>().m_scale;
+		transform.m_prevPosition = transform.m_position;
+		transform.m_prevOrientation = transform.m_orientation;
+		transform.m_prevScale = transform.m_scale;
+
+		// Rebuild the cached matrices if needed; the current transformation is also the previous one from now on
+		updateCachedMatrices(transform);
+		transform.m_prevModelMatrix = transform.m_modelMatrix;
+		transform.m_prevNormalMatrix = transform.m_normalMatrix;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void updateObject(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object)
+	{
+		updateTransform(object->component<Transform::TransformComponent>());
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -60,11 +74,219 @@ namespace Transform
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getModelMatrix(glm::vec3 pos, glm::vec3 orientation, glm::vec3 scale)
 	{
-		return glm::translate(pos) *
-			glm::rotate(orientation.y, glm::vec3(0.0f, 1.0f, 0.0f)) *
-			glm::rotate(orientation.x, glm::vec3(1.0f, 0.0f, 0.0f)) *
-			glm::rotate(orientation.z, glm::vec3(0.0f, 0.0f, 1.0f)) *
-			glm::scale(scale);
+		// Closed form of translate(pos) * rotateY * rotateX * rotateZ * scale(scale)
+		const glm::vec3 c = glm::cos(orientation), s = glm::sin(orientation);
+		const glm::vec3 yx0 = glm::vec3(c.y, 0.0f, -s.y);
+		const glm::vec3 yx1 = glm::vec3(s.y * s.x, c.x, c.y * s.x);
+		const glm::vec3 yx2 = glm::vec3(s.y * c.x, -s.x, c.y * c.x);
+
+		glm::mat4 result;
+		result[0] = glm::vec4((c.z * yx0 + s.z * yx1) * scale.x, 0.0f);
+		result[1] = glm::vec4((c.z * yx1 - s.z * yx0) * scale.y, 0.0f);
+		result[2] = glm::vec4(yx2 * scale.z, 0.0f);
+		result[3] = glm::vec4(pos, 1.0f);
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool hasValidCachedMatrices(TransformComponent const& transform)
+	{
+		return transform.m_modelPosition == transform.m_position &&
+			transform.m_modelOrientation == transform.m_orientation &&
+			transform.m_modelScale == transform.m_scale;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void updateCachedMatrices(TransformComponent& transform)
+	{
+		if (hasValidCachedMatrices(transform)) return;
+
+		transform.m_modelMatrix = getModelMatrix(transform.m_position, transform.m_orientation, transform.m_scale);
+		transform.m_normalMatrix = getNormalMatrix(transform.m_modelMatrix);
+		transform.m_modelPosition = transform.m_position;
+		transform.m_modelOrientation = transform.m_orientation;
+		transform.m_modelScale = transform.m_scale;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void clearTransforms(TransformArray& transforms)
+	{
+		transforms.m_components.clear();
+		for (auto attribute : { &transforms.m_positionX, &transforms.m_positionY, &transforms.m_positionZ,
+			&transforms.m_scaleX, &transforms.m_scaleY, &transforms.m_scaleZ,
+			&transforms.m_sinX, &transforms.m_sinY, &transforms.m_sinZ, &transforms.m_cosX, &transforms.m_cosY, &transforms.m_cosZ })
+			attribute->clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void appendTransform(TransformArray& transforms, TransformComponent& transform)
+	{
+		transforms.m_components.push_back(&transform);
+		transforms.m_positionX.push_back(transform.m_position.x);
+		transforms.m_positionY.push_back(transform.m_position.y);
+		transforms.m_positionZ.push_back(transform.m_position.z);
+		transforms.m_scaleX.push_back(transform.m_scale.x);
+		transforms.m_scaleY.push_back(transform.m_scale.y);
+		transforms.m_scaleZ.push_back(transform.m_scale.z);
+		transforms.m_sinX.push_back(glm::sin(transform.m_orientation.x));
+		transforms.m_sinY.push_back(glm::sin(transform.m_orientation.y));
+		transforms.m_sinZ.push_back(glm::sin(transform.m_orientation.z));
+		transforms.m_cosX.push_back(glm::cos(transform.m_orientation.x));
+		transforms.m_cosY.push_back(glm::cos(transform.m_orientation.y));
+		transforms.m_cosZ.push_back(glm::cos(transform.m_orientation.z));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace Simd
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		// SIMD_WIDTH three-component vectors, one register per coordinate
+		struct Vec3
+		{
+			__m256 x, y, z;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline Vec3 load(std::vector<float> const& x, std::vector<float> const& y, std::vector<float> const& z, size_t first)
+		{
+			return { _mm256_loadu_ps(x.data() + first), _mm256_loadu_ps(y.data() + first), _mm256_loadu_ps(z.data() + first) };
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline void store(Vec3 const& v, float (&result)[3][SIMD_WIDTH])
+		{
+			_mm256_store_ps(result[0], v.x);
+			_mm256_store_ps(result[1], v.y);
+			_mm256_store_ps(result[2], v.z);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline __m256 negate(__m256 a)
+		{
+			return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline Vec3 add(Vec3 const& a, Vec3 const& b)
+		{
+			return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z) };
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline Vec3 sub(Vec3 const& a, Vec3 const& b)
+		{
+			return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z) };
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline Vec3 scale(Vec3 const& a, __m256 b)
+		{
+			return { _mm256_mul_ps(a.x, b), _mm256_mul_ps(a.y, b), _mm256_mul_ps(a.z, b) };
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline __m256 dot(Vec3 const& a, Vec3 const& b)
+		{
+			return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y)), _mm256_mul_ps(a.z, b.z));
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		inline Vec3 cross(Vec3 const& a, Vec3 const& b)
+		{
+			return
+			{
+				_mm256_sub_ps(_mm256_mul_ps(a.y, b.z), _mm256_mul_ps(b.y, a.z)),
+				_mm256_sub_ps(_mm256_mul_ps(a.z, b.x), _mm256_mul_ps(b.z, a.x)),
+				_mm256_sub_ps(_mm256_mul_ps(a.x, b.y), _mm256_mul_ps(b.x, a.y)),
+			};
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void updateCachedMatrices(TransformArray& transforms)
+	{
+		// Pad the arrays with identity transformations, so that the SIMD loads never run past the end
+		const size_t numTransforms = transforms.m_components.size();
+		const size_t numPadded = ((numTransforms + SIMD_WIDTH - 1) / SIMD_WIDTH) * SIMD_WIDTH;
+		for (auto attribute : { &transforms.m_positionX, &transforms.m_positionY, &transforms.m_positionZ, &transforms.m_sinX, &transforms.m_sinY, &transforms.m_sinZ })
+			attribute->resize(numPadded, 0.0f);
+		for (auto attribute : { &transforms.m_scaleX, &transforms.m_scaleY, &transforms.m_scaleZ, &transforms.m_cosX, &transforms.m_cosY, &transforms.m_cosZ })
+			attribute->resize(numPadded, 1.0f);
+
+		// Columns of the model matrix, columns of the normal matrix, and the last row of the normal matrix, per lane
+		alignas(32) float columns[7][3][SIMD_WIDTH];
+		auto column = [&](size_t columnId, size_t lane) { return glm::vec3(columns[columnId][0][lane], columns[columnId][1][lane], columns[columnId][2][lane]); };
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		for (size_t first = 0; first < numPadded; first += SIMD_WIDTH)
+		{
+			const Simd::Vec3 s = Simd::load(transforms.m_sinX, transforms.m_sinY, transforms.m_sinZ, first);
+			const Simd::Vec3 c = Simd::load(transforms.m_cosX, transforms.m_cosY, transforms.m_cosZ, first);
+			const Simd::Vec3 scale = Simd::load(transforms.m_scaleX, transforms.m_scaleY, transforms.m_scaleZ, first);
+			const Simd::Vec3 translation = Simd::load(transforms.m_positionX, transforms.m_positionY, transforms.m_positionZ, first);
+
+			// Closed form of the model matrix; the same operations, in the same order, as the scalar version
+			const Simd::Vec3 yx0 = { c.y, zero, Simd::negate(s.y) };
+			const Simd::Vec3 yx1 = { _mm256_mul_ps(s.y, s.x), c.x, _mm256_mul_ps(c.y, s.x) };
+			const Simd::Vec3 yx2 = { _mm256_mul_ps(s.y, c.x), Simd::negate(s.x), _mm256_mul_ps(c.y, c.x) };
+			const Simd::Vec3 a0 = Simd::scale(Simd::add(Simd::scale(yx0, c.z), Simd::scale(yx1, s.z)), scale.x);
+			const Simd::Vec3 a1 = Simd::scale(Simd::sub(Simd::scale(yx1, c.z), Simd::scale(yx0, s.z)), scale.y);
+			const Simd::Vec3 a2 = Simd::scale(yx2, scale.z);
+
+			// Inverse transpose, using the cofactors of the upper 3x3 block
+			const Simd::Vec3 c0 = Simd::cross(a1, a2), c1 = Simd::cross(a2, a0), c2 = Simd::cross(a0, a1);
+			const __m256 invDet = _mm256_div_ps(one, Simd::dot(a0, c0));
+			const Simd::Vec3 normalTranslation =
+			{
+				_mm256_mul_ps(Simd::negate(Simd::dot(c0, translation)), invDet),
+				_mm256_mul_ps(Simd::negate(Simd::dot(c1, translation)), invDet),
+				_mm256_mul_ps(Simd::negate(Simd::dot(c2, translation)), invDet),
+			};
+
+			Simd::store(a0, columns[0]);
+			Simd::store(a1, columns[1]);
+			Simd::store(a2, columns[2]);
+			Simd::store(Simd::scale(c0, invDet), columns[3]);
+			Simd::store(Simd::scale(c1, invDet), columns[4]);
+			Simd::store(Simd::scale(c2, invDet), columns[5]);
+			Simd::store(normalTranslation, columns[6]);
+
+			// Scatter the results into the components
+			for (size_t lane = 0; lane < SIMD_WIDTH && first + lane < numTransforms; ++lane)
+			{
+				TransformComponent& transform = *transforms.m_components[first + lane];
+				transform.m_modelMatrix[0] = glm::vec4(column(0, lane), 0.0f);
+				transform.m_modelMatrix[1] = glm::vec4(column(1, lane), 0.0f);
+				transform.m_modelMatrix[2] = glm::vec4(column(2, lane), 0.0f);
+				transform.m_modelMatrix[3] = glm::vec4(transform.m_position, 1.0f);
+				transform.m_normalMatrix[0] = glm::vec4(column(3, lane), columns[6][0][lane]);
+				transform.m_normalMatrix[1] = glm::vec4(column(4, lane), columns[6][1][lane]);
+				transform.m_normalMatrix[2] = glm::vec4(column(5, lane), columns[6][2][lane]);
+				transform.m_normalMatrix[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+				transform.m_modelPosition = transform.m_position;
+				transform.m_modelOrientation = transform.m_orientation;
+				transform.m_modelScale = transform.m_scale;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void updateCachedMatrices(Scene::Scene& scene, Scene::Object* renderSettings)
+	{
+		Profiler::ScopedCpuPerfCounter perfCounter(scene, "Transform Cache");
+
+		// Gather the objects that moved since their matrices were built, including the ones moved by the input and the animations
+		TransformArray& transforms = RenderSettings::renderPayload<TransformArray>(scene, renderSettings, RenderSettings::renderPayloadCategory({ "Transform", "Batch" }), true);
+		clearTransforms(transforms);
+		for (auto object : Scene::filterObjects(scene, { Scene::COMPONENT_ID_TRANSFORM }, false))
+		{
+			if (!hasValidCachedMatrices(object->component<TransformComponent>()))
+				appendTransform(transforms, object->component<TransformComponent>());
+		}
+
+		// Rebuild them together
+		updateCachedMatrices(transforms);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +304,10 @@ namespace Transform
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getModelMatrix(Scene::Object* object)
 	{
+		// Objects moved since their last update are not cached
+		if (hasValidCachedMatrices(object->component<Transform::TransformComponent>()))
+			return object->component<Transform::TransformComponent>().m_modelMatrix;
+
 		return getModelMatrix(
 			object->component<Transform::TransformComponent>().m_position, 
 			object->component<Transform::TransformComponent>().m_orientation, 
@@ -91,28 +317,40 @@ namespace Transform
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getPrevModelMatrix(Scene::Object* object)
 	{
-		return getModelMatrix(
-			object->component<Transform::TransformComponent>().m_prevPosition, 
-			object->component<Transform::TransformComponent>().m_prevOrientation, 
-			object->component<Transform::TransformComponent>().m_prevScale);
+		return object->component<Transform::TransformComponent>().m_prevModelMatrix;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getNormalMatrix(glm::mat4 const& matrix)
 	{
-		return glm::inverseTranspose(matrix);
+		// Inverse transpose of the affine matrix, using the cofactors of its upper 3x3 block
+		const glm::vec3 a0 = glm::vec3(matrix[0]), a1 = glm::vec3(matrix[1]), a2 = glm::vec3(matrix[2]);
+		const glm::vec3 c0 = glm::cross(a1, a2), c1 = glm::cross(a2, a0), c2 = glm::cross(a0, a1);
+		const float invDet = 1.0f / glm::dot(a0, c0);
+		const glm::vec3 translation = glm::vec3(matrix[3]);
+
+		glm::mat4 result;
+		result[0] = glm::vec4(c0 * invDet, -glm::dot(c0, translation) * invDet);
+		result[1] = glm::vec4(c1 * invDet, -glm::dot(c1, translation) * invDet);
+		result[2] = glm::vec4(c2 * invDet, -glm::dot(c2, translation) * invDet);
+		result[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		return result;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getNormalMatrix(Scene::Object* object)
 	{
+		// Objects moved since their last update are not cached
+		if (hasValidCachedMatrices(object->component<Transform::TransformComponent>()))
+			return object->component<Transform::TransformComponent>().m_normalMatrix;
+
 		return getNormalMatrix(getModelMatrix(object));
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getPrevNormalMatrix(Scene::Object* object)
 	{
-		return getNormalMatrix(getPrevModelMatrix(object));
+		return object->component<Transform::TransformComponent>().m_prevNormalMatrix;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -168,4 +406,154 @@ namespace Transform
 	{
 		return getUpVector(Transform::getPrevModelMatrix(object));
 	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	namespace Reference
+	{
+		////////////////////////////////////////////////////////////////////////////////
+		/** The original model matrix: translation, three axis rotations and scale, multiplied together. */
+		glm::mat4 getModelMatrix(glm::vec3 pos, glm::vec3 orientation, glm::vec3 scale)
+		{
+			return glm::translate(pos) *
+				glm::rotate(orientation.y, glm::vec3(0.0f, 1.0f, 0.0f)) *
+				glm::rotate(orientation.x, glm::vec3(1.0f, 0.0f, 0.0f)) *
+				glm::rotate(orientation.z, glm::vec3(0.0f, 0.0f, 1.0f)) *
+				glm::scale(scale);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		/** The original normal matrix: a general 4x4 inverse transpose. */
+		glm::mat4 getNormalMatrix(glm::mat4 const& matrix)
+		{
+			return glm::inverseTranspose(matrix);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		float maxDifference(glm::mat4 const& a, glm::mat4 const& b)
+		{
+			float result = 0.0f;
+			for (int col = 0; col < 4; ++col)
+			{
+				const glm::vec4 difference = glm::abs(a[col] - b[col]);
+				result = glm::max(result, glm::max(glm::max(difference.x, difference.y), glm::max(difference.z, difference.w)));
+			}
+			return result;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkTransforms(const size_t numTransforms, const size_t numFrames, const size_t movedPeriod)
+	{
+		// Random transformations; every frame, one in 'movedPeriod' objects moves
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+		std::vector<TransformComponent> initialTransforms(numTransforms);
+		for (TransformComponent& transform : initialTransforms)
+		{
+			transform.m_position = glm::vec3(uniform(generator), uniform(generator), uniform(generator)) * 100.0f;
+			transform.m_orientation = glm::vec3(uniform(generator), uniform(generator), uniform(generator)) * glm::pi<float>();
+			transform.m_scale = glm::vec3(1.5f) + glm::vec3(uniform(generator), uniform(generator), uniform(generator));
+		}
+
+		auto const& moveObject = [](TransformComponent& transform)
+		{
+			transform.m_position.x += 0.1f;
+			transform.m_orientation.y += 0.01f;
+		};
+
+		// Per frame, each object reads its current and previous model and normal matrices, like the mesh and motion blur passes.
+		// Originally, every read rebuilt its matrix from the stored transformation.
+		std::vector<TransformComponent> referenceTransforms = initialTransforms;
+		float checksumReference = 0.0f;
+		DateTime::Timer referenceTimer(true);
+		for (size_t frameId = 0; frameId < numFrames; ++frameId)
+		{
+			for (size_t transformId = frameId % movedPeriod; transformId < referenceTransforms.size(); transformId += movedPeriod)
+				moveObject(referenceTransforms[transformId]);
+
+			for (TransformComponent& transform : referenceTransforms)
+			{
+				const glm::mat4 model = Reference::getModelMatrix(transform.m_position, transform.m_orientation, transform.m_scale);
+				const glm::mat4 normal = Reference::getNormalMatrix(model);
+				const glm::mat4 prevModel = Reference::getModelMatrix(transform.m_prevPosition, transform.m_prevOrientation, transform.m_prevScale);
+				const glm::mat4 prevNormal = Reference::getNormalMatrix(prevModel);
+				checksumReference += model[3][0] + normal[0][0] + prevModel[3][0] + prevNormal[0][0];
+				transform.m_prevPosition = transform.m_position;
+				transform.m_prevOrientation = transform.m_orientation;
+				transform.m_prevScale = transform.m_scale;
+			}
+		}
+		referenceTimer.stop();
+
+		// Cached: the actor update stores the previous matrices, the objects move, the cache is refreshed after the update,
+		// and the passes read the matrices through the object accessors
+		auto const& benchmarkCached = [&](float& checksum, double& refreshTime, bool batched)
+		{
+			std::vector<Scene::Object> objects(numTransforms);
+			for (size_t objectId = 0; objectId < numTransforms; ++objectId)
+			{
+				objects[objectId].addComponent<Scene::COMPONENT_ID_TRANSFORM>();
+				objects[objectId].component<TransformComponent>() = initialTransforms[objectId];
+			}
+
+			TransformArray transforms;
+			DateTime::Timer timer(true);
+			for (size_t frameId = 0; frameId < numFrames; ++frameId)
+			{
+				for (Scene::Object& object : objects)
+					updateTransform(object.component<TransformComponent>());
+
+				for (size_t objectId = frameId % movedPeriod; objectId < objects.size(); objectId += movedPeriod)
+					moveObject(objects[objectId].component<TransformComponent>());
+
+				DateTime::Timer refreshTimer(true);
+				if (batched)
+				{
+					clearTransforms(transforms);
+					for (Scene::Object& object : objects)
+						if (!hasValidCachedMatrices(object.component<TransformComponent>()))
+							appendTransform(transforms, object.component<TransformComponent>());
+					updateCachedMatrices(transforms);
+				}
+				else
+				{
+					for (Scene::Object& object : objects)
+						updateCachedMatrices(object.component<TransformComponent>());
+				}
+				refreshTimer.stop();
+				refreshTime += refreshTimer.getElapsedTime();
+
+				for (Scene::Object& object : objects)
+				{
+					checksum += getModelMatrix(&object)[3][0] + getNormalMatrix(&object)[0][0] +
+						getPrevModelMatrix(&object)[3][0] + getPrevNormalMatrix(&object)[0][0];
+				}
+			}
+			timer.stop();
+
+			// Accuracy of the closed forms against the original matrix products
+			glm::vec2 maxDifference(0.0f);
+			for (Scene::Object& object : objects)
+			{
+				TransformComponent const& transform = object.component<TransformComponent>();
+				const glm::mat4 model = Reference::getModelMatrix(transform.m_position, transform.m_orientation, transform.m_scale);
+				maxDifference.x = glm::max(maxDifference.x, Reference::maxDifference(model, transform.m_modelMatrix));
+				maxDifference.y = glm::max(maxDifference.y, Reference::maxDifference(Reference::getNormalMatrix(model), transform.m_normalMatrix));
+			}
+			return std::make_pair(timer.getElapsedTime(), maxDifference);
+		};
+
+		float checksumScalar = 0.0f, checksumBatched = 0.0f;
+		double refreshScalar = 0.0, refreshBatched = 0.0;
+		const auto [scalarTime, scalarDifference] = benchmarkCached(checksumScalar, refreshScalar, false);
+		const auto [batchedTime, batchedDifference] = benchmarkCached(checksumBatched, refreshBatched, true);
+
+		Debug::log_info() << "Transform benchmark (" << numTransforms << " transforms, " << numFrames << " frames, 1 in " << movedPeriod << " moved per frame):" << Debug::end;
+		Debug::log_info() << "  - rebuilt on every read: " << referenceTimer.getElapsedTime() * 1e3 / numFrames << " ms per frame" << Debug::end;
+		Debug::log_info() << "  - cached, refreshed per object: " << scalarTime * 1e3 / numFrames << " ms per frame (refresh: " << refreshScalar * 1e3 / numFrames << " ms)" << Debug::end;
+		Debug::log_info() << "  - cached, refreshed in SIMD batches: " << batchedTime * 1e3 / numFrames << " ms per frame (refresh: " << refreshBatched * 1e3 / numFrames << " ms)" << Debug::end;
+		Debug::log_info() << "  - max. difference to the original matrices: " << scalarDifference.x << " (model), " << scalarDifference.y << " (normal) per object, "
+			<< batchedDifference.x << " (model), " << batchedDifference.y << " (normal) batched" << Debug::end;
+		Debug::log_info() << "  - checksums: " << checksumReference << " vs " << checksumScalar << " vs " << checksumBatched << Debug::end;
+	}
 }
\ No newline at end of file
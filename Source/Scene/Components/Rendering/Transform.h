@@ -41,8 +41,46 @@ namespace Transform
 
 		// Orientation of the object
 		glm::vec3 m_prevOrientation{ 0.0f };
+
+		// Cached model and normal matrices
+		glm::mat4 m_modelMatrix{ 1.0f };
+		glm::mat4 m_normalMatrix{ 1.0f };
+
+		// Transformation the cached matrices were built from
+		glm::vec3 m_modelPosition{ 0.0f };
+		glm::vec3 m_modelScale{ 1.0f };
+		glm::vec3 m_modelOrientation{ 0.0f };
+
+		// Cached matrices of the previous transformation
+		glm::mat4 m_prevModelMatrix{ 1.0f };
+		glm::mat4 m_prevNormalMatrix{ 1.0f };
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Number of transformations processed together by the SIMD matrix update
+	static const size_t SIMD_WIDTH = 8;
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Transformations whose cached matrices are rebuilt together. The inputs are stored as SoA arrays,
+		padded to a multiple of the SIMD width, and the results are scattered back into the components. */
+	struct TransformArray
+	{
+		// Components the entries were gathered from
+		std::vector<TransformComponent*> m_components;
+
+		// Translation and scale of the entries
+		std::vector<float> m_positionX, m_positionY, m_positionZ;
+		std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+
+		// Sines and cosines of the orientation angles
+		std::vector<float> m_sinX, m_sinY, m_sinZ;
+		std::vector<float> m_cosX, m_cosY, m_cosZ;
 	};
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Tracks whether the transformation changed since the previous frame, and refreshes the cached matrices. */
+	void updateTransform(TransformComponent& transform);
+
 	////////////////////////////////////////////////////////////////////////////////
 	void updateObject(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object);
 
@@ -55,6 +93,31 @@ namespace Transform
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getModelMatrix(glm::vec3 pos, glm::vec3 orientation, glm::vec3 scale);
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether the cached matrices were built from the current transformation. */
+	bool hasValidCachedMatrices(TransformComponent const& transform);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Rebuilds the cached matrices if the transformation changed since they were built. */
+	void updateCachedMatrices(TransformComponent& transform);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Removes every entry from the transformation array. */
+	void clearTransforms(TransformArray& transforms);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends the parameter transformation to the array. */
+	void appendTransform(TransformArray& transforms, TransformComponent& transform);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Rebuilds the cached matrices of every entry in the array, SIMD_WIDTH entries at a time. */
+	void updateCachedMatrices(TransformArray& transforms);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Rebuilds the cached matrices of every object that moved since they were built. Runs after the object updates,
+		so that the render passes read the matrices of the current frame instead of rebuilding them. */
+	void updateCachedMatrices(Scene::Scene& scene, Scene::Object* renderSettings);
+
 	////////////////////////////////////////////////////////////////////////////////
 	glm::mat4 getModelMatrix(Scene::Object* object);
 
@@ -96,6 +159,11 @@ namespace Transform
 
 	////////////////////////////////////////////////////////////////////////////////
 	glm::vec3 getPrevUpVector(Scene::Object* object);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times the cached matrices, refreshed per object and in SIMD batches, against rebuilding them on every read,
+		over synthetic transforms, and logs the difference to the original matrix products. */
+	void benchmarkTransforms(const size_t numTransforms = 50000, const size_t numFrames = 100, const size_t movedPeriod = 10);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
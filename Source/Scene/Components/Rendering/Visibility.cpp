@@ -0,0 +1,250 @@
+#include "PCH.h"
+#include "Visibility.h"
+#include "Scene/Components/Rendering/Includes.h"
+#include "Scene/Components/Lighting/Includes.h"
+
+#include <random>
+
+namespace Visibility
+{
+	////////////////////////////////////////////////////////////////////////////////
+	VisibilityCache& getVisibilityCache(Scene::Scene& scene)
+	{
+		Scene::Object* renderSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_RENDER_SETTINGS);
+		return RenderSettings::renderPayload<VisibilityCache>(scene, renderSettings, RenderSettings::renderPayloadCategory({ "Visibility", "Cache" }), true);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void gatherObjects(Scene::Scene& scene, VisibilityCache& cache, size_t numThreads)
+	{
+		cache.m_objects.clear();
+		cache.m_objectIds.clear();
+		cache.m_submeshOffsets.assign(1, 0);
+
+		// Collect the objects and look up their meshes; this touches the mesh map, so it stays serial
+		cache.m_meshes.clear();
+		for (auto object : Scene::filterObjects(scene, Scene::OBJECT_TYPE_MESH, false, false))
+		{
+			if (!Mesh::isMeshValid(scene, object)) continue;
+
+			GPU::Mesh const& mesh = scene.m_meshes.find(object->component<Mesh::MeshComponent>().m_meshName)->second;
+			cache.m_objectIds[object] = uint32_t(cache.m_objects.size());
+			cache.m_objects.push_back(object);
+			cache.m_submeshOffsets.push_back(cache.m_submeshOffsets.back() + uint32_t(mesh.m_subMeshes.size()));
+			cache.m_meshes.push_back(&mesh);
+		}
+
+		cache.m_objectAabbs.resize(cache.m_objects.size());
+		cache.m_submeshIds.resize(cache.m_submeshOffsets.back());
+		cache.m_submeshAabbs.resize(cache.m_submeshOffsets.back());
+
+		// Nothing else to do without mesh objects; the threaded execution would still run a single job
+		if (cache.m_objects.empty()) return;
+
+		// Compute the world-space bounds
+		Threading::threadedExecuteIndices(numThreads,
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t objectId)
+			{
+				GPU::Mesh const& mesh = *cache.m_meshes[objectId];
+				const glm::mat4 model = Transform::getModelMatrix(cache.m_objects[objectId]);
+				cache.m_objectAabbs[objectId] = mesh.m_aabb.transform(model);
+
+				// Sort the submeshes by material, to minimize the state changes while rendering them
+				uint32_t* submeshIds = cache.m_submeshIds.data() + cache.m_submeshOffsets[objectId];
+				std::iota(submeshIds, submeshIds + mesh.m_subMeshes.size(), 0);
+				std::stable_sort(submeshIds, submeshIds + mesh.m_subMeshes.size(), [&](uint32_t a, uint32_t b)
+				{
+					return mesh.m_subMeshes[a].m_materialId < mesh.m_subMeshes[b].m_materialId;
+				});
+
+				for (size_t i = 0; i < mesh.m_subMeshes.size(); ++i)
+					cache.m_submeshAabbs[cache.m_submeshOffsets[objectId] + i] = mesh.m_subMeshes[submeshIds[i]].m_aabb.transform(model);
+			},
+			cache.m_objects.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	std::vector<View> collectViews(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera)
+	{
+		std::vector<View> result;
+
+		// Main camera
+		View cameraView;
+		cameraView.m_owner = camera;
+		cameraView.m_sliceId = -1;
+		cameraView.m_frustum = camera->component<Camera::CameraComponent>().m_viewFrustum;
+		result.push_back(cameraView);
+
+		// Shadow map slices that will be rendered in this frame
+		if (renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_shadowMethod == RenderSettings::ShadowMapping)
+		{
+			for (auto shadowCaster : ShadowMap::getShadowCasters(scene))
+			{
+				auto const& slices = shadowCaster->component<ShadowMap::ShadowMapComponent>().m_slices;
+				for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId)
+				{
+					if (!slices[sliceId].m_needsUpdate) continue;
+
+					View sliceView;
+					sliceView.m_owner = shadowCaster;
+					sliceView.m_sliceId = int(sliceId);
+					sliceView.m_frustum = slices[sliceId].m_transform.m_frustum;
+					result.push_back(sliceView);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void cullViews(VisibilityCache& cache, std::vector<View> const& views, size_t numThreads)
+	{
+		// Keep the arenas of the previous frames around
+		if (cache.m_views.size() < views.size())
+			cache.m_views.resize(views.size());
+		cache.m_numViews = views.size();
+
+		cache.m_firstViews.clear();
+		for (size_t viewId = 0; viewId < views.size(); ++viewId)
+			cache.m_firstViews.emplace(views[viewId].m_owner, uint32_t(viewId));
+
+		// One job per view, each writing to its own arena
+		const size_t numObjects = cache.m_objects.size();
+		Threading::threadedExecuteIndices(numThreads,
+			[&](Threading::ThreadedExecuteEnvironment const& environment, size_t viewId)
+			{
+				ViewVisibility& result = cache.m_views[viewId];
+				result.m_view = views[viewId];
+				result.m_objects.clear();
+				result.m_submeshes.clear();
+				result.m_objectSlots.assign(numObjects, -1);
+
+				BVH::Frustum const& frustum = result.m_view.m_frustum;
+				for (size_t objectId = 0; objectId < numObjects; ++objectId)
+				{
+					const BVH::Intersection intersection = frustum.intersection(cache.m_objectAabbs[objectId]);
+					if (intersection == BVH::Outside) continue;
+
+					// Only test the submeshes if the object straddles the frustum
+					VisibleObject visibleObject{ uint32_t(objectId), uint32_t(result.m_submeshes.size()), 0 };
+					for (uint32_t submesh = cache.m_submeshOffsets[objectId]; submesh < cache.m_submeshOffsets[objectId + 1]; ++submesh)
+					{
+						if (intersection == BVH::Inside || frustum.intersection(cache.m_submeshAabbs[submesh]) != BVH::Outside)
+							result.m_submeshes.push_back(cache.m_submeshIds[submesh]);
+					}
+					visibleObject.m_numSubmeshes = uint32_t(result.m_submeshes.size()) - visibleObject.m_firstSubmesh;
+
+					if (visibleObject.m_numSubmeshes == 0) continue;
+					result.m_objectSlots[objectId] = int32_t(result.m_objects.size());
+					result.m_objects.push_back(visibleObject);
+				}
+			},
+			views.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void updateVisibility(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera)
+	{
+		Profiler::ScopedCpuPerfCounter perfCounter(scene, "Visibility");
+
+		VisibilityCache& cache = getVisibilityCache(scene);
+
+		// Fall back to culling in the render callbacks
+		if (!renderSettings->component<RenderSettings::RenderSettingsComponent>().m_features.m_visibilityPass)
+		{
+			cache.m_objects.clear();
+			cache.m_objectIds.clear();
+			cache.m_numViews = 0;
+			cache.m_firstViews.clear();
+			return;
+		}
+
+		gatherObjects(scene, cache);
+		cullViews(cache, collectViews(scene, renderSettings, camera));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	ViewVisibility const* findView(VisibilityCache const& cache, Scene::Object* owner, int sliceId)
+	{
+		auto it = cache.m_firstViews.find(owner);
+		if (it == cache.m_firstViews.end()) return nullptr;
+
+		for (size_t viewId = it->second; viewId < cache.m_numViews && cache.m_views[viewId].m_view.m_owner == owner; ++viewId)
+			if (cache.m_views[viewId].m_view.m_sliceId == sliceId)
+				return &cache.m_views[viewId];
+		return nullptr;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	VisibleObject const* findObject(VisibilityCache const& cache, ViewVisibility const& view, Scene::Object* object)
+	{
+		auto it = cache.m_objectIds.find(object);
+		if (it == cache.m_objectIds.end() || view.m_objectSlots[it->second] < 0) return nullptr;
+		return &view.m_objects[view.m_objectSlots[it->second]];
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmark(std::vector<size_t> const& viewCounts, size_t numObjects, size_t numSubmeshes, size_t numFrames)
+	{
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		auto randomVector = [&](float scale) { return (glm::vec3(unit(generator), unit(generator), unit(generator)) * 2.0f - 1.0f) * scale; };
+
+		// Synthetic objects, spread over a large area, made up of smaller submeshes
+		VisibilityCache cache;
+		cache.m_submeshOffsets.assign(1, 0);
+		for (size_t objectId = 0; objectId < numObjects; ++objectId)
+		{
+			const glm::vec3 center = randomVector(500.0f);
+			const glm::vec3 halfSize = glm::vec3(1.0f) + glm::abs(randomVector(4.0f));
+			cache.m_objects.push_back(nullptr);
+			cache.m_objectAabbs.push_back(BVH::AABB(center - halfSize, center + halfSize));
+			for (size_t submeshId = 0; submeshId < numSubmeshes; ++submeshId)
+			{
+				const glm::vec3 submeshCenter = center + randomVector(1.0f) * halfSize * 0.5f;
+				const glm::vec3 submeshHalfSize = halfSize * 0.5f;
+				cache.m_submeshIds.push_back(uint32_t(submeshId));
+				cache.m_submeshAabbs.push_back(BVH::AABB(glm::max(submeshCenter - submeshHalfSize, center - halfSize), glm::min(submeshCenter + submeshHalfSize, center + halfSize)));
+			}
+			cache.m_submeshOffsets.push_back(uint32_t(cache.m_submeshIds.size()));
+		}
+
+		Debug::log_info() << "Visibility benchmark: " << numObjects << " objects, " << numSubmeshes << " submeshes each, " << Threading::numThreads() << " threads" << Debug::end;
+
+		for (size_t numViews : viewCounts)
+		{
+			// Random perspective views looking into the scene
+			std::vector<View> views(numViews);
+			const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+			for (auto& view : views)
+			{
+				const glm::vec3 eye = randomVector(400.0f);
+				view.m_frustum = BVH::Frustum(projection * glm::lookAt(eye, eye + glm::normalize(randomVector(1.0f) + glm::vec3(0.0f, 0.0f, 1e-3f)), glm::vec3(0.0f, 1.0f, 0.0f)));
+			}
+
+			// Time the parallel and the serial culling
+			DateTime::Timer parallelTimer(true);
+			for (size_t frameId = 0; frameId < numFrames; ++frameId)
+				cullViews(cache, views);
+			parallelTimer.stop();
+
+			DateTime::Timer serialTimer(true);
+			for (size_t frameId = 0; frameId < numFrames; ++frameId)
+				cullViews(cache, views, 1);
+			serialTimer.stop();
+
+			size_t numVisibleObjects = 0, numVisibleSubmeshes = 0;
+			for (size_t viewId = 0; viewId < cache.m_numViews; ++viewId)
+			{
+				numVisibleObjects += cache.m_views[viewId].m_objects.size();
+				numVisibleSubmeshes += cache.m_views[viewId].m_submeshes.size();
+			}
+
+			const double parallelTime = parallelTimer.getElapsedTime() * 1000.0 / double(numFrames);
+			const double serialTime = serialTimer.getElapsedTime() * 1000.0 / double(numFrames);
+			Debug::log_info() << "  - " << numViews << " views: " << parallelTime << " ms per frame (serial: " << serialTime << " ms, speedup: " << serialTime / glm::max(parallelTime, 1e-9)
+				<< "), " << float(numVisibleObjects) / float(numViews) << " objects and " << float(numVisibleSubmeshes) / float(numViews) << " submeshes visible per view" << Debug::end;
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+//  Headers
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PCH.h"
+#include "Common.h"
+
+namespace Visibility
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/** A single view that the meshes are culled against. */
+	struct View
+	{
+		// Object that owns the view (camera or shadow caster)
+		Scene::Object* m_owner = nullptr;
+
+		// Shadow map slice of the owner, or -1 for cameras
+		int m_sliceId = -1;
+
+		// World-space frustum of the view
+		BVH::Frustum m_frustum;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** An object that survived culling, with its range in the view's submesh list. */
+	struct VisibleObject
+	{
+		// Index of the object in the gathered object list
+		uint32_t m_objectId;
+
+		// Range of the visible submeshes
+		uint32_t m_firstSubmesh;
+		uint32_t m_numSubmeshes;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Culling results of a single view. The lists are cleared, but not deallocated between frames. */
+	struct ViewVisibility
+	{
+		// The view itself
+		View m_view;
+
+		// Objects visible in the view
+		std::vector<VisibleObject> m_objects;
+
+		// Visible submesh ids, sorted by material for each object
+		std::vector<uint32_t> m_submeshes;
+
+		// Index of each gathered object in the visible object list, or -1 if it was culled
+		std::vector<int32_t> m_objectSlots;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Per-frame visibility data, shared by every render pass. */
+	struct VisibilityCache
+	{
+		// Mesh objects gathered for the frame
+		std::vector<Scene::Object*> m_objects;
+
+		// Mesh of each gathered object
+		std::vector<GPU::Mesh const*> m_meshes;
+
+		// Index of each object in the gathered list
+		std::unordered_map<Scene::Object*, uint32_t> m_objectIds;
+
+		// World-space bounds of the objects
+		std::vector<BVH::AABB> m_objectAabbs;
+
+		// Range of each object's submeshes in the submesh arrays
+		std::vector<uint32_t> m_submeshOffsets;
+
+		// Submesh ids and world-space bounds, sorted by material for each object
+		std::vector<uint32_t> m_submeshIds;
+		std::vector<BVH::AABB> m_submeshAabbs;
+
+		// Per-view results; only the first m_numViews entries are valid
+		std::vector<ViewVisibility> m_views;
+		size_t m_numViews = 0;
+
+		// First view of each view owner; the views of an owner are stored consecutively
+		std::unordered_map<Scene::Object*, uint32_t> m_firstViews;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Accesses the visibility cache of the scene. */
+	VisibilityCache& getVisibilityCache(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Collects the valid mesh objects of the scene, along with their world-space bounds. */
+	void gatherObjects(Scene::Scene& scene, VisibilityCache& cache, size_t numThreads = Threading::numThreads());
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Collects the views to cull for: the main camera, and every shadow map slice that needs to be rendered. */
+	std::vector<View> collectViews(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Culls the gathered objects against the views, with one job per view. */
+	void cullViews(VisibilityCache& cache, std::vector<View> const& views, size_t numThreads = Threading::numThreads());
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Runs the visibility pass for the current frame. */
+	void updateVisibility(Scene::Scene& scene, Scene::Object* renderSettings, Scene::Object* camera);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Results of the parameter view, or nullptr if it was not part of the visibility pass. */
+	ViewVisibility const* findView(VisibilityCache const& cache, Scene::Object* owner, int sliceId = -1);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Entry of the parameter object in the view, or nullptr if it was culled. */
+	VisibleObject const* findObject(VisibilityCache const& cache, ViewVisibility const& view, Scene::Object* object);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Culls a synthetic scene against an increasing number of random views, and logs the per-frame culling times. */
+	void benchmark(std::vector<size_t> const& viewCounts = { 1, 8, 32, 128 }, size_t numObjects = 10000, size_t numSubmeshes = 8, size_t numFrames = 10);
+}
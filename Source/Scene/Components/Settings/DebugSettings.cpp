@@ -17,6 +17,7 @@ namespace DebugSettings
 		object.component<DebugSettings::DebugSettingsComponent>().m_logToMemory = Debug::defaultLogChannelsMemory();
 		object.component<DebugSettings::DebugSettingsComponent>().m_logConsole = Debug::defaultLogChannelsConsole();
 		object.component<DebugSettings::DebugSettingsComponent>().m_logToFile = Debug::defaultLogChannelsFile();
+		object.component<DebugSettings::DebugSettingsComponent>().m_logAsync = Debug::defaultAsyncLogging();
 		object.component<DebugSettings::DebugSettingsComponent>().m_profileCpu = Profiler::profilingDefault();
 		object.component<DebugSettings::DebugSettingsComponent>().m_profileGpu = Profiler::profilingDefault();
 
@@ -79,47 +80,18 @@ namespace DebugSettings
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	bool shouldPurgeProfilerHistory(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object)
+	void updateProfilerHistoryLength(Scene::Scene& scene, Scene::Object* object)
 	{
-		const int frameId = simulationSettings->component<SimulationSettings::SimulationSettingsComponent>().m_frameId;
-		const int lastPurge = object->component<DebugSettingsComponent>().m_profilerHistoryLastPurgeFrame;
-		const int purgeFrequency = object->component<DebugSettingsComponent>().m_profilerHistoryPurgeFrequency;
-		return frameId > lastPurge + purgeFrequency;
-	}
-
-	////////////////////////////////////////////////////////////////////////////////
-	void purgeProfilerHistory(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object)
-	{
-		Profiler::ScopedCpuPerfCounter perfCounter(scene, "Profiler History Purge");
-
-		const int frameId = simulationSettings->component<SimulationSettings::SimulationSettingsComponent>().m_frameId;
-		const int keptFrames = object->component<DebugSettingsComponent>().m_profilerHistoryNumPrevFrames;
-
-		for (auto& node : scene.m_profilerData)
-		{
-			if (node.second.m_previousValues.size() > 0)
-			{
-				// Create a local copy of the old values
-				auto oldValues = node.second.m_previousValues;
-				node.second.m_previousValues.clear();
-				node.second.m_previousValues.reserve(keptFrames);
-
-				// Copy over the old values that are recent enough
-				for (auto const& value : oldValues)
-					if (value.first >= frameId - keptFrames)
-						node.second.m_previousValues[value.first] = value.second;
-			}
-		}
-
-		object->component<DebugSettingsComponent>().m_profilerHistoryLastPurgeFrame = frameId;
+		const size_t historyLength = (size_t)glm::max(object->component<DebugSettingsComponent>().m_profilerHistoryNumPrevFrames, 1);
+		if (historyLength != scene.m_profilerHistoryLength)
+			Profiler::setHistoryLength(scene, historyLength);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	void updateObject(Scene::Scene& scene, Scene::Object* simulationSettings, Scene::Object* object)
 	{
-		// Purge the profiler history buffer
-		if (shouldPurgeProfilerHistory(scene, simulationSettings, object))
-			purgeProfilerHistory(scene, simulationSettings, object);
+		// Resize the profiler history buffers
+		updateProfilerHistoryLength(scene, object);
 
 		// Log the costly tasks
 		auto& currentProfilerTree = scene.m_profilerTree[scene.m_profilerBufferReadId][0];
@@ -142,6 +114,7 @@ namespace DebugSettings
 		Debug::setMemoryLogging(object->component<DebugSettings::DebugSettingsComponent>().m_logToMemory);
 		Debug::setConsoleLogging(object->component<DebugSettings::DebugSettingsComponent>().m_logConsole);
 		Debug::setFileLogging(object->component<DebugSettings::DebugSettingsComponent>().m_logToFile);
+		Debug::setAsyncLogging(object->component<DebugSettings::DebugSettingsComponent>().m_logAsync);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -191,7 +164,17 @@ namespace DebugSettings
 			logChanged = generateGuiLogChannel(scene, guiSettings, object, "Log to Memory", object->component<DebugSettings::DebugSettingsComponent>().m_logToMemory) || logChanged;
 			logChanged = generateGuiLogChannel(scene, guiSettings, object, "Log to Console", object->component<DebugSettings::DebugSettingsComponent>().m_logConsole) || logChanged;
 			logChanged = generateGuiLogChannel(scene, guiSettings, object, "Log to File", object->component<DebugSettings::DebugSettingsComponent>().m_logToFile) || logChanged;
+			logChanged = ImGui::Checkbox("Asynchronous Logging", &object->component<DebugSettings::DebugSettingsComponent>().m_logAsync) || logChanged;
 
+			if (ImGui::Button("Benchmark Logging"))
+			{
+				Debug::benchmarkLogging();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Disabled Logging"))
+			{
+				Debug::benchmarkDisabledLogging();
+			}
 
 			EditorSettings::editorProperty<std::string>(scene, object, "MainTabBar_SelectedTab") = ImGui::CurrentTabItemName();
 			ImGui::EndTabItem();
@@ -199,8 +182,14 @@ namespace DebugSettings
 
 		if (ImGui::BeginTabItem("Profiler", activeTab.c_str()))
 		{
-			ImGui::DragInt("History Purge Frequency", &object->component<DebugSettings::DebugSettingsComponent>().m_profilerHistoryPurgeFrequency);
-			ImGui::DragInt("History Kept Frames", &object->component<DebugSettings::DebugSettingsComponent>().m_profilerHistoryNumPrevFrames);
+			// Edit a copy of the history length and only commit it on release, since resizing the history drops the stored values
+			int& historyLength = EditorSettings::editorProperty<int>(scene, object, "Debug_ProfilerHistoryLength", false);
+			bool& historyLengthEditing = EditorSettings::editorProperty<bool>(scene, object, "Debug_ProfilerHistoryLength_Editing", false);
+			if (!historyLengthEditing) historyLength = object->component<DebugSettings::DebugSettingsComponent>().m_profilerHistoryNumPrevFrames;
+			ImGui::DragInt("History Kept Frames", &historyLength, 1.0f, 1, 1 << 20);
+			historyLengthEditing = ImGui::IsItemActive();
+			if (ImGui::IsItemDeactivatedAfterEdit())
+				object->component<DebugSettings::DebugSettingsComponent>().m_profilerHistoryNumPrevFrames = historyLength;
 
 			ImGui::SliderFloat("Long Task Threshold", &object->component<DebugSettings::DebugSettingsComponent>().m_costlyTaskLogThreshold, 0.0f, 1000.0f);
 			ImGui::SliderInt("Long Task Prefix Length", &object->component<DebugSettingsComponent>().m_costlyTaskLogNodeLength, 1, 4);
@@ -211,6 +200,29 @@ namespace DebugSettings
 			ImGui::SameLine();
 			ImGui::Checkbox("Profiler History", &object->component<DebugSettings::DebugSettingsComponent>().m_profilerStoreValues);
 
+			// Events lost to full event buffers leave the aggregated scope times undercounted
+			ImGui::Text("Dropped Profiler Events: %zu (last frame: %zu)", scene.m_profilerEvents->m_numDroppedTotal, scene.m_profilerEvents->m_numDroppedLastFrame);
+
+			if (ImGui::Button("Benchmark Profiler Scopes"))
+			{
+				Profiler::benchmarkScopes(scene);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Validate Profiler History"))
+			{
+				Profiler::validateHistory();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Profiler History"))
+			{
+				Profiler::benchmarkHistory();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Component Access"))
+			{
+				Scene::benchmarkComponentAccess(scene);
+			}
+
 			if (ImGui::Button("Save Profiler Stats"))
 			{
 				EditorSettings::editorProperty<std::string>(scene, object, "Debug_SaveProfilerStats_FileName") = EnginePaths::generateUniqueFilename("Profile-Data-", ".csv");
@@ -223,6 +235,24 @@ namespace DebugSettings
 				Profiler::clearTree(scene);
 			}
 
+			if (Profiler::isCapturingTrace(scene))
+			{
+				if (ImGui::Button("Stop Trace Capture"))
+				{
+					Profiler::stopTraceCapture(scene);
+				}
+			}
+			else if (ImGui::Button("Start Trace Capture"))
+			{
+				EditorSettings::editorProperty<std::string>(scene, object, "Debug_TraceCapture_FileName") = EnginePaths::generateUniqueFilename("Profile-Trace-", "");
+				ImGui::OpenPopup("StartTraceCapture");
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Validate Trace Capture"))
+			{
+				Profiler::validateTrace(scene);
+			}
+
 			EditorSettings::editorProperty<std::string>(scene, object, "MainTabBar_SelectedTab") = ImGui::CurrentTabItemName();
 			ImGui::EndTabItem();
 		}
@@ -251,6 +281,28 @@ namespace DebugSettings
 			ImGui::EndPopup();
 		}
 
+		if (ImGui::BeginPopup("StartTraceCapture"))
+		{
+			ImGui::InputText("File Name", EditorSettings::editorProperty<std::string>(scene, object, "Debug_TraceCapture_FileName"));
+			ImGui::Combo("Format", &object->component<DebugSettings::DebugSettingsComponent>().m_traceFormat, Profiler::TraceFormat_meta);
+
+			if (ImGui::ButtonEx("Ok", "|########|"))
+			{
+				const Profiler::TraceFormat format = object->component<DebugSettings::DebugSettingsComponent>().m_traceFormat;
+				std::string fileName = EditorSettings::editorProperty<std::string>(scene, object, "Debug_TraceCapture_FileName");
+				fileName += format == Profiler::ChromeJson ? ".json" : ".perfetto-trace";
+				Profiler::startTraceCapture(scene, fileName, format);
+				ImGui::CloseCurrentPopup();
+			}
+			ImGui::SameLine();
+			if (ImGui::ButtonEx("Cancel", "|########|"))
+			{
+				ImGui::CloseCurrentPopup();
+			}
+
+			ImGui::EndPopup();
+		}
+
 		if (logChanged)
 		{
 			updateLoggerStates(scene, object);
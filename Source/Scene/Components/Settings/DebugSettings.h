@@ -29,11 +29,11 @@ namespace DebugSettings
 		// Whether the profiler should collect previous values or not
 		bool m_profilerStoreValues = true;
 
-		// How many frames to keep when purging the profiler history buffer
+		// How many frames to keep in the profiler history buffer
 		int m_profilerHistoryNumPrevFrames = 512;
 
-		// How frequently to purge the profiler frame history
-		int m_profilerHistoryPurgeFrequency = 2048;
+		// Output format of the profiler trace captures
+		Profiler::TraceFormat m_traceFormat = Profiler::ChromeJson;
 
 		// Whether logging to memory buffers should be enabled or not.
 		Debug::LogChannels m_logToMemory;
@@ -44,6 +44,9 @@ namespace DebugSettings
 		// Whether logging to the console should be enabled or not.
 		Debug::LogChannels m_logConsole;
 
+		// Whether the log lines should be written out by the asynchronous sink thread or not.
+		bool m_logAsync = true;
+
 		// Length of a costly task node prefix (per depth)
 		int m_costlyTaskLogNodeLength = 1;
 
@@ -55,11 +58,6 @@ namespace DebugSettings
 		{
 			bool m_debugMemory;
 		} m_crtSettings;
-
-		//  ----------------- Private members ------------------------------
-
-		// When was the profiler history buffer last purged
-		int m_profilerHistoryLastPurgeFrame = 0;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 #include "InputSettings.h"
 #include "SimulationSettings.h"
 #include "RenderSettings.h"
+#include "../Rendering/MaterialTable.h"
 
 namespace GuiSettings
 {
@@ -1122,15 +1123,8 @@ namespace GuiSettings
 			// Id of the current frame
 			const int frameId = getFrameId(payload, index);
 
-			// Look the the specified frame's data
-			if (const auto it = payload.m_entry.get().m_previousValues.find(frameId); it != payload.m_entry.get().m_previousValues.end())
-			{
-				// Return the current value
-				return ImPlotPoint(frameId, Profiler::convertEntryData<float>(it->second));
-			}
-
-			// Fall back to zero if it's not stored
-			return ImPlotPoint(frameId, 0.0f);
+			// Look the the specified frame's data (falls back to zero if it's not stored)
+			return ImPlotPoint(frameId, payload.m_entry.get().m_previousValues.value<float>(frameId));
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -1164,11 +1158,8 @@ namespace GuiSettings
 			// Size of the average window
 			const int windowSize = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_profilerChartsSettings.m_avgWindowSize;
 
-			// Look the the specified frame's data
-			auto it = entry.m_previousValues.find(frameId);
-
 			// Float values
-			const float cur = it == entry.m_previousValues.end() ? 0.0f : Profiler::convertEntryData<float>(it->second);
+			const float cur = entry.m_previousValues.value<float>(frameId);
 			const float min = Profiler::slidingMinWindowed<float>(entry, frameId, windowSize);
 			const float avg = Profiler::slidingAverageWindowed<float>(entry, frameId, windowSize, false);
 			const float max = Profiler::slidingMaxWindowed<float>(entry, frameId, windowSize);
@@ -1267,10 +1258,9 @@ namespace GuiSettings
 
 			// Extract the current frame time
 			const int currFrameId = glm::min(simulationSettings->component<SimulationSettings::SimulationSettingsComponent>().m_frameId - 1, startFrameId + numFrames - 1);
-			auto currIt = entry.m_previousValues.find(currFrameId);
 
 			// Min, avg and max values (sliding)
-			const float cur = (currIt == entry.m_previousValues.end()) ? 0.0f : Profiler::convertEntryData<float>(currIt->second);
+			const float cur = entry.m_previousValues.value<float>(currFrameId);
 			const float min = Profiler::slidingMin<float>(entry, startFrameId, endFrameId);
 			const float avg = Profiler::slidingAverage<float>(entry, startFrameId, endFrameId, false);
 			const float max = Profiler::slidingMax<float>(entry, startFrameId, endFrameId);
@@ -1523,11 +1513,11 @@ namespace GuiSettings
 		{
 			glm::vec3 color = glm::vec3(1.0f);
 
-			if (message.m_sourceLog == Debug::log_debug().m_ref.get().m_name)   color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_debugColor;
-			if (message.m_sourceLog == Debug::log_trace().m_ref.get().m_name)   color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_traceColor;
-			if (message.m_sourceLog == Debug::log_info().m_ref.get().m_name)    color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_infoColor;
-			if (message.m_sourceLog == Debug::log_warning().m_ref.get().m_name) color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_warningColor;
-			if (message.m_sourceLog == Debug::log_error().m_ref.get().m_name)   color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_errorColor;
+			if (message.m_sourceLog == Debug::logger_impl::log_debug.m_name)   color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_debugColor;
+			if (message.m_sourceLog == Debug::logger_impl::log_trace.m_name)   color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_traceColor;
+			if (message.m_sourceLog == Debug::logger_impl::log_info.m_name)    color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_infoColor;
+			if (message.m_sourceLog == Debug::logger_impl::log_warning.m_name) color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_warningColor;
+			if (message.m_sourceLog == Debug::logger_impl::log_error.m_name)   color = guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_errorColor;
 
 			return ImGui::ColorFromGlmVector(color);
 		}
@@ -1545,11 +1535,11 @@ namespace GuiSettings
 				return msgState.m_visible;
 
 			bool result = true;
-			if (message.m_sourceLog == Debug::log_debug().m_ref.get().m_name)   result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showDebug;
-			if (message.m_sourceLog == Debug::log_trace().m_ref.get().m_name)   result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showTrace;
-			if (message.m_sourceLog == Debug::log_info().m_ref.get().m_name)    result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showInfo;
-			if (message.m_sourceLog == Debug::log_warning().m_ref.get().m_name) result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showWarning;
-			if (message.m_sourceLog == Debug::log_error().m_ref.get().m_name)   result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showError;
+			if (message.m_sourceLog == Debug::logger_impl::log_debug.m_name)   result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showDebug;
+			if (message.m_sourceLog == Debug::logger_impl::log_trace.m_name)   result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showTrace;
+			if (message.m_sourceLog == Debug::logger_impl::log_info.m_name)    result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showInfo;
+			if (message.m_sourceLog == Debug::logger_impl::log_warning.m_name) result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showWarning;
+			if (message.m_sourceLog == Debug::logger_impl::log_error.m_name)   result &= guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_showError;
 
 			if (guiSettings->component<GuiSettings::GuiSettingsComponent>().m_logOutputSettings.m_includeFilter.m_empty == false)
 			{
@@ -2908,10 +2898,12 @@ namespace GuiSettings
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
-		void generateTextureEditor(Scene::Scene& scene, Scene::Object* guiSettings, std::string const& name, std::string& texture, std::string const& defaultTexture)
+		bool generateTextureEditor(Scene::Scene& scene, Scene::Object* guiSettings, std::string const& name, std::string& texture, std::string const& defaultTexture)
 		{
 			ImGui::PushID(name.c_str());
 
+			const std::string previousTexture = texture;
+
 			int previewHeight = guiSettings->component<GuiSettingsComponent>().m_materialEditorSettings.m_previewHeight;
 			int tooltipHeight = guiSettings->component<GuiSettingsComponent>().m_materialEditorSettings.m_tooltipHeight;
 
@@ -2936,6 +2928,8 @@ namespace GuiSettings
 			}
 
 			ImGui::PopID();
+
+			return texture != previousTexture;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -2948,24 +2942,29 @@ namespace GuiSettings
 			{
 				GPU::Material& material = scene.m_materials[currentMaterialId];
 
-				ImGui::Combo("Blend Mode", &material.m_blendMode, GPU::Material::BlendMode_meta);
+				bool changed = false;
+
+				changed |= ImGui::Combo("Blend Mode", &material.m_blendMode, GPU::Material::BlendMode_meta);
+
+				changed |= ImGui::ColorEdit3("Diffuse", glm::value_ptr(material.m_diffuse));
+				changed |= ImGui::ColorEdit3("Emissive", glm::value_ptr(material.m_emissive));
 
-				ImGui::ColorEdit3("Diffuse", glm::value_ptr(material.m_diffuse));
-				ImGui::ColorEdit3("Emissive", glm::value_ptr(material.m_emissive));
+				changed |= ImGui::SliderFloat("Opacity", &material.m_opacity, 0.0f, 1.0f);
+				changed |= ImGui::SliderFloat("Metallic", &material.m_metallic, 0.0f, 1.0f);
+				changed |= ImGui::SliderFloat("Roughness", &material.m_roughness, 0.015f, 1.0f);
+				changed |= ImGui::SliderFloat("Specular", &material.m_specular, 0.0f, 1.0f);
+				changed |= ImGui::SliderFloat("Normal Map Strength", &material.m_normalMapStrength, 0.0f, 1.0f);
+				changed |= ImGui::SliderFloat("Displacement Map Strength", &material.m_displacementScale, 0.0f, 1.0f);
+				changed |= ImGui::Checkbox("Two-sided", &material.m_twoSided);
 
-				ImGui::SliderFloat("Opacity", &material.m_opacity, 0.0f, 1.0f);
-				ImGui::SliderFloat("Metallic", &material.m_metallic, 0.0f, 1.0f);
-				ImGui::SliderFloat("Roughness", &material.m_roughness, 0.015f, 1.0f);
-				ImGui::SliderFloat("Specular", &material.m_specular, 0.0f, 1.0f);
-				ImGui::SliderFloat("Normal Map Strength", &material.m_normalMapStrength, 0.0f, 1.0f);
-				ImGui::SliderFloat("Displacement Map Strength", &material.m_displacementScale, 0.0f, 1.0f);
-				ImGui::Checkbox("Two-sided", &material.m_twoSided);
+				changed |= generateTextureEditor(scene, guiSettings, "Diffuse Map", material.m_diffuseMap, "default_diffuse_map");
+				changed |= generateTextureEditor(scene, guiSettings, "Normal Map", material.m_normalMap, "default_normal_map");
+				changed |= generateTextureEditor(scene, guiSettings, "Specular Map", material.m_specularMap, "default_specular_map");
+				changed |= generateTextureEditor(scene, guiSettings, "Alpha Map", material.m_alphaMap, "default_alpha_map");
+				changed |= generateTextureEditor(scene, guiSettings, "Displacement Map", material.m_displacementMap, "default_displacement_map");
 
-				generateTextureEditor(scene, guiSettings, "Diffuse Map", material.m_diffuseMap, "default_diffuse_map");
-				generateTextureEditor(scene, guiSettings, "Normal Map", material.m_normalMap, "default_normal_map");
-				generateTextureEditor(scene, guiSettings, "Specular Map", material.m_specularMap, "default_specular_map");
-				generateTextureEditor(scene, guiSettings, "Alpha Map", material.m_alphaMap, "default_alpha_map");
-				generateTextureEditor(scene, guiSettings, "Displacement Map", material.m_displacementMap, "default_displacement_map");
+				// Let the material table repack the edited material
+				if (changed) MaterialTable::markMaterialChanged(scene, currentMaterialId);
 			}
 			ImGui::EndChild();
 		}
@@ -3018,6 +3017,7 @@ namespace GuiSettings
 				std::string refMat = EditorSettings::editorProperty<std::string>(scene, guiSettings, "MaterialEditor_ReferenceMaterialName");
 				scene.m_materials[EditorSettings::editorProperty<std::string>(scene, guiSettings, "MaterialEditor_NewMaterialName")] = refMat.empty() ? GPU::Material() : scene.m_materials[refMat];
 				currentMaterialId = EditorSettings::editorProperty<std::string>(scene, guiSettings, "MaterialEditor_NewMaterialName");
+				MaterialTable::markMaterialChanged(scene, currentMaterialId);
 
 				ImGui::CloseCurrentPopup();
 			}
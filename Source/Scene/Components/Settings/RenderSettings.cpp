@@ -2,9 +2,14 @@
 #include "RenderSettings.h"
 #include "SimulationSettings.h"
 #include "DelayedJobs.h"
+#include "../Lighting/LightClusters.h"
 #include "../Lighting/ShadowMap.h"
 #include "../Lighting/VoxelGlobalIllumination.h"
 #include "../Rendering/Camera.h"
+#include "../Rendering/Transform.h"
+#include "../Rendering/Visibility.h"
+#include "../Rendering/DrawPackets.h"
+#include "../Rendering/MaterialTable.h"
 
 namespace RenderSettings
 {
@@ -350,6 +355,14 @@ namespace RenderSettings
 			lightingChanged |= ImGui::SliderFloat("Max Specular Power", &object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_specularPowerMax, 2.0f, 4096.0f);
 			ImGui::SliderFloat("Gamma", &object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_gamma, 0.0f, 8.0f);
 			ImGui::Checkbox("AO Affects Direct Light", &object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_aoAffectsDirectLighting);
+			ImGui::Checkbox("Clustered Light Culling", &object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_clusteredLightCulling);
+			ImGui::DragInt3("Light Clusters", glm::value_ptr(object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_lightClusters), 1, 1, 64);
+			ImGui::Checkbox("Validate Light Clusters", &object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_validateLightClusters);
+			if (ImGui::Button("Benchmark Light Clusters"))
+			{
+				LightClusters::benchmark(LightClusters::buildClusterGrid(object, getMainCamera(scene, object),
+					object->component<RenderSettings::RenderSettingsComponent>().m_lighting.m_lightClusters));
+			}
 			lightingChanged |= ImGui::Button("Update Lighting");
 
 			EditorSettings::editorProperty<std::string>(scene, object, "MainTabBar_SelectedTab") = ImGui::CurrentTabItemName();
@@ -365,6 +378,48 @@ namespace RenderSettings
 			lightingChanged |= ImGui::Combo("Shadows", &object->component<RenderSettings::RenderSettingsComponent>().m_features.m_shadowMethod, RenderSettings::ShadowMethod_meta);
 
 			ImGui::Checkbox("Depth Pre-pass", &object->component<RenderSettings::RenderSettingsComponent>().m_features.m_depthPrepass);
+			ImGui::Checkbox("Visibility Pass", &object->component<RenderSettings::RenderSettingsComponent>().m_features.m_visibilityPass);
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Visibility"))
+			{
+				Visibility::benchmark();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Draw Packets"))
+			{
+				DrawPackets::benchmark();
+			}
+			if (ImGui::Button("Validate Material Table"))
+			{
+				MaterialTable::validate();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark Material Table"))
+			{
+				MaterialTable::benchmark();
+			}
+			if (ImGui::Button("Validate GPU Layouts"))
+			{
+				GPU::validateLayouts();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Benchmark GPU Packing"))
+			{
+				GPU::benchmarkPacking();
+			}
+			if (ImGui::Button("Benchmark Transforms"))
+			{
+				Transform::benchmarkTransforms();
+			}
+			if (ImGui::Button("Validate Upload Ring"))
+			{
+				UploadRing::validate();
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Stress Test Upload Ring"))
+			{
+				UploadRing::stressTest();
+			}
 			ImGui::Checkbox("Wireframe Mesh", &object->component<RenderSettings::RenderSettingsComponent>().m_features.m_wireframeMesh);
 			ImGui::Checkbox("Show Aperture Size", &object->component<RenderSettings::RenderSettingsComponent>().m_features.m_showApertureSize);
 			ImGui::Checkbox("Background Rendering", &object->component<RenderSettings::RenderSettingsComponent>().m_features.m_backgroundRendering);
@@ -212,6 +212,15 @@ namespace RenderSettings
 
 		// Whether AO (ambient oclusion) affects direct lighting or not
 		bool m_aoAffectsDirectLighting = true;
+
+		// Whether point and spot lights are culled against a clustered view frustum or not
+		bool m_clusteredLightCulling = true;
+
+		// Number of light clusters along the individual axes
+		glm::ivec3 m_lightClusters{ 16, 9, 24 };
+
+		// Whether the clustered light assignment should be validated against brute force or not
+		bool m_validateLightClusters = false;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -235,6 +244,9 @@ namespace RenderSettings
 		// Whether depth pre-pass should be enabled or not
 		bool m_depthPrepass = true;
 
+		// Whether to cull every view in a single visibility pass at the start of the frame
+		bool m_visibilityPass = true;
+
 		// Whether the world should be rendered in wireframe mode or not
 		bool m_wireframeMesh = false;
 
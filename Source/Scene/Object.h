@@ -18,6 +18,10 @@ namespace Scene
 	using ComponentId = int;
 	using ObjectType = unsigned long long;
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Maximum number of component types; each one owns a bit of the 64-bit component masks. */
+	static constexpr ComponentId s_maxComponents = 64;
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** Component class to component id mapping. */
 	template<typename T> struct ComponentClassToComponentId {
@@ -50,16 +54,25 @@ namespace Scene
 	struct TypeErasedComponentUniquePtr
 	{
 		////////////////////////////////////////////////////////////////////////////////
-		using Storage = std::unique_ptr<void, void(*)(void const*)>;
+		/** Type-erased deleter; default constructible, so that empty component slots are valid. */
+		struct Deleter
+		{
+			void(*m_delete)(void const*) = nullptr;
+
+			void operator()(void const* data) const { m_delete(data); }
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		using Storage = std::unique_ptr<void, Deleter>;
 
 		////////////////////////////////////////////////////////////////////////////////
 		template<typename T>
 		inline static Storage make()
 		{
-			return Storage(new T(), [](void const* data)
+			return Storage(new T(), Deleter{ [](void const* data)
 			{
 				delete (static_cast<T const*>(data));
-			});
+			} });
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -78,7 +91,8 @@ namespace Scene
 	template<ComponentId id, typename ComponentClass = typename ComponentIdToComponentClass<id>::type>
 	void defaultComponentConstructor(Object& object)
 	{
-		object.m_components.emplace(std::make_pair(id, std::move(TypeErasedComponent::make<ComponentClass>())));
+		object.m_components[id] = TypeErasedComponent::make<ComponentClass>();
+		object.m_componentList |= (1ull << id);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -203,6 +217,7 @@ namespace Scene
 	namespace Scene \
 	{ \
 		static const ComponentId CONCAT(COMPONENT_ID_, NAME) = CONCAT(__COMPONENT_ID_, NAME); \
+		static_assert(CONCAT(__COMPONENT_ID_, NAME) < s_maxComponents, "Component id does not fit in the component masks."); \
 		template<> struct ComponentClassToComponentId<FULL_CLASS> { static constexpr ComponentId s_componentId = CONCAT(COMPONENT_ID_, NAME); }; \
 		template<> struct ComponentIdToComponentClass<CONCAT(COMPONENT_ID_, NAME)> { using type = FULL_CLASS; }; \
 		inline FULL_CLASS& CLASS(Object& object) { return object.component<FULL_CLASS>(); } \
@@ -317,8 +332,8 @@ namespace Scene
 		// The components that are attached to this object.
 		unsigned long long m_componentList = 0;
 
-		// Type agnostic component storage
-		std::unordered_map<ComponentId, TypeErasedComponent::Storage> m_components;
+		// Type agnostic component storage, indexed by the component id; empty slots belong to missing components
+		std::array<TypeErasedComponent::Storage, s_maxComponents> m_components;
 
 		////////////////////////////////////////////////////////////////////////////////
 		// Templated component getters
@@ -327,13 +342,13 @@ namespace Scene
 		////////////////////////////////////////////////////////////////////////////////
 		template<ComponentId id> typename ComponentIdToComponentClass<id>::type& component()
 		{
-			return TypeErasedComponent::extractRef<typename ComponentIdToComponentClass<id>::type>(m_components.find(id)->second);
+			return TypeErasedComponent::extractRef<typename ComponentIdToComponentClass<id>::type>(m_components[id]);
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
 		template<ComponentId id> typename ComponentIdToComponentClass<id>::type const& component() const
 		{
-			return TypeErasedComponent::extractConstRef<typename ComponentIdToComponentClass<id>::type>(m_components.find(id)->second);
+			return TypeErasedComponent::extractConstRef<typename ComponentIdToComponentClass<id>::type>(m_components[id]);
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -351,7 +366,7 @@ namespace Scene
 		////////////////////////////////////////////////////////////////////////////////
 		template<ComponentId id> bool hasComponent() const
 		{
-			return m_components.find(id) != m_components.end();
+			return (m_componentList & (1ull << id)) != 0;
 		}
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -363,11 +378,11 @@ namespace Scene
 		////////////////////////////////////////////////////////////////////////////////
 		template<ComponentId id> typename ComponentIdToComponentClass<id>::type& addComponent()
 		{
-			if (auto it = m_components.find(id); it != m_components.end())
-				return TypeErasedComponent::extractRef<T>(it->second);
+			if (hasComponent<id>())
+				return component<id>();
 
 			componentConstructors()[id](*this);
-			m_componentList |= std::bit_mask(id);
+			m_componentList |= (1ull << id);
 			return component<id>();
 		}
 
@@ -380,10 +395,10 @@ namespace Scene
 		////////////////////////////////////////////////////////////////////////////////
 		template<ComponentId id> bool removeComponent()
 		{
-			if (auto it = m_components.find(id); it != m_components.end())
+			if (hasComponent<id>())
 			{
-				m_components.erase(it);
-				m_componentList &= (~std::bit_mask(id));
+				m_components[id].reset();
+				m_componentList &= ~(1ull << id);
 				return true;
 			}
 
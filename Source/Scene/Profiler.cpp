@@ -6,6 +6,8 @@
 #include "Profiler.h"
 #include "Scene/Includes.h"
 
+#include <random>
+
 namespace Profiler
 {
 	////////////////////////////////////////////////////////////////////////////////
@@ -55,8 +57,14 @@ namespace Profiler
 	ProfilerDataEntry& dataEntry(Scene::Scene& scene, std::string const& category)
 	{
 		auto it = scene.m_profilerData.find(category);
-		if (it == scene.m_profilerData.end()) scene.m_profilerData[category].m_category = category;
-		return scene.m_profilerData[category];
+		if (it == scene.m_profilerData.end())
+		{
+			ProfilerDataEntry& entry = scene.m_profilerData[category];
+			entry.m_category = category;
+			entry.m_previousValues.setCapacity(scene.m_profilerHistoryLength);
+			return entry;
+		}
+		return it->second;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -142,7 +150,7 @@ namespace Profiler
 		entry.m_max = ProfilerDataEntry::EntryDataFieldTime(glm::max((float)std::get_or(entry.m_max, ProfilerDataEntry::EntryDataFieldTime(-FLT_MAX)), (float)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldTime(0.0f))));
 		entry.m_total = ProfilerDataEntry::EntryDataFieldTime((float)std::get_or(entry.m_total, ProfilerDataEntry::EntryDataFieldTime(0.0f)) + (float)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldTime(0.0f)));
 		entry.m_avg = ProfilerDataEntry::EntryDataFieldTime((float)std::get<ProfilerDataEntry::EntryDataFieldTime>(entry.m_total) / entry.m_totalValueCount);
-		if (store) entry.m_previousValues[frameId] = entry.m_current;
+		if (store) entry.m_previousValues.store(frameId, (float)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldTime(0.0f)));
 		entry.m_currentCountTmp = 0;
 		entry.m_currentTmp = ProfilerDataEntry::EntryDataFieldTime(0.0f);
 	}
@@ -159,7 +167,7 @@ namespace Profiler
 		entry.m_max = ProfilerDataEntry::EntryDataFieldOtherInt(glm::max((int)std::get_or(entry.m_max, ProfilerDataEntry::EntryDataFieldOtherInt(-INT_MAX)), (int)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldOtherInt(0))));
 		entry.m_total = ProfilerDataEntry::EntryDataFieldOtherInt((int)std::get_or(entry.m_total, ProfilerDataEntry::EntryDataFieldOtherInt(0)) + (int)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldOtherInt(0)));
 		entry.m_avg = ProfilerDataEntry::EntryDataFieldOtherInt((int)std::get<ProfilerDataEntry::EntryDataFieldOtherInt>(entry.m_total) / entry.m_totalValueCount);
-		if (store) entry.m_previousValues[frameId] = entry.m_current;
+		if (store) entry.m_previousValues.store(frameId, (int)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldOtherInt(0)));
 		entry.m_currentCountTmp = 0;
 		entry.m_currentTmp = ProfilerDataEntry::EntryDataFieldOtherInt(0);
 	}
@@ -176,7 +184,7 @@ namespace Profiler
 		entry.m_max = ProfilerDataEntry::EntryDataFieldOtherFloat(glm::max((float)std::get_or(entry.m_max, ProfilerDataEntry::EntryDataFieldOtherFloat(-FLT_MAX)), (float)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldOtherFloat(0.0f))));
 		entry.m_total = ProfilerDataEntry::EntryDataFieldOtherFloat((float)std::get_or(entry.m_total, ProfilerDataEntry::EntryDataFieldOtherFloat(0.0f)) + (float)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldOtherFloat(0.0f)));
 		entry.m_avg = ProfilerDataEntry::EntryDataFieldOtherFloat((float)std::get<ProfilerDataEntry::EntryDataFieldOtherFloat>(entry.m_total) / entry.m_totalValueCount);
-		if (store) entry.m_previousValues[frameId] = entry.m_current;
+		if (store) entry.m_previousValues.store(frameId, (float)std::get_or(entry.m_current, ProfilerDataEntry::EntryDataFieldOtherFloat(0.0f)));
 		entry.m_currentCountTmp = 0;
 		entry.m_currentTmp = ProfilerDataEntry::EntryDataFieldOtherFloat(0.0f);
 	}
@@ -193,7 +201,6 @@ namespace Profiler
 		entry.m_max = ProfilerDataEntry::EntryDataFieldOtherString(""s);
 		entry.m_total = ProfilerDataEntry::EntryDataFieldOtherString(""s);
 		entry.m_avg = ProfilerDataEntry::EntryDataFieldOtherString(""s);
-		if (store) entry.m_previousValues[frameId] = entry.m_current;
 		entry.m_currentCountTmp = 0;
 		entry.m_currentTmp = ProfilerDataEntry::EntryDataFieldOtherString(""s);
 	}
@@ -399,6 +406,7 @@ namespace Profiler
 	{
 		// Store the start time
 		m_times[0] = glfwGetTime();
+		if (isCapturingTrace(scene)) m_traceTimestamp = eventTimestamp();
 
 		// Insert it into the tree
 		m_iterator = enterRegion(m_scene, m_category, threadId, 
@@ -417,6 +425,10 @@ namespace Profiler
 		// Compute the elapsed time
 		float time = (m_times[1] - m_times[0]) * 1000.0f;
 
+		// Forward the scope to the trace capture
+		if (m_traceTimestamp != 0 && isCapturingTrace(m_scene))
+			recordTraceScope(m_scene, m_category.back(), Threading::currentThreadId(), m_traceTimestamp, eventTimestamp());
+
 		// Update the entry
 		appendValue(m_scene, m_iterator, m_threadId, time, m_sum, &appendEntryTime);
 
@@ -519,6 +531,10 @@ namespace Profiler
 	{
 		// Store the entry
 		storeData(m_scene, m_category, m_count, m_sum, m_threadId);
+
+		// Forward the value to the trace capture
+		if (isCapturingTrace(m_scene))
+			recordTraceCounter(m_scene, m_category, Threading::currentThreadId(), eventTimestamp(), m_count);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -589,6 +605,1193 @@ namespace Profiler
 		return 0;
     }
 
+	////////////////////////////////////////////////////////////////////////////////
+	ScopedCpuEvent::ScopedCpuEvent(Scene::Scene& scene, EventCategory const& category, bool sum, size_t threadId) :
+		ScopedCpuEvent(*scene.m_profilerEvents, category, sum, threadId)
+	{}
+
+	////////////////////////////////////////////////////////////////////////////////
+	ScopedCpuEvent::ScopedCpuEvent(EventStreams& streams, EventCategory const& category, bool sum, size_t threadId) :
+		m_category(category),
+		m_sum(sum)
+	{
+		// Make sure recording is on
+		if (threadId >= streams.m_buffers.size() || !streams.m_enabled.load(std::memory_order_relaxed))
+			return;
+
+		// Record the enclosing profiler region; only the profiled threads have a tree
+		ProfilerThreadTreeIterator region;
+		if (streams.m_writePosition != nullptr && threadId < Constants::s_maxProfilerThreads)
+			region = (*streams.m_writePosition)[threadId];
+
+		// Store the begin event, leaving room for the end events of every open scope
+		EventRingBuffer& buffer = streams.m_buffers[threadId];
+		if (buffer.push(Event{ m_category, eventTimestamp(), true, m_sum, region }, buffer.m_depth + 2))
+		{
+			++buffer.m_depth;
+			m_buffer = &buffer;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	ScopedCpuEvent::~ScopedCpuEvent()
+	{
+		if (m_buffer == nullptr)
+			return;
+
+		// Store the end event; the begin event already reserved a slot for it
+		m_buffer->push(Event{ m_category, eventTimestamp(), false, m_sum });
+		--m_buffer->m_depth;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether CPU profiling is currently enabled or not. */
+	bool profileCpu(Scene::Scene& scene)
+	{
+		Scene::Object* debugSettings = Scene::findFirstObject(scene, Scene::OBJECT_TYPE_DEBUG_SETTINGS);
+		return (debugSettings == nullptr && profilingDefault()) || (debugSettings != nullptr && debugSettings->component<DebugSettings::DebugSettingsComponent>().m_profileCpu);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Names of the regions leading from the root of the parameter tree to the parameter region. */
+	std::vector<std::string> regionPath(ProfilerThreadTree const& tree, ProfilerThreadTreeIterator region)
+	{
+		std::vector<std::string> result;
+		for (auto it = region; it.node != nullptr && tree.is_head(it) == false; it = tree.parent(it))
+			result.insert(result.begin(), it->m_name);
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Finds the region of the parameter thread's tree with the parameter path, creating it if needed. */
+	ProfilerThreadTreeIterator findRegion(Scene::Scene& scene, size_t threadId, std::vector<std::string> const& path)
+	{
+		ProfilerThreadTree& tree = scene.m_profilerTree[scene.m_profilerBufferWriteId][threadId];
+		ProfilerThreadTreeIterator& writePosition = scene.m_profilerWritePosition[threadId];
+		const ProfilerThreadTreeIterator previousPosition = writePosition;
+
+		writePosition = tree.begin();
+		for (auto const& name : path)
+			enterRegionImpl(scene, name, tree, writePosition, threadId, nullptr, nullptr);
+
+		const ProfilerThreadTreeIterator result = writePosition;
+		writePosition = previousPosition;
+		return result;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Finds the child of the parameter aggregation node with the category and region of the event, creating it if needed. */
+	size_t enterAggregate(std::vector<EventAggregate>& aggregates, size_t parent, Event const& event)
+	{
+		size_t lastChild = 0;
+		for (size_t child = aggregates[parent].m_firstChild; child != 0; child = aggregates[child].m_nextSibling)
+		{
+			if (aggregates[child].m_category.m_id == event.m_category.m_id && aggregates[child].m_region == event.m_region)
+				return child;
+			lastChild = child;
+		}
+
+		EventAggregate aggregate;
+		aggregate.m_category = event.m_category;
+		aggregate.m_sum = event.m_sum;
+		aggregate.m_region = event.m_region;
+		aggregate.m_parent = parent;
+
+		// The root is never a child, so index 0 doubles as the end of the lists
+		const size_t childId = aggregates.size();
+		aggregates.push_back(aggregate);
+		if (lastChild == 0) aggregates[parent].m_firstChild = childId;
+		else aggregates[lastChild].m_nextSibling = childId;
+		return childId;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Writes the children of the parameter aggregation node into the tree of the parameter thread, recursively. */
+	void emitAggregates(Scene::Scene& scene, size_t threadId, std::vector<EventAggregate> const& aggregates, size_t parent, ProfilerThreadTreeIterator parentRegion)
+	{
+		ProfilerThreadTree& tree = scene.m_profilerTree[scene.m_profilerBufferWriteId][threadId];
+		ProfilerThreadTreeIterator& writePosition = scene.m_profilerWritePosition[threadId];
+
+		for (size_t child = aggregates[parent].m_firstChild; child != 0; child = aggregates[child].m_nextSibling)
+		{
+			EventAggregate const& aggregate = aggregates[child];
+
+			// Scopes opened in the same region as their parent scope are nested under it; the others
+			// were opened inside a perf counter of the parent scope, and go into its region
+			writePosition = aggregate.m_region == aggregates[parent].m_region ? parentRegion : aggregate.m_region;
+			enterRegionImpl(scene, std::string(aggregate.m_category.m_name), tree, writePosition, threadId,
+				[&scene](ProfilerDataEntry& entry)
+				{
+					storeValue(scene, entry, &storeEntryTime);
+				},
+				nullptr);
+			const ProfilerThreadTreeIterator region = writePosition;
+
+			// Scopes that are still open have no time yet
+			if (aggregate.m_count > 0)
+			{
+				ProfilerDataEntry& entry = dataEntry(scene, *region);
+				appendEntryTime(entry, aggregate.m_time, aggregate.m_sum);
+				entry.m_currentCountTmp += aggregate.m_count - 1;
+			}
+
+			emitAggregates(scene, threadId, aggregates, child, region);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void aggregateEvents(Scene::Scene& scene, EventStreams& streams)
+	{
+		const bool capturingTrace = isCapturingTrace(scene);
+
+		// Aggregate the events of each thread
+		for (size_t threadId = 0; threadId < streams.m_buffers.size(); ++threadId)
+		{
+			EventRingBuffer& buffer = streams.m_buffers[threadId];
+			std::vector<Event>& openScopes = streams.m_openScopes[threadId];
+
+			// Skip the idle threads
+			if (openScopes.empty() && buffer.m_tail.load(std::memory_order_relaxed) == buffer.m_head.load(std::memory_order_acquire))
+				continue;
+
+			// Only the profiled threads have a tree to write into; the rest only feed the trace capture
+			const bool hasTree = threadId < numProfiledThreads();
+
+			// Restore the scopes that were left open during the previous aggregation, re-entering their
+			// regions in the current tree
+			std::vector<EventAggregate>& aggregates = streams.m_aggregates;
+			std::vector<size_t>& stack = streams.m_aggregateStack;
+			std::vector<std::vector<std::string>>& openScopeRegions = streams.m_openScopeRegions[threadId];
+			aggregates.assign(1, EventAggregate{});
+			stack.assign(1, 0);
+			for (size_t scopeId = 0; scopeId < openScopes.size(); ++scopeId)
+			{
+				openScopes[scopeId].m_region = hasTree && scopeId < openScopeRegions.size() ?
+					findRegion(scene, threadId, openScopeRegions[scopeId]) : ProfilerThreadTreeIterator();
+				stack.push_back(enterAggregate(aggregates, stack.back(), openScopes[scopeId]));
+			}
+
+			// Process the pending events
+			Event event;
+			while (buffer.pop(event))
+			{
+				if (event.m_begin)
+				{
+					stack.push_back(enterAggregate(aggregates, stack.back(), event));
+					openScopes.push_back(event);
+				}
+				else if (!openScopes.empty())
+				{
+					// Accumulate the elapsed time
+					Event const& beginEvent = openScopes.back();
+					EventAggregate& aggregate = aggregates[stack.back()];
+					const float time = (event.m_timestamp - beginEvent.m_timestamp) / 1000000.0f;
+					aggregate.m_time = aggregate.m_sum ? aggregate.m_time + time : time;
+					++aggregate.m_count;
+
+					// Forward the scope to the trace capture
+					if (capturingTrace)
+						recordTraceScope(scene, beginEvent.m_category, threadId, beginEvent.m_timestamp, event.m_timestamp);
+
+					stack.pop_back();
+					openScopes.pop_back();
+				}
+			}
+
+			// Remember the regions of the scopes left open, by name
+			openScopeRegions.clear();
+			for (auto const& scope : openScopes)
+				openScopeRegions.push_back(hasTree ? regionPath(scene.m_profilerTree[scene.m_profilerBufferWriteId][threadId], scope.m_region) : std::vector<std::string>{});
+
+			// Touch the tree of the producer thread once per distinct scope
+			if (hasTree)
+			{
+				ProfilerThreadTreeIterator& writePosition = scene.m_profilerWritePosition[threadId];
+				const ProfilerThreadTreeIterator previousPosition = writePosition;
+				emitAggregates(scene, threadId, aggregates, 0, scene.m_profilerTree[scene.m_profilerBufferWriteId][threadId].begin());
+				writePosition = previousPosition;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void flushEvents(Scene::Scene& scene)
+	{
+		EventStreams& streams = *scene.m_profilerEvents;
+
+		// Aggregate the events recorded during the frame
+		aggregateEvents(scene, streams);
+
+		// Report the events lost to full buffers, since they leave the aggregated times undercounted
+		streams.m_numDroppedLastFrame = 0;
+		for (auto& buffer : streams.m_buffers)
+			streams.m_numDroppedLastFrame += buffer.m_numDropped.exchange(0, std::memory_order_relaxed);
+		if (streams.m_numDroppedLastFrame > 0)
+		{
+			streams.m_numDroppedTotal += streams.m_numDroppedLastFrame;
+			Debug::log_warning() << "Profiler event buffers are full; dropped " << streams.m_numDroppedLastFrame << " events this frame"
+				<< " (" << streams.m_numDroppedTotal << " in total). The affected scopes are undercounted." << Debug::end;
+		}
+
+		// Refresh the recording flag
+		streams.m_enabled = profileCpu(scene);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkScopes(Scene::Scene& scene, size_t numScopes)
+	{
+		volatile size_t sink = 0;
+
+		// Bare loop, subtracted from the other measurements
+		DateTime::Timer baselineTimer(true);
+		for (size_t i = 0; i < numScopes; ++i)
+			sink = sink + i;
+		baselineTimer.stop();
+
+		// Regular CPU perf counters
+		DateTime::Timer counterTimer(true);
+		{
+			ScopedCpuPerfCounter perfCounter(scene, "Scope Benchmark (Perf Counters)");
+			for (size_t i = 0; i < numScopes; ++i)
+			{
+				ScopedCpuPerfCounter scopeCounter(scene, "Scope", true);
+				sink = sink + i;
+			}
+		}
+		counterTimer.stop();
+
+		// Event path, into private streams so the benchmark cannot overflow the frame's buffers
+		std::unique_ptr<EventStreams> streams = std::make_unique<EventStreams>();
+		streams->m_writePosition = &scene.m_profilerWritePosition;
+		const size_t threadId = Threading::currentThreadId();
+		const size_t batchSize = Constants::s_profilerEventBufferSize / 4;
+
+		// Recording disabled
+		streams->m_enabled = false;
+		DateTime::Timer disabledTimer(true);
+		for (size_t i = 0; i < numScopes; ++i)
+		{
+			ScopedCpuEvent scopeEvent(*streams, "Scope", true, threadId);
+			sink = sink + i;
+		}
+		disabledTimer.stop();
+
+		// Recording enabled; the buffers are aggregated whenever they fill up, like at the end of a frame
+		streams->m_enabled = true;
+		double recordTime = 0.0, aggregateTime = 0.0;
+		{
+			ScopedCpuPerfCounter perfCounter(scene, "Scope Benchmark (Events)");
+			for (size_t batchStart = 0; batchStart < numScopes; batchStart += batchSize)
+			{
+				const size_t batchEnd = glm::min(batchStart + batchSize, numScopes);
+
+				DateTime::Timer recordTimer(true);
+				for (size_t i = batchStart; i < batchEnd; ++i)
+				{
+					ScopedCpuEvent scopeEvent(*streams, "Scope", true, threadId);
+					sink = sink + i;
+				}
+				recordTimer.stop();
+				recordTime += recordTimer.getElapsedTime();
+
+				DateTime::Timer aggregateTimer(true);
+				aggregateEvents(scene, *streams);
+				aggregateTimer.stop();
+				aggregateTime += aggregateTimer.getElapsedTime();
+			}
+		}
+
+		size_t numDropped = 0;
+		for (auto const& buffer : streams->m_buffers)
+			numDropped += buffer.m_numDropped.load();
+
+		const double baseline = baselineTimer.getElapsedTime();
+		auto perScope = [&](double seconds) { return glm::max(seconds - baseline, 0.0) * 1e9 / double(glm::max(numScopes, size_t(1))); };
+		Debug::log_info() << "Profiler scope benchmark (" << numScopes << " scopes):" << Debug::end;
+		Debug::log_info() << "  - perf counters: " << perScope(counterTimer.getElapsedTime()) << " ns per scope"
+			<< (profileCpu(scene) ? "" : " (CPU profiling is disabled)") << Debug::end;
+		Debug::log_info() << "  - events, disabled: " << perScope(disabledTimer.getElapsedTime()) << " ns per scope" << Debug::end;
+		Debug::log_info() << "  - events, recording: " << perScope(recordTime) << " ns per scope" << Debug::end;
+		Debug::log_info() << "  - events, aggregation: " << aggregateTime * 1e9 / double(glm::max(numScopes, size_t(1))) << " ns per scope" << Debug::end;
+		Debug::log_info() << "  - dropped events: " << numDropped << Debug::end;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Escapes the parameter string for a JSON string literal. */
+	void appendJsonString(std::string& out, std::string const& value)
+	{
+		out += '"';
+		for (char c : value)
+		{
+			switch (c)
+			{
+			case '"':  out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if ((unsigned char)c >= 0x20) out += c;
+			}
+		}
+		out += '"';
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a nanosecond timestamp as fractional microseconds. */
+	void appendJsonMicroseconds(std::string& out, long long nanoseconds)
+	{
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", nanoseconds / 1000, nanoseconds % 1000);
+		out += buffer;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Resolves an interned record name on the writer thread. */
+	std::string const& traceName(TraceWriter& writer, unsigned long long nameId)
+	{
+		// Copy the name over from the shared table on first use
+		auto it = writer.m_writerNames.find(nameId);
+		if (it == writer.m_writerNames.end())
+		{
+			std::lock_guard namesLock(writer.m_namesMutex);
+			auto shared = writer.m_names.find(nameId);
+			it = writer.m_writerNames.emplace(nameId, shared != writer.m_names.end() ? shared->second : "Unknown").first;
+		}
+		return it->second;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a single record in the Chrome JSON trace event format. */
+	void appendChromeTraceEvent(TraceWriter& writer, std::string& out, TraceEvent const& event)
+	{
+		// Name the thread on its first appearance
+		if (writer.m_tracksWritten.insert(event.m_threadId).second)
+		{
+			if (writer.m_numEventsWritten++ > 0) out += ",\n";
+			out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(event.m_threadId) + ",\"args\":{\"name\":";
+			appendJsonString(out, event.m_threadId == 0 ? "Main Thread" : "Worker " + std::to_string(event.m_threadId));
+			out += "}}";
+		}
+
+		if (writer.m_numEventsWritten++ > 0) out += ",\n";
+		out += "{\"name\":";
+		appendJsonString(out, traceName(writer, event.m_nameId));
+		out += ",\"pid\":0,\"tid\":" + std::to_string(event.m_threadId);
+		out += ",\"ts\":";
+		appendJsonMicroseconds(out, event.m_timestamp);
+		if (event.m_type == TraceEvent::Scope)
+		{
+			out += ",\"ph\":\"X\",\"cat\":\"cpu\",\"dur\":";
+			appendJsonMicroseconds(out, event.m_duration);
+			out += "}";
+		}
+		else
+		{
+			out += ",\"ph\":\"C\",\"cat\":\"counter\",\"args\":{\"value\":" + std::to_string(event.m_value) + "}}";
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Protobuf wire format helpers. */
+	void appendProtoVarint(std::string& out, unsigned long long value)
+	{
+		for (; value >= 0x80; value >>= 7)
+			out += char((value & 0x7F) | 0x80);
+		out += char(value);
+	}
+
+	void appendProtoTag(std::string& out, int field, int wireType)
+	{
+		appendProtoVarint(out, (unsigned long long)((field << 3) | wireType));
+	}
+
+	void appendProtoVarintField(std::string& out, int field, unsigned long long value)
+	{
+		appendProtoTag(out, field, 0);
+		appendProtoVarint(out, value);
+	}
+
+	void appendProtoDoubleField(std::string& out, int field, double value)
+	{
+		appendProtoTag(out, field, 1);
+		unsigned long long bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		for (int i = 0; i < 8; ++i)
+			out += char((bits >> (i * 8)) & 0xFF);
+	}
+
+	void appendProtoBytesField(std::string& out, int field, std::string const& value)
+	{
+		appendProtoTag(out, field, 2);
+		appendProtoVarint(out, value.size());
+		out += value;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Field numbers of the Perfetto trace messages we emit (perfetto/trace/trace_packet.proto). */
+	namespace PerfettoFields
+	{
+		static constexpr int Trace_packet = 1;
+
+		static constexpr int TracePacket_timestamp = 8;
+		static constexpr int TracePacket_trustedPacketSequenceId = 10;
+		static constexpr int TracePacket_trackEvent = 11;
+		static constexpr int TracePacket_trackDescriptor = 60;
+
+		static constexpr int TrackDescriptor_uuid = 1;
+		static constexpr int TrackDescriptor_name = 2;
+		static constexpr int TrackDescriptor_thread = 4;
+		static constexpr int TrackDescriptor_counter = 8;
+
+		static constexpr int ThreadDescriptor_pid = 1;
+		static constexpr int ThreadDescriptor_tid = 2;
+
+		static constexpr int TrackEvent_type = 9;
+		static constexpr int TrackEvent_trackUuid = 11;
+		static constexpr int TrackEvent_name = 23;
+		static constexpr int TrackEvent_doubleCounterValue = 44;
+
+		static constexpr int TrackEventType_sliceBegin = 1;
+		static constexpr int TrackEventType_sliceEnd = 2;
+		static constexpr int TrackEventType_counter = 4;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a single packet to a Perfetto trace stream. */
+	void appendPerfettoPacket(std::string& out, unsigned long long timestamp, int payloadField, std::string const& payload)
+	{
+		std::string packet;
+		if (payloadField == PerfettoFields::TracePacket_trackEvent)
+			appendProtoVarintField(packet, PerfettoFields::TracePacket_timestamp, timestamp);
+		appendProtoVarintField(packet, PerfettoFields::TracePacket_trustedPacketSequenceId, 1);
+		appendProtoBytesField(packet, payloadField, payload);
+		appendProtoBytesField(out, PerfettoFields::Trace_packet, packet);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a single record in the Perfetto protobuf trace format. */
+	void appendPerfettoTraceEvent(TraceWriter& writer, std::string& out, TraceEvent const& event)
+	{
+		// Thread tracks are numbered after the thread ids, counter tracks use the name hash with the top bit set
+		const unsigned long long trackUuid = event.m_type == TraceEvent::Scope ?
+			(unsigned long long)(event.m_threadId + 1) :
+			(event.m_nameId | (1ull << 63));
+
+		// Write out the track descriptor on the first appearance
+		if (writer.m_tracksWritten.insert(trackUuid).second)
+		{
+			std::string descriptor;
+			appendProtoVarintField(descriptor, PerfettoFields::TrackDescriptor_uuid, trackUuid);
+			if (event.m_type == TraceEvent::Scope)
+			{
+				std::string thread;
+				appendProtoVarintField(thread, PerfettoFields::ThreadDescriptor_pid, 1);
+				appendProtoVarintField(thread, PerfettoFields::ThreadDescriptor_tid, event.m_threadId + 1);
+				appendProtoBytesField(descriptor, PerfettoFields::TrackDescriptor_name, event.m_threadId == 0 ? "Main Thread" : "Worker " + std::to_string(event.m_threadId));
+				appendProtoBytesField(descriptor, PerfettoFields::TrackDescriptor_thread, thread);
+			}
+			else
+			{
+				appendProtoBytesField(descriptor, PerfettoFields::TrackDescriptor_name, traceName(writer, event.m_nameId));
+				appendProtoBytesField(descriptor, PerfettoFields::TrackDescriptor_counter, "");
+			}
+			appendPerfettoPacket(out, 0, PerfettoFields::TracePacket_trackDescriptor, descriptor);
+		}
+
+		if (event.m_type == TraceEvent::Scope)
+		{
+			// Slice begin and end on the thread track
+			std::string begin;
+			appendProtoVarintField(begin, PerfettoFields::TrackEvent_type, PerfettoFields::TrackEventType_sliceBegin);
+			appendProtoVarintField(begin, PerfettoFields::TrackEvent_trackUuid, trackUuid);
+			appendProtoBytesField(begin, PerfettoFields::TrackEvent_name, traceName(writer, event.m_nameId));
+			appendPerfettoPacket(out, event.m_timestamp, PerfettoFields::TracePacket_trackEvent, begin);
+
+			std::string end;
+			appendProtoVarintField(end, PerfettoFields::TrackEvent_type, PerfettoFields::TrackEventType_sliceEnd);
+			appendProtoVarintField(end, PerfettoFields::TrackEvent_trackUuid, trackUuid);
+			appendPerfettoPacket(out, event.m_timestamp + event.m_duration, PerfettoFields::TracePacket_trackEvent, end);
+		}
+		else
+		{
+			std::string counter;
+			appendProtoVarintField(counter, PerfettoFields::TrackEvent_type, PerfettoFields::TrackEventType_counter);
+			appendProtoVarintField(counter, PerfettoFields::TrackEvent_trackUuid, trackUuid);
+			appendProtoDoubleField(counter, PerfettoFields::TrackEvent_doubleCounterValue, event.m_value);
+			appendPerfettoPacket(out, event.m_timestamp, PerfettoFields::TracePacket_trackEvent, counter);
+		}
+		++writer.m_numEventsWritten;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Serializes an event block into the output file. */
+	void writeTraceBlock(TraceWriter& writer, std::vector<TraceEvent> const& block)
+	{
+		std::string out;
+		out.reserve(block.size() * 128);
+		for (auto const& event : block)
+		{
+			if (writer.m_format == ChromeJson) appendChromeTraceEvent(writer, out, event);
+			else                               appendPerfettoTraceEvent(writer, out, event);
+		}
+		writer.m_file.write(out.data(), out.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Background writer thread callback. */
+	void traceWriterThreadCallback(TraceWriter& writer)
+	{
+		while (true)
+		{
+			// Wait for handed over records or the stop signal
+			std::unique_lock writerLock(writer.m_writerMutex);
+			writer.m_writerCondition.wait(writerLock, [&]() { return writer.m_blockPending || writer.m_stop; });
+			if (!writer.m_blockPending && writer.m_stop)
+				break;
+
+			// Write out the pending records without holding the lock; the recording threads only touch their current buffers
+			writerLock.unlock();
+			for (auto& buffer : writer.m_threadBuffers)
+			{
+				writeTraceBlock(writer, buffer.m_pending);
+				buffer.m_pending.clear();
+			}
+
+			// Signal that the pending buffers can be reused
+			writerLock.lock();
+			writer.m_blockPending = false;
+			writer.m_writerCondition.notify_all();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Hands the records of every thread over to the writer thread. */
+	void submitTraceBlock(TraceWriter& writer)
+	{
+		// Wait for the writer to finish the previous records
+		std::unique_lock writerLock(writer.m_writerMutex);
+		writer.m_writerCondition.wait(writerLock, [&]() { return !writer.m_blockPending; });
+
+		// Swap the buffers of each thread; the recording threads continue into the emptied ones
+		bool anyRecords = false;
+		for (auto& buffer : writer.m_threadBuffers)
+		{
+			std::lock_guard bufferLock(buffer.m_mutex);
+			buffer.m_records.swap(buffer.m_pending);
+			anyRecords = anyRecords || !buffer.m_pending.empty();
+		}
+		if (!anyRecords)
+			return;
+
+		// Wake up the writer
+		writer.m_blockPending = true;
+		writer.m_writerCondition.notify_all();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Flushes the remaining records, stops the writer thread and closes the file. */
+	void closeTraceWriter(TraceWriter& writer)
+	{
+		// Stop accepting records; the final hand-over takes every buffer lock, which waits out the in-flight recorders
+		writer.m_capturing.store(false, std::memory_order_release);
+
+		if (writer.m_writerThread.joinable())
+		{
+			submitTraceBlock(writer);
+			{
+				std::lock_guard writerLock(writer.m_writerMutex);
+				writer.m_stop = true;
+				writer.m_writerCondition.notify_all();
+			}
+			writer.m_writerThread.join();
+		}
+
+		if (writer.m_file.is_open())
+		{
+			if (writer.m_format == ChromeJson)
+				writer.m_file << "\n]}\n";
+			writer.m_file.close();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	TraceWriter::~TraceWriter()
+	{
+		closeTraceWriter(*this);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool startTraceCapture(Scene::Scene& scene, std::string const& fileName, TraceFormat format)
+	{
+		// Stop any ongoing capture first
+		stopTraceCapture(scene);
+
+		TraceWriter& writer = *scene.m_profilerTrace;
+		writer.m_format = format;
+		writer.m_filePath = (EnginePaths::assetsFolder() / "Generated" / "Profiler" / fileName).string();
+
+		// Open the output file
+		EnginePaths::makeDirectoryStructure(writer.m_filePath, true);
+		writer.m_file.open(writer.m_filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!writer.m_file.good())
+		{
+			Debug::log_error() << "Unable to open trace output file: " << writer.m_filePath << Debug::end;
+			writer.m_file.close();
+			return false;
+		}
+
+		Debug::log_info() << "Trace capture start, output file name: " << writer.m_filePath << Debug::end;
+
+		// Write the header
+		if (format == ChromeJson)
+			writer.m_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		// Reset the per-capture state
+		writer.m_tracksWritten.clear();
+		writer.m_numEventsWritten = 0;
+		writer.m_blockPending = false;
+		writer.m_stop = false;
+
+		// Start the writer thread
+		writer.m_startTimestamp = eventTimestamp();
+		writer.m_writerThread = std::thread(traceWriterThreadCallback, std::ref(writer));
+
+		// Publish the capture to the recording threads
+		writer.m_capturing.store(true, std::memory_order_release);
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void stopTraceCapture(Scene::Scene& scene)
+	{
+		if (!isCapturingTrace(scene)) return;
+
+		closeTraceWriter(*scene.m_profilerTrace);
+
+		Debug::log_info() << "Trace capture end, " << scene.m_profilerTrace->m_numEventsWritten << " records written to " << scene.m_profilerTrace->m_filePath << Debug::end;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool isCapturingTrace(Scene::Scene& scene)
+	{
+		return scene.m_profilerTrace->m_capturing.load(std::memory_order_acquire);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Continues an FNV-1a hash with the parameter string, matching hashEventCategory. */
+	unsigned long long hashTraceName(unsigned long long hash, std::string_view name)
+	{
+		for (char c : name)
+			hash = (hash ^ (unsigned long long)(unsigned char)c) * 1099511628211ull;
+		return hash;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Appends a record to the calling thread's trace buffer. The name is only built and
+	    interned the first time the thread records it. */
+	template<typename N>
+	void recordTraceEvent(TraceWriter& writer, TraceEvent event, N const& makeName)
+	{
+		TraceThreadBuffer& buffer = writer.m_threadBuffers[Threading::currentThreadId() % writer.m_threadBuffers.size()];
+		std::lock_guard bufferLock(buffer.m_mutex);
+
+		// The capture may have stopped since the caller checked
+		if (!writer.m_capturing.load(std::memory_order_acquire))
+			return;
+
+		// Intern the name on its first use on this thread
+		if (buffer.m_internedNames.insert(event.m_nameId).second)
+		{
+			std::lock_guard namesLock(writer.m_namesMutex);
+			if (writer.m_names.find(event.m_nameId) == writer.m_names.end())
+				writer.m_names.emplace(event.m_nameId, makeName());
+		}
+
+		event.m_timestamp = glm::max(event.m_timestamp - writer.m_startTimestamp, 0ll);
+		buffer.m_records.push_back(event);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void recordTraceScope(Scene::Scene& scene, std::string const& name, size_t threadId, long long beginTimestamp, long long endTimestamp)
+	{
+		TraceWriter& writer = *scene.m_profilerTrace;
+		if (!writer.m_capturing.load(std::memory_order_relaxed)) return;
+
+		TraceEvent event;
+		event.m_type = TraceEvent::Scope;
+		event.m_nameId = hashTraceName(hashEventCategory(""), name);
+		event.m_threadId = threadId;
+		event.m_timestamp = beginTimestamp;
+		event.m_duration = glm::max(endTimestamp - beginTimestamp, 0ll);
+		recordTraceEvent(writer, event, [&]() { return name; });
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void recordTraceScope(Scene::Scene& scene, EventCategory const& category, size_t threadId, long long beginTimestamp, long long endTimestamp)
+	{
+		TraceWriter& writer = *scene.m_profilerTrace;
+		if (!writer.m_capturing.load(std::memory_order_relaxed)) return;
+
+		TraceEvent event;
+		event.m_type = TraceEvent::Scope;
+		event.m_nameId = category.m_id;
+		event.m_threadId = threadId;
+		event.m_timestamp = beginTimestamp;
+		event.m_duration = glm::max(endTimestamp - beginTimestamp, 0ll);
+		recordTraceEvent(writer, event, [&]() { return std::string(category.m_name); });
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void recordTraceCounter(Scene::Scene& scene, Category const& category, size_t threadId, long long timestamp, double value)
+	{
+		TraceWriter& writer = *scene.m_profilerTrace;
+		if (!writer.m_capturing.load(std::memory_order_relaxed)) return;
+
+		// Hash the joined category name without building it
+		unsigned long long nameId = hashEventCategory("");
+		for (size_t i = 0; i < category.size(); ++i)
+			nameId = hashTraceName(i == 0 ? nameId : hashTraceName(nameId, "::"), category[i]);
+
+		TraceEvent event;
+		event.m_type = TraceEvent::Counter;
+		event.m_nameId = nameId;
+		event.m_threadId = threadId;
+		event.m_timestamp = timestamp;
+		event.m_value = value;
+		recordTraceEvent(writer, event, [&]() { return std::string_join("::", category.begin(), category.end()); });
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether the parameter scope intervals of a single thread form a proper hierarchy. */
+	bool traceScopesNested(std::vector<std::pair<long long, long long>> scopes)
+	{
+		// Parents come before their children when sorted by begin time, then by decreasing end time
+		std::sort(scopes.begin(), scopes.end(), [](auto const& a, auto const& b)
+			{ return a.first < b.first || (a.first == b.first && a.second > b.second); });
+
+		std::vector<long long> openScopes;
+		for (auto const& [begin, end] : scopes)
+		{
+			while (!openScopes.empty() && openScopes.back() <= begin)
+				openScopes.pop_back();
+			if (!openScopes.empty() && end > openScopes.back())
+				return false;
+			openScopes.push_back(end);
+		}
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Parses a single record written by appendChromeTraceEvent into key-value pairs.
+	    String values are unescaped, nested objects are kept as raw text. */
+	bool parseChromeTraceRecord(std::string_view text, std::unordered_map<std::string, std::string>& fields)
+	{
+		size_t pos = 0;
+
+		// Reads a string literal starting at the current position
+		auto readString = [&](std::string& out)
+		{
+			if (pos >= text.size() || text[pos] != '"') return false;
+			for (++pos; pos < text.size(); ++pos)
+			{
+				if (text[pos] == '"') { ++pos; return true; }
+				if (text[pos] == '\\' && ++pos >= text.size()) return false;
+				out += text[pos];
+			}
+			return false;
+		};
+
+		// Reads a string, number or nested object
+		auto readValue = [&](std::string& out)
+		{
+			if (pos < text.size() && text[pos] == '"')
+				return readString(out);
+
+			const size_t begin = pos;
+			int depth = 0;
+			while (pos < text.size() && (depth > 0 || (text[pos] != ',' && text[pos] != '}')))
+			{
+				std::string ignored;
+				if (text[pos] == '"') { if (!readString(ignored)) return false; }
+				else if (text[pos] == '{') ++depth, ++pos;
+				else if (text[pos] == '}') --depth, ++pos;
+				else ++pos;
+			}
+			out = std::string(text.substr(begin, pos - begin));
+			return depth == 0 && !out.empty();
+		};
+
+		if (text.empty() || text[pos++] != '{') return false;
+		while (pos < text.size())
+		{
+			std::string key, value;
+			if (!readString(key) || pos >= text.size() || text[pos++] != ':' || !readValue(value)) return false;
+			if (!fields.emplace(key, value).second) return false;
+			if (pos >= text.size()) return false;
+			if (text[pos] == '}') return ++pos == text.size();
+			if (text[pos++] != ',') return false;
+		}
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Converts a fractional microsecond value written by appendJsonMicroseconds back to nanoseconds. */
+	bool parseChromeTraceTimestamp(std::string const& value, long long& nanoseconds)
+	{
+		const size_t separator = value.find('.');
+		if (separator == std::string::npos || value.size() - separator != 4) return false;
+		try
+		{
+			nanoseconds = std::stoll(value.substr(0, separator)) * 1000 + std::stoll(value.substr(separator + 1));
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the structure of a Chrome JSON trace and counts the records per name. */
+	bool validateChromeTrace(std::string const& contents, std::unordered_map<std::string, size_t>& recordCounts)
+	{
+		const std::string header = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		const std::string footer = "\n]}\n";
+		if (contents.size() < header.size() + footer.size() ||
+			contents.compare(0, header.size(), header) != 0 ||
+			contents.compare(contents.size() - footer.size(), footer.size(), footer) != 0)
+		{
+			Debug::log_error() << "Chrome trace: missing or malformed header and footer" << Debug::end;
+			return false;
+		}
+
+		std::unordered_set<std::string> namedThreads;
+		std::unordered_map<std::string, std::vector<std::pair<long long, long long>>> threadScopes;
+
+		// One record per line, separated by commas
+		const std::string_view body = std::string_view(contents).substr(header.size(), contents.size() - header.size() - footer.size());
+		for (size_t lineStart = 0, lineId = 0; lineStart < body.size(); ++lineId)
+		{
+			const size_t lineEnd = glm::min(body.find('\n', lineStart), body.size());
+			std::string_view record = body.substr(lineStart, lineEnd - lineStart);
+			const bool lastRecord = lineEnd == body.size();
+			lineStart = lineEnd + 1;
+
+			if (!lastRecord && (record.empty() || record.back() != ','))
+			{
+				Debug::log_error() << "Chrome trace: record " << lineId << " is not followed by a separator" << Debug::end;
+				return false;
+			}
+			if (!lastRecord) record.remove_suffix(1);
+
+			std::unordered_map<std::string, std::string> fields;
+			if (!parseChromeTraceRecord(record, fields))
+			{
+				Debug::log_error() << "Chrome trace: unable to parse record " << lineId << ": " << std::string(record) << Debug::end;
+				return false;
+			}
+			for (auto key : { "name", "ph", "pid", "tid" })
+			{
+				if (fields.count(key) == 0)
+				{
+					Debug::log_error() << "Chrome trace: record " << lineId << " is missing the '" << key << "' field" << Debug::end;
+					return false;
+				}
+			}
+
+			std::string const& phase = fields["ph"];
+			std::string const& tid = fields["tid"];
+			if (phase == "M")
+			{
+				// Thread names must precede the records of the thread
+				if (fields["name"] != "thread_name" || !namedThreads.insert(tid).second)
+				{
+					Debug::log_error() << "Chrome trace: invalid or duplicate metadata record " << lineId << Debug::end;
+					return false;
+				}
+				continue;
+			}
+
+			long long timestamp = 0, duration = 0;
+			if (!parseChromeTraceTimestamp(fields["ts"], timestamp) || namedThreads.count(tid) == 0)
+			{
+				Debug::log_error() << "Chrome trace: record " << lineId << " has no valid timestamp or precedes its thread name" << Debug::end;
+				return false;
+			}
+
+			if (phase == "X")
+			{
+				if (!parseChromeTraceTimestamp(fields["dur"], duration))
+				{
+					Debug::log_error() << "Chrome trace: scope record " << lineId << " has no valid duration" << Debug::end;
+					return false;
+				}
+				threadScopes[tid].push_back({ timestamp, timestamp + duration });
+			}
+			else if (phase != "C" || fields["args"].find("\"value\":") == std::string::npos)
+			{
+				Debug::log_error() << "Chrome trace: record " << lineId << " has an unknown phase or no counter value" << Debug::end;
+				return false;
+			}
+			++recordCounts[fields["name"]];
+		}
+
+		// Scopes recorded on the same thread must nest
+		for (auto const& [tid, scopes] : threadScopes)
+		{
+			if (!traceScopesNested(scopes))
+			{
+				Debug::log_error() << "Chrome trace: overlapping scopes on thread " << tid << Debug::end;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Reads the next field of a protobuf message. Varint and fixed64 values are returned
+	    in the value parameter, length-delimited payloads in the bytes parameter. */
+	bool readProtoField(std::string_view message, size_t& pos, int& field, int& wireType, unsigned long long& value, std::string_view& bytes)
+	{
+		auto readVarint = [&](unsigned long long& out)
+		{
+			out = 0;
+			for (int shift = 0; pos < message.size() && shift < 64; shift += 7)
+			{
+				const unsigned char byte = (unsigned char)message[pos++];
+				out |= (unsigned long long)(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) return true;
+			}
+			return false;
+		};
+
+		unsigned long long tag;
+		if (!readVarint(tag)) return false;
+		field = int(tag >> 3);
+		wireType = int(tag & 7);
+
+		switch (wireType)
+		{
+		case 0:
+			return readVarint(value);
+		case 1:
+			if (message.size() - pos < 8) return false;
+			std::memcpy(&value, message.data() + pos, 8);
+			pos += 8;
+			return true;
+		case 2:
+			if (!readVarint(value) || message.size() - pos < value) return false;
+			bytes = message.substr(pos, size_t(value));
+			pos += size_t(value);
+			return true;
+		}
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the structure of a Perfetto protobuf trace and counts the records per name. */
+	bool validatePerfettoTrace(std::string const& contents, std::unordered_map<std::string, size_t>& recordCounts)
+	{
+		// Declared tracks (uuid -> whether it is a counter track, and its name), and the open and finished slices per track
+		std::unordered_map<unsigned long long, std::pair<bool, std::string>> tracks;
+		std::unordered_map<unsigned long long, std::vector<std::pair<long long, std::string>>> openSlices;
+		std::unordered_map<unsigned long long, std::vector<std::pair<long long, long long>>> trackScopes;
+
+		int field, wireType;
+		unsigned long long value;
+		std::string_view bytes;
+		for (size_t pos = 0, packetId = 0; pos < contents.size(); ++packetId)
+		{
+			if (!readProtoField(contents, pos, field, wireType, value, bytes) || field != PerfettoFields::Trace_packet || wireType != 2)
+			{
+				Debug::log_error() << "Perfetto trace: malformed packet " << packetId << Debug::end;
+				return false;
+			}
+
+			// Split the packet into its fields
+			long long timestamp = -1;
+			std::string_view trackEvent, trackDescriptor;
+			bool hasSequenceId = false;
+			const std::string_view packet = bytes;
+			for (size_t packetPos = 0; packetPos < packet.size();)
+			{
+				if (!readProtoField(packet, packetPos, field, wireType, value, bytes))
+				{
+					Debug::log_error() << "Perfetto trace: malformed field in packet " << packetId << Debug::end;
+					return false;
+				}
+				if (field == PerfettoFields::TracePacket_timestamp) timestamp = (long long)value;
+				if (field == PerfettoFields::TracePacket_trustedPacketSequenceId) hasSequenceId = true;
+				if (field == PerfettoFields::TracePacket_trackEvent) trackEvent = bytes;
+				if (field == PerfettoFields::TracePacket_trackDescriptor) trackDescriptor = bytes;
+			}
+			if (!hasSequenceId || trackEvent.empty() == trackDescriptor.empty())
+			{
+				Debug::log_error() << "Perfetto trace: packet " << packetId << " needs a sequence id and exactly one payload" << Debug::end;
+				return false;
+			}
+
+			if (!trackDescriptor.empty())
+			{
+				// Track descriptors must be unique and declare either a thread or a counter
+				unsigned long long uuid = 0;
+				bool thread = false, counter = false;
+				std::string trackName;
+				for (size_t descriptorPos = 0; descriptorPos < trackDescriptor.size();)
+				{
+					if (!readProtoField(trackDescriptor, descriptorPos, field, wireType, value, bytes)) return false;
+					if (field == PerfettoFields::TrackDescriptor_uuid) uuid = value;
+					if (field == PerfettoFields::TrackDescriptor_name) trackName = std::string(bytes);
+					if (field == PerfettoFields::TrackDescriptor_thread) thread = true;
+					if (field == PerfettoFields::TrackDescriptor_counter) counter = true;
+				}
+				if (uuid == 0 || trackName.empty() || thread == counter || !tracks.emplace(uuid, std::make_pair(counter, trackName)).second)
+				{
+					Debug::log_error() << "Perfetto trace: invalid or duplicate track descriptor in packet " << packetId << Debug::end;
+					return false;
+				}
+				continue;
+			}
+
+			// Track events must reference a previously declared track
+			unsigned long long type = 0, trackUuid = 0;
+			std::string name;
+			bool hasValue = false;
+			for (size_t eventPos = 0; eventPos < trackEvent.size();)
+			{
+				if (!readProtoField(trackEvent, eventPos, field, wireType, value, bytes)) return false;
+				if (field == PerfettoFields::TrackEvent_type) type = value;
+				if (field == PerfettoFields::TrackEvent_trackUuid) trackUuid = value;
+				if (field == PerfettoFields::TrackEvent_name) name = std::string(bytes);
+				if (field == PerfettoFields::TrackEvent_doubleCounterValue) hasValue = wireType == 1;
+			}
+			auto track = tracks.find(trackUuid);
+			if (timestamp < 0 || track == tracks.end())
+			{
+				Debug::log_error() << "Perfetto trace: event in packet " << packetId << " has no timestamp or precedes its track descriptor" << Debug::end;
+				return false;
+			}
+
+			auto& slices = openSlices[trackUuid];
+			const bool counterTrack = track->second.first;
+			if (type == PerfettoFields::TrackEventType_sliceBegin && !counterTrack && !name.empty())
+			{
+				slices.push_back({ timestamp, name });
+			}
+			else if (type == PerfettoFields::TrackEventType_sliceEnd && !counterTrack && !slices.empty() && slices.back().first <= timestamp)
+			{
+				trackScopes[trackUuid].push_back({ slices.back().first, timestamp });
+				++recordCounts[slices.back().second];
+				slices.pop_back();
+			}
+			else if (type == PerfettoFields::TrackEventType_counter && counterTrack && hasValue)
+			{
+				++recordCounts[track->second.second];
+			}
+			else
+			{
+				Debug::log_error() << "Perfetto trace: invalid or unbalanced track event in packet " << packetId << Debug::end;
+				return false;
+			}
+		}
+
+		// Every slice must be closed, and slices on the same track must nest
+		for (auto const& [uuid, slices] : openSlices)
+		{
+			if (!slices.empty() || !traceScopesNested(trackScopes[uuid]))
+			{
+				Debug::log_error() << "Perfetto trace: unbalanced or overlapping slices on track " << uuid << Debug::end;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validateTrace(Scene::Scene& scene)
+	{
+		if (isCapturingTrace(scene))
+		{
+			Debug::log_warning() << "Cannot validate the trace output while a capture is running" << Debug::end;
+			return false;
+		}
+
+		// Enough items to exercise every worker, while staying well within the event buffers
+		const size_t numItems = Constants::s_profilerEventBufferSize / 8;
+
+		bool valid = true;
+		for (auto format : { ChromeJson, PerfettoProtobuf })
+		{
+			const std::string fileName = format == ChromeJson ? "TraceValidation.json" : "TraceValidation.perfetto-trace";
+			if (!startTraceCapture(scene, fileName, format))
+			{
+				valid = false;
+				continue;
+			}
+
+			// Synthetic workload: nested event scopes, a named scope around them and a counter per item, on every worker
+			std::unique_ptr<EventStreams> streams = std::make_unique<EventStreams>();
+			std::atomic<size_t> sink = 0;
+			Threading::threadedExecuteIndices(Threading::numThreads(),
+				[&](Threading::ThreadedExecuteEnvironment const& environment, size_t itemId)
+				{
+					const size_t threadId = Threading::currentThreadId();
+					const long long taskBegin = eventTimestamp();
+					{
+						ScopedCpuEvent itemEvent(*streams, "Trace Validation Item", false, threadId);
+						for (size_t step = 0; step < 2; ++step)
+						{
+							ScopedCpuEvent stepEvent(*streams, "Trace Validation Step", true, threadId);
+							sink.fetch_add(itemId + step, std::memory_order_relaxed);
+						}
+					}
+					recordTraceScope(scene, std::string("Trace Validation Task"), threadId, taskBegin, eventTimestamp());
+					recordTraceCounter(scene, Category{ "Trace Validation", "Counter" }, threadId, eventTimestamp(), double(itemId));
+				},
+				numItems);
+			aggregateEvents(scene, *streams);
+
+			size_t numDropped = 0;
+			for (auto const& buffer : streams->m_buffers)
+				numDropped += buffer.m_numDropped.load();
+
+			const std::string filePath = scene.m_profilerTrace->m_filePath;
+			stopTraceCapture(scene);
+
+			// Read back the output
+			std::ifstream file(filePath, std::ios::in | std::ios::binary);
+			const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			std::unordered_map<std::string, size_t> recordCounts;
+			bool formatValid = format == ChromeJson ?
+				validateChromeTrace(contents, recordCounts) :
+				validatePerfettoTrace(contents, recordCounts);
+
+			// Every record of the workload must be present exactly once
+			const std::pair<std::string, size_t> expectedCounts[] =
+			{
+				{ "Trace Validation Item", numItems },
+				{ "Trace Validation Step", numItems * 2 },
+				{ "Trace Validation Task", numItems },
+				{ "Trace Validation::Counter", numItems },
+			};
+			for (auto const& [name, expected] : expectedCounts)
+			{
+				if (formatValid && numDropped == 0 && recordCounts[name] != expected)
+				{
+					Debug::log_error() << TraceFormat_value_to_string(format) << " trace: " << recordCounts[name] << " '" << name << "' records, expected " << expected << Debug::end;
+					formatValid = false;
+				}
+			}
+
+			Debug::log_info() << "Trace validation (" << TraceFormat_value_to_string(format) << ", " << contents.size() << " bytes, "
+				<< numDropped << " dropped events): " << (formatValid ? "passed" : "FAILED") << Debug::end;
+			valid = valid && formatValid;
+		}
+
+		return valid;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	void queryFutureValues(Scene::Scene& scene, ProfilerThreadTree const& tree, ProfilerThreadTreeIterator root, size_t threadId)
 	{
@@ -621,6 +1824,9 @@ namespace Profiler
 		{
 			scene.m_profilerWritePosition[i] = scene.m_profilerTree[scene.m_profilerBufferWriteId][i].set_head(Profiler::ProfilerTreeEntry{});
 		}
+
+		// Let the events record the regions they are opened in
+		scene.m_profilerEvents->m_writePosition = &scene.m_profilerWritePosition;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -633,6 +1839,13 @@ namespace Profiler
 	////////////////////////////////////////////////////////////////////////////////
 	void endFrame(Scene::Scene& scene)
 	{
+		// Aggregate the events recorded during the frame
+		flushEvents(scene);
+
+		// Hand the recorded trace events over to the writer thread
+		if (isCapturingTrace(scene))
+			submitTraceBlock(*scene.m_profilerTrace);
+
 		// Swap the profiler buffers
 		scene.m_profilerBufferWriteId = (scene.m_profilerBufferWriteId + 1) % scene.m_profilerTree.size();
 		scene.m_profilerBufferReadId = (scene.m_profilerBufferReadId + 1) % scene.m_profilerTree.size();
@@ -697,6 +1910,174 @@ namespace Profiler
 		printTree(scene, scene.m_profilerTree[scene.m_profilerBufferWriteId][0], scene.m_profilerTree[scene.m_profilerBufferWriteId][0].begin(), 0, 0);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	void setHistoryLength(Scene::Scene& scene, size_t historyLength)
+	{
+		scene.m_profilerHistoryLength = historyLength;
+		for (auto& node : scene.m_profilerData)
+			node.second.m_previousValues.setCapacity(historyLength);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool validateHistory()
+	{
+		std::mt19937 generator(0);
+		size_t numChecks = 0, numFailures = 0;
+		auto check = [&](bool condition, std::string const& what, int capacity, int firstFrame, int lastFrame)
+		{
+			++numChecks;
+			if (condition) return;
+			if (numFailures++ < 16)
+				Debug::log_error() << "Profiler history check failed: " << what << " (capacity: " << capacity
+					<< ", window: [" << firstFrame << ", " << lastFrame << "])" << Debug::end;
+		};
+		auto nearlyEqual = [](double a, double b) { return std::abs(a - b) <= 1e-4 * std::max(1.0, std::abs(b)); };
+
+		for (int capacity : { 1, 2, 7, 64, 512 })
+		{
+			ProfilerDataEntry entry;
+			entry.m_previousValues.setCapacity(capacity);
+
+			// Reference copy of the stored values, by frame
+			std::map<int, float> reference;
+			int firstStored = -1, lastStored = -1;
+
+			// Brute-force window statistics over the frames still kept
+			auto referenceStats = [&](int firstFrame, int lastFrame)
+			{
+				struct { float m_min = 0.0f, m_max = 0.0f; double m_sum = 0.0; int m_count = 0; } stats;
+				if (lastStored < 0) return stats;
+				const int oldestKept = std::max(firstStored, lastStored - capacity + 1);
+				for (auto it = reference.lower_bound(std::max(firstFrame, oldestKept)); it != reference.end() && it->first <= lastFrame; ++it)
+				{
+					stats.m_min = stats.m_count == 0 ? it->second : std::min(stats.m_min, it->second);
+					stats.m_max = stats.m_count == 0 ? it->second : std::max(stats.m_max, it->second);
+					stats.m_sum += it->second;
+					++stats.m_count;
+				}
+				return stats;
+			};
+
+			std::uniform_int_distribution<int> actionDistribution(0, 99);
+			std::uniform_int_distribution<int> gapDistribution(2, 2 * capacity + 2);
+			std::uniform_int_distribution<int> valueDistribution(0, 15);
+			std::uniform_int_distribution<int> windowDistribution(1, 2 * capacity + 1);
+			int frameId = 0, trailingWindow = std::max(capacity / 2, 1);
+			for (int step = 0; step < 20000; ++step)
+			{
+				// Advance the frame: mostly by one, sometimes with gaps, overwrites or stale stores
+				const int action = actionDistribution(generator);
+				int storeFrame = frameId;
+				if (action < 70)      storeFrame = ++frameId;
+				else if (action < 80) storeFrame = frameId += gapDistribution(generator);
+				else if (action < 90) storeFrame = frameId;
+				else if (action < 95) storeFrame = frameId > 16 ? frameId - 1 - valueDistribution(generator) : ++frameId;
+				else if (action < 96)
+				{
+					entry.m_previousValues.clear();
+					reference.clear();
+					firstStored = lastStored = -1;
+					continue;
+				}
+
+				// Store the value, mirroring the history rules in the reference
+				const float value = float(valueDistribution(generator)) * 0.25f;
+				entry.m_previousValues.store(storeFrame, value);
+				if (storeFrame >= lastStored && storeFrame >= 0)
+				{
+					reference[storeFrame] = value;
+					if (firstStored < 0) firstStored = storeFrame;
+					lastStored = storeFrame;
+				}
+
+				// Trailing range window, moving forward with the frames
+				const int rangeFirst = frameId - trailingWindow + 1;
+				const auto expected = referenceStats(rangeFirst, frameId);
+				check(slidingMin<float>(entry, rangeFirst, frameId) == expected.m_min, "trailing min", capacity, rangeFirst, frameId);
+				check(slidingMax<float>(entry, rangeFirst, frameId) == expected.m_max, "trailing max", capacity, rangeFirst, frameId);
+				check(nearlyEqual(slidingAverage<float>(entry, rangeFirst, frameId, false), expected.m_count > 0 ? expected.m_sum / expected.m_count : 0.0),
+					"trailing average", capacity, rangeFirst, frameId);
+				check(nearlyEqual(slidingAverage<float>(entry, rangeFirst, frameId, true), expected.m_sum / double(trailingWindow)),
+					"trailing average over all frames", capacity, rangeFirst, frameId);
+
+				// Centered window around a random frame, moving in either direction
+				const int windowSize = windowDistribution(generator);
+				const int centerFrame = frameId - valueDistribution(generator);
+				const int oddSize = (windowSize / 2) * 2 + 1;
+				const auto centered = referenceStats(centerFrame - oddSize / 2, centerFrame + oddSize / 2);
+				check(slidingMinWindowed<float>(entry, centerFrame, windowSize) == centered.m_min, "centered min", capacity, centerFrame - oddSize / 2, centerFrame + oddSize / 2);
+				check(slidingMaxWindowed<float>(entry, centerFrame, windowSize) == centered.m_max, "centered max", capacity, centerFrame - oddSize / 2, centerFrame + oddSize / 2);
+
+				// Point queries and the number of kept values
+				check(entry.m_previousValues.size() == size_t(referenceStats(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()).m_count), "kept value count", capacity, frameId, frameId);
+				const int probeFrame = frameId - valueDistribution(generator);
+				const auto probe = referenceStats(probeFrame, probeFrame);
+				check(entry.m_previousValues.contains(probeFrame) == (probe.m_count > 0), "contains", capacity, probeFrame, probeFrame);
+				check(entry.m_previousValues.value<float>(probeFrame) == probe.m_min, "value", capacity, probeFrame, probeFrame);
+
+				// Change the trailing window length every now and then
+				if (action == 99) trailingWindow = windowDistribution(generator);
+			}
+		}
+
+		Debug::log_info() << "Profiler history validation: " << (numChecks - numFailures) << " of " << numChecks << " checks passed." << Debug::end;
+		return numFailures == 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkHistory(size_t numFrames, size_t historyLength, int windowSize)
+	{
+		// Synthetic frame times
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> distribution(0.0f, 16.0f);
+		std::vector<float> values(numFrames);
+		for (auto& value : values) value = distribution(generator);
+
+		// Store every frame and query the trailing window statistics, as the profiler charts do
+		ProfilerDataEntry entry;
+		entry.m_previousValues.setCapacity(historyLength);
+		double checksum = 0.0;
+		DateTime::Timer slidingTimer(true);
+		for (int frameId = 0; frameId < int(numFrames); ++frameId)
+		{
+			entry.m_previousValues.store(frameId, values[frameId]);
+			const int firstFrame = frameId - windowSize + 1;
+			checksum += slidingMin<float>(entry, firstFrame, frameId) + slidingMax<float>(entry, firstFrame, frameId) + slidingAverage<float>(entry, firstFrame, frameId, false);
+		}
+		slidingTimer.stop();
+
+		// Same statistics, scanning the window every frame
+		FrameHistory& history = entry.m_previousValues;
+		history.setCapacity(historyLength);
+		double referenceChecksum = 0.0;
+		DateTime::Timer scanTimer(true);
+		for (int frameId = 0; frameId < int(numFrames); ++frameId)
+		{
+			history.store(frameId, values[frameId]);
+			float min = 0.0f, max = 0.0f;
+			double sum = 0.0;
+			int count = 0;
+			for (int scanned = std::max(frameId - windowSize + 1, history.oldestFrame()); scanned <= frameId; ++scanned)
+			{
+				if (!history.contains(scanned)) continue;
+				const float value = history.value<float>(scanned);
+				min = count == 0 ? value : std::min(min, value);
+				max = count == 0 ? value : std::max(max, value);
+				sum += value;
+				++count;
+			}
+			referenceChecksum += min + max + float(sum / double(count > 0 ? count : 1));
+		}
+		scanTimer.stop();
+
+		const size_t slotBytes = sizeof(unsigned char) + sizeof(float) + sizeof(double) + sizeof(int);
+		Debug::log_info() << "Profiler history benchmark (" << numFrames << " frames, " << historyLength << " kept, window of " << windowSize << "): "
+			<< (std::abs(checksum - referenceChecksum) <= 1e-6 * std::abs(referenceChecksum) ? "results match" : "RESULTS DIFFER") << Debug::end;
+		Debug::log_info() << "  - sliding windows: " << slidingTimer.getElapsedTime() * 1e9 / double(numFrames) << " ns per frame" << Debug::end;
+		Debug::log_info() << "  - window scans: " << scanTimer.getElapsedTime() * 1e9 / double(numFrames) << " ns per frame" << Debug::end;
+		Debug::log_info() << "  - history memory: " << Units::bytesToString(historyLength * slotBytes) << " per entry, independent of the run length" << Debug::end;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** Clears the profiler tree. */
 	void clearTree(Scene::Scene& scene)
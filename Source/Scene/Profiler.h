@@ -53,6 +53,258 @@ namespace Profiler
 	// Future callback type.
 	using FutureValue = std::function<void(ProfilerDataEntry&)>;
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Default number of frames kept in the per-entry frame histories. */
+	static constexpr size_t s_defaultHistoryLength = 512;
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Fixed-capacity, columnar history of per-frame values.
+
+	    Frames are direct-mapped to slots (frame id modulo the capacity) and gaps between
+	    consecutive stores are filled with empty slots, so every frame in the kept range
+	    has a slot. Each slot also stores the running sum and count of the values up to
+	    and including it, making range sums and averages O(1). */
+	struct FrameHistory
+	{
+		// Number of frames kept
+		size_t m_capacity = 0;
+
+		// First and last frame ever stored
+		int m_firstFrame = -1;
+		int m_lastFrame = -1;
+
+		// Incremented whenever the stored values are dropped
+		size_t m_generation = 0;
+
+		// Whether the slot holds a stored value or only fills a gap
+		std::vector<unsigned char> m_present;
+
+		// Value columns; only the one matching the entry type is allocated
+		std::vector<float> m_floatValues;
+		std::vector<int> m_intValues;
+
+		// Running sums and counts of the stored values
+		std::vector<double> m_runningSums;
+		std::vector<int> m_runningCounts;
+
+		// Changes the number of frames kept; this drops the stored values
+		void setCapacity(size_t capacity)
+		{
+			m_capacity = capacity;
+			clear();
+		}
+
+		// Drops all the stored values
+		void clear()
+		{
+			++m_generation;
+			m_firstFrame = m_lastFrame = -1;
+			m_present.assign(m_capacity, 0);
+			m_floatValues.clear();
+			m_intValues.clear();
+			m_runningSums.assign(m_capacity, 0.0);
+			m_runningCounts.assign(m_capacity, 0);
+		}
+
+		// Whether any values have been stored
+		bool empty() const { return m_lastFrame < 0; }
+
+		// Slot index of a frame
+		size_t slot(int frameId) const { return size_t(frameId) % m_capacity; }
+
+		// Oldest frame that still has a slot
+		int oldestFrame() const { return std::max(m_firstFrame, m_lastFrame - int(m_capacity) + 1); }
+
+		// Whether the parameter frame has a slot
+		bool hasSlot(int frameId) const { return !empty() && frameId >= oldestFrame() && frameId <= m_lastFrame; }
+
+		// Whether a value is stored for the parameter frame
+		bool contains(int frameId) const { return hasSlot(frameId) && m_present[slot(frameId)]; }
+
+		// Number of frames with a stored value
+		size_t size() const { return empty() ? 0 : size_t(countBefore(m_lastFrame + 1) - countBefore(oldestFrame())); }
+
+		// Value stored in the parameter slot
+		double slotValue(size_t slotId) const
+		{
+			if (!m_floatValues.empty()) return m_floatValues[slotId];
+			if (!m_intValues.empty()) return m_intValues[slotId];
+			return 0.0;
+		}
+
+		// Value stored for the parameter frame, or zero if nothing is stored
+		template<typename T>
+		T value(int frameId) const
+		{
+			return contains(frameId) ? T(slotValue(slot(frameId))) : T(0);
+		}
+
+		// Running sum and count of the values stored before the parameter frame
+		double sumBefore(int frameId) const
+		{
+			if (frameId > m_lastFrame) return m_runningSums[slot(m_lastFrame)];
+			const size_t slotId = slot(frameId);
+			return m_runningSums[slotId] - (m_present[slotId] ? slotValue(slotId) : 0.0);
+		}
+		int countBefore(int frameId) const
+		{
+			if (frameId > m_lastFrame) return m_runningCounts[slot(m_lastFrame)];
+			const size_t slotId = slot(frameId);
+			return m_runningCounts[slotId] - (m_present[slotId] ? 1 : 0);
+		}
+
+		// Clamps a frame range to the kept frames; returns false if they don't overlap
+		bool clampRange(int& firstFrame, int& lastFrame) const
+		{
+			if (empty()) return false;
+			firstFrame = std::max(firstFrame, oldestFrame());
+			lastFrame = std::min(lastFrame, m_lastFrame);
+			return firstFrame <= lastFrame;
+		}
+
+		// Sum and number of the stored values in the parameter (inclusive) frame range
+		std::pair<double, int> rangeSum(int firstFrame, int lastFrame) const
+		{
+			if (!clampRange(firstFrame, lastFrame)) return { 0.0, 0 };
+			return { sumBefore(lastFrame + 1) - sumBefore(firstFrame), countBefore(lastFrame + 1) - countBefore(firstFrame) };
+		}
+
+		// Stores a value for the parameter frame
+		template<typename T>
+		void store(int frameId, T value)
+		{
+			// Ignore the value if we aren't keeping any history, or it's older than the current frame
+			if (m_capacity == 0 || frameId < m_lastFrame) return;
+
+			// Allocate the value column on first use
+			std::vector<T>& values = valueColumn<T>();
+			if (values.empty()) values.assign(m_capacity, T(0));
+
+			// Overwrite the value of the last frame
+			if (frameId == m_lastFrame)
+			{
+				const size_t slotId = slot(frameId);
+				m_runningSums[slotId] += double(value) - (m_present[slotId] ? double(values[slotId]) : 0.0);
+				m_runningCounts[slotId] += m_present[slotId] ? 0 : 1;
+				m_present[slotId] = 1;
+				values[slotId] = value;
+				return;
+			}
+
+			// Carry over the running sums into the skipped frames
+			const double runningSum = empty() ? 0.0 : m_runningSums[slot(m_lastFrame)];
+			const int runningCount = empty() ? 0 : m_runningCounts[slot(m_lastFrame)];
+			const int firstSkipped = empty() ? frameId : std::max(m_lastFrame + 1, frameId - int(m_capacity) + 1);
+			for (int skipped = firstSkipped; skipped < frameId; ++skipped)
+			{
+				const size_t slotId = slot(skipped);
+				m_present[slotId] = 0;
+				values[slotId] = T(0);
+				m_runningSums[slotId] = runningSum;
+				m_runningCounts[slotId] = runningCount;
+			}
+
+			// Store the new value
+			const size_t slotId = slot(frameId);
+			m_present[slotId] = 1;
+			values[slotId] = value;
+			m_runningSums[slotId] = runningSum + double(value);
+			m_runningCounts[slotId] = runningCount + 1;
+			if (empty()) m_firstFrame = frameId;
+			m_lastFrame = frameId;
+		}
+
+	private:
+		template<typename T> std::vector<T>& valueColumn();
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	template<> inline std::vector<float>& FrameHistory::valueColumn<float>() { return m_floatValues; }
+	template<> inline std::vector<int>& FrameHistory::valueColumn<int>() { return m_intValues; }
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Sliding window extrema over a frame history, meant to be kept alive between queries.
+	    Windows moving forward are updated in O(1) amortized time using monotonic deques;
+	    moving backwards or dropping the history rebuilds the window.
+
+	    Only the frames before the last stored one are pushed into the deques, since the
+	    value of the last frame may still be overwritten; it is compared separately. */
+	struct SlidingWindow
+	{
+		// Current window (inclusive)
+		int m_firstFrame = 0;
+		int m_lastFrame = -1;
+
+		// Last frame pushed into the deques
+		int m_pushedFrame = -1;
+
+		// Generation of the history the deques were built from
+		size_t m_generation = 0;
+
+		// Candidate frames for the min and max values, in increasing frame order
+		std::deque<int> m_minFrames;
+		std::deque<int> m_maxFrames;
+
+		// Moves the window to the parameter range
+		void advance(FrameHistory const& history, int firstFrame, int lastFrame)
+		{
+			// Restart if the window moved backwards or the history was dropped
+			if (history.m_generation != m_generation || firstFrame < m_firstFrame || lastFrame < m_lastFrame)
+			{
+				m_minFrames.clear();
+				m_maxFrames.clear();
+				m_pushedFrame = firstFrame - 1;
+				m_generation = history.m_generation;
+			}
+
+			// Push the new frames whose values are final
+			const int finalFrame = std::min(lastFrame, history.m_lastFrame - 1);
+			for (int frameId = std::max(m_pushedFrame + 1, firstFrame); frameId <= finalFrame; ++frameId)
+			{
+				if (!history.contains(frameId)) continue;
+				const double value = history.value<double>(frameId);
+				while (!m_minFrames.empty() && history.value<double>(m_minFrames.back()) >= value) m_minFrames.pop_back();
+				while (!m_maxFrames.empty() && history.value<double>(m_maxFrames.back()) <= value) m_maxFrames.pop_back();
+				m_minFrames.push_back(frameId);
+				m_maxFrames.push_back(frameId);
+			}
+			m_pushedFrame = std::max({ m_pushedFrame, finalFrame, firstFrame - 1 });
+
+			// Pop the frames that left the window, or were evicted from the history
+			const int oldestFrame = std::max(firstFrame, history.oldestFrame());
+			while (!m_minFrames.empty() && m_minFrames.front() < oldestFrame) m_minFrames.pop_front();
+			while (!m_maxFrames.empty() && m_maxFrames.front() < oldestFrame) m_maxFrames.pop_front();
+
+			m_firstFrame = firstFrame;
+			m_lastFrame = lastFrame;
+		}
+
+		// Min of the stored values in the window, or zero if there are none
+		template<typename T>
+		T min(FrameHistory const& history) const
+		{
+			return T(extremum(history, m_minFrames, [](double a, double b) { return std::min(a, b); }));
+		}
+
+		// Max of the stored values in the window, or zero if there are none
+		template<typename T>
+		T max(FrameHistory const& history) const
+		{
+			return T(extremum(history, m_maxFrames, [](double a, double b) { return std::max(a, b); }));
+		}
+
+	private:
+		template<typename F>
+		double extremum(FrameHistory const& history, std::deque<int> const& frames, F const& select) const
+		{
+			const int lastFrame = history.m_lastFrame;
+			const bool lastInWindow = lastFrame >= m_firstFrame && lastFrame <= m_lastFrame && history.contains(lastFrame);
+			if (frames.empty()) return lastInWindow ? history.value<double>(lastFrame) : 0.0;
+			const double result = history.value<double>(frames.front());
+			return lastInWindow ? select(result, history.value<double>(lastFrame)) : result;
+		}
+	};
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** Profiler data block. */
 	struct ProfilerDataEntry
@@ -102,7 +354,11 @@ namespace Profiler
 		EntryDataField m_avg;
 
 		// Previous values
-		std::unordered_map<unsigned, EntryDataField> m_previousValues;
+		FrameHistory m_previousValues;
+
+		// Sliding windows kept between the range and the centered window queries
+		mutable SlidingWindow m_rangeWindow;
+		mutable SlidingWindow m_centeredWindow;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -278,27 +534,12 @@ namespace Profiler
 	template<typename T>
 	T slidingAverage(ProfilerDataEntry const& entry, int firstFrame, int lastFrame, bool countNonExistent = true)
 	{
-		// Result and number of entries
-		T sum = T(0);
-		int count = 0;
-
-		// Compute the sum
-		for (int i = firstFrame; i <= lastFrame; ++i)
-		{
-			if (auto it = entry.m_previousValues.find(i); it != entry.m_previousValues.end())
-			{
-				sum += convertEntryData<T>(it->second);
-				++count;
-			}
-			else if (countNonExistent)
-			{
-				sum += T(0);
-				++count;
-			}
-		}
+		// Compute the sum in constant time, using the running sums
+		auto const [sum, count] = entry.m_previousValues.rangeSum(firstFrame, lastFrame);
+		const int numValues = countNonExistent ? (lastFrame - firstFrame + 1) : count;
 
 		// Return the final average
-		return sum / T(count > 0 ? count : 1);
+		return T(sum / double(numValues > 0 ? numValues : 1));
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -316,23 +557,8 @@ namespace Profiler
 	template<typename T>
 	T slidingMin(ProfilerDataEntry const& entry, int firstFrame, int lastFrame)
 	{
-		// Result and number of entries
-		T min = T(0);
-		bool first = true;
-
-		// Compute the sum
-		for (int i = firstFrame; i <= lastFrame; ++i)
-		{
-			if (auto it = entry.m_previousValues.find(i); it != entry.m_previousValues.end())
-			{
-				T curr = convertEntryData<T>(it->second);
-				min = first ? curr : std::min(min, curr);
-				first = false;
-			}
-		}
-
-		// Return the final result
-		return min;
+		entry.m_rangeWindow.advance(entry.m_previousValues, firstFrame, lastFrame);
+		return entry.m_rangeWindow.min<T>(entry.m_previousValues);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -342,31 +568,17 @@ namespace Profiler
 		// Make sure the window size is odd
 		windowSize = (windowSize / 2) * 2 + 1;
 
-		// Compute the average
-		return slidingMin<T>(entry, backward ? frameId - windowSize / 2 : frameId, forward ? frameId + windowSize / 2 : frameId);
+		// Compute the min; consecutive frames reuse the window
+		entry.m_centeredWindow.advance(entry.m_previousValues, backward ? frameId - windowSize / 2 : frameId, forward ? frameId + windowSize / 2 : frameId);
+		return entry.m_centeredWindow.min<T>(entry.m_previousValues);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	template<typename T>
 	T slidingMax(ProfilerDataEntry const& entry, int firstFrame, int lastFrame)
 	{
-		// Result and number of entries
-		T max = T(0);
-		bool first = true;
-
-		// Compute the sum
-		for (int i = firstFrame; i <= lastFrame; ++i)
-		{
-			if (auto it = entry.m_previousValues.find(i); it != entry.m_previousValues.end())
-			{
-				T curr = convertEntryData<T>(it->second);
-				max = first ? curr : std::max(max, curr);
-				first = false;
-			}
-		}
-
-		// Return the final result
-		return max;
+		entry.m_rangeWindow.advance(entry.m_previousValues, firstFrame, lastFrame);
+		return entry.m_rangeWindow.max<T>(entry.m_previousValues);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -376,8 +588,9 @@ namespace Profiler
 		// Make sure the window size is odd
 		windowSize = (windowSize / 2) * 2 + 1;
 
-		// Compute the average
-		return slidingMax<T>(entry, backward ? frameId - windowSize / 2 : frameId, forward ? frameId + windowSize / 2 : frameId);
+		// Compute the max; consecutive frames reuse the window
+		entry.m_centeredWindow.advance(entry.m_previousValues, backward ? frameId - windowSize / 2 : frameId, forward ? frameId + windowSize / 2 : frameId);
+		return entry.m_centeredWindow.max<T>(entry.m_previousValues);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -400,6 +613,7 @@ namespace Profiler
 		bool m_sum;
 		size_t m_threadId;
 		double m_times[2];
+		long long m_traceTimestamp = 0;
 		ProfilerTreeIterator m_iterator;
 		Category m_category;
 
@@ -472,6 +686,318 @@ namespace Profiler
 		operator int() const;
 	};
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** FNV-1a hash of an event category name. */
+	constexpr unsigned long long hashEventCategory(const char* name)
+	{
+		unsigned long long hash = 14695981039346656037ull;
+		for (; *name != '\0'; ++name)
+			hash = (hash ^ (unsigned long long)(unsigned char)(*name)) * 1099511628211ull;
+		return hash;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A flat event category, interned at compile time. Only string literals are accepted,
+	    so the name pointer can be stored in the event buffers as-is. */
+	struct EventCategory
+	{
+		// Name of the category
+		const char* m_name = nullptr;
+
+		// Interned id of the category
+		unsigned long long m_id = 0;
+
+		constexpr EventCategory() = default;
+
+		template<size_t N>
+		constexpr EventCategory(const char(&name)[N]) :
+			m_name(name),
+			m_id(hashEventCategory(name))
+		{}
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Timestamp source for the events, in nanoseconds. */
+	inline long long eventTimestamp()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A single begin or end event. */
+	struct Event
+	{
+		// Category of the event
+		EventCategory m_category;
+
+		// When the event happened
+		long long m_timestamp = 0;
+
+		// Whether this is a begin or end event
+		bool m_begin = false;
+
+		// Whether the scope times should be summed or not
+		bool m_sum = false;
+
+		// Profiler region of the producer thread that encloses a begin event
+		ProfilerThreadTreeIterator m_region;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Fixed-size, single-producer single-consumer event ring buffer. */
+	struct EventRingBuffer
+	{
+		// Mask for the buffer indices
+		static constexpr size_t s_indexMask = Constants::s_profilerEventBufferSize - 1;
+		static_assert((Constants::s_profilerEventBufferSize & s_indexMask) == 0, "Event buffer size must be a power of two.");
+
+		// The event storage
+		std::array<Event, Constants::s_profilerEventBufferSize> m_events;
+
+		// Write position; only modified by the producer thread
+		alignas(64) std::atomic<size_t> m_head = 0;
+
+		// Read position; only modified by the consumer thread
+		alignas(64) std::atomic<size_t> m_tail = 0;
+
+		// Number of scopes that were successfully opened by the producer
+		size_t m_depth = 0;
+
+		// Number of events dropped due to the buffer being full
+		std::atomic<size_t> m_numDropped = 0;
+
+		// Tries to store an event, making sure that at least 'reserve' slots remain available
+		inline bool push(Event const& event, size_t reserve = 1)
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			const size_t tail = m_tail.load(std::memory_order_acquire);
+			if (head - tail + reserve > Constants::s_profilerEventBufferSize)
+			{
+				m_numDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			m_events[head & s_indexMask] = event;
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Tries to extract the oldest event
+		inline bool pop(Event& event)
+		{
+			const size_t tail = m_tail.load(std::memory_order_relaxed);
+			const size_t head = m_head.load(std::memory_order_acquire);
+			if (tail == head) return false;
+			event = m_events[tail & s_indexMask];
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A node of the per-flush event aggregation tree. Scopes are matched by their interned
+	    category id, so the profiler tree is only touched once per distinct scope. */
+	struct EventAggregate
+	{
+		// Category of the scope
+		EventCategory m_category;
+
+		// Whether the scope times should be summed or not
+		bool m_sum = false;
+
+		// Profiler region that encloses the scope
+		ProfilerThreadTreeIterator m_region;
+
+		// Aggregated time, in milliseconds, and the number of finished scopes
+		float m_time = 0.0f;
+		int m_count = 0;
+
+		// Links to the parent, first child and next sibling nodes
+		size_t m_parent = 0;
+		size_t m_firstChild = 0;
+		size_t m_nextSibling = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Holds the per-thread event buffers and the aggregation state. */
+	struct EventStreams
+	{
+		// Whether event recording is enabled or not; refreshed once per frame
+		std::atomic_bool m_enabled = false;
+
+		// The per-thread event buffers
+		std::array<EventRingBuffer, Constants::s_maxThreads> m_buffers;
+
+		// Profiler write positions of the threads, recorded with the begin events
+		ProfilerTreeIterator* m_writePosition = nullptr;
+
+		// Begin events of the scopes still open at the end of the last aggregation
+		std::array<std::vector<Event>, Constants::s_maxThreads> m_openScopes;
+
+		// Region paths of the open scopes, since the tree they were recorded in is recycled
+		std::array<std::vector<std::vector<std::string>>, Constants::s_maxThreads> m_openScopeRegions;
+
+		// Scratch storage for the aggregation, reused between flushes
+		std::vector<EventAggregate> m_aggregates;
+		std::vector<size_t> m_aggregateStack;
+
+		// Number of events dropped during the last flushed frame, and since startup
+		size_t m_numDroppedLastFrame = 0;
+		size_t m_numDroppedTotal = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Low-overhead RAII CPU scope. Records a begin/end event pair into the calling thread's
+	    ring buffer; the events are aggregated into the profiler tree once per frame. */
+	struct ScopedCpuEvent
+	{
+		EventRingBuffer* m_buffer = nullptr;
+		EventCategory m_category;
+		bool m_sum;
+
+		ScopedCpuEvent(Scene::Scene& scene, EventCategory const& category, bool sum = false, size_t threadId = Threading::currentThreadId());
+		ScopedCpuEvent(EventStreams& streams, EventCategory const& category, bool sum = false, size_t threadId = Threading::currentThreadId());
+		~ScopedCpuEvent();
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Aggregates the events recorded into the parameter streams into the profiler tree. The scopes of
+	    each thread are placed into the region they were opened in, in the tree of that thread. */
+	void aggregateEvents(Scene::Scene& scene, EventStreams& streams);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Aggregates the recorded events into the profiler tree, and reports the dropped events.
+	    Must be called from the main thread. */
+	void flushEvents(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Measures the per-scope overhead of the regular CPU perf counters and the event path,
+	    and logs the results in nanoseconds. */
+	void benchmarkScopes(Scene::Scene& scene, size_t numScopes = 1 << 20);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Output formats for the trace captures. */
+	meta_enum(TraceFormat, int, ChromeJson, PerfettoProtobuf);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** A single captured trace record. */
+	struct TraceEvent
+	{
+		// Type of the record
+		meta_enum(TraceEventType, int, Scope, Counter);
+
+		// Type of the record
+		TraceEventType m_type = Scope;
+
+		// Interned name of the scope or counter (FNV-1a hash of the name)
+		unsigned long long m_nameId = 0;
+
+		// Thread that produced the record
+		size_t m_threadId = 0;
+
+		// Start time, in nanoseconds
+		long long m_timestamp = 0;
+
+		// Length of the scope, in nanoseconds
+		long long m_duration = 0;
+
+		// Value of the counter
+		double m_value = 0.0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Trace records of a single recording thread. The lock is only contended when the
+	    records are handed over to the writer at the end of the frame. */
+	struct alignas(64) TraceThreadBuffer
+	{
+		// Records of the current frame
+		std::vector<TraceEvent> m_records;
+
+		// Records handed over to the writer thread
+		std::vector<TraceEvent> m_pending;
+
+		// Names this thread has already interned
+		std::unordered_set<unsigned long long> m_internedNames;
+
+		// Lock for the record buffer
+		std::mutex m_mutex;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Streams the recorded scopes and counters to a trace file. Each thread records into
+	    its own buffer; the buffers are handed over at the end of each frame and serialized
+	    by a background writer thread. The writer lives as long as the scene, so recording
+	    threads never observe it being freed. */
+	struct TraceWriter
+	{
+		// Format of the output
+		TraceFormat m_format = ChromeJson;
+
+		// Full path of the output file
+		std::string m_filePath;
+
+		// The output file
+		std::ofstream m_file;
+
+		// Timestamp of the capture start; all records are relative to this
+		long long m_startTimestamp = 0;
+
+		// Whether a capture is running
+		std::atomic<bool> m_capturing = false;
+
+		// Per-thread record buffers, indexed by the id of the recording thread
+		std::array<TraceThreadBuffer, Constants::s_maxThreads> m_threadBuffers;
+
+		// Interned record names; only locked on the first use of a name on each thread
+		std::mutex m_namesMutex;
+		std::unordered_map<unsigned long long, std::string> m_names;
+
+		// Copy of the interned names owned by the writer thread
+		std::unordered_map<unsigned long long, std::string> m_writerNames;
+
+		// Writer thread synchronization
+		std::mutex m_writerMutex;
+		std::condition_variable m_writerCondition;
+		bool m_blockPending = false;
+		bool m_stop = false;
+
+		// Thread and counter tracks that already have their descriptors written out
+		std::unordered_set<unsigned long long> m_tracksWritten;
+
+		// Number of records written so far
+		size_t m_numEventsWritten = 0;
+
+		// The background writer thread
+		std::thread m_writerThread;
+
+		~TraceWriter();
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Starts streaming the profiler scopes and counters into the parameter file. */
+	bool startTraceCapture(Scene::Scene& scene, std::string const& fileName, TraceFormat format);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Stops the current trace capture and closes the output file. */
+	void stopTraceCapture(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Whether a trace capture is currently running. */
+	bool isCapturingTrace(Scene::Scene& scene);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Records a finished scope into the current trace capture, if any. */
+	void recordTraceScope(Scene::Scene& scene, std::string const& name, size_t threadId, long long beginTimestamp, long long endTimestamp);
+	void recordTraceScope(Scene::Scene& scene, EventCategory const& category, size_t threadId, long long beginTimestamp, long long endTimestamp);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Records a counter value into the current trace capture, if any. */
+	void recordTraceCounter(Scene::Scene& scene, Category const& category, size_t threadId, long long timestamp, double value);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Captures a synthetic multi-threaded workload in both trace formats and checks the
+	    structure of the written files. */
+	bool validateTrace(Scene::Scene& scene);
+
 	////////////////////////////////////////////////////////////////////////////////
 	void init(Scene::Scene& scene);
 
@@ -481,6 +1007,20 @@ namespace Profiler
 	////////////////////////////////////////////////////////////////////////////////
 	void endFrame(Scene::Scene& scene);
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Changes the number of frames kept in the history of each entry. */
+	void setHistoryLength(Scene::Scene& scene, size_t historyLength);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Checks the frame history and the sliding window statistics against brute-force
+	    computations over randomized histories, and logs the results. Returns whether all the checks passed. */
+	bool validateHistory();
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Stores a synthetic value for each frame of a long run, querying the trailing window
+	    statistics after every frame, and logs the per-frame cost next to a brute-force scan. */
+	void benchmarkHistory(size_t numFrames = 1000000, size_t historyLength = s_defaultHistoryLength, int windowSize = 255);
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** Prints the profiler tree. */
 	void printTree(Scene::Scene& scene);
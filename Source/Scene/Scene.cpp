@@ -2,6 +2,9 @@
 #include "Scene.h"
 #include "Components/Settings/SimulationSettings.h"
 #include "Components/Rendering/Camera.h"
+#include "Components/Rendering/Transform.h"
+#include "Components/Rendering/Visibility.h"
+#include "Components/Rendering/MaterialTable.h"
 
 namespace Scene
 {
@@ -224,6 +227,87 @@ namespace Scene
 		return filterObjects(scene, std::bit_mask(components), exactMatch, includeDisabled, thisGroupOnly);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	void benchmarkComponentAccess(Scene& scene, const size_t numPasses)
+	{
+		// Gather the objects, and mirror their components into the hash map storage they used to live in
+		std::vector<Object*> objects;
+		std::vector<std::unordered_map<ComponentId, void*>> componentMaps;
+		size_t numComponents = 0;
+		for (auto& objectIt : scene.m_objects)
+		{
+			Object* object = &objectIt.second;
+			objects.push_back(object);
+			std::unordered_map<ComponentId, void*>& componentMap = componentMaps.emplace_back();
+			for (ComponentId id = 0; id < s_maxComponents; ++id)
+			{
+				if ((object->m_componentList & (1ull << id)) == 0) continue;
+				componentMap[id] = object->m_components[id].get();
+				++numComponents;
+			}
+		}
+
+		if (objects.empty())
+		{
+			Debug::log_warning() << "The scene has no objects, nothing to benchmark." << Debug::end;
+			return;
+		}
+
+		// Typed access: the transform of every object that has one, like the per-object update and render callbacks
+		float checksumSlots = 0.0f, checksumMap = 0.0f;
+		DateTime::Timer typedSlotTimer(true);
+		for (size_t passId = 0; passId < numPasses; ++passId)
+		for (Object* object : objects)
+		{
+			if (object->hasComponent<Transform::TransformComponent>())
+				checksumSlots += object->component<Transform::TransformComponent>().m_position.x;
+		}
+		typedSlotTimer.stop();
+
+		DateTime::Timer typedMapTimer(true);
+		for (size_t passId = 0; passId < numPasses; ++passId)
+		for (size_t objectId = 0; objectId < objects.size(); ++objectId)
+		{
+			auto it = componentMaps[objectId].find(COMPONENT_ID_TRANSFORM);
+			if (it != componentMaps[objectId].end())
+				checksumMap += static_cast<Transform::TransformComponent const*>(it->second)->m_position.x;
+		}
+		typedMapTimer.stop();
+
+		// Scene-wide pass: every component of every object
+		uintptr_t pointerSumSlots = 0, pointerSumMap = 0;
+		DateTime::Timer sceneSlotTimer(true);
+		for (size_t passId = 0; passId < numPasses; ++passId)
+		for (Object* object : objects)
+		for (ComponentId id = 0; id < s_maxComponents; ++id)
+		{
+			if (object->m_componentList & (1ull << id))
+				pointerSumSlots += uintptr_t(object->m_components[id].get());
+		}
+		sceneSlotTimer.stop();
+
+		DateTime::Timer sceneMapTimer(true);
+		for (size_t passId = 0; passId < numPasses; ++passId)
+		for (size_t objectId = 0; objectId < objects.size(); ++objectId)
+		for (ComponentId id = 0; id < s_maxComponents; ++id)
+		{
+			if (objects[objectId]->m_componentList & (1ull << id))
+				pointerSumMap += uintptr_t(componentMaps[objectId].find(id)->second);
+		}
+		sceneMapTimer.stop();
+
+		const double numTyped = double(numPasses * objects.size()), numScene = double(numPasses * numComponents);
+		Debug::log_info() << "Component access benchmark (" << objects.size() << " objects, " << numComponents << " components, " << numPasses << " passes):" << Debug::end;
+		Debug::log_info() << "  - transform, slots: " << typedSlotTimer.getElapsedTime() * 1e9 / numTyped << " ns per object" << Debug::end;
+		Debug::log_info() << "  - transform, hash map: " << typedMapTimer.getElapsedTime() * 1e9 / numTyped << " ns per object" << Debug::end;
+		Debug::log_info() << "  - every component, slots: " << sceneSlotTimer.getElapsedTime() * 1e9 / numScene << " ns per component, "
+			<< sceneSlotTimer.getElapsedTime() * 1e3 / numPasses << " ms per scene pass" << Debug::end;
+		Debug::log_info() << "  - every component, hash map: " << sceneMapTimer.getElapsedTime() * 1e9 / numScene << " ns per component, "
+			<< sceneMapTimer.getElapsedTime() * 1e3 / numPasses << " ms per scene pass" << Debug::end;
+		if (checksumSlots != checksumMap || pointerSumSlots != pointerSumMap)
+			Debug::log_error() << "  - checksums differ between the two storages" << Debug::end;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	Object* findFirstObjectSlow(Scene& scene, std::string const& group, unsigned long long objectType)
 	{
@@ -1169,7 +1253,7 @@ namespace Scene
 		if (buffer.m_persistentlyMapped)
 		{
 			char* dataPtr = (char*) glMapBufferRange(buffer.m_bufferType, 0, buffer.m_totalSize, s_persistentBufferFlags);
-			for (size_t i = 0; i < 3; ++i) buffer.m_persistentRegions[0] = dataPtr + i * buffer.m_size;
+			for (size_t i = 0; i < 3; ++i) buffer.m_persistentRegions[i] = dataPtr + i * buffer.m_size;
 		}
 
 		// Unbind the buffer, we are done with it
@@ -1235,7 +1319,7 @@ namespace Scene
 		if (buffer.m_persistentlyMapped)
 		{
 			char* dataPtr = (char*)glMapBufferRange(buffer.m_bufferType, 0, buffer.m_totalSize, s_persistentBufferFlags);
-			for (size_t i = 0; i < 3; ++i) buffer.m_persistentRegions[0] = dataPtr + i * buffer.m_size;
+			for (size_t i = 0; i < 3; ++i) buffer.m_persistentRegions[i] = dataPtr + i * buffer.m_size;
 		}
 
 		// Unbind the buffer, we are done with it
@@ -1454,6 +1538,162 @@ namespace Scene
 		uploadBufferData(ubo, uboName, size, data);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	void uploadBufferSubData(GPU::GenericBuffer& buffer, std::string const& bufferName, size_t offset, size_t size, const void* data)
+	{
+		Debug::log_trace() << "Uploading sub-data to " << bufferName << "; "
+			<< "offset: " << Units::bytesToString(offset) << ", "
+			<< "data size: " << Units::bytesToString(size)
+			<< Debug::end;
+
+		// Sub-range uploads never reallocate the buffer
+		if (offset + size > size_t(buffer.m_size))
+		{
+			Debug::log_error() << "Attempting to upload past the end of GPU buffer \"" << bufferName << "\"" << Debug::end;
+			return;
+		}
+
+		glBufferSubData(buffer.m_bufferType, offset, size, data);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	void uploadBufferSubData(Scene& scene, std::string const& bufferName, size_t offset, size_t size, const void* data)
+	{
+		GPU::GenericBuffer& buffer = scene.m_genericBuffers[bufferName];
+
+		bindBuffer(buffer, GPU::UniformBufferIndices(buffer.m_bindingId));
+		uploadBufferSubData(buffer, bufferName, offset, size, data);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// Initial and maximum size of the upload ring
+	static const size_t s_uploadRingInitialSize = 4 * 1024 * 1024;
+	static const size_t s_uploadRingMaxSize = 64 * 1024 * 1024;
+
+	////////////////////////////////////////////////////////////////////////////////
+	UploadRing::Backend uploadRingBackendOpenGL()
+	{
+		UploadRing::Backend backend;
+
+		// Immutable, persistently mapped buffers
+		backend.m_createStorage = [](size_t size, void** mappedMemory)
+		{
+			GLuint buffer = 0;
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glObjectLabel(GL_BUFFER, buffer, -1, "UploadRing");
+			glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, s_persistentBufferFlags);
+			*mappedMemory = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, s_persistentBufferFlags);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			return UploadRing::StorageHandle(buffer);
+		};
+		backend.m_releaseStorage = [](UploadRing::StorageHandle storage)
+		{
+			GLuint buffer = GLuint(storage);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			glDeleteBuffers(1, &buffer);
+		};
+
+		// Regular sync objects
+		backend.m_insertFence = []()
+		{
+			return UploadRing::FenceHandle(reinterpret_cast<uintptr_t>(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)));
+		};
+		backend.m_queryFence = [](UploadRing::FenceHandle fence, bool wait)
+		{
+			GLsync sync = reinterpret_cast<GLsync>(uintptr_t(fence));
+			GLenum status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+			while (wait && status == GL_TIMEOUT_EXPIRED)
+				status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+			// A failed wait is treated as signaled, so a lost context cannot stall the ring forever
+			return status != GL_TIMEOUT_EXPIRED;
+		};
+		backend.m_deleteFence = [](UploadRing::FenceHandle fence)
+		{
+			glDeleteSync(reinterpret_cast<GLsync>(uintptr_t(fence)));
+		};
+
+		return backend;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	UploadRing::Ring& getUploadRing(Scene& scene)
+	{
+		if (scene.m_uploadRing.m_memory == nullptr)
+			UploadRing::initialize(scene.m_uploadRing, uploadRingBackendOpenGL(), s_uploadRingInitialSize, s_uploadRingMaxSize);
+		return scene.m_uploadRing;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	size_t uploadRingAlignment(GLenum bufferType)
+	{
+		static const GLint s_uniformAlignment = []() { GLint result = 256; glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &result); return result; }();
+		static const GLint s_storageAlignment = []() { GLint result = 256; glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &result); return result; }();
+
+		if (bufferType == GL_UNIFORM_BUFFER) return size_t(s_uniformAlignment);
+		if (bufferType == GL_SHADER_STORAGE_BUFFER) return size_t(s_storageAlignment);
+		return 16;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool uploadTransientBufferData(Scene& scene, std::string const& bufferName, size_t size, const void* data)
+	{
+		GPU::GenericBuffer& buffer = scene.m_genericBuffers[bufferName];
+
+		// Only indexed buffers can be bound to a sub-range
+		UploadRing::Allocation allocation;
+		if (buffer.m_indexed)
+			allocation = UploadRing::upload(getUploadRing(scene), data, size, uploadRingAlignment(buffer.m_bufferType));
+
+		// Fall back to a regular upload if the ring is out of space, or the data is larger than the ring can ever be
+		if (allocation.m_data == nullptr)
+		{
+			uploadBufferData(scene, bufferName, size, data);
+			return false;
+		}
+
+		Debug::log_trace() << "Uploading transient data to " << bufferName << "; "
+			<< "data size: " << Units::bytesToString(size) << ", "
+			<< "ring offset: " << Units::bytesToString(allocation.m_offset)
+			<< Debug::end;
+
+		glBindBufferRange(buffer.m_bufferType, buffer.m_bindingId, GLuint(allocation.m_storage), allocation.m_offset, allocation.m_size);
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	bool uploadBufferDataStaged(Scene& scene, std::string const& bufferName, size_t size, const void* data)
+	{
+		const UploadRing::Allocation allocation = UploadRing::upload(getUploadRing(scene), data, size, 16);
+
+		// Fall back to a regular upload if the ring is out of space, or the data is larger than the ring can ever be
+		if (allocation.m_data == nullptr)
+		{
+			uploadBufferData(scene, bufferName, size, data);
+			return false;
+		}
+
+		// Make room for the data; the previous contents are overwritten anyway
+		resizeGPUBuffer(scene, bufferName, size, true);
+		GPU::GenericBuffer& buffer = scene.m_genericBuffers[bufferName];
+
+		Debug::log_trace() << "Uploading staged data to " << bufferName << "; "
+			<< "data size: " << Units::bytesToString(size) << ", "
+			<< "ring offset: " << Units::bytesToString(allocation.m_offset)
+			<< Debug::end;
+
+		// Copy the data over on the GPU
+		glBindBuffer(GL_COPY_READ_BUFFER, GLuint(allocation.m_storage));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.m_buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.m_offset, 0, size);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		return true;
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	bool waitForGpu(Scene& scene, const size_t maxWaitPeriod)
 	{
@@ -1554,6 +1794,9 @@ namespace Scene
 			glDeleteBuffers(1, &genericBuffer.second.m_buffer);
 		}
 		scene.m_genericBuffers.clear();
+
+		// Release the upload ring
+		UploadRing::release(scene.m_uploadRing);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -2033,6 +2276,18 @@ namespace Scene
 
 		Debug::log_trace() << "Rendering scene: " << scene.m_name << ", using camera: " << renderParameters.m_camera->m_name << Debug::end;
 
+		// Reclaim the upload ring space of the finished frames, and keep the CPU from running too far ahead
+		UploadRing::beginFrame(getUploadRing(scene));
+
+		// Rebuild the cached matrices of the objects moved during the update, so the render passes do not have to
+		Transform::updateCachedMatrices(scene, renderParameters.m_renderSettings);
+
+		// Cull the scene for every view up front, so the render callbacks can share the results
+		Visibility::updateVisibility(scene, renderParameters.m_renderSettings, renderParameters.m_camera);
+
+		// Upload the materials that changed since the last frame
+		MaterialTable::updateMaterialTable(scene, renderParameters.m_renderSettings);
+
 		// Render with the corresponding render functions
 		switch (renderParameters.m_renderSettings->component<RenderSettings::RenderSettingsComponent>().m_rendering.m_renderer)
 		{
@@ -2040,6 +2295,9 @@ namespace Scene
 			renderScene(scene, objectRenderFunctionsOpenGL(), renderParameters);
 			break;
 		}
+
+		// Fence the upload ring allocations of the frame
+		UploadRing::endFrame(scene.m_uploadRing);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
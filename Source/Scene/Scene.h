@@ -104,6 +104,9 @@ namespace Scene
 		// The various GPU buffers.
 		std::unordered_map<std::string, GPU::GenericBuffer> m_genericBuffers;
 
+		// Ring buffer for the per-frame uploads.
+		UploadRing::Ring m_uploadRing;
+
 		// The various occlusion queries.
 		std::unordered_map<std::string, GPU::OcclusionQuery> m_occlusionQueries;
 
@@ -157,8 +160,17 @@ namespace Scene
 		int m_profilerBufferReadId = 0;
 		int m_profilerBufferWriteId = 2;
 
+		// Number of frames kept in the profiler entry histories
+		size_t m_profilerHistoryLength = Profiler::s_defaultHistoryLength;
+
 		// Iterator where the debug data should be written to
 		Profiler::ProfilerTreeIterator m_profilerWritePosition;
+
+		// Per-thread profiler event buffers
+		std::unique_ptr<Profiler::EventStreams> m_profilerEvents = std::make_unique<Profiler::EventStreams>();
+
+		// The profiler trace capture state
+		std::unique_ptr<Profiler::TraceWriter> m_profilerTrace = std::make_unique<Profiler::TraceWriter>();
 	};
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -266,6 +278,10 @@ namespace Scene
 		return filterObjects(scene, std::bit_mask(components), pred, exactMatch, includeDisabled, thisGroupOnly);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Times component lookups through the object component slots against a hash map mirror of the same components. */
+	void benchmarkComponentAccess(Scene& scene, const size_t numPasses = 1 << 16);
+
 	////////////////////////////////////////////////////////////////////////////////
 	Object* findFirstObject(Scene& scene, std::string const& group, std::initializer_list<ComponentId> components);
 
@@ -483,6 +499,14 @@ namespace Scene
 	/** Helper function for updating uniforms. */
 	void uploadBufferData(Scene& scene, std::string const& uboName, size_t size, const void* data);
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Updates a sub-range of an already allocated buffer. */
+	void uploadBufferSubData(GPU::GenericBuffer& buffer, std::string const& bufferName, size_t offset, size_t size, const void* data);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Updates a sub-range of an already allocated buffer. */
+	void uploadBufferSubData(Scene& scene, std::string const& bufferName, size_t offset, size_t size, const void* data);
+
 	////////////////////////////////////////////////////////////////////////////////
 	/** Helper function for updating uniforms. */
 	template<typename T, typename std::enable_if<std::is_container<T>::value, bool>::type = true>
@@ -510,6 +534,41 @@ namespace Scene
 		uploadBufferData(ubo, uboName, data);
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/** Writes the data into the upload ring, and binds the written range to the binding point of the named buffer.
+		The data is only valid for the current frame. Falls back to a regular upload if the ring is out of space;
+		returns whether the ring was used. */
+	bool uploadTransientBufferData(Scene& scene, std::string const& bufferName, size_t size, const void* data);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Writes the data into the upload ring, and binds the written range to the binding point of the named buffer. */
+	template<typename T, typename std::enable_if<std::is_container<T>::value, bool>::type = true>
+	bool uploadTransientBufferData(Scene& scene, std::string const& bufferName, T const& data)
+	{
+		return uploadTransientBufferData(scene, bufferName, data.size() * sizeof(data[0]), data.data());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Writes the data into the upload ring, and binds the written range to the binding point of the named buffer. */
+	template<typename T, typename std::enable_if<!std::is_container<T>::value && !std::is_pointer<T>::value, bool>::type = true>
+	bool uploadTransientBufferData(Scene& scene, std::string const& bufferName, T const& data)
+	{
+		return uploadTransientBufferData(scene, bufferName, sizeof(T), &data);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Stages the data in the upload ring and copies it into the named buffer on the GPU, growing the buffer if needed.
+		Meant for data that outlives the frame. Returns whether the ring was used. */
+	bool uploadBufferDataStaged(Scene& scene, std::string const& bufferName, size_t size, const void* data);
+
+	////////////////////////////////////////////////////////////////////////////////
+	/** Stages the data in the upload ring and copies it into the named buffer on the GPU. */
+	template<typename T, typename std::enable_if<std::is_container<T>::value, bool>::type = true>
+	bool uploadBufferDataStaged(Scene& scene, std::string const& bufferName, T const& data)
+	{
+		return uploadBufferDataStaged(scene, bufferName, data.size() * sizeof(data[0]), data.data());
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	//  GPU SYNCHRONIZATION
 	////////////////////////////////////////////////////////////////////////////////
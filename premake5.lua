@@ -168,7 +168,7 @@ workspace(WORKSPACE_NAME)
         ignoredefaultlibraries{ "libcmt" }
         warnings("Off")
         inlining("Auto")
-        defines({ "CONFIG_RELEASE", "CONFIG=\"Release\"", "NDEBUG" })
+        defines({ "CONFIG_RELEASE", "CONFIG_RELEASE_FINAL", "CONFIG=\"Release\"", "NDEBUG" })
     filter({})
 
     -- configure the platforms